@@ -186,7 +186,9 @@ void main() {
 
 	m_Params.Normal = normalize(psInput.Normal);
 	if(MaterialUniforms.NormalTexToggle > 0.5) {
-		m_Params.Normal = normalize(2.0 * texture(u_NormalTexture, psInput.TexCoords).rgb - 1.0);
+		// Only xy is read, BC5 normal maps have no z and tangent space normals always face out of the surface
+		vec2 normalXY = 2.0 * texture(u_NormalTexture, psInput.TexCoords).rg - 1.0;
+		m_Params.Normal = vec3(normalXY, sqrt(max(1.0 - dot(normalXY, normalXY), 0.0)));
 		m_Params.Normal = normalize(psInput.WorldNormals * m_Params.Normal);
 	}
 	m_Params.View = normalize(environment.u_CameraPosition - psInput.WorldPosition);
@@ -10,8 +10,9 @@ layout(std140, binding = 0) uniform Camera {
 	mat4 ViewProjection;
 } mainCamera;
 
+// One transform per instance, Renderer3D::MaxInstancesPerDraw must match the array size
 layout(std140, binding = 1) uniform ObjectTransform {
-	mat4 Transform;
+	mat4 Transforms[256];
 } transform;
 
 layout(location = 0) out PixelInput {
@@ -24,12 +25,15 @@ layout(location = 0) out PixelInput {
 } psInput;
 
 void main() {
-	psInput.WorldPosition = vec3(transform.Transform * vec4(a_Position, 1.0));
-	psInput.Normal = mat3(transform.Transform) * a_Normal;
+	// Vulkan GLSL, OpenGL links the cross-compiled source where this becomes gl_InstanceID
+	mat4 model = transform.Transforms[gl_InstanceIndex];
+
+	psInput.WorldPosition = vec3(model * vec4(a_Position, 1.0));
+	psInput.Normal = mat3(model) * a_Normal;
 	psInput.TexCoords = vec2(a_TexCoord.x, 1.0 - a_TexCoord.y);
-	psInput.WorldNormals = mat3(transform.Transform) * mat3(a_Tangent, a_Binormal, a_Normal);
-	psInput.WorldTransform = mat3(transform.Transform);
+	psInput.WorldNormals = mat3(model) * mat3(a_Tangent, a_Binormal, a_Normal);
+	psInput.WorldTransform = mat3(model);
 	psInput.Binormal = a_Binormal;
 
-	gl_Position = mainCamera.ViewProjection * transform.Transform * vec4(a_Position, 1.0);
+	gl_Position = mainCamera.ViewProjection * model * vec4(a_Position, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,56 @@
+#version 450
+
+// Mesh::CompactVertex, see Mesh.h for the encoding
+layout(location = 0) in vec4 a_Position;	// xyz unorm16 inside the mesh bounds, w bitangent sign
+layout(location = 1) in vec2 a_Normal;		// Octahedral snorm16
+layout(location = 2) in vec2 a_Tangent;		// Octahedral snorm16
+layout(location = 3) in vec2 a_TexCoord;	// Half floats
+
+layout(std140, binding = 0) uniform Camera {
+	mat4 ViewProjection;
+} mainCamera;
+
+// One transform per instance, Renderer3D::MaxInstancesPerDraw must match the array size
+layout(std140, binding = 1) uniform ObjectTransform {
+	mat4 Transforms[256];
+} transform;
+
+layout(std140, binding = 5) uniform MeshQuantization {
+	vec4 PositionMin;
+	vec4 PositionExtent;
+} quantization;
+
+layout(location = 0) out PixelInput {
+	vec3 WorldPosition;
+	vec3 Normal;
+	vec2 TexCoords;
+	mat3 WorldNormals;
+	mat3 WorldTransform;
+	vec3 Binormal;
+} psInput;
+
+vec3 OctDecode(vec2 e) {
+	vec3 v = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+	if (v.z < 0.0)
+		v.xy = (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+	return normalize(v);
+}
+
+void main() {
+	// Vulkan GLSL, OpenGL links the cross-compiled source where this becomes gl_InstanceID
+	mat4 model = transform.Transforms[gl_InstanceIndex];
+
+	vec3 position = quantization.PositionMin.xyz + a_Position.xyz * quantization.PositionExtent.xyz;
+	vec3 normal = OctDecode(a_Normal);
+	vec3 tangent = OctDecode(a_Tangent);
+	vec3 binormal = cross(normal, tangent) * (a_Position.w * 2.0 - 1.0);
+
+	psInput.WorldPosition = vec3(model * vec4(position, 1.0));
+	psInput.Normal = mat3(model) * normal;
+	psInput.TexCoords = vec2(a_TexCoord.x, 1.0 - a_TexCoord.y);
+	psInput.WorldNormals = mat3(model) * mat3(tangent, binormal, normal);
+	psInput.WorldTransform = mat3(model);
+	psInput.Binormal = binormal;
+
+	gl_Position = mainCamera.ViewProjection * model * vec4(position, 1.0);
+}
@@ -1,14 +1,17 @@
 #type vertex
 #version 450
 
-layout (location = 0) in vec3 a_Position;
-layout (location = 1) in vec2 a_TexCoord;
-layout (location = 2) in float a_TexID;
-layout (location = 3) in vec4 a_Color;
+// Per-instance quad record, the corners are expanded from the vertex index
+layout (location = 0) in vec4 a_TransformRow0;
+layout (location = 1) in vec4 a_TransformRow1;
+layout (location = 2) in vec4 a_TransformRow2;
+layout (location = 3) in vec4 a_TexRect;
+layout (location = 4) in uint a_Color;
+layout (location = 5) in uint a_TexIndex;
 
 layout (location = 0) out VertexOutput {
     vec2 TexCoord;
-    float TexID;
+    flat uint TexIndex;
     vec4 Color;
 } vsOutput;
 
@@ -16,13 +19,23 @@ layout (std140, binding = 0) uniform Camera {
     mat4 ViewProjection;
 } mainCamera;
 
-
+const vec2 c_QuadCorners[4] = vec2[](
+    vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0), vec2(0.0, 1.0)
+);
 
 void main() {
-    gl_Position = mainCamera.ViewProjection * vec4(a_Position, 1.0);
-    vsOutput.TexCoord = a_TexCoord;
-    vsOutput.TexID = a_TexID;
-    vsOutput.Color = a_Color;
+    // Vulkan GLSL, OpenGL links the cross-compiled source where this becomes gl_VertexID
+    vec2 corner = c_QuadCorners[gl_VertexIndex & 3];
+    vec4 localPosition = vec4(corner - 0.5, 0.0, 1.0);
+    vec3 worldPosition = vec3(
+        dot(a_TransformRow0, localPosition),
+        dot(a_TransformRow1, localPosition),
+        dot(a_TransformRow2, localPosition));
+
+    gl_Position = mainCamera.ViewProjection * vec4(worldPosition, 1.0);
+    vsOutput.TexCoord = mix(a_TexRect.xy, a_TexRect.zw, corner);
+    vsOutput.TexIndex = a_TexIndex;
+    vsOutput.Color = unpackUnorm4x8(a_Color);
 }
 
 #type pixel
@@ -32,49 +45,31 @@ layout (location = 0) out vec4 Color;
 
 layout (location = 0) in VertexOutput {
     vec2 TexCoord;
-    float TexID;
+    flat uint TexIndex;
     vec4 Color;
 } psInput;
 
-layout (binding = 0) uniform sampler2D u_Textures[32];
+// One array per power of two size class, 16 to 4096 texels
+layout (binding = 0) uniform sampler2DArray u_TexturePages[9];
+
+const uint c_NoTexture = 0xffffffffu;
 
 void main() {
     vec4 texColor = psInput.Color;
-    switch(int(psInput.TexID)) {
-    case 0: texColor *= texture(u_Textures[0], psInput.TexCoord); break;
-    case 1: texColor *= texture(u_Textures[1], psInput.TexCoord); break;
-    case 2: texColor *= texture(u_Textures[2], psInput.TexCoord); break;
-    case 3: texColor *= texture(u_Textures[3], psInput.TexCoord); break;
-    case 4: texColor *= texture(u_Textures[4], psInput.TexCoord); break;
-    case 5: texColor *= texture(u_Textures[5], psInput.TexCoord); break;
-    case 6: texColor *= texture(u_Textures[6], psInput.TexCoord); break;
-    case 7: texColor *= texture(u_Textures[7], psInput.TexCoord); break;
-    case 8: texColor *= texture(u_Textures[8], psInput.TexCoord); break;
-    case 9: texColor *= texture(u_Textures[9], psInput.TexCoord); break;
-    case 10: texColor *= texture(u_Textures[10], psInput.TexCoord); break;
-    case 11: texColor *= texture(u_Textures[11], psInput.TexCoord); break;
-    case 12: texColor *= texture(u_Textures[12], psInput.TexCoord); break;
-    case 13: texColor *= texture(u_Textures[13], psInput.TexCoord); break;
-    case 14: texColor *= texture(u_Textures[14], psInput.TexCoord); break;
-    case 15: texColor *= texture(u_Textures[15], psInput.TexCoord); break;
-    case 16: texColor *= texture(u_Textures[16], psInput.TexCoord); break;
-    case 17: texColor *= texture(u_Textures[17], psInput.TexCoord); break;
-    case 18: texColor *= texture(u_Textures[18], psInput.TexCoord); break;
-    case 19: texColor *= texture(u_Textures[19], psInput.TexCoord); break;
-    case 20: texColor *= texture(u_Textures[20], psInput.TexCoord); break;
-    case 21: texColor *= texture(u_Textures[21], psInput.TexCoord); break;
-    case 22: texColor *= texture(u_Textures[22], psInput.TexCoord); break;
-    case 23: texColor *= texture(u_Textures[23], psInput.TexCoord); break;
-    case 24: texColor *= texture(u_Textures[24], psInput.TexCoord); break;
-    case 25: texColor *= texture(u_Textures[25], psInput.TexCoord); break;
-    case 26: texColor *= texture(u_Textures[26], psInput.TexCoord); break;
-    case 27: texColor *= texture(u_Textures[27], psInput.TexCoord); break;
-    case 28: texColor *= texture(u_Textures[28], psInput.TexCoord); break;
-    case 29: texColor *= texture(u_Textures[29], psInput.TexCoord); break;
-    case 30: texColor *= texture(u_Textures[30], psInput.TexCoord); break;
-    case 31: texColor *= texture(u_Textures[31], psInput.TexCoord); break;
+    if (psInput.TexIndex != c_NoTexture) {
+        vec3 coord = vec3(psInput.TexCoord, float(psInput.TexIndex & 0xffffu));
+        switch(int(psInput.TexIndex >> 16)) {
+        case 0: texColor *= texture(u_TexturePages[0], coord); break;
+        case 1: texColor *= texture(u_TexturePages[1], coord); break;
+        case 2: texColor *= texture(u_TexturePages[2], coord); break;
+        case 3: texColor *= texture(u_TexturePages[3], coord); break;
+        case 4: texColor *= texture(u_TexturePages[4], coord); break;
+        case 5: texColor *= texture(u_TexturePages[5], coord); break;
+        case 6: texColor *= texture(u_TexturePages[6], coord); break;
+        case 7: texColor *= texture(u_TexturePages[7], coord); break;
+        case 8: texColor *= texture(u_TexturePages[8], coord); break;
+        }
     }
 
     Color = texColor;
-    //Color = vec4(0.0f);
 }
@@ -6,12 +6,19 @@
 namespace Snow {
     class MainApplication : public Core::Application {
     public:
-        MainApplication() {
+        MainApplication(const Core::ApplicationSpecification& spec) :
+            Core::Application(spec) {
             PushLayer(new EditorLayer());
         }
     };
 
-    Core::Application* Core::CreateApplication() {
-        return new MainApplication();
+    Core::Application* Core::CreateApplication(Core::ApplicationCommandLineArgs args) {
+        Core::ApplicationSpecification spec;
+        // --headless runs the editor without a window or GPU on the Null API, for profiling the CPU side and CI
+        if (args.Contains("--headless"))
+            spec.RenderAPI = Render::RenderAPIType::Null;
+        if (args.Contains("--no-render-thread"))
+            spec.RenderThread = false;
+        return new MainApplication(spec);
     }
 }
@@ -15,6 +15,8 @@
 #include <imgui.h>
 #include <ImGuizmo.h>
 
+#include <filesystem>
+
 namespace Snow {
 
     int EditorLayer::m_ImGuizmoSelection = -1;
@@ -289,6 +291,10 @@ namespace Snow {
 
         void* textureID = Render::SceneRenderer::GetFinalColorAttachment();
         ImGui::Image(reinterpret_cast<void*>(textureID), ImVec2{ m_ViewportSize.x, m_ViewportSize.y }, ImVec2{ 0, 1 }, ImVec2{ 1, 0 });
+        ImVec2 viewportMin = ImGui::GetItemRectMin();
+        ImVec2 viewportMax = ImGui::GetItemRectMax();
+        m_ViewportBounds[0] = { viewportMin.x, viewportMin.y };
+        m_ViewportBounds[1] = { viewportMax.x, viewportMax.y };
 
 
         // Gizmos
@@ -325,6 +331,8 @@ namespace Snow {
                 transformComp.Translation = translation;
                 transformComp.Rotation += deltaRot;
                 transformComp.Scale = scale;
+                transformComp.UpdateTransform();
+                selectedEntity.MarkChanged<TransformComponent>();
             }
         }
 
@@ -347,7 +355,7 @@ namespace Snow {
     }
 
     void EditorLayer::OpenScene() {
-        std::optional<std::string> filepath = Utils::FileDialogs::OpenFile("Snow Scene (*.snow)\0*.snow\0");
+        std::optional<std::string> filepath = Utils::FileDialogs::OpenFile("Snow Scene (*.snow, *.snowb)\0*.snow;*.snowb\0");
         if (filepath) {
             m_EditorScene = Ref<Scene>::Create();
             //m_ActiveScene->OnViewportResize((uint32_t)m_ViewportSize.x, (uint32_t)m_ViewportSize.y);
@@ -358,15 +366,21 @@ namespace Snow {
 
 
             SceneSerializer serializer(m_EditorScene);
-            serializer.DeserializeText(*filepath);
+            if (std::filesystem::path(*filepath).extension() == ".snowb")
+                serializer.DeserializeBinary(*filepath);
+            else
+                serializer.DeserializeText(*filepath);
         }
     }
 
     void EditorLayer::SaveSceneAs() {
-        std::optional<std::string> filepath = Utils::FileDialogs::SaveFile("Snow Scene (*.snow)\0*.snow\0");
+        std::optional<std::string> filepath = Utils::FileDialogs::SaveFile("Snow Scene (*.snow)\0*.snow\0Binary Snow Scene (*.snowb)\0*.snowb\0");
         if (filepath) {
             SceneSerializer serializer(m_EditorScene);
-            serializer.SerializeText(*filepath);
+            if (std::filesystem::path(*filepath).extension() == ".snowb")
+                serializer.SerializeBinary(*filepath);
+            else
+                serializer.SerializeText(*filepath);
         }
     }
 
@@ -374,6 +388,28 @@ namespace Snow {
 
         Core::Event::EventDispatcher dispatcher(e);
         dispatcher.Dispatch<Core::Event::KeyPressedEvent>(SNOW_BIND_EVENT_FN(EditorLayer::OnKeyPressed));
+        dispatcher.Dispatch<Core::Event::MouseButtonPressedEvent>(SNOW_BIND_EVENT_FN(EditorLayer::OnMouseButtonPressed));
+    }
+
+    // Selects the entity under the mouse, clicks on the gizmo are left to it
+    bool EditorLayer::OnMouseButtonPressed(Core::Event::MouseButtonPressedEvent& e) {
+        if (e.GetMouseButton() != MouseCode::ButtonLeft || !m_ViewportHovered || m_SceneState != SceneState::Editor || ImGuizmo::IsOver())
+            return false;
+
+        // The viewport image is drawn flipped, so screen y grows down while device y grows up
+        ImVec2 mousePos = ImGui::GetMousePos();
+        glm::vec2 viewportSize = m_ViewportBounds[1] - m_ViewportBounds[0];
+        glm::vec2 ndc = (glm::vec2(mousePos.x, mousePos.y) - m_ViewportBounds[0]) / viewportSize * 2.0f - 1.0f;
+        ndc.y = -ndc.y;
+
+        glm::mat4 inverseViewProjection = glm::inverse(m_EditorCamera.GetViewProjectionMatrix());
+        glm::vec4 nearPoint = inverseViewProjection * glm::vec4(ndc, -1.0f, 1.0f);
+        glm::vec4 farPoint = inverseViewProjection * glm::vec4(ndc, 1.0f, 1.0f);
+        glm::vec3 origin = glm::vec3(nearPoint) / nearPoint.w;
+        glm::vec3 direction = glm::normalize(glm::vec3(farPoint) / farPoint.w - origin);
+
+        m_SceneHierarchyPanel.SetSelectedEntity(m_EditorScene->RayCast(Core::Ray(direction, origin)));
+        return false;
     }
 
     bool EditorLayer::OnKeyPressed(Core::Event::KeyPressedEvent& e) {
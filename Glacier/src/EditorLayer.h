@@ -8,6 +8,7 @@
 #include <Snow/Core/Input.h>
 
 #include "Snow/Core/Event/KeyEvent.h"
+#include "Snow/Core/Event/MouseEvent.h"
 
 namespace Snow {
 
@@ -26,6 +27,7 @@ namespace Snow {
 
     private:
         bool OnKeyPressed(Core::Event::KeyPressedEvent& e);
+        bool OnMouseButtonPressed(Core::Event::MouseButtonPressedEvent& e);
 
         void NewScene();
         void OpenScene();
@@ -45,6 +47,8 @@ namespace Snow {
 
         bool m_ViewportFocused = false, m_ViewportHovered = false;
         glm::vec2 m_ViewportSize = { 0.0f, 0.0f };
+        // Screen space corners of the viewport image, for picking
+        glm::vec2 m_ViewportBounds[2];
         bool m_ReloadScriptOnPlay = false;
 
         bool m_Running = false;
@@ -81,16 +81,18 @@ namespace Snow {
 
     
 
-    void SceneHierarchyPanel::DrawIconedImage(const std::string& label, Ref<Render::API::Texture2D>& texture) {
+    bool SceneHierarchyPanel::DrawIconedImage(const std::string& label, Ref<Render::API::Texture2D>& texture) {
         ImGui::PushID(label.c_str());
 
+        bool changed = false;
         void* textureID = texture.Raw() == nullptr ? (void*)m_CheckerboardTexture->GetRendererID() : (void*)texture->GetRendererID();
 
         ImGui::Image(textureID, ImVec2(64, 64), ImVec2(0.0, 1.0), ImVec2(1.0, 0.0));
         if (ImGui::IsItemClicked()) {
             std::optional<std::string> filepath = Utils::FileDialogs::OpenFile("");
             if (filepath.has_value()) {
-                texture = Render::API::Texture2D::Create(filepath.value());
+                texture = Render::AssetManager::LoadTexture2D(filepath.value());
+                changed = true;
             }
         }
 
@@ -98,6 +100,7 @@ namespace Snow {
         ImGui::Text(label.c_str());
 
         ImGui::PopID();
+        return changed;
     }
 
     template<typename T, typename UIFunction>
@@ -227,13 +230,17 @@ namespace Snow {
 
         ImGui::PopItemWidth();
 
-        DrawComponent<TransformComponent>("Transform", entity, [](TransformComponent& component) {
+        DrawComponent<TransformComponent>("Transform", entity, [&entity](TransformComponent& component) {
             UI::DrawVec3Control("Translation", component.Translation);
             glm::vec3 rotation = glm::degrees(component.Rotation);
             UI::DrawVec3Control("Rotation", rotation);
             component.Rotation = glm::radians(rotation);
             UI::DrawVec3Control("Scale", component.Scale, 1.0f);
+
+            glm::mat4 previous = component.Transform;
             component.UpdateTransform();
+            if (component.Transform != previous)
+                entity.MarkChanged<TransformComponent>();
         });
 
         DrawComponent<CameraComponent>("Camera", entity, [](auto& component) {
@@ -297,66 +304,87 @@ namespace Snow {
             if (ImGui::IsItemClicked()) {
                 std::optional<std::string> filepath = Utils::FileDialogs::OpenFile("");
                 if (filepath.has_value()) {
-                    component.Texture = Render::API::Texture2D::Create(filepath.value());
+                    component.Texture = Render::AssetManager::LoadTexture2D(filepath.value());
                 }
             }
             
         });
 
-        DrawComponent<MeshComponent>("Mesh", entity, [](auto& component) {
+        DrawComponent<MeshComponent>("Mesh", entity, [&entity](auto& component) {
             Ref<Render::Mesh> m = component.Mesh;
             auto p = m.Raw() == nullptr ? "assets/models/Cube.obj" : m->GetPath();
             ImGui::Text(p.c_str());
             if (ImGui::IsItemClicked()) {
                 std::optional<std::string> filepath = Utils::FileDialogs::OpenFile("");
                 if (filepath.has_value()) {
-                    component.Mesh = Ref<Render::Mesh>::Create(filepath.value());
+                    Render::VertexFormat format = m.Raw() == nullptr ? Render::VertexFormat::Full : m->GetVertexFormat();
+                    component.Mesh = Render::AssetManager::LoadMesh(filepath.value(), format);
+                    entity.MarkChanged<MeshComponent>();
                 }
             }
+
+            // Compact meshes upload quantized vertices, the asset cache keeps the two formats apart
+            bool compact = m.Raw() != nullptr && m->GetVertexFormat() == Render::VertexFormat::Compact;
+            if (m.Raw() != nullptr && ImGui::Checkbox("Compact Vertices", &compact)) {
+                component.Mesh = Render::AssetManager::LoadMesh(m->GetPath(), compact ? Render::VertexFormat::Compact : Render::VertexFormat::Full);
+                entity.MarkChanged<MeshComponent>();
+            }
         });
 
         DrawComponent<BRDFMaterialComponent>("Material", entity, [this](auto& component) {
             Ref<Render::MaterialInstance> mat = component.MaterialInstance;
 
+            bool changed = false;
             if (ImGui::CollapsingHeader("Albedo", nullptr, ImGuiTreeNodeFlags_DefaultOpen)) {
                 bool albedoMap = component.AlbedoInput.UseTexture;
-                DrawIconedImage("Albedo Tex", component.AlbedoInput.AlbedoTexture);
+                changed |= DrawIconedImage("Albedo Tex", component.AlbedoInput.AlbedoTexture);
                 ImGui::SameLine();
                 ImGui::BeginGroup();
-                if (ImGui::Checkbox("Use##AlbedoTexture", &albedoMap))
+                if (ImGui::Checkbox("Use##AlbedoTexture", &albedoMap)) {
                     component.AlbedoInput.UseTexture = albedoMap;
+                    changed = true;
+                }
                 ImGui::EndGroup();
                 ImGui::SameLine();
-                ImGui::ColorEdit3("Albedo Color", glm::value_ptr(component.AlbedoInput.AlbedoColor));
+                changed |= ImGui::ColorEdit3("Albedo Color", glm::value_ptr(component.AlbedoInput.AlbedoColor));
             }
 
             if (ImGui::CollapsingHeader("Normal", nullptr, ImGuiTreeNodeFlags_DefaultOpen)) {
                 bool normalMap = component.NormalInput.UseTexture;
-                DrawIconedImage("Normal Tex", component.NormalInput.NormalTexture);
+                changed |= DrawIconedImage("Normal Tex", component.NormalInput.NormalTexture);
                 ImGui::SameLine();
-                if (ImGui::Checkbox("Use Normal Texture", &normalMap))
+                if (ImGui::Checkbox("Use Normal Texture", &normalMap)) {
                     component.NormalInput.UseTexture = normalMap;
+                    changed = true;
+                }
             }
 
             if (ImGui::CollapsingHeader("Metalness", nullptr, ImGuiTreeNodeFlags_DefaultOpen)) {
                 float& value = component.MetalnessInput.Value;
                 bool metalMap = component.MetalnessInput.UseTexture;
-                DrawIconedImage("Metalness", component.MetalnessInput.MetalnessTexture);
+                changed |= DrawIconedImage("Metalness", component.MetalnessInput.MetalnessTexture);
                 ImGui::SameLine();
-                if(ImGui::Checkbox("Use Texture", &metalMap))
+                if (ImGui::Checkbox("Use Texture", &metalMap)) {
                     component.MetalnessInput.UseTexture = metalMap;
-                ImGui::SliderFloat("Value##MetalnessValue", &value, 0.0f, 1.0f);
+                    changed = true;
+                }
+                changed |= ImGui::SliderFloat("Value##MetalnessValue", &value, 0.0f, 1.0f);
             }
 
             if (ImGui::CollapsingHeader("Roughness", nullptr, ImGuiTreeNodeFlags_DefaultOpen)) {
                 float& value = component.RoughnessInput.Value;
                 bool roughMap = component.RoughnessInput.UseTexture;
-                DrawIconedImage("Roughness", component.RoughnessInput.RoughnessTexture);
+                changed |= DrawIconedImage("Roughness", component.RoughnessInput.RoughnessTexture);
                 ImGui::SameLine();
-                if (ImGui::Checkbox("Use Texture", &roughMap))
+                if (ImGui::Checkbox("Use Texture", &roughMap)) {
                     component.RoughnessInput.UseTexture = roughMap;
-                ImGui::SliderFloat("Value##RoughnessValue", &value, 0.0f, 1.0f);
+                    changed = true;
+                }
+                changed |= ImGui::SliderFloat("Value##RoughnessValue", &value, 0.0f, 1.0f);
             }
+
+            if (changed)
+                component.Dirty = true;
         });
 
         DrawComponent<ScriptComponent>("Script", entity, [=](ScriptComponent& component) mutable {
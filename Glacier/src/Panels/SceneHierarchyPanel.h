@@ -17,6 +17,7 @@ namespace Snow {
         void OnImGuiRender();
 
         Entity GetSelectedEntity() { return m_SelectionContext; }
+        void SetSelectedEntity(Entity entity) { m_SelectionContext = entity; }
 
     private:
         void DrawEntityNode(Entity entity);
@@ -24,7 +25,8 @@ namespace Snow {
 
         void DrawEnvironment();
 
-        void DrawIconedImage(const std::string& label, Ref<Render::API::Texture2D>& texture);
+        // Returns true when a new texture was picked
+        bool DrawIconedImage(const std::string& label, Ref<Render::API::Texture2D>& texture);
 
         Ref<Scene> m_SceneContext;
         Entity m_SelectionContext = {};
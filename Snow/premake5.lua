@@ -26,6 +26,7 @@ project "Snow"
         "src/Snow/Script/**.*",
         "src/Snow/Platform/OpenGL/**.*",
         "src/Snow/Platform/Vulkan/**.*",
+        "src/Snow/Platform/Null/**.*",
 
         
         "vendor/stb/stb_image.cpp",
@@ -3,6 +3,7 @@
 #include "Snow/Core/Application.h"
 #include "Snow/Core/Base.h"
 #include "Snow/Core/Input.h"
+#include "Snow/Core/JobSystem.h"
 #include "Snow/Core/Layer.h"
 #include "Snow/Core/Log.h"
 #include "Snow/Core/Ref.h"
@@ -15,6 +16,7 @@
 #include "Snow/Math/Mat4.h"
 
 #include "Snow/Render/API/Framebuffer.h"
+#include "Snow/Render/AssetManager.h"
 #include "Snow/Render/RenderCommand.h"
 #include "Snow/Render/Renderer.h"
 #include "Snow/Render/RenderContext.h"
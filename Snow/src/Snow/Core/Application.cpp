@@ -1,12 +1,17 @@
 #include <spch.h>
 
 #include "Snow/Core/Application.h"
+#include "Snow/Core/JobSystem.h"
 #include "Snow/Render/Renderer.h"
 
 #include "Snow/Render/Renderer2D.h"
+#include "Snow/Render/AssetManager.h"
+#include "Snow/Render/TextureStreamer.h"
 
 #include "Snow/Script/ScriptEngine.h"
 
+#include <chrono>
+
 namespace Snow {
     namespace Core {
 
@@ -15,19 +20,26 @@ namespace Snow {
 
        
 
-        Application::Application() {
+        Application::Application(const ApplicationSpecification& spec) :
+            m_Specification(spec) {
             SNOW_CORE_INFO("Creating Application...");
             s_Instance = this;
 
-            Render::Renderer::SetRenderAPI(Render::RenderAPIType::OpenGL);
-            m_Window = new Window();
-            m_Window->SetEventCallback(SNOW_BIND_EVENT_FN(Application::OnEvent));
-            Input::Init();
-            Input::SetEventCallback(SNOW_BIND_EVENT_FN(Application::OnEvent));
+            Render::Renderer::SetRenderAPI(m_Specification.RenderAPI);
+            if (m_Specification.RenderAPI != Render::RenderAPIType::Null) {
+                m_Window = new Window();
+                m_Window->SetEventCallback(SNOW_BIND_EVENT_FN(Application::OnEvent));
+                Input::Init();
+                Input::SetEventCallback(SNOW_BIND_EVENT_FN(Application::OnEvent));
+            }
 
             m_LayerStack = LayerStack();
 
+            JobSystem::Init();
             Render::Renderer::Init();
+            Render::AssetManager::Init();
+            if (m_Specification.RenderThread && !IsHeadless())
+                Render::RenderThread::Start();
             m_ImGuiLayer = ImGuiLayer::Create();
             m_LayerStack.PushOverlay(m_ImGuiLayer);
 
@@ -36,6 +48,11 @@ namespace Snow {
 
         Application::~Application() {
             //delete m_Window;
+            // Everything destroyed from here on runs its commands in place
+            Render::RenderThread::Stop();
+            Render::AssetManager::Shutdown();
+            Render::TextureStreamer::Shutdown();
+            JobSystem::Shutdown();
             SNOW_CORE_TRACE("Destroying Application");
         }
 
@@ -49,25 +66,40 @@ namespace Snow {
         }
 
         void Application::Run() {
+            auto startTime = std::chrono::steady_clock::now();
             while(m_Running) {
-                float time = m_Window->GetSystemTime();
+                float time = m_Window ? m_Window->GetSystemTime() :
+                    std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count();
                 Timestep timestep = time - m_LastFrameTime;
                 m_LastFrameTime = time;
                 
+                // Assets finished by the loader threads are uploaded before anything draws this frame
+                Render::AssetManager::Update();
+                // Texture levels the last frame asked for start loading, levels nothing draws are freed
+                Render::TextureStreamer::Update();
+
                 //Render::Renderer::BeginScene();
                 OnUpdate(timestep);
                 
 
                 OnImGuiRender();
 
+                // Without a window nothing presents, so close out the frame here
+                if (IsHeadless())
+                    Render::RenderCommand::SwapBuffers();
+
                 //Render::Renderer::SwapBuffers();
                 //Render::Renderer::EndScene();
 
+                Render::Renderer2D::NextFrame();
+                Render::RenderThread::SubmitFrame();
+
             }
         }
 
         void Application::OnUpdate(Timestep ts) {
-            m_Window->OnUpdate();
+            if (m_Window)
+                m_Window->OnUpdate();
 
             for(Layer* layer : m_LayerStack)
                 layer->OnUpdate(ts);
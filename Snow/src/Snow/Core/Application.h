@@ -2,6 +2,8 @@
 
 #include "Snow/Core/Ref.h"
 
+#include <cstring>
+
 #include "Snow/Core/Window.h"
 #include "Snow/Core/Input.h"
 
@@ -14,13 +16,35 @@
 
 #include "Snow/Core/Timestep.h"
 
+#include "Snow/Render/RenderContext.h"
+
 
 namespace Snow {
     namespace Core {
 
+        struct ApplicationCommandLineArgs {
+            int Count = 0;
+            char** Args = nullptr;
+
+            const char* operator[](int index) const { return Args[index]; }
+            bool Contains(const char* arg) const {
+                for (int i = 1; i < Count; i++) {
+                    if (std::strcmp(Args[i], arg) == 0)
+                        return true;
+                }
+                return false;
+            }
+        };
+
+        struct ApplicationSpecification {
+            Render::RenderAPIType RenderAPI = Render::RenderAPIType::OpenGL;
+            // Records render commands on the main thread and executes them on a render thread a frame behind
+            bool RenderThread = true;
+        };
+
         class Application {
         public:
-            Application();
+            Application(const ApplicationSpecification& spec = ApplicationSpecification());
             ~Application();
 
             void Run();
@@ -39,6 +63,8 @@ namespace Snow {
             void OnImGuiRender();
 
             void Close() { m_Running = false; }
+
+            bool IsHeadless() const { return !m_Window; }
         private:
 
             bool OnApplicationUpdate(Event::AppUpdateEvent& e);
@@ -52,10 +78,12 @@ namespace Snow {
             LayerStack m_LayerStack;
             ImGuiLayer* m_ImGuiLayer;
 
+            ApplicationSpecification m_Specification;
+
             bool m_Running = true;
             float m_LastFrameTime = 0.0f;
         };
 
-        Application* CreateApplication();
+        Application* CreateApplication(ApplicationCommandLineArgs args);
     }
 }
@@ -0,0 +1,310 @@
+#include <spch.h>
+#include "Snow/Core/JobSystem.h"
+
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+namespace Snow {
+    namespace Core {
+        struct QueuedJob {
+            Job Fn;
+            JobCounter* Counter = nullptr;
+        };
+
+        struct WorkerQueue {
+            std::mutex Mutex;
+            std::deque<QueuedJob> Jobs;
+        };
+
+        struct JobSystemData {
+            std::vector<std::thread> Workers;
+            std::atomic<bool> Running{ false };
+
+            // One per worker, threads that are not workers hand their jobs out round robin
+            std::unique_ptr<WorkerQueue[]> Queues;
+            uint32_t QueueCount = 0;
+            std::atomic<uint32_t> NextQueue{ 0 };
+
+            // Jobs in any queue, workers sleep while there are none
+            std::atomic<uint32_t> QueuedJobs{ 0 };
+
+            // Background jobs are only counted in QueuedBackgroundJobs, workers sleep through them while
+            // MaxBackgroundJobs are already running
+            WorkerQueue BackgroundQueue;
+            std::atomic<uint32_t> QueuedBackgroundJobs{ 0 };
+            std::atomic<uint32_t> RunningBackgroundJobs{ 0 };
+            uint32_t MaxBackgroundJobs = 1;
+            std::mutex SleepMutex;
+            std::condition_variable JobAvailable;
+            bool Stopping = false;
+        };
+        static JobSystemData s_Data;
+
+        // Index of the calling worker's queue, -1 on other threads
+        static thread_local int32_t t_WorkerIndex = -1;
+
+        void JobSystem::Push(Job job, JobCounter* counter) {
+            if (!s_Data.Running) {
+                Execute(job, counter);
+                return;
+            }
+
+            uint32_t index = t_WorkerIndex >= 0 ? (uint32_t)t_WorkerIndex : s_Data.NextQueue++ % s_Data.QueueCount;
+            {
+                WorkerQueue& queue = s_Data.Queues[index];
+                std::lock_guard<std::mutex> lock(queue.Mutex);
+                queue.Jobs.push_back({ std::move(job), counter });
+            }
+            s_Data.QueuedJobs++;
+
+            {
+                std::lock_guard<std::mutex> lock(s_Data.SleepMutex);
+            }
+            s_Data.JobAvailable.notify_one();
+        }
+
+        // Newest job of the calling worker's own queue, otherwise the oldest job of another queue
+        static bool TryTake(QueuedJob& outJob) {
+            int32_t self = t_WorkerIndex;
+            if (self >= 0) {
+                WorkerQueue& queue = s_Data.Queues[self];
+                std::lock_guard<std::mutex> lock(queue.Mutex);
+                if (!queue.Jobs.empty()) {
+                    outJob = std::move(queue.Jobs.back());
+                    queue.Jobs.pop_back();
+                    s_Data.QueuedJobs--;
+                    return true;
+                }
+            }
+
+            uint32_t start = self >= 0 ? (uint32_t)self + 1 : s_Data.NextQueue.load();
+            for (uint32_t i = 0; i < s_Data.QueueCount; i++) {
+                uint32_t index = (start + i) % s_Data.QueueCount;
+                if ((int32_t)index == self)
+                    continue;
+
+                WorkerQueue& queue = s_Data.Queues[index];
+                std::lock_guard<std::mutex> lock(queue.Mutex);
+                if (!queue.Jobs.empty()) {
+                    outJob = std::move(queue.Jobs.front());
+                    queue.Jobs.pop_front();
+                    s_Data.QueuedJobs--;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        static bool CanRunBackground() {
+            return s_Data.QueuedBackgroundJobs > 0 && s_Data.RunningBackgroundJobs < s_Data.MaxBackgroundJobs;
+        }
+
+        bool JobSystem::TryRunBackground() {
+            // Claims a slot first, so no more than MaxBackgroundJobs run even when workers race for the last one
+            if (s_Data.RunningBackgroundJobs.fetch_add(1) >= s_Data.MaxBackgroundJobs) {
+                s_Data.RunningBackgroundJobs--;
+                return false;
+            }
+
+            QueuedJob job;
+            {
+                std::lock_guard<std::mutex> lock(s_Data.BackgroundQueue.Mutex);
+                if (!s_Data.BackgroundQueue.Jobs.empty()) {
+                    job = std::move(s_Data.BackgroundQueue.Jobs.front());
+                    s_Data.BackgroundQueue.Jobs.pop_front();
+                    s_Data.QueuedBackgroundJobs--;
+                }
+            }
+
+            if (job.Fn)
+                Execute(job.Fn, job.Counter);
+            s_Data.RunningBackgroundJobs--;
+
+            // The freed slot may let a sleeping worker take the next one
+            if (s_Data.QueuedBackgroundJobs > 0) {
+                {
+                    std::lock_guard<std::mutex> lock(s_Data.SleepMutex);
+                }
+                s_Data.JobAvailable.notify_one();
+            }
+            return (bool)job.Fn;
+        }
+
+        void JobSystem::Finish(JobCounter* counter) {
+            // Jobs that are not the last one leave without the lock
+            uint32_t count = counter->m_Count.load(std::memory_order_relaxed);
+            while (count > 1) {
+                if (counter->m_Count.compare_exchange_weak(count, count - 1, std::memory_order_acq_rel))
+                    return;
+            }
+
+            // The count reaches zero under the lock RunAfter checks it under, and Wait takes the lock before it returns,
+            // so the counter outlives the unlock even when its owner destroys it right after waiting
+            std::vector<JobCounter::Dependant> dependants;
+            {
+                std::lock_guard<std::mutex> lock(counter->m_Mutex);
+                if (counter->m_Count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    std::swap(dependants, counter->m_Dependants);
+            }
+            for (auto& dependant : dependants)
+                Push(std::move(dependant.Fn), dependant.Counter);
+        }
+
+        void JobSystem::Execute(Job& job, JobCounter* counter) {
+            job();
+            if (counter)
+                Finish(counter);
+        }
+
+        void JobSystem::WorkerLoop(uint32_t index) {
+            t_WorkerIndex = (int32_t)index;
+
+            while (true) {
+                QueuedJob job;
+                if (TryTake(job)) {
+                    Execute(job.Fn, job.Counter);
+                    continue;
+                }
+                if (TryRunBackground())
+                    continue;
+
+                std::unique_lock<std::mutex> lock(s_Data.SleepMutex);
+                s_Data.JobAvailable.wait(lock, [] { return s_Data.Stopping || s_Data.QueuedJobs > 0 || CanRunBackground(); });
+                if (s_Data.Stopping && s_Data.QueuedJobs == 0)
+                    return;
+            }
+        }
+
+        void JobSystem::Init(uint32_t workerCount) {
+            if (IsRunning())
+                return;
+
+            if (workerCount == 0) {
+                uint32_t hardwareThreads = std::thread::hardware_concurrency();
+                workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+            }
+            workerCount = std::min(workerCount, MaxWorkers);
+
+            s_Data.Queues = std::make_unique<WorkerQueue[]>(workerCount);
+            s_Data.QueueCount = workerCount;
+            s_Data.MaxBackgroundJobs = std::max(workerCount / 2, 1u);
+            s_Data.Stopping = false;
+            s_Data.Running = true;
+            for (uint32_t i = 0; i < workerCount; i++)
+                s_Data.Workers.emplace_back(WorkerLoop, i);
+
+            SNOW_CORE_INFO("Job system started with {0} workers", workerCount);
+        }
+
+        void JobSystem::Shutdown() {
+            if (!IsRunning())
+                return;
+
+            {
+                std::lock_guard<std::mutex> lock(s_Data.SleepMutex);
+                s_Data.Stopping = true;
+            }
+            s_Data.JobAvailable.notify_all();
+
+            for (auto& worker : s_Data.Workers)
+                worker.join();
+            s_Data.Workers.clear();
+
+            s_Data.Running = false;
+            s_Data.Queues.reset();
+            s_Data.QueueCount = 0;
+
+            // Workers leave background jobs they had no slot for, they still have to run
+            for (auto& job : s_Data.BackgroundQueue.Jobs)
+                Execute(job.Fn, job.Counter);
+            s_Data.BackgroundQueue.Jobs.clear();
+            s_Data.QueuedBackgroundJobs = 0;
+        }
+
+        void JobSystem::Run(Job job, JobCounter* counter) {
+            if (counter)
+                counter->m_Count.fetch_add(1, std::memory_order_relaxed);
+
+            Push(std::move(job), counter);
+        }
+
+        void JobSystem::RunAfter(JobCounter& dependency, Job job, JobCounter* counter) {
+            if (counter)
+                counter->m_Count.fetch_add(1, std::memory_order_relaxed);
+
+            {
+                // Finish takes the dependants under the same lock once the count is zero, so checking here either
+                // sees the count still running and the job gets released, or sees it done
+                std::lock_guard<std::mutex> lock(dependency.m_Mutex);
+                if (!dependency.IsDone()) {
+                    dependency.m_Dependants.push_back({ std::move(job), counter });
+                    return;
+                }
+            }
+
+            Push(std::move(job), counter);
+        }
+
+        void JobSystem::RunBackground(Job job, JobCounter* counter) {
+            if (counter)
+                counter->m_Count.fetch_add(1, std::memory_order_relaxed);
+
+            if (!s_Data.Running) {
+                Execute(job, counter);
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(s_Data.BackgroundQueue.Mutex);
+                s_Data.BackgroundQueue.Jobs.push_back({ std::move(job), counter });
+            }
+            s_Data.QueuedBackgroundJobs++;
+
+            {
+                std::lock_guard<std::mutex> lock(s_Data.SleepMutex);
+            }
+            s_Data.JobAvailable.notify_one();
+        }
+
+        void JobSystem::Wait(JobCounter& counter) {
+            while (!counter.IsDone()) {
+                QueuedJob job;
+                if (TryTake(job))
+                    Execute(job.Fn, job.Counter);
+                else
+                    std::this_thread::yield();
+            }
+
+            // The last job may still be unlocking the counter after the count reached zero
+            std::lock_guard<std::mutex> lock(counter.m_Mutex);
+        }
+
+        void JobSystem::ParallelFor(uint32_t count, uint32_t batchSize, const std::function<void(uint32_t, uint32_t)>& body) {
+            batchSize = std::max(batchSize, 1u);
+            if (!IsRunning() || count <= batchSize) {
+                if (count)
+                    body(0, count);
+                return;
+            }
+
+            JobCounter counter;
+            for (uint32_t begin = batchSize; begin < count; begin += batchSize) {
+                uint32_t end = std::min(begin + batchSize, count);
+                Run([&body, begin, end]() { body(begin, end); }, &counter);
+            }
+
+            // The calling thread takes the first batch, then helps with the rest
+            body(0, batchSize);
+            Wait(counter);
+        }
+
+        uint32_t JobSystem::GetWorkerCount() {
+            return s_Data.QueueCount;
+        }
+
+        bool JobSystem::IsRunning() {
+            return s_Data.Running;
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace Snow {
+    namespace Core {
+        using Job = std::function<void()>;
+
+        // Counts the jobs run against it that have not finished. Jobs can be made to wait on a counter, they are
+        // scheduled once it drops to zero. A counter must outlive the jobs run against and waiting on it, JobSystem::Wait
+        // on it before destroying it rather than polling IsDone.
+        class JobCounter {
+        public:
+            JobCounter() = default;
+            JobCounter(const JobCounter&) = delete;
+            JobCounter& operator=(const JobCounter&) = delete;
+
+            bool IsDone() const { return m_Count.load(std::memory_order_acquire) == 0; }
+
+        private:
+            std::atomic<uint32_t> m_Count{ 0 };
+
+            struct Dependant {
+                Job Fn;
+                JobCounter* Counter;
+            };
+            std::mutex m_Mutex;
+            std::vector<Dependant> m_Dependants;
+
+            friend class JobSystem;
+        };
+
+        // Runs jobs on a worker per hardware thread, less the main thread. Every worker owns a deque it pushes and pops
+        // its own jobs at the back of, idle workers steal the oldest jobs from the front of the others. Threads waiting
+        // on a counter run jobs until it is done, so jobs may wait on jobs they start.
+        class JobSystem {
+        public:
+            // workerCount 0 picks one less than the hardware threads
+            static void Init(uint32_t workerCount = 0);
+            // Finishes every job already run
+            static void Shutdown();
+
+            // counter, if given, counts the job until it has finished
+            static void Run(Job job, JobCounter* counter = nullptr);
+            // Runs job once every job counted by dependency has finished
+            static void RunAfter(JobCounter& dependency, Job job, JobCounter* counter = nullptr);
+            // For long jobs that may block on files, such as asset loads. Only workers with nothing else queued run them,
+            // at most half the workers at once, and threads waiting on a counter never pick them up.
+            static void RunBackground(Job job, JobCounter* counter = nullptr);
+
+            static void Wait(JobCounter& counter);
+
+            // Calls body(begin, end) for batches of batchSize indices in [0, count) and returns once all have run
+            static void ParallelFor(uint32_t count, uint32_t batchSize, const std::function<void(uint32_t, uint32_t)>& body);
+
+            // Calls func(entity) for every entity in an EnTT view. func may write the components of the entity it is
+            // given, but must not add or remove components or entities.
+            template<typename View, typename Func>
+            static void ParallelForEach(const View& view, uint32_t batchSize, Func&& func) {
+                std::vector<std::decay_t<decltype(*view.begin())>> entities(view.begin(), view.end());
+                ParallelFor((uint32_t)entities.size(), batchSize, [&](uint32_t begin, uint32_t end) {
+                    for (uint32_t i = begin; i < end; i++)
+                        func(entities[i]);
+                });
+            }
+
+            // Worker threads, not counting the threads that help while waiting
+            static uint32_t GetWorkerCount();
+            static bool IsRunning();
+
+            static constexpr uint32_t MaxWorkers = 64;
+        private:
+            static void WorkerLoop(uint32_t index);
+            static void Push(Job job, JobCounter* counter);
+            static bool TryRunBackground();
+            static void Execute(Job& job, JobCounter* counter);
+            // Releases the jobs waiting on counter once its last job is done
+            static void Finish(JobCounter* counter);
+        };
+    }
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <memory>
 #include <utility>
 
 #include "Base.h"
@@ -9,6 +10,16 @@ namespace Snow {
 
 	class RefCounted {
 	public:
+		RefCounted() = default;
+		// A copy is a new object, it starts with no references and its own alive flag
+		RefCounted(const RefCounted&) {}
+		RefCounted& operator=(const RefCounted&) { return *this; }
+
+		~RefCounted() {
+			if (m_AliveFlag)
+				*m_AliveFlag = false;
+		}
+
 		void IncRefCount() const {
 			m_RefCount++;
 		}
@@ -18,8 +29,16 @@ namespace Snow {
 		}
 
 		uint32_t GetRefCount() const { return m_RefCount; }
+
+		// Shared with every WeakRef to this object, cleared when the object is destroyed
+		const std::shared_ptr<bool>& GetAliveFlag() const {
+			if (!m_AliveFlag)
+				m_AliveFlag = std::make_shared<bool>(true);
+			return m_AliveFlag;
+		}
 	private:
 		mutable uint32_t m_RefCount = 0;
+		mutable std::shared_ptr<bool> m_AliveFlag;
 	};
 
 	template<typename T>
@@ -137,4 +156,28 @@ namespace Snow {
 	};
 
 
+	// Observes a Ref without keeping it alive
+	template<typename T>
+	class WeakRef {
+	public:
+		WeakRef() = default;
+
+		template<typename T2>
+		WeakRef(const Ref<T2>& ref) :
+			m_Instance((T*)ref.Raw()) {
+			if (m_Instance)
+				m_AliveFlag = m_Instance->GetAliveFlag();
+		}
+
+		bool IsValid() const { return m_AliveFlag && *m_AliveFlag; }
+
+		// A strong reference, or nullptr once the object is gone
+		template<typename T2 = T>
+		Ref<T2> Lock() const { return IsValid() ? Ref<T2>((T2*)m_Instance) : nullptr; }
+
+	private:
+		T* m_Instance = nullptr;
+		std::shared_ptr<bool> m_AliveFlag;
+	};
+
 }
\ No newline at end of file
@@ -2,11 +2,11 @@
 
 #include "Snow/Core/Log.h"
 
-extern Snow::Core::Application* Snow::Core::CreateApplication();
+extern Snow::Core::Application* Snow::Core::CreateApplication(Snow::Core::ApplicationCommandLineArgs args);
 
-int main() {
+int main(int argc, char** argv) {
     Snow::Core::Logger::Init();
-    auto app = Snow::Core::CreateApplication();
+    auto app = Snow::Core::CreateApplication({ argc, argv });
     app->Run();
     delete app;
 
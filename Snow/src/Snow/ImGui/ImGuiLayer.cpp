@@ -4,6 +4,7 @@
 #include "Snow/Render/Renderer.h"
 
 #include "Snow/Platform/OpenGL/OpenGLImGuiLayer.h"
+#include "Snow/Platform/Null/NullImGuiLayer.h"
 //#include "Snow/Platform/Vulkan/VulkanImGuiLayer.h"
 
 #if defined(SNOW_PLATFORM_WINDOWS)
@@ -26,6 +27,7 @@ namespace Snow {
     ImGuiLayer* ImGuiLayer::Create() {
         switch(Render::Renderer::GetRenderAPI()) {
         case Render::RenderAPIType::OpenGL: return new OpenGLImGuiLayer();
+        case Render::RenderAPIType::Null:   return new NullImGuiLayer();
         //case Render::RenderAPIType::Vulkan: return new VulkanImGuiLayer();
 #if defined(SNOW_PLATFORM_WINDOWS)
         case Render::RenderAPIType::DirectX:    return new DirectX11ImGuiLayer();
@@ -7,12 +7,42 @@ namespace Snow {
 		struct AABB {
 			glm::vec3 MinBounds, MaxBounds;
 
+			AABB() :
+				MinBounds(0.0f), MaxBounds(0.0f) {}
+
 			AABB(const glm::vec3& min, const glm::vec3& max) :
 				MinBounds(min), MaxBounds(max) {}
 
-			bool Intersects(const AABB& other) {
-				if(other.)
+			glm::vec3 GetCenter() const { return (MinBounds + MaxBounds) * 0.5f; }
+			glm::vec3 GetExtents() const { return (MaxBounds - MinBounds) * 0.5f; }
+
+			bool Intersects(const AABB& other) const {
+				return MinBounds.x <= other.MaxBounds.x && MaxBounds.x >= other.MinBounds.x &&
+					MinBounds.y <= other.MaxBounds.y && MaxBounds.y >= other.MinBounds.y &&
+					MinBounds.z <= other.MaxBounds.z && MaxBounds.z >= other.MinBounds.z;
+			}
+
+			bool Contains(const glm::vec3& point) const {
+				return glm::all(glm::greaterThanEqual(point, MinBounds)) && glm::all(glm::lessThanEqual(point, MaxBounds));
+			}
+
+			void Expand(const glm::vec3& point) {
+				MinBounds = glm::min(MinBounds, point);
+				MaxBounds = glm::max(MaxBounds, point);
+			}
+
+			void Expand(const AABB& other) {
+				MinBounds = glm::min(MinBounds, other.MinBounds);
+				MaxBounds = glm::max(MaxBounds, other.MaxBounds);
+			}
+
+			// Box around this box after transform, the extents are projected through the absolute rotation/scale
+			AABB Transform(const glm::mat4& transform) const {
+				glm::vec3 center = transform * glm::vec4(GetCenter(), 1.0f);
+				glm::mat3 absolute = glm::mat3(glm::abs(glm::vec3(transform[0])), glm::abs(glm::vec3(transform[1])), glm::abs(glm::vec3(transform[2])));
+				glm::vec3 extents = absolute * GetExtents();
+				return AABB(center - extents, center + extents);
 			}
 		};
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace Snow {
+	namespace Core {
+		struct BoundingSphere {
+			glm::vec3 Center = glm::vec3(0.0f);
+			float Radius = 0.0f;
+
+			BoundingSphere() = default;
+			BoundingSphere(const glm::vec3& center, float radius) :
+				Center(center), Radius(radius) {}
+
+			// Sphere around this sphere after transform, non-uniform scale grows the radius by the largest axis
+			BoundingSphere Transform(const glm::mat4& transform) const {
+				float scale = glm::max(glm::max(glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1]))), glm::length(glm::vec3(transform[2])));
+				return BoundingSphere(transform * glm::vec4(Center, 1.0f), Radius * scale);
+			}
+		};
+	}
+}
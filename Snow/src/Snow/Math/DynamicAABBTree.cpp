@@ -0,0 +1,278 @@
+#include <spch.h>
+#include "Snow/Math/DynamicAABBTree.h"
+
+namespace Snow {
+	namespace Core {
+		static AABB Combine(const AABB& a, const AABB& b) {
+			return AABB(glm::min(a.MinBounds, b.MinBounds), glm::max(a.MaxBounds, b.MaxBounds));
+		}
+
+		static float SurfaceArea(const AABB& box) {
+			glm::vec3 size = box.MaxBounds - box.MinBounds;
+			return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+		}
+
+		static bool ContainsBox(const AABB& outer, const AABB& inner) {
+			return glm::all(glm::lessThanEqual(outer.MinBounds, inner.MinBounds)) && glm::all(glm::greaterThanEqual(outer.MaxBounds, inner.MaxBounds));
+		}
+
+		DynamicAABBTree::DynamicAABBTree(float margin) :
+			m_Margin(margin) {}
+
+		int32_t DynamicAABBTree::CreateProxy(const AABB& box, uint64_t userData) {
+			int32_t proxy = AllocateNode();
+			Node& node = m_Nodes[proxy];
+			node.Box = AABB(box.MinBounds - glm::vec3(m_Margin), box.MaxBounds + glm::vec3(m_Margin));
+			node.UserData = userData;
+			node.Height = 0;
+
+			InsertLeaf(proxy);
+			m_ProxyCount++;
+			return proxy;
+		}
+
+		void DynamicAABBTree::DestroyProxy(int32_t proxy) {
+			SNOW_CORE_ASSERT(m_Nodes[proxy].IsLeaf());
+
+			RemoveLeaf(proxy);
+			FreeNode(proxy);
+			m_ProxyCount--;
+		}
+
+		bool DynamicAABBTree::MoveProxy(int32_t proxy, const AABB& box) {
+			SNOW_CORE_ASSERT(m_Nodes[proxy].IsLeaf());
+
+			if (ContainsBox(m_Nodes[proxy].Box, box))
+				return false;
+
+			RemoveLeaf(proxy);
+			m_Nodes[proxy].Box = AABB(box.MinBounds - glm::vec3(m_Margin), box.MaxBounds + glm::vec3(m_Margin));
+			InsertLeaf(proxy);
+			return true;
+		}
+
+		void DynamicAABBTree::Clear() {
+			m_Nodes.clear();
+			m_Root = NullNode;
+			m_FreeList = NullNode;
+			m_ProxyCount = 0;
+		}
+
+		int32_t DynamicAABBTree::AllocateNode() {
+			if (m_FreeList == NullNode) {
+				m_Nodes.emplace_back();
+				return (int32_t)m_Nodes.size() - 1;
+			}
+
+			int32_t node = m_FreeList;
+			m_FreeList = m_Nodes[node].Parent;
+			m_Nodes[node] = Node();
+			return node;
+		}
+
+		void DynamicAABBTree::FreeNode(int32_t node) {
+			m_Nodes[node].Parent = m_FreeList;
+			m_Nodes[node].Height = -1;
+			m_FreeList = node;
+		}
+
+		void DynamicAABBTree::InsertLeaf(int32_t leaf) {
+			if (m_Root == NullNode) {
+				m_Root = leaf;
+				m_Nodes[leaf].Parent = NullNode;
+				return;
+			}
+
+			// Descend towards the sibling that grows the total surface area the least
+			AABB leafBox = m_Nodes[leaf].Box;
+			int32_t index = m_Root;
+			while (!m_Nodes[index].IsLeaf()) {
+				const Node& node = m_Nodes[index];
+				float area = SurfaceArea(node.Box);
+				float combinedArea = SurfaceArea(Combine(node.Box, leafBox));
+
+				// Cost of pairing the leaf with this node, and the growth every child pairing inherits
+				float cost = 2.0f * combinedArea;
+				float inheritance = 2.0f * (combinedArea - area);
+
+				auto childCost = [&](int32_t child) {
+					const Node& childNode = m_Nodes[child];
+					float growth = SurfaceArea(Combine(childNode.Box, leafBox));
+					if (!childNode.IsLeaf())
+						growth -= SurfaceArea(childNode.Box);
+					return growth + inheritance;
+				};
+
+				float cost1 = childCost(node.Child1);
+				float cost2 = childCost(node.Child2);
+				if (cost < cost1 && cost < cost2)
+					break;
+
+				index = cost1 < cost2 ? node.Child1 : node.Child2;
+			}
+
+			int32_t sibling = index;
+			int32_t oldParent = m_Nodes[sibling].Parent;
+			int32_t newParent = AllocateNode();
+
+			Node& parent = m_Nodes[newParent];
+			parent.Parent = oldParent;
+			parent.Box = Combine(leafBox, m_Nodes[sibling].Box);
+			parent.Height = m_Nodes[sibling].Height + 1;
+			parent.Child1 = sibling;
+			parent.Child2 = leaf;
+
+			if (oldParent != NullNode) {
+				if (m_Nodes[oldParent].Child1 == sibling)
+					m_Nodes[oldParent].Child1 = newParent;
+				else
+					m_Nodes[oldParent].Child2 = newParent;
+			}
+			else
+				m_Root = newParent;
+
+			m_Nodes[sibling].Parent = newParent;
+			m_Nodes[leaf].Parent = newParent;
+
+			for (index = m_Nodes[leaf].Parent; index != NullNode; index = m_Nodes[index].Parent) {
+				index = Balance(index);
+
+				Node& node = m_Nodes[index];
+				node.Height = 1 + std::max(m_Nodes[node.Child1].Height, m_Nodes[node.Child2].Height);
+				node.Box = Combine(m_Nodes[node.Child1].Box, m_Nodes[node.Child2].Box);
+			}
+		}
+
+		void DynamicAABBTree::RemoveLeaf(int32_t leaf) {
+			if (leaf == m_Root) {
+				m_Root = NullNode;
+				return;
+			}
+
+			int32_t parent = m_Nodes[leaf].Parent;
+			int32_t grandParent = m_Nodes[parent].Parent;
+			int32_t sibling = m_Nodes[parent].Child1 == leaf ? m_Nodes[parent].Child2 : m_Nodes[parent].Child1;
+
+			FreeNode(parent);
+
+			if (grandParent == NullNode) {
+				m_Root = sibling;
+				m_Nodes[sibling].Parent = NullNode;
+				return;
+			}
+
+			if (m_Nodes[grandParent].Child1 == parent)
+				m_Nodes[grandParent].Child1 = sibling;
+			else
+				m_Nodes[grandParent].Child2 = sibling;
+			m_Nodes[sibling].Parent = grandParent;
+
+			for (int32_t index = grandParent; index != NullNode; index = m_Nodes[index].Parent) {
+				index = Balance(index);
+
+				Node& node = m_Nodes[index];
+				node.Height = 1 + std::max(m_Nodes[node.Child1].Height, m_Nodes[node.Child2].Height);
+				node.Box = Combine(m_Nodes[node.Child1].Box, m_Nodes[node.Child2].Box);
+			}
+		}
+
+		// Rotates the taller grandchild up when the subtrees of node differ in height by more than one,
+		// returns the node now at the old position
+		int32_t DynamicAABBTree::Balance(int32_t iA) {
+			Node& A = m_Nodes[iA];
+			if (A.IsLeaf() || A.Height < 2)
+				return iA;
+
+			int32_t iB = A.Child1;
+			int32_t iC = A.Child2;
+			Node& B = m_Nodes[iB];
+			Node& C = m_Nodes[iC];
+
+			int32_t balance = C.Height - B.Height;
+
+			if (balance > 1) {
+				int32_t iF = C.Child1;
+				int32_t iG = C.Child2;
+				Node& F = m_Nodes[iF];
+				Node& G = m_Nodes[iG];
+
+				C.Child1 = iA;
+				C.Parent = A.Parent;
+				A.Parent = iC;
+
+				if (C.Parent != NullNode) {
+					if (m_Nodes[C.Parent].Child1 == iA)
+						m_Nodes[C.Parent].Child1 = iC;
+					else
+						m_Nodes[C.Parent].Child2 = iC;
+				}
+				else
+					m_Root = iC;
+
+				if (F.Height > G.Height) {
+					C.Child2 = iF;
+					A.Child2 = iG;
+					G.Parent = iA;
+					A.Box = Combine(B.Box, G.Box);
+					C.Box = Combine(A.Box, F.Box);
+					A.Height = 1 + std::max(B.Height, G.Height);
+					C.Height = 1 + std::max(A.Height, F.Height);
+				}
+				else {
+					C.Child2 = iG;
+					A.Child2 = iF;
+					F.Parent = iA;
+					A.Box = Combine(B.Box, F.Box);
+					C.Box = Combine(A.Box, G.Box);
+					A.Height = 1 + std::max(B.Height, F.Height);
+					C.Height = 1 + std::max(A.Height, G.Height);
+				}
+
+				return iC;
+			}
+
+			if (balance < -1) {
+				int32_t iD = B.Child1;
+				int32_t iE = B.Child2;
+				Node& D = m_Nodes[iD];
+				Node& E = m_Nodes[iE];
+
+				B.Child1 = iA;
+				B.Parent = A.Parent;
+				A.Parent = iB;
+
+				if (B.Parent != NullNode) {
+					if (m_Nodes[B.Parent].Child1 == iA)
+						m_Nodes[B.Parent].Child1 = iB;
+					else
+						m_Nodes[B.Parent].Child2 = iB;
+				}
+				else
+					m_Root = iB;
+
+				if (D.Height > E.Height) {
+					B.Child2 = iD;
+					A.Child1 = iE;
+					E.Parent = iA;
+					A.Box = Combine(C.Box, E.Box);
+					B.Box = Combine(A.Box, D.Box);
+					A.Height = 1 + std::max(C.Height, E.Height);
+					B.Height = 1 + std::max(A.Height, D.Height);
+				}
+				else {
+					B.Child2 = iE;
+					A.Child1 = iD;
+					D.Parent = iA;
+					A.Box = Combine(C.Box, D.Box);
+					B.Box = Combine(A.Box, E.Box);
+					A.Height = 1 + std::max(C.Height, D.Height);
+					B.Height = 1 + std::max(A.Height, E.Height);
+				}
+
+				return iB;
+			}
+
+			return iA;
+		}
+	}
+}
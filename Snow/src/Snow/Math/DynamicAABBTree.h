@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Snow/Math/AABB.h"
+#include "Snow/Math/Frustum.h"
+#include "Snow/Math/Ray.h"
+
+#include <vector>
+
+namespace Snow {
+	namespace Core {
+		// Bounding volume hierarchy over fattened boxes. Proxies are only reinserted once they leave their fat box,
+		// so small movements are free and the tree stays height balanced through rotations.
+		class DynamicAABBTree {
+		public:
+			static constexpr int32_t NullNode = -1;
+
+			DynamicAABBTree(float margin = 0.1f);
+
+			int32_t CreateProxy(const AABB& box, uint64_t userData);
+			void DestroyProxy(int32_t proxy);
+			// Returns true if the proxy had to be reinserted
+			bool MoveProxy(int32_t proxy, const AABB& box);
+			void Clear();
+
+			uint64_t GetUserData(int32_t proxy) const { return m_Nodes[proxy].UserData; }
+			const AABB& GetFatAABB(int32_t proxy) const { return m_Nodes[proxy].Box; }
+			uint32_t GetProxyCount() const { return m_ProxyCount; }
+			int32_t GetHeight() const { return m_Root == NullNode ? 0 : m_Nodes[m_Root].Height; }
+
+			// The callbacks receive each overlapping proxy's user data and return false to stop the query
+			template<typename Callback>
+			void Query(const AABB& box, Callback&& callback) const {
+				Traverse([&box](const AABB& nodeBox) { return nodeBox.Intersects(box); }, callback);
+			}
+
+			template<typename Callback>
+			void Query(const Frustum& frustum, Callback&& callback) const {
+				Traverse([&frustum](const AABB& nodeBox) { return frustum.Intersects(nodeBox); }, callback);
+			}
+
+			// callback(userData, distance) for each fat box the ray enters before maxDistance, in no particular order
+			template<typename Callback>
+			void RayCast(const Ray& ray, float maxDistance, Callback&& callback) const {
+				float distance = 0.0f;
+				Traverse([&](const AABB& nodeBox) { return ray.Intersects(nodeBox, distance) && distance <= maxDistance; },
+					[&](uint64_t userData) { return callback(userData, distance); });
+			}
+		private:
+			struct Node {
+				AABB Box;
+				uint64_t UserData = 0;
+				int32_t Parent = NullNode; // Next free node while the node is unused
+				int32_t Child1 = NullNode, Child2 = NullNode;
+				int32_t Height = 0; // -1 while the node is unused
+
+				bool IsLeaf() const { return Child1 == NullNode; }
+			};
+
+			int32_t AllocateNode();
+			void FreeNode(int32_t node);
+
+			void InsertLeaf(int32_t leaf);
+			void RemoveLeaf(int32_t leaf);
+			int32_t Balance(int32_t node);
+
+			template<typename Overlaps, typename Callback>
+			void Traverse(Overlaps&& overlaps, Callback&& callback) const {
+				if (m_Root == NullNode)
+					return;
+
+				std::vector<int32_t> stack;
+				stack.reserve(64);
+				stack.push_back(m_Root);
+				while (!stack.empty()) {
+					const Node& node = m_Nodes[stack.back()];
+					stack.pop_back();
+
+					if (!overlaps(node.Box))
+						continue;
+
+					if (node.IsLeaf()) {
+						if (!callback(node.UserData))
+							return;
+					}
+					else {
+						stack.push_back(node.Child1);
+						stack.push_back(node.Child2);
+					}
+				}
+			}
+
+			std::vector<Node> m_Nodes;
+			int32_t m_Root = NullNode;
+			int32_t m_FreeList = NullNode;
+			uint32_t m_ProxyCount = 0;
+			float m_Margin;
+		};
+	}
+}
@@ -0,0 +1,83 @@
+#include <spch.h>
+#include "Snow/Math/Frustum.h"
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE__)
+	#define SNOW_FRUSTUM_SSE
+	#include <xmmintrin.h>
+#endif
+
+namespace Snow {
+	namespace Core {
+		Frustum::Frustum(const glm::mat4& viewProjection) {
+			glm::vec4 row0 = { viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0] };
+			glm::vec4 row1 = { viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1] };
+			glm::vec4 row2 = { viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2] };
+			glm::vec4 row3 = { viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3] };
+
+			m_Planes[0] = row3 + row0; // Left
+			m_Planes[1] = row3 - row0; // Right
+			m_Planes[2] = row3 + row1; // Bottom
+			m_Planes[3] = row3 - row1; // Top
+			m_Planes[4] = row3 + row2; // Near
+			m_Planes[5] = row3 - row2; // Far
+
+			for (auto& plane : m_Planes)
+				plane /= glm::length(glm::vec3(plane));
+		}
+
+		bool Frustum::Intersects(const AABB& box) const {
+			for (auto& plane : m_Planes) {
+				// Corner furthest along the plane normal
+				glm::vec3 corner = glm::mix(box.MinBounds, box.MaxBounds, glm::greaterThanEqual(glm::vec3(plane), glm::vec3(0.0f)));
+				if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f)
+					return false;
+			}
+			return true;
+		}
+
+		bool Frustum::Intersects(const BoundingSphere& sphere) const {
+			for (auto& plane : m_Planes) {
+				if (glm::dot(glm::vec3(plane), sphere.Center) + plane.w < -sphere.Radius)
+					return false;
+			}
+			return true;
+		}
+
+		void Frustum::CullSpheres(const float* x, const float* y, const float* z, const float* radius, uint32_t count, uint8_t* outVisible) const {
+			uint32_t i = 0;
+
+#ifdef SNOW_FRUSTUM_SSE
+			__m128 planeX[6], planeY[6], planeZ[6], planeW[6];
+			for (uint32_t p = 0; p < 6; p++) {
+				planeX[p] = _mm_set1_ps(m_Planes[p].x);
+				planeY[p] = _mm_set1_ps(m_Planes[p].y);
+				planeZ[p] = _mm_set1_ps(m_Planes[p].z);
+				planeW[p] = _mm_set1_ps(m_Planes[p].w);
+			}
+
+			const __m128 zero = _mm_setzero_ps();
+			for (; i + 4 <= count; i += 4) {
+				__m128 sx = _mm_loadu_ps(x + i);
+				__m128 sy = _mm_loadu_ps(y + i);
+				__m128 sz = _mm_loadu_ps(z + i);
+				__m128 negRadius = _mm_sub_ps(zero, _mm_loadu_ps(radius + i));
+
+				__m128 visible = _mm_cmpeq_ps(zero, zero);
+				for (uint32_t p = 0; p < 6; p++) {
+					__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[p], sx), _mm_mul_ps(planeY[p], sy)), _mm_add_ps(_mm_mul_ps(planeZ[p], sz), planeW[p]));
+					visible = _mm_and_ps(visible, _mm_cmpge_ps(distance, negRadius));
+				}
+
+				int mask = _mm_movemask_ps(visible);
+				outVisible[i + 0] = (mask >> 0) & 1;
+				outVisible[i + 1] = (mask >> 1) & 1;
+				outVisible[i + 2] = (mask >> 2) & 1;
+				outVisible[i + 3] = (mask >> 3) & 1;
+			}
+#endif
+
+			for (; i < count; i++)
+				outVisible[i] = Intersects(BoundingSphere({ x[i], y[i], z[i] }, radius[i])) ? 1 : 0;
+		}
+	}
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Snow/Math/AABB.h"
+#include "Snow/Math/BoundingSphere.h"
+
+#include <glm/glm.hpp>
+
+namespace Snow {
+	namespace Core {
+		class Frustum {
+		public:
+			Frustum() = default;
+			// Planes are extracted from the clip space bounds, normals point inwards
+			Frustum(const glm::mat4& viewProjection);
+
+			bool Intersects(const AABB& box) const;
+			bool Intersects(const BoundingSphere& sphere) const;
+
+			// Tests count spheres laid out as separate x, y, z and radius arrays, four at a time when SSE is available.
+			// outVisible[i] is 1 if sphere i touches the frustum and 0 otherwise
+			void CullSpheres(const float* x, const float* y, const float* z, const float* radius, uint32_t count, uint8_t* outVisible) const;
+
+			const glm::vec4& GetPlane(uint32_t index) const { return m_Planes[index]; }
+		private:
+			glm::vec4 m_Planes[6];
+		};
+	}
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Snow/Math/AABB.h"
+
 #include <glm/glm.hpp>
 
 namespace Snow {
@@ -9,9 +11,24 @@ namespace Snow {
 			glm::vec3 Direction;
 
 			Ray(glm::vec3 dir, glm::vec3 origin = glm::vec3(0.0f)) :
-				Direction(dir), Origin(origin) {}
+				Origin(origin), Direction(dir) {}
+
+			// Slab test, outDistance is where the ray enters the box in units of Direction, 0 if it starts inside
+			bool Intersects(const AABB& box, float& outDistance) const {
+				glm::vec3 inverse = 1.0f / Direction;
+				glm::vec3 t0 = (box.MinBounds - Origin) * inverse;
+				glm::vec3 t1 = (box.MaxBounds - Origin) * inverse;
+				glm::vec3 tMin = glm::min(t0, t1);
+				glm::vec3 tMax = glm::max(t0, t1);
 
+				float enter = glm::max(glm::max(tMin.x, tMin.y), glm::max(tMin.z, 0.0f));
+				float exit = glm::min(glm::min(tMax.x, tMax.y), tMax.z);
+				if (enter > exit)
+					return false;
 
+				outDistance = enter;
+				return true;
+			}
 		};
 	}
-}
\ No newline at end of file
+}
@@ -20,6 +20,14 @@ namespace Snow {
 		dxDevice->GetDeviceContext()->DrawIndexed(count, 0, 0);
 	}
 
+	void DirectX11RenderCommand::DrawIndexedInstanced(uint32_t count, uint32_t instanceCount, Render::PrimitiveType type, uint32_t baseInstance) {
+		auto dxContext = DirectX11RenderContext::Get();
+		auto dxDevice = dxContext->GetDevice();
+
+		dxDevice->GetDeviceContext()->IASetPrimitiveTopology(GetD3DTopology(type));
+		dxDevice->GetDeviceContext()->DrawIndexedInstanced(count, instanceCount, 0, 0, baseInstance);
+	}
+
 	void DirectX11RenderCommand::SwapBuffers() {
 		auto dxContext = DirectX11RenderContext::Get();
 		auto dxSwapChain = dxContext->GetSwapChain();
@@ -11,6 +11,7 @@ namespace Snow {
 		void Clear() override {}
 
 		void DrawIndexed(uint32_t count, Render::PrimitiveType type) override;
+		void DrawIndexedInstanced(uint32_t count, uint32_t instanceCount, Render::PrimitiveType type, uint32_t baseInstance) override;
 
 		void BeginCommandBuffer() override {}
 		void EndCommandBuffer() override {}
@@ -22,6 +22,14 @@ namespace Snow {
 		void Unlock() override;
 
 		void SetData(void* data, uint32_t size) override;
+		void CopyFrom(const Ref<Render::API::Texture2D>& source, uint32_t x, uint32_t y) override { SNOW_CORE_ERROR("Texture copies are not implemented for DirectX11"); }
+		// Placeholders are created from their file up front, see Texture2D::CreatePlaceholder
+		void SetImage(const Render::API::Image& image) override {}
+
+		// Always fully resident, nothing is streamed for DirectX11
+		uint32_t GetMipCount() const override { return 1; }
+		uint32_t GetResidentMip() const override { return 0; }
+		void EvictMips(uint32_t mip) override {}
 
 		uint32_t GetRendererID() const { return 0; }
 
@@ -0,0 +1,46 @@
+#include <spch.h>
+
+#include "Snow/Utils/MappedFile.h"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Snow {
+    namespace Utils {
+        // The mapping keeps the file referenced, so the descriptor is closed straight away and no handles are kept
+        MappedFile::MappedFile(const std::string& filepath) {
+            int file = open(filepath.c_str(), O_RDONLY);
+            if (file == -1) {
+                // Missing files are an expected answer for callers probing caches or optional sources
+                if (errno != ENOENT)
+                    SNOW_CORE_ERROR("Could not open file {0}", filepath);
+                return;
+            }
+
+            struct stat fileStat;
+            if (fstat(file, &fileStat) == -1 || fileStat.st_size == 0) {
+                close(file);
+                return;
+            }
+
+            void* data = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+            close(file);
+            if (data == MAP_FAILED) {
+                SNOW_CORE_ERROR("Could not map file {0}", filepath);
+                return;
+            }
+
+            madvise(data, (size_t)fileStat.st_size, MADV_SEQUENTIAL);
+            m_Data = (const uint8_t*)data;
+            m_Size = (uint64_t)fileStat.st_size;
+        }
+
+        MappedFile::~MappedFile() {
+            if (m_Data)
+                munmap((void*)m_Data, (size_t)m_Size);
+        }
+    }
+}
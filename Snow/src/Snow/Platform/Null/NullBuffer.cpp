@@ -0,0 +1,84 @@
+#include <spch.h>
+#include "Snow/Platform/Null/NullBuffer.h"
+
+#include "Snow/Platform/Null/NullRenderCommand.h"
+
+namespace Snow {
+    namespace Render {
+        NullVertexBuffer::NullVertexBuffer(void* data, uint32_t size) :
+            m_Size(size) {
+            if (data)
+                NullRenderCommand::AddUpload(size);
+        }
+
+        void NullVertexBuffer::Bind() const {
+            NullRenderCommand::AddStateChange();
+        }
+
+        void NullVertexBuffer::SetData(void* data, uint32_t size) {
+            m_Size = size;
+            NullRenderCommand::AddUpload(size);
+        }
+
+        NullStreamingVertexBuffer::NullStreamingVertexBuffer(uint32_t frameSize, uint32_t frameCount) :
+            m_FrameSize(frameSize), m_FrameCount(frameCount) {
+            m_Storage.resize((size_t)m_FrameSize * m_FrameCount);
+        }
+
+        void NullStreamingVertexBuffer::Bind() const {
+            NullRenderCommand::AddStateChange();
+        }
+
+        void* NullStreamingVertexBuffer::Map(uint32_t stride, uint32_t& maxElements) {
+            uint32_t regionStart = m_FrameIndex * m_FrameSize;
+            uint32_t regionEnd = regionStart + m_FrameSize;
+            uint32_t offset = (regionStart + m_Head + stride - 1) / stride * stride;
+
+            m_MapOffset = offset;
+            m_MapStride = stride;
+            maxElements = offset < regionEnd ? (regionEnd - offset) / stride : 0;
+            return m_Storage.data() + offset;
+        }
+
+        uint32_t NullStreamingVertexBuffer::Commit(uint32_t count) {
+            NullRenderCommand::AddUpload((uint64_t)count * m_MapStride);
+            m_Head = m_MapOffset + count * m_MapStride - m_FrameIndex * m_FrameSize;
+            return m_MapOffset / m_MapStride;
+        }
+
+        void NullStreamingVertexBuffer::NextFrame() {
+            m_FrameIndex = (m_FrameIndex + 1) % m_FrameCount;
+            m_Head = 0;
+        }
+
+        void NullStreamingVertexBuffer::Resize(uint32_t frameSize) {
+            m_FrameSize = frameSize;
+            m_Storage.assign((size_t)m_FrameSize * m_FrameCount, 0);
+            m_FrameIndex = 0;
+            m_Head = 0;
+        }
+
+        void NullUniformBuffer::Bind(uint32_t bindingPoint) const {
+            NullRenderCommand::AddStateChange();
+        }
+
+        void NullUniformBuffer::SetData(const void* data, uint32_t size) {
+            NullRenderCommand::AddUpload(size);
+        }
+
+        NullIndexBuffer::NullIndexBuffer(void* data, uint32_t size) :
+            m_Count(size / sizeof(uint32_t)) {
+            if (data)
+                NullRenderCommand::AddUpload(size);
+        }
+
+        void NullIndexBuffer::Bind() const {
+            NullRenderCommand::AddStateChange();
+        }
+
+        void NullIndexBuffer::SetData(void* data, uint32_t size) {
+            m_Count = size / sizeof(uint32_t);
+            NullRenderCommand::AddUpload(size);
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "Snow/Render/API/Buffer.h"
+
+namespace Snow {
+    namespace Render {
+        class NullVertexBuffer : public API::VertexBuffer {
+        public:
+            NullVertexBuffer(void* data, uint32_t size);
+
+            void Bind() const override;
+            void Unbind() const override {}
+
+            void SetData(void* data, uint32_t size) override;
+
+        private:
+            uint32_t m_Size;
+        };
+
+        class NullStreamingVertexBuffer : public API::StreamingVertexBuffer {
+        public:
+            NullStreamingVertexBuffer(uint32_t frameSize, uint32_t frameCount);
+
+            void Bind() const override;
+
+            void* Map(uint32_t stride, uint32_t& maxElements) override;
+            uint32_t Commit(uint32_t count) override;
+
+            void NextFrame() override;
+            void Resize(uint32_t frameSize) override;
+
+            uint32_t GetFrameSize() const override { return m_FrameSize; }
+
+        private:
+            std::vector<uint8_t> m_Storage;
+
+            uint32_t m_FrameSize;
+            uint32_t m_FrameCount;
+            uint32_t m_FrameIndex = 0;
+            uint32_t m_Head = 0;
+
+            uint32_t m_MapOffset = 0;
+            uint32_t m_MapStride = 0;
+        };
+
+        class NullUniformBuffer : public API::UniformBuffer {
+        public:
+            NullUniformBuffer(uint32_t size) {}
+
+            void Bind(uint32_t bindingPoint) const override;
+
+            void SetData(const void* data, uint32_t size) override;
+        };
+
+        class NullIndexBuffer : public API::IndexBuffer {
+        public:
+            NullIndexBuffer(void* data, uint32_t size);
+
+            void Bind() const override;
+            void Unbind() const override {}
+
+            void SetData(void* data, uint32_t size) override;
+
+            virtual uint32_t GetCount() const override { return m_Count; }
+
+        private:
+            uint32_t m_Count;
+        };
+    }
+}
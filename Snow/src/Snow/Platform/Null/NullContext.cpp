@@ -0,0 +1,17 @@
+#include <spch.h>
+#include "Snow/Platform/Null/NullContext.h"
+
+namespace Snow {
+    namespace Render {
+        NullContext::NullContext(const ContextSpecification& spec) {
+            m_Specification = spec;
+            SNOW_CORE_TRACE("=============================");
+            SNOW_CORE_INFO("Using Null Render API");
+            SNOW_CORE_INFO("    No GPU work will be submitted, draw calls and uploads are only counted");
+            SNOW_CORE_TRACE("=============================");
+
+            SwapChainSpecification swapchainSpec = {};
+            m_NullSwapChain = static_cast<NullSwapChain*>(SwapChain::Create(swapchainSpec));
+        }
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Snow/Render/RenderContext.h"
+
+#include "Snow/Platform/Null/NullSwapChain.h"
+
+namespace Snow {
+    namespace Render {
+        class NullContext : public Context {
+        public:
+            NullContext(const ContextSpecification& spec);
+
+            virtual const ContextSpecification& GetSpecification() const override { return m_Specification; }
+
+            NullSwapChain& GetSwapChain() { return *m_NullSwapChain; }
+        private:
+            ContextSpecification m_Specification;
+
+            NullSwapChain* m_NullSwapChain;
+        };
+    }
+}
@@ -0,0 +1,26 @@
+#include <spch.h>
+#include "Snow/Platform/Null/NullFramebuffer.h"
+
+#include "Snow/Platform/Null/NullRenderCommand.h"
+
+namespace Snow {
+	NullFramebuffer::NullFramebuffer(const Render::FramebufferSpecification& spec) :
+		m_Specification(spec) {}
+
+	void NullFramebuffer::Resize(uint32_t width, uint32_t height) {
+		m_Specification.Width = width;
+		m_Specification.Height = height;
+	}
+
+	void NullFramebuffer::Bind() const {
+		Render::NullRenderCommand::AddStateChange();
+	}
+
+	void NullFramebuffer::Unbind() const {
+		Render::NullRenderCommand::AddStateChange();
+	}
+
+	void NullFramebuffer::BindTexture(uint32_t attachmentIndex, uint32_t slot) const {
+		Render::NullRenderCommand::AddStateChange();
+	}
+}
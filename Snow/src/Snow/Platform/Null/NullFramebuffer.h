@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Snow/Render/API/Framebuffer.h"
+
+namespace Snow {
+	class NullFramebuffer : public Render::Framebuffer {
+	public:
+		NullFramebuffer(const Render::FramebufferSpecification& spec);
+		virtual ~NullFramebuffer() = default;
+
+		virtual void Resize(uint32_t width, uint32_t height) override;
+
+		virtual void Bind() const override;
+		virtual void Unbind() const override;
+
+		virtual void BindTexture(uint32_t attachmentIndex = 0, uint32_t slot = 0) const override;
+
+		virtual uint32_t GetWidth() const override { return m_Specification.Width; }
+		virtual uint32_t GetHeight() const override { return m_Specification.Height; }
+
+		virtual void* GetColorAttachmentTexture(int index) const override { return nullptr; }
+		virtual void* GetDepthAttachmentTexture() const override { return nullptr; }
+
+		virtual const Render::FramebufferSpecification& GetSpecification() const override { return m_Specification; }
+
+	private:
+		Render::FramebufferSpecification m_Specification;
+	};
+}
@@ -0,0 +1,40 @@
+#include <spch.h>
+#include "Snow/Platform/Null/NullImGuiLayer.h"
+
+#include <ImGuizmo.h>
+
+namespace Snow {
+    NullImGuiLayer::NullImGuiLayer() {
+        m_Name = "NullImGuiLayer";
+    }
+
+    void NullImGuiLayer::OnAttach() {
+        IMGUI_CHECKVERSION();
+        ImGui::CreateContext();
+        ImGuiIO& io = ImGui::GetIO();
+        io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
+        io.DisplaySize = ImVec2(1280.0f, 720.0f);
+        io.IniFilename = nullptr;
+
+        // The font atlas has to be built before the first NewFrame, there is just no texture to upload it to
+        unsigned char* pixels;
+        int width, height;
+        io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+        ImGui::StyleColorsClassic();
+    }
+
+    void NullImGuiLayer::OnDetach() {
+        ImGui::DestroyContext();
+    }
+
+    void NullImGuiLayer::BeginImGuiFrame() {
+        ImGui::NewFrame();
+
+        ImGuizmo::BeginFrame();
+    }
+
+    void NullImGuiLayer::EndImGuiFrame() {
+        ImGui::Render();
+    }
+}
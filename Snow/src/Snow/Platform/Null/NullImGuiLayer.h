@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Snow/ImGui/ImGuiLayer.h"
+
+#include <imgui.h>
+
+namespace Snow {
+    // Runs ImGui without a platform or renderer backend so editor layers still execute their UI code headless
+    class NullImGuiLayer : public ImGuiLayer {
+    public:
+        NullImGuiLayer();
+
+        void OnAttach() override;
+        void OnDetach() override;
+        void BeginImGuiFrame() override;
+        void EndImGuiFrame() override;
+    };
+}
@@ -0,0 +1,12 @@
+#include <spch.h>
+#include "Snow/Platform/Null/NullPipeline.h"
+
+#include "Snow/Platform/Null/NullRenderCommand.h"
+
+namespace Snow {
+    namespace Render {
+        void NullPipeline::Bind() const {
+            NullRenderCommand::AddStateChange();
+        }
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include "Snow/Render/Pipeline.h"
+
+namespace Snow {
+    namespace Render {
+        class NullPipeline : public Pipeline {
+        public:
+            NullPipeline(const PipelineSpecification& spec) :
+                m_Specification(spec) {}
+
+            void Bind() const override;
+
+            const PipelineSpecification& GetSpecification() const override { return m_Specification; }
+
+        private:
+            PipelineSpecification m_Specification;
+        };
+    }
+}
@@ -0,0 +1,60 @@
+#include <spch.h>
+
+#include "Snow/Platform/Null/NullRenderCommand.h"
+
+#include "Snow/Render/Renderer.h"
+
+#include "Snow/Platform/Null/NullContext.h"
+
+namespace Snow {
+    namespace Render {
+        NullRenderStats NullRenderCommand::s_Stats;
+        NullRenderStats NullRenderCommand::s_LastFrameStats;
+        uint64_t NullRenderCommand::s_FrameCount = 0;
+
+        void NullRenderCommand::Init() {
+            s_Stats = {};
+            s_LastFrameStats = {};
+            s_FrameCount = 0;
+        }
+
+        void NullRenderCommand::DrawIndexed(uint32_t count, PrimitiveType type) {
+            s_Stats.DrawCalls++;
+            s_Stats.IndexCount += count;
+        }
+
+        void NullRenderCommand::DrawIndexedInstanced(uint32_t count, uint32_t instanceCount, PrimitiveType type, uint32_t baseInstance) {
+            s_Stats.DrawCalls++;
+            s_Stats.IndexCount += (uint64_t)count * instanceCount;
+        }
+
+        void NullRenderCommand::SetClearColor(const glm::vec4& color) {
+            AddStateChange();
+        }
+
+        void NullRenderCommand::Clear() {
+
+        }
+
+        void NullRenderCommand::SetViewport(uint32_t width, uint32_t height) {
+            AddStateChange();
+        }
+
+        void NullRenderCommand::SetBlending(bool blend) {
+            AddStateChange();
+        }
+
+        void NullRenderCommand::SetDepthTesting(bool depthTest) {
+            AddStateChange();
+        }
+
+        void NullRenderCommand::SwapBuffers() {
+            NullContext* nullContext = static_cast<NullContext*>(Render::Renderer::GetContext());
+            nullContext->GetSwapChain().SwapBuffers();
+
+            s_LastFrameStats = s_Stats;
+            s_Stats = {};
+            s_FrameCount++;
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Snow/Render/RenderCommand.h"
+
+namespace Snow {
+    namespace Render {
+        struct NullRenderStats {
+            uint32_t DrawCalls = 0;
+            uint64_t IndexCount = 0;
+            uint64_t BytesUploaded = 0;
+            uint32_t StateChanges = 0;
+        };
+
+        class NullRenderCommand : public RenderAPI {
+        public:
+            virtual void Init() override;
+
+            void BeginCommandBuffer() override {}
+            void EndCommandBuffer() override {}
+
+            void SetClearColor(const glm::vec4& color) override;
+            void Clear() override;
+
+            void DrawIndexed(uint32_t count, PrimitiveType type) override;
+            void DrawIndexedInstanced(uint32_t count, uint32_t instanceCount, PrimitiveType type, uint32_t baseInstance) override;
+
+            void SetBlending(bool blend) override;
+            void SetDepthTesting(bool depthTest) override;
+
+            void SetViewport(uint32_t width, uint32_t height) override;
+
+            void SwapBuffers() override;
+
+            // Counters for the frame currently being recorded, bumped by every Null resource
+            static NullRenderStats& GetStats() { return s_Stats; }
+            // Counters of the last frame that was ended with SwapBuffers
+            static const NullRenderStats& GetLastFrameStats() { return s_LastFrameStats; }
+            static uint64_t GetFrameCount() { return s_FrameCount; }
+
+            static void AddStateChange() { s_Stats.StateChanges++; }
+            static void AddUpload(uint64_t size) { s_Stats.BytesUploaded += size; }
+        private:
+            static NullRenderStats s_Stats;
+            static NullRenderStats s_LastFrameStats;
+            static uint64_t s_FrameCount;
+        };
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Snow/Render/RenderPass.h"
+
+namespace Snow {
+	class NullRenderPass : public Render::RenderPass {
+	public:
+		NullRenderPass(const Render::RenderPassSpecification& spec) :
+			m_Specification(spec) {}
+
+		virtual void BeginPass() override {}
+		virtual void EndPass() override {}
+
+		virtual Render::RenderPassSpecification& GetSpecification() override { return m_Specification; }
+		virtual const Render::RenderPassSpecification& GetSpecification() const override { return m_Specification; }
+	private:
+		Render::RenderPassSpecification m_Specification;
+	};
+}
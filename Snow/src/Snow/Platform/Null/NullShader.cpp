@@ -0,0 +1,97 @@
+#include <spch.h>
+
+#include "Snow/Platform/Null/NullShader.h"
+
+#include "Snow/Platform/Null/NullRenderCommand.h"
+
+#include "Snow/Render/Shader/ShaderCompiler.h"
+
+#include <shaderc/shaderc.hpp>
+#include <spirv_cross.hpp>
+
+namespace Snow {
+    namespace Render {
+        NullShader::NullShader(const std::initializer_list<ShaderModule>& shaderModules) :
+            m_ShaderModules(shaderModules) {
+
+            for (auto [type, path] : m_ShaderModules) {
+                m_Paths.push_back(path);
+                size_t found = path.find_last_of("/\\");
+                m_Name = found != std::string::npos ? path.substr(found + 1) : path;
+                found = m_Name.find_first_of(".");
+                m_Name = found != std::string::npos ? m_Name.substr(0, found) : m_Name;
+            }
+
+            Reload();
+        }
+
+        void NullShader::Bind() const {
+            NullRenderCommand::AddStateChange();
+        }
+
+        void NullShader::Reload() {
+            m_ReloadCount++;
+            m_UniformBuffers.clear();
+            m_Resources.clear();
+            ShaderCompiler::LoadSources(m_ShaderModules, m_ShaderSources, m_ShaderTypes);
+
+            shaderc::Compiler compiler;
+            shaderc::CompileOptions options;
+            options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_2);
+
+            for (uint32_t i = 0; i < m_ShaderSources.size(); i++) {
+                shaderc::SpvCompilationResult module = compiler.CompileGlslToSpv(m_ShaderSources[i], ShaderCompiler::ShaderTypeToShaderC(m_ShaderTypes[i]), m_Name.c_str(), options);
+                if (module.GetCompilationStatus() != shaderc_compilation_status_success) {
+                    SNOW_CORE_ERROR(module.GetErrorMessage());
+                    continue;
+                }
+
+                Reflect(std::vector<uint32_t>(module.cbegin(), module.cend()), m_ShaderTypes[i]);
+            }
+        }
+
+        void NullShader::Reflect(const std::vector<uint32_t>& spirv, ShaderType type) {
+            spirv_cross::Compiler compiler(spirv);
+            spirv_cross::ShaderResources res = compiler.get_shader_resources();
+
+            for (const spirv_cross::Resource& resource : res.uniform_buffers) {
+                uint32_t bindingPoint = compiler.get_decoration(resource.id, spv::DecorationBinding);
+                if (m_UniformBuffers.find(bindingPoint) != m_UniformBuffers.end())
+                    continue;
+
+                ShaderUniformBuffer& buffer = m_UniformBuffers[bindingPoint];
+                ShaderCompiler::ReflectUniformBuffer(compiler, resource, type, buffer);
+                buffer.RendererID = 0;
+            }
+
+            for (const spirv_cross::Resource& resource : res.sampled_images)
+                m_Resources[resource.name] = ShaderCompiler::ReflectResource(compiler, resource, type);
+        }
+
+        const ShaderUniformBuffer& NullShader::GetUniformBuffer(const std::string& name) const {
+            for (auto& [bindingPoint, ub] : m_UniformBuffers) {
+                if (ub.Name == name)
+                    return ub;
+            }
+
+            static ShaderUniformBuffer s_EmptyBuffer = {};
+            return s_EmptyBuffer;
+        }
+
+        uint32_t NullShader::GetUniformBufferBinding(const std::string& name) const {
+            for (auto& [bindingPoint, ub] : m_UniformBuffers) {
+                if (ub.Name == name)
+                    return bindingPoint;
+            }
+            return InvalidBinding;
+        }
+
+        void NullShader::SetUniformBufferData(const std::string& uniformBufferName, void* data, uint32_t size) {
+            NullRenderCommand::AddUpload(size);
+        }
+
+        void NullShader::SetUniformBufferData(uint32_t bindingPoint, void* data, uint32_t size) {
+            NullRenderCommand::AddUpload(size);
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Snow/Render/Shader/Shader.h"
+#include "Snow/Render/Shader/ShaderUniform.h"
+
+#include <unordered_map>
+
+namespace Snow {
+    namespace Render {
+        // Shader that is never compiled for a GPU. The sources are still compiled to SPIR-V on
+        // the CPU so uniform buffers and resources reflect the same sizes as the real backends,
+        // which keeps material code paths and upload byte counts representative.
+        class NullShader : public Shader {
+        public:
+            NullShader(const std::initializer_list<ShaderModule>& shaderModules);
+
+            void Bind() const override;
+            void Reload() override;
+
+            virtual const ShaderUniformBuffer& GetUniformBuffer(const std::string& name) const override;
+            virtual uint32_t GetUniformBufferBinding(const std::string& name) const override;
+            virtual const std::unordered_map<std::string, ShaderResource>& GetResources() const override { return m_Resources; }
+
+            virtual void SetUniformBufferData(const std::string& uniformBufferName, void* data, uint32_t size) override;
+            virtual void SetUniformBufferData(uint32_t bindingPoint, void* data, uint32_t size) override;
+
+            const std::string& GetPath() const override { return m_Paths[0]; }
+            const std::string& GetName() const override { return m_Name; }
+
+        private:
+            void Reflect(const std::vector<uint32_t>& spirv, ShaderType type);
+
+            std::vector<ShaderModule> m_ShaderModules;
+            std::string m_Name;
+            std::vector<std::string> m_Paths;
+            std::vector<std::string> m_ShaderSources;
+            std::vector<ShaderType> m_ShaderTypes;
+
+            std::unordered_map<uint32_t, ShaderUniformBuffer> m_UniformBuffers;
+            std::unordered_map<std::string, ShaderResource> m_Resources;
+        };
+    }
+}
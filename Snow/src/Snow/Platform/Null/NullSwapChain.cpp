@@ -0,0 +1,11 @@
+#include <spch.h>
+#include "Snow/Platform/Null/NullSwapChain.h"
+
+namespace Snow {
+    namespace Render {
+        NullSwapChain::NullSwapChain(const SwapChainSpecification& spec) :
+            m_Specification(spec) {
+            SNOW_CORE_TRACE("Creating Null SwapChain");
+        }
+    }
+}
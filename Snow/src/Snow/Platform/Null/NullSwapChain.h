@@ -0,0 +1,15 @@
+#pragma once
+#include "Snow/Render/SwapChain.h"
+
+namespace Snow {
+    namespace Render {
+        class NullSwapChain : public SwapChain {
+        public:
+            NullSwapChain(const SwapChainSpecification& spec);
+
+            virtual void SwapBuffers() override {}
+        private:
+            SwapChainSpecification m_Specification;
+        };
+    }
+}
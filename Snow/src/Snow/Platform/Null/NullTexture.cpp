@@ -0,0 +1,135 @@
+#include <spch.h>
+#include "Snow/Platform/Null/NullTexture.h"
+
+#include "Snow/Platform/Null/NullRenderCommand.h"
+
+#include <stb_image.h>
+
+namespace Snow {
+    namespace Render {
+        NullTexture2D::NullTexture2D(API::TextureFormat format, uint32_t width, uint32_t height, API::TextureWrap wrap) :
+            m_Format(format), m_Width(width), m_Height(height) {
+            m_ImageData.Allocate(width * height * API::Texture::GetBPP(m_Format));
+        }
+
+        NullTexture2D::NullTexture2D(const std::string& path, bool srgb) :
+            m_Path(path) {
+            // Only the header is read, the image is never decoded since nothing gets uploaded
+            int width, height, channels;
+            if (!stbi_info(path.c_str(), &width, &height, &channels)) {
+                SNOW_CORE_ERROR("Could not read texture {0}", path);
+                return;
+            }
+
+            m_Format = channels == 4 ? API::TextureFormat::RGBA : API::TextureFormat::RGB;
+            m_Width = width;
+            m_Height = height;
+
+            NullRenderCommand::AddUpload((uint64_t)m_Width * m_Height * API::Texture::GetBPP(m_Format));
+        }
+
+        NullTexture2D::NullTexture2D(const std::string& path, const API::Image& image) :
+            m_Path(path) {
+            SetImage(image);
+        }
+
+        void NullTexture2D::SetImage(const API::Image& image) {
+            m_ImageVersion++;
+            m_Format = image.Format;
+            m_Width = std::max(image.Width >> image.FirstMip, 1u);
+            m_Height = std::max(image.Height >> image.FirstMip, 1u);
+            m_MipCount = image.MipCount;
+            m_ResidentMip = image.FirstMip;
+            NullRenderCommand::AddUpload(image.Pixels.size());
+        }
+
+        void NullTexture2D::EvictMips(uint32_t mip) {
+            if (mip <= m_ResidentMip || mip >= m_MipCount)
+                return;
+
+            m_Width = std::max(m_Width >> (mip - m_ResidentMip), 1u);
+            m_Height = std::max(m_Height >> (mip - m_ResidentMip), 1u);
+            m_ResidentMip = mip;
+        }
+
+        void NullTexture2D::Bind(uint32_t slot) const {
+            NullRenderCommand::AddStateChange();
+        }
+
+        void NullTexture2D::ResizeBuffer(uint32_t width, uint32_t height) {
+            SNOW_CORE_ASSERT(m_Locked, "Trying to write to texture without it being locked");
+            m_Width = width;
+            m_Height = height;
+            m_ImageData.Allocate(width * height * API::Texture::GetBPP(m_Format));
+            m_ImageData.ZeroInitialize();
+        }
+
+        Buffer NullTexture2D::GetWriteableBuffer() {
+            SNOW_CORE_ASSERT(m_Locked, "Texture is currently uploaded to gpu");
+            return m_ImageData;
+        }
+
+        void NullTexture2D::Unlock() {
+            NullRenderCommand::AddUpload(m_ImageData.Size);
+            m_Locked = false;
+        }
+
+        void NullTexture2D::SetData(void* data, uint32_t size) {
+            NullRenderCommand::AddUpload(size);
+        }
+
+        void NullTexture2D::CopyFrom(const Ref<API::Texture2D>& source, uint32_t x, uint32_t y) {
+            if (x + source->GetWidth() > m_Width || y + source->GetHeight() > m_Height) {
+                SNOW_CORE_ERROR("Texture copy does not fit into the destination texture");
+                return;
+            }
+            NullRenderCommand::AddUpload((uint64_t)source->GetWidth() * source->GetHeight() * API::Texture::GetBPP(m_Format));
+        }
+
+        NullTexture2DArray::NullTexture2DArray(API::TextureFormat format, uint32_t width, uint32_t height, uint32_t layers) :
+            m_Format(format), m_Width(width), m_Height(height), m_Layers(layers) {}
+
+        void NullTexture2DArray::Bind(uint32_t slot) const {
+            NullRenderCommand::AddStateChange();
+        }
+
+        void NullTexture2DArray::SetLayer(uint32_t layer, const Ref<API::Texture2D>& source, uint32_t x, uint32_t y, uint32_t extrude) {
+            if (layer >= m_Layers || x + source->GetWidth() > m_Width || y + source->GetHeight() > m_Height) {
+                SNOW_CORE_ERROR("Texture does not fit into texture array layer {0}", layer);
+                return;
+            }
+            NullRenderCommand::AddUpload((uint64_t)source->GetWidth() * source->GetHeight() * API::Texture::GetBPP(m_Format));
+        }
+
+        NullTextureCube::NullTextureCube(const std::string& path, bool srgb) :
+            m_Path(path) {
+            int width, height, channels;
+            if (!stbi_info(path.c_str(), &width, &height, &channels)) {
+                SNOW_CORE_ERROR("Could not read texture {0}", path);
+                return;
+            }
+
+            m_Format = channels == 4 ? API::TextureFormat::RGBA : API::TextureFormat::RGB;
+            m_Width = width;
+            m_Height = height;
+
+            NullRenderCommand::AddUpload((uint64_t)m_Width * m_Height * API::Texture::GetBPP(m_Format));
+        }
+
+        NullTextureCube::NullTextureCube(const std::string& path, const API::Image& image) :
+            m_Path(path) {
+            SetImage(image);
+        }
+
+        void NullTextureCube::SetImage(const API::Image& image) {
+            m_Format = image.Format;
+            m_Width = image.Width;
+            m_Height = image.Height;
+            NullRenderCommand::AddUpload(image.Pixels.size());
+        }
+
+        void NullTextureCube::Bind(uint32_t slot) const {
+            NullRenderCommand::AddStateChange();
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include "Snow/Render/API/Texture.h"
+
+#include "Snow/Core/Buffer.h"
+
+namespace Snow {
+    namespace Render {
+        class NullTexture2D : public API::Texture2D {
+        public:
+            NullTexture2D(API::TextureFormat format, uint32_t width, uint32_t height, API::TextureWrap wrap);
+            NullTexture2D(const std::string& path, bool srgb);
+            NullTexture2D(const std::string& path, const API::Image& image);
+
+            void SetImage(const API::Image& image) override;
+
+            void Bind(uint32_t slot) const override;
+            void ResizeBuffer(uint32_t width, uint32_t height) override;
+            Buffer GetWriteableBuffer() override;
+
+            void Lock() override { m_Locked = true; }
+            void Unlock() override;
+
+            void SetData(void* data, uint32_t size) override;
+            void CopyFrom(const Ref<API::Texture2D>& source, uint32_t x, uint32_t y) override;
+
+            API::TextureFormat GetFormat() const override { return m_Format; }
+            uint32_t GetWidth() const override { return m_Width; }
+            uint32_t GetHeight() const override { return m_Height; }
+
+            uint32_t GetMipCount() const override { return m_MipCount; }
+            uint32_t GetResidentMip() const override { return m_ResidentMip; }
+            void EvictMips(uint32_t mip) override;
+
+            const std::string& GetPath() const override { return m_Path; }
+
+            uint32_t GetRendererID() const override { return 0; }
+
+        private:
+            API::TextureFormat m_Format = API::TextureFormat::RGBA;
+            uint32_t m_Width = 0, m_Height = 0;
+            uint32_t m_MipCount = 1;
+            uint32_t m_ResidentMip = 0;
+
+            std::string m_Path;
+
+            Buffer m_ImageData;
+
+            bool m_Locked = false;
+        };
+
+        class NullTexture2DArray : public API::Texture2DArray {
+        public:
+            NullTexture2DArray(API::TextureFormat format, uint32_t width, uint32_t height, uint32_t layers);
+
+            void Bind(uint32_t slot) const override;
+
+            void SetLayer(uint32_t layer, const Ref<API::Texture2D>& source, uint32_t x, uint32_t y, uint32_t extrude = 0) override;
+            void Resize(uint32_t layers) override { m_Layers = layers; }
+
+            API::TextureFormat GetFormat() const override { return m_Format; }
+            uint32_t GetWidth() const override { return m_Width; }
+            uint32_t GetHeight() const override { return m_Height; }
+            uint32_t GetLayerCount() const override { return m_Layers; }
+
+        private:
+            API::TextureFormat m_Format;
+            uint32_t m_Width, m_Height;
+            uint32_t m_Layers;
+        };
+
+        class NullTextureCube : public API::TextureCube {
+        public:
+            NullTextureCube(const std::string& path, bool srgb);
+            NullTextureCube(const std::string& path, const API::Image& image);
+
+            void SetImage(const API::Image& image) override;
+
+            void Bind(uint32_t slot) const override;
+
+            API::TextureFormat GetFormat() const override { return m_Format; }
+            uint32_t GetWidth() const override { return m_Width; }
+            uint32_t GetHeight() const override { return m_Height; }
+
+            const std::string& GetPath() const { return m_Path; }
+        private:
+            API::TextureFormat m_Format = API::TextureFormat::RGBA;
+            uint32_t m_Width = 0, m_Height = 0;
+
+            std::string m_Path;
+        };
+    }
+}
@@ -1,42 +1,280 @@
 #include <spch.h>
 #include "Snow/Platform/OpenGL/OpenGLBuffer.h"
 
+#include "Snow/Render/Renderer.h"
+
+#include "Snow/Platform/OpenGL/OpenGLNamePool.h"
+#include "Snow/Platform/OpenGL/OpenGLStateCache.h"
+
 #include <glad/glad.h>
 
 namespace Snow {
     namespace Render {
-        OpenGLVertexBuffer::OpenGLVertexBuffer(void* data, uint32_t size) {
+        OpenGLVertexBuffer::OpenGLVertexBuffer(void* data, uint32_t size) :
+            m_Size(size) {
 
-            if (data)
-                m_LocalBuffer = Buffer::Copy(data, size);
-            else
-                m_LocalBuffer.Allocate(size);
+            m_RendererID = OpenGLNamePool::Create(OpenGLObjectType::Buffer);
+            const void* commandData = Renderer::CopyCommandData(data, size);
+            Renderer::Submit([rendererID = m_RendererID, commandData, size]() {
+                glNamedBufferData(rendererID, size, commandData, commandData ? GL_STATIC_DRAW : GL_DYNAMIC_DRAW);
+            });
+        }
 
-            glGenBuffers(1, &m_RendererID);
-            glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
-            glBufferData(GL_ARRAY_BUFFER, m_LocalBuffer.Size, (void*)(data ? m_LocalBuffer.Data : nullptr), GL_STATIC_DRAW);
+        OpenGLVertexBuffer::~OpenGLVertexBuffer() {
+            Renderer::Submit([rendererID = m_RendererID]() {
+                OpenGLStateCache::DeleteBuffers(1, &rendererID);
+            });
         }
 
         void OpenGLVertexBuffer::Bind() const {
-            glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+            Renderer::Submit([rendererID = m_RendererID]() {
+                OpenGLStateCache::BindBuffer(GL_ARRAY_BUFFER, rendererID);
+            });
         }
 
         void OpenGLVertexBuffer::Unbind() const {
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            Renderer::Submit([]() {
+                OpenGLStateCache::BindBuffer(GL_ARRAY_BUFFER, 0);
+            });
         }
 
         void OpenGLVertexBuffer::SetData(void* data, uint32_t size) {
-
-            if (m_Size != size)
+            // Only re-specify the store when it has to grow
+            bool grow = size > m_Size;
+            if (grow)
                 m_Size = size;
 
-            if (!m_LocalBuffer.Data)
-                m_LocalBuffer.Allocate(m_Size);
-            
-            m_LocalBuffer.Write(data, size, 0);
+            const void* commandData = Renderer::CopyCommandData(data, size);
+            Renderer::Submit([rendererID = m_RendererID, commandData, size, grow]() {
+                if (grow)
+                    glNamedBufferData(rendererID, size, commandData, GL_DYNAMIC_DRAW);
+                else
+                    glNamedBufferSubData(rendererID, 0, size, commandData);
+            });
+        }
+
+        // Render thread, fences the region written this frame and frees the region of a later frame once the GPU is done
+        // reading it. With a render thread the main thread records a frame ahead, so that is the region after the next
+        // one. WaitForRegion makes the main thread wait for it, this only decides how early it is freed.
+        static void AdvanceFrame(OpenGLFrameFences& frameFences, const char* bufferName) {
+            std::vector<GLsync>& fences = frameFences.Fences;
+            uint32_t count = (uint32_t)fences.size();
+            uint64_t frame = frameFences.Frame++;
+
+            uint32_t frameIndex = frame % count;
+            if (fences[frameIndex])
+                glDeleteSync(fences[frameIndex]);
+            fences[frameIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+            // The region of freedFrame was last used count frames before it
+            uint64_t freedFrame = frame + 1 + (RenderThread::IsRunning() ? 1 : 0);
+            uint32_t waitIndex = freedFrame % count;
+            GLsync fence = fences[waitIndex];
+            if (fence) {
+                GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+                while (result == GL_TIMEOUT_EXPIRED)
+                    result = glClientWaitSync(fence, 0, 1000000);
+                if (result == GL_WAIT_FAILED)
+                    SNOW_CORE_ERROR("Waiting on {0} fence failed", bufferName);
+
+                glDeleteSync(fence);
+                fences[waitIndex] = nullptr;
+            }
+
+            if (freedFrame + 1 > frameFences.WritableFrames.load(std::memory_order_relaxed))
+                frameFences.WritableFrames.store(freedFrame + 1, std::memory_order_release);
+        }
+
+        // Main thread, returns once the region of frame can be written. The render thread normally freed it while
+        // executing an earlier frame, otherwise the commands that free it have to run first.
+        static void WaitForRegion(const OpenGLFrameFences& frameFences, uint64_t frame) {
+            if (frame < frameFences.WritableFrames.load(std::memory_order_acquire))
+                return;
+
+            RenderThread::WaitForFrame();
+            if (frame < frameFences.WritableFrames.load(std::memory_order_acquire))
+                return;
+
+            RenderThread::Flush();
+            SNOW_CORE_ASSERT(frame < frameFences.WritableFrames.load(std::memory_order_acquire), "Frame region was not freed");
+        }
+
+        static void DeleteFrameFences(OpenGLFrameFences& frameFences) {
+            for (GLsync fence : frameFences.Fences) {
+                if (fence)
+                    glDeleteSync(fence);
+            }
+            frameFences.Fences.clear();
+        }
+
+        // Creates immutable storage for a persistently mapped buffer and returns the mapping. The main thread writes
+        // through it, so this waits for the render thread to create it.
+        static uint8_t* CreateMappedStorage(uint32_t rendererID, uint32_t size) {
+            uint8_t* mappedData = nullptr;
+            Renderer::Submit([rendererID, size, &mappedData]() {
+                constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+                glNamedBufferStorage(rendererID, size, nullptr, flags);
+                mappedData = (uint8_t*)glMapNamedBufferRange(rendererID, 0, size, flags);
+            });
+            RenderThread::Flush();
+            return mappedData;
+        }
+
+        static void DeleteMappedStorage(uint32_t rendererID, const std::shared_ptr<OpenGLFrameFences>& fences) {
+            Renderer::Submit([rendererID, fences]() {
+                DeleteFrameFences(*fences);
+
+                // Deletion is deferred by the driver until pending draws stop reading the buffer
+                glUnmapNamedBuffer(rendererID);
+                OpenGLStateCache::DeleteBuffers(1, &rendererID);
+            });
+        }
+
+        OpenGLStreamingVertexBuffer::OpenGLStreamingVertexBuffer(uint32_t frameSize, uint32_t frameCount) :
+            m_FrameSize(frameSize), m_FrameCount(frameCount) {
+            Allocate();
+        }
+
+        OpenGLStreamingVertexBuffer::~OpenGLStreamingVertexBuffer() {
+            Release();
+        }
+
+        void OpenGLStreamingVertexBuffer::Allocate() {
+            m_RendererID = OpenGLNamePool::Create(OpenGLObjectType::Buffer);
+            m_MappedData = CreateMappedStorage(m_RendererID, m_FrameSize * m_FrameCount);
+            if (!m_MappedData)
+                SNOW_CORE_ERROR("Failed to persistently map streaming vertex buffer");
+
+            m_Fences = std::make_shared<OpenGLFrameFences>();
+            m_Fences->Fences.assign(m_FrameCount, nullptr);
+            m_Fences->WritableFrames = m_FrameCount;
+            m_FrameIndex = 0;
+            m_Frame = 0;
+            m_Head = 0;
+        }
+
+        void OpenGLStreamingVertexBuffer::Release() {
+            DeleteMappedStorage(m_RendererID, m_Fences);
+            m_Fences = nullptr;
+            m_MappedData = nullptr;
+        }
+
+        void OpenGLStreamingVertexBuffer::Bind() const {
+            Renderer::Submit([rendererID = m_RendererID]() {
+                OpenGLStateCache::BindBuffer(GL_ARRAY_BUFFER, rendererID);
+            });
+        }
+
+        void* OpenGLStreamingVertexBuffer::Map(uint32_t stride, uint32_t& maxElements) {
+            uint32_t regionStart = m_FrameIndex * m_FrameSize;
+            uint32_t regionEnd = regionStart + m_FrameSize;
+
+            // Element offsets are passed as a base instance/vertex, so the start has to be a multiple of the stride
+            uint32_t offset = (regionStart + m_Head + stride - 1) / stride * stride;
+
+            m_MapOffset = offset;
+            m_MapStride = stride;
+            maxElements = offset < regionEnd ? (regionEnd - offset) / stride : 0;
+            return m_MappedData + offset;
+        }
+
+        uint32_t OpenGLStreamingVertexBuffer::Commit(uint32_t count) {
+            m_Head = m_MapOffset + count * m_MapStride - m_FrameIndex * m_FrameSize;
+            return m_MapOffset / m_MapStride;
+        }
+
+        void OpenGLStreamingVertexBuffer::NextFrame() {
+            Renderer::Submit([fences = m_Fences]() {
+                AdvanceFrame(*fences, "streaming vertex buffer");
+            });
+            m_FrameIndex = (m_FrameIndex + 1) % m_FrameCount;
+            m_Head = 0;
+            WaitForRegion(*m_Fences, ++m_Frame);
+        }
+
+        void OpenGLStreamingVertexBuffer::Resize(uint32_t frameSize) {
+            Release();
+            m_FrameSize = frameSize;
+            Allocate();
+        }
+
+        OpenGLUniformBufferRing::OpenGLUniformBufferRing(uint32_t frameSize, uint32_t frameCount) :
+            m_FrameSize(frameSize), m_FrameCount(frameCount) {
+            GLint alignment = 0, maxBlockSize = 0;
+            Renderer::Submit([&alignment, &maxBlockSize]() {
+                glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+                glGetIntegerv(GL_MAX_UNIFORM_BLOCK_SIZE, &maxBlockSize);
+            });
+            RenderThread::Flush();
+            m_Alignment = std::max(alignment, 1);
+            m_TailSize = (uint32_t)maxBlockSize;
+
+            m_RendererID = OpenGLNamePool::Create(OpenGLObjectType::Buffer);
+            m_MappedData = CreateMappedStorage(m_RendererID, m_FrameSize * m_FrameCount + m_TailSize);
+            if (!m_MappedData)
+                SNOW_CORE_ERROR("Failed to persistently map uniform buffer ring");
+
+            m_Fences = std::make_shared<OpenGLFrameFences>();
+            m_Fences->Fences.assign(m_FrameCount, nullptr);
+            m_Fences->WritableFrames = m_FrameCount;
+        }
 
-            glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
-            glBufferData(GL_ARRAY_BUFFER, size, (void*)data, GL_STATIC_DRAW);
+        OpenGLUniformBufferRing::~OpenGLUniformBufferRing() {
+            DeleteMappedStorage(m_RendererID, m_Fences);
+        }
+
+        bool OpenGLUniformBufferRing::Bind(uint32_t bindingPoint, const void* data, uint32_t size, uint32_t blockSize) {
+            uint32_t regionStart = m_FrameIndex * m_FrameSize;
+            uint32_t regionEnd = regionStart + m_FrameSize;
+            uint32_t offset = (regionStart + m_Head + m_Alignment - 1) / m_Alignment * m_Alignment;
+            if (!m_MappedData || offset + size > regionEnd || blockSize > m_TailSize)
+                return false;
+
+            // The range always covers the whole block so the shader never reads past what is bound. Slices only advance
+            // by what was written, an array block's unused tail overlaps the slices after it and is never read.
+            memcpy(m_MappedData + offset, data, size);
+            Renderer::Submit([rendererID = m_RendererID, bindingPoint, offset, range = std::max(blockSize, size)]() {
+                OpenGLStateCache::BindUniformBufferRange(bindingPoint, rendererID, offset, range);
+            });
+            m_Head = offset + size - regionStart;
+            return true;
+        }
+
+        void OpenGLUniformBufferRing::NextFrame() {
+            Renderer::Submit([fences = m_Fences]() {
+                AdvanceFrame(*fences, "uniform buffer ring");
+            });
+            m_FrameIndex = (m_FrameIndex + 1) % m_FrameCount;
+            m_Head = 0;
+            WaitForRegion(*m_Fences, ++m_Frame);
+        }
+
+        OpenGLUniformBuffer::OpenGLUniformBuffer(uint32_t size) :
+            m_Size(size) {
+            m_RendererID = OpenGLNamePool::Create(OpenGLObjectType::Buffer);
+            Renderer::Submit([rendererID = m_RendererID, size]() {
+                glNamedBufferData(rendererID, size, nullptr, GL_DYNAMIC_DRAW);
+            });
+        }
+
+        OpenGLUniformBuffer::~OpenGLUniformBuffer() {
+            Renderer::Submit([rendererID = m_RendererID]() {
+                OpenGLStateCache::DeleteBuffers(1, &rendererID);
+            });
+        }
+
+        void OpenGLUniformBuffer::Bind(uint32_t bindingPoint) const {
+            Renderer::Submit([rendererID = m_RendererID, bindingPoint]() {
+                OpenGLStateCache::BindUniformBuffer(bindingPoint, rendererID);
+            });
+        }
+
+        void OpenGLUniformBuffer::SetData(const void* data, uint32_t size) {
+            size = std::min(size, m_Size);
+            const void* commandData = Renderer::CopyCommandData(data, size);
+            Renderer::Submit([rendererID = m_RendererID, commandData, size]() {
+                glNamedBufferSubData(rendererID, 0, size, commandData);
+            });
         }
 
         OpenGLIndexBuffer::OpenGLIndexBuffer(void* data, uint32_t size) :
@@ -44,18 +282,30 @@ namespace Snow {
 
             m_LocalBuffer = Buffer::Copy(data, size);
 
-            glGenBuffers(1, &m_RendererID);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_LocalBuffer.Size, (void*)m_LocalBuffer.Data, GL_STATIC_DRAW);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+            // Uploaded without a bind, binding the element array buffer would change whichever vertex array is bound
+            m_RendererID = OpenGLNamePool::Create(OpenGLObjectType::Buffer);
+            const void* commandData = Renderer::CopyCommandData(m_LocalBuffer.Data, m_LocalBuffer.Size);
+            Renderer::Submit([rendererID = m_RendererID, commandData, size = m_LocalBuffer.Size]() {
+                glNamedBufferData(rendererID, size, commandData, GL_STATIC_DRAW);
+            });
+        }
+
+        OpenGLIndexBuffer::~OpenGLIndexBuffer() {
+            Renderer::Submit([rendererID = m_RendererID]() {
+                OpenGLStateCache::DeleteBuffers(1, &rendererID);
+            });
         }
 
         void OpenGLIndexBuffer::Bind() const {
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+            Renderer::Submit([rendererID = m_RendererID]() {
+                OpenGLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, rendererID);
+            });
         }
 
         void OpenGLIndexBuffer::Unbind() const {
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+            Renderer::Submit([]() {
+                OpenGLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+            });
         }
 
         void OpenGLIndexBuffer::SetData(void* data, uint32_t size) {
@@ -68,8 +318,10 @@ namespace Snow {
                     m_LocalBuffer.Write(data, size, 0);
                 }
 
-            glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
-            glBufferData(GL_ARRAY_BUFFER, size, (void*)data, GL_STATIC_DRAW);
+            const void* commandData = Renderer::CopyCommandData(data, size);
+            Renderer::Submit([rendererID = m_RendererID, commandData, size]() {
+                glNamedBufferData(rendererID, size, commandData, GL_STATIC_DRAW);
+            });
         }
     }
-}
\ No newline at end of file
+}
@@ -3,11 +3,27 @@
 
 #include "Snow/Core/Buffer.h"
 
+#include <glad/glad.h>
+
+#include <atomic>
+
 namespace Snow {
     namespace Render {
+        // Fences guarding the frame regions of a persistently mapped buffer. They are only touched on the render thread,
+        // which may still use them after the buffer object is gone, so the buffer shares them with its commands.
+        struct OpenGLFrameFences {
+            std::vector<GLsync> Fences;
+            // Frames fenced so far
+            uint64_t Frame = 0;
+            // Published by the render thread once the GPU is done with the older frames: the main thread may write the
+            // region of every frame before this one
+            std::atomic<uint64_t> WritableFrames{ 0 };
+        };
+
         class OpenGLVertexBuffer : public API::VertexBuffer {
         public:
             OpenGLVertexBuffer(void* data, uint32_t size);
+            ~OpenGLVertexBuffer();
 
             void Bind() const override;
             void Unbind() const override;
@@ -17,13 +33,94 @@ namespace Snow {
         private:
             uint32_t m_RendererID;
 
-            Buffer m_LocalBuffer;
+            uint32_t m_Size;
+        };
+
+        class OpenGLStreamingVertexBuffer : public API::StreamingVertexBuffer {
+        public:
+            OpenGLStreamingVertexBuffer(uint32_t frameSize, uint32_t frameCount);
+            ~OpenGLStreamingVertexBuffer();
+
+            void Bind() const override;
+
+            void* Map(uint32_t stride, uint32_t& maxElements) override;
+            uint32_t Commit(uint32_t count) override;
+
+            void NextFrame() override;
+            void Resize(uint32_t frameSize) override;
+
+            uint32_t GetFrameSize() const override { return m_FrameSize; }
+
+        private:
+            void Allocate();
+            void Release();
+
+            uint32_t m_RendererID = 0;
+            uint8_t* m_MappedData = nullptr;
+
+            uint32_t m_FrameSize;
+            uint32_t m_FrameCount;
+            uint32_t m_FrameIndex = 0;
+            uint64_t m_Frame = 0;
+            // Bytes used in the current frame region
+            uint32_t m_Head = 0;
+
+            uint32_t m_MapOffset = 0;
+            uint32_t m_MapStride = 0;
+
+            std::shared_ptr<OpenGLFrameFences> m_Fences;
+        };
+
+        // Per-frame ring for uniform buffer updates. Each update is written once into its own slice of a persistently
+        // mapped buffer and bound with glBindBufferRange, so no uniform buffer is rewritten while earlier draws still read it.
+        // Slices are written straight from the main thread, only the binds are recorded.
+        class OpenGLUniformBufferRing {
+        public:
+            OpenGLUniformBufferRing(uint32_t frameSize, uint32_t frameCount);
+            ~OpenGLUniformBufferRing();
+
+            // Copies size bytes into a new slice and binds blockSize bytes from its start to bindingPoint. Returns false
+            // once this frame's region is full.
+            bool Bind(uint32_t bindingPoint, const void* data, uint32_t size, uint32_t blockSize);
+
+            void NextFrame();
+
+        private:
+            uint32_t m_RendererID = 0;
+            uint8_t* m_MappedData = nullptr;
+
+            uint32_t m_FrameSize;
+            uint32_t m_FrameCount;
+            uint32_t m_FrameIndex = 0;
+            uint64_t m_Frame = 0;
+            uint32_t m_Head = 0;
+
+            uint32_t m_Alignment = 256;
+            // Room past the last region for the largest block, see Bind
+            uint32_t m_TailSize = 0;
+
+            std::shared_ptr<OpenGLFrameFences> m_Fences;
+        };
+
+        class OpenGLUniformBuffer : public API::UniformBuffer {
+        public:
+            OpenGLUniformBuffer(uint32_t size);
+            ~OpenGLUniformBuffer();
+
+            void Bind(uint32_t bindingPoint) const override;
+
+            void SetData(const void* data, uint32_t size) override;
+
+        private:
+            uint32_t m_RendererID = 0;
+
             uint32_t m_Size;
         };
 
         class OpenGLIndexBuffer : public API::IndexBuffer {
         public:
             OpenGLIndexBuffer(void* data, uint32_t size);
+            ~OpenGLIndexBuffer();
 
             void Bind() const override;
             void Unbind() const override;
@@ -37,9 +37,11 @@ namespace Snow {
 
             HGLRC RenderContext = wglCreateContextAttribsARB(dc, 0, attribList);
 
+            m_NativeContext = TempContext;
             if (RenderContext) {
                 wglMakeCurrent(NULL, NULL);
                 wglDeleteContext(TempContext);
+                m_NativeContext = RenderContext;
                 if (!wglMakeCurrent(dc, RenderContext)) {
                     SNOW_CORE_ERROR("Failed to make OpenGL context");
                 }
@@ -69,6 +71,8 @@ namespace Snow {
             GLXContext context = glXCreateContext(display, visualInfo, NULL, GL_TRUE);
             ::Window* window = (::Window*)m_Specification.WindowHandle;
             glXMakeCurrent(display, *window, context);
+            m_NativeContext = context;
+            m_NativeDisplay = display;
             SNOW_CORE_TRACE("BRUH1");
 #endif
 
@@ -83,5 +87,25 @@ namespace Snow {
             SwapChainSpecification swapchainSpec = {};
             m_OpenGLSwapChain = static_cast<OpenGLSwapChain*>(SwapChain::Create(swapchainSpec));
         }
+
+        void OpenGLContext::MakeCurrent() {
+#if defined(SNOW_WINDOW_WIN32)
+            wglMakeCurrent(GetDC((HWND)m_Specification.WindowHandle), (HGLRC)m_NativeContext);
+#elif defined(SNOW_WINDOW_GLFW)
+            glfwMakeContextCurrent((GLFWwindow*)m_Specification.WindowHandle);
+#elif defined(SNOW_WINDOW_XLIB)
+            glXMakeCurrent((Display*)m_NativeDisplay, *(::Window*)m_Specification.WindowHandle, (GLXContext)m_NativeContext);
+#endif
+        }
+
+        void OpenGLContext::ReleaseCurrent() {
+#if defined(SNOW_WINDOW_WIN32)
+            wglMakeCurrent(NULL, NULL);
+#elif defined(SNOW_WINDOW_GLFW)
+            glfwMakeContextCurrent(nullptr);
+#elif defined(SNOW_WINDOW_XLIB)
+            glXMakeCurrent((Display*)m_NativeDisplay, None, NULL);
+#endif
+        }
     }
-}
\ No newline at end of file
+}
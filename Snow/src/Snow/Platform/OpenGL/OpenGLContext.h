@@ -12,10 +12,17 @@ namespace Snow {
 
             virtual const ContextSpecification& GetSpecification() const override { return m_Specification; }
 
+            void MakeCurrent() override;
+            void ReleaseCurrent() override;
+
             OpenGLSwapChain& GetSwapChain() { return *m_OpenGLSwapChain; }
         private:
             ContextSpecification m_Specification;
 
+            // The platform's context and what it is made current with, unused by GLFW which keeps them with the window
+            void* m_NativeContext = nullptr;
+            void* m_NativeDisplay = nullptr;
+
             OpenGLSwapChain* m_OpenGLSwapChain;
         };
     }
@@ -1,6 +1,11 @@
 #include <spch.h>
 #include "Snow/Platform/OpenGL/OpenGLFramebuffer.h"
 
+#include "Snow/Render/Renderer.h"
+
+#include "Snow/Platform/OpenGL/OpenGLNamePool.h"
+#include "Snow/Platform/OpenGL/OpenGLStateCache.h"
+
 #include <glad/glad.h>
 
 namespace Snow {
@@ -10,11 +15,13 @@ namespace Snow {
 		}
 
 		static void CreateTextures(bool multisampled, uint32_t* outID, uint32_t count) {
-			glCreateTextures(TextureTarget(multisampled), count, outID);
+			Render::OpenGLObjectType type = multisampled ? Render::OpenGLObjectType::Texture2DMultisample : Render::OpenGLObjectType::Texture2D;
+			for (uint32_t i = 0; i < count; i++)
+				outID[i] = Render::OpenGLNamePool::Create(type);
 		}
 
 		static void BindTexture(bool multisampled, uint32_t id) {
-			glBindTexture(TextureTarget(multisampled), id);
+			Render::OpenGLStateCache::BindTexture(TextureTarget(multisampled), id);
 		}
 
 		static GLenum DataType(GLenum format) {
@@ -64,6 +71,16 @@ namespace Snow {
 			glFramebufferTexture2D(GL_FRAMEBUFFER, attachmentType, TextureTarget(multisampled), id, 0);
 		}
 
+		static GLenum ColorFormat(Render::FramebufferTextureFormat format) {
+			switch (format) {
+			case Render::FramebufferTextureFormat::RGBA8:	return GL_RGBA8;
+			case Render::FramebufferTextureFormat::RGBA16F:	return GL_RGBA16F;
+			case Render::FramebufferTextureFormat::RGBA32F:	return GL_RGBA32F;
+			case Render::FramebufferTextureFormat::RG32F:	return GL_RG32F;
+			}
+			return 0;
+		}
+
 		static bool IsDepthFormat(Render::FramebufferTextureFormat format) {
 			switch (format) {
 			case Render::FramebufferTextureFormat::Depth24Stencil8:
@@ -89,7 +106,11 @@ namespace Snow {
 	}
 
 	OpenGLFramebuffer::~OpenGLFramebuffer() {
-		glDeleteFramebuffers(1, &m_RendererID);
+		Render::Renderer::Submit([rendererID = m_RendererID, colorAttachments = m_ColorAttachments, depthAttachment = m_DepthAttachment]() {
+			Render::OpenGLStateCache::DeleteFramebuffers(1, &rendererID);
+			Render::OpenGLStateCache::DeleteTextures(colorAttachments.size(), colorAttachments.data());
+			Render::OpenGLStateCache::DeleteTextures(1, &depthAttachment);
+		});
 	}
 
 	void OpenGLFramebuffer::Resize(uint32_t width, uint32_t height) {
@@ -97,82 +118,88 @@ namespace Snow {
 		m_Height = height;
 
 		if (m_RendererID) {
-			glDeleteFramebuffers(1, &m_RendererID);
-			glDeleteTextures(m_ColorAttachments.size(), m_ColorAttachments.data());
-			glDeleteTextures(1, &m_DepthAttachment);
+			Render::Renderer::Submit([rendererID = m_RendererID, colorAttachments = m_ColorAttachments, depthAttachment = m_DepthAttachment]() {
+				Render::OpenGLStateCache::DeleteFramebuffers(1, &rendererID);
+				Render::OpenGLStateCache::DeleteTextures(colorAttachments.size(), colorAttachments.data());
+				Render::OpenGLStateCache::DeleteTextures(1, &depthAttachment);
+			});
 
 			m_ColorAttachments.clear();
 			m_DepthAttachment = 0;
 		}
 
-		glGenFramebuffers(1, &m_RendererID);
-		glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
+		// Names are taken here so GetColorAttachmentTexture is valid right away, the attachments are created with the
+		// recorded commands below
+		m_RendererID = Render::OpenGLNamePool::Create(Render::OpenGLObjectType::Framebuffer);
 
 		bool multisample = m_Specification.Samples > 1;
 
+		std::vector<GLenum> colorFormats;
 		if (m_ColorAttachmentSpecifications.size()) {
 			m_ColorAttachments.resize(m_ColorAttachmentSpecifications.size());
 			Utils::CreateTextures(multisample, m_ColorAttachments.data(), m_ColorAttachments.size());
 
-			for (int i = 0; i < m_ColorAttachments.size(); i++) {
-				Utils::BindTexture(multisample, m_ColorAttachments[i]);
-				switch (m_ColorAttachmentSpecifications[i].TextureFormat) {
-				case Render::FramebufferTextureFormat::RGBA8:
-					Utils::AttachColorTexture(m_ColorAttachments[i], m_Specification.Samples, GL_RGBA8, m_Width, m_Height, i);
-					break;
-				case Render::FramebufferTextureFormat::RGBA16F:
-					Utils::AttachColorTexture(m_ColorAttachments[i], m_Specification.Samples, GL_RGBA16F, m_Width, m_Height, i);
-					break;
-				case Render::FramebufferTextureFormat::RGBA32F:
-					Utils::AttachColorTexture(m_ColorAttachments[i], m_Specification.Samples, GL_RGBA32F, m_Width, m_Height, i);
-					break;
-				case Render::FramebufferTextureFormat::RG32F:
-					Utils::AttachColorTexture(m_ColorAttachments[i], m_Specification.Samples, GL_RG32F, m_Width, m_Height, i);
-					break;
-				}
-			}
+			for (auto& spec : m_ColorAttachmentSpecifications)
+				colorFormats.push_back(Utils::ColorFormat(spec.TextureFormat));
 		}
 
+		GLenum depthFormat = 0, depthAttachmentType = 0;
 		if (m_DepthAttachmentSpecification.TextureFormat != Render::FramebufferTextureFormat::None) {
 			Utils::CreateTextures(multisample, &m_DepthAttachment, 1);
-			Utils::BindTexture(multisample, m_DepthAttachment);
 			switch (m_DepthAttachmentSpecification.TextureFormat) {
 			case Render::FramebufferTextureFormat::Depth24Stencil8:
-				Utils::AttachDepthTexture(m_DepthAttachment, m_Specification.Samples, GL_DEPTH24_STENCIL8, GL_DEPTH_STENCIL_ATTACHMENT, m_Width, m_Height);
+				depthFormat = GL_DEPTH24_STENCIL8;
+				depthAttachmentType = GL_DEPTH_STENCIL_ATTACHMENT;
 				break;
 			case Render::FramebufferTextureFormat::Depth32F:
-				Utils::AttachDepthTexture(m_DepthAttachment, m_Specification.Samples, GL_DEPTH_COMPONENT32F, GL_DEPTH_ATTACHMENT, m_Width, m_Height);
+				depthFormat = GL_DEPTH_COMPONENT32F;
+				depthAttachmentType = GL_DEPTH_ATTACHMENT;
 				break;
 			}
 		}
 
-		if (m_ColorAttachments.size() > 1) {
-			GLenum buffers[4] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3 };
-			glDrawBuffers(m_ColorAttachments.size(), buffers);
-		}
-		else if (m_ColorAttachments.size() == 0) {
-			glDrawBuffer(GL_NONE);
-		}
+		Render::Renderer::Submit([rendererID = m_RendererID, colorAttachments = m_ColorAttachments, colorFormats = std::move(colorFormats),
+			depthAttachment = m_DepthAttachment, depthFormat, depthAttachmentType, samples = m_Specification.Samples, multisample, width, height]() {
+			Render::OpenGLStateCache::BindFramebuffer(rendererID);
 
-		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-			SNOW_CORE_ERROR("Framebuffer is incomplete");
+			for (int i = 0; i < colorAttachments.size(); i++) {
+				Utils::BindTexture(multisample, colorAttachments[i]);
+				if (colorFormats[i])
+					Utils::AttachColorTexture(colorAttachments[i], samples, colorFormats[i], width, height, i);
+			}
+
+			if (depthAttachment) {
+				Utils::BindTexture(multisample, depthAttachment);
+				if (depthFormat)
+					Utils::AttachDepthTexture(depthAttachment, samples, depthFormat, depthAttachmentType, width, height);
+			}
 
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			if (colorAttachments.size() > 1) {
+				GLenum buffers[4] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3 };
+				glDrawBuffers(colorAttachments.size(), buffers);
+			}
+			else if (colorAttachments.size() == 0) {
+				glDrawBuffer(GL_NONE);
+			}
+
+			if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+				SNOW_CORE_ERROR("Framebuffer is incomplete");
+
+			Render::OpenGLStateCache::BindFramebuffer(0);
+		});
 	}
 
 	void OpenGLFramebuffer::Bind() const {
-		if (m_Specification.SwapChainTarget) {
-			glBindFramebuffer(GL_FRAMEBUFFER, 0);
-			glViewport(0, 0, m_Width, m_Height);
-		}
-		else {
-			glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
-			glViewport(0, 0, m_Width, m_Height);
-		}
+		Render::Renderer::Submit([rendererID = m_Specification.SwapChainTarget ? 0 : m_RendererID, width = m_Width, height = m_Height]() {
+			Render::OpenGLStateCache::BindFramebuffer(rendererID);
+			Render::OpenGLStateCache::SetViewport(0, 0, width, height);
+		});
 	}
 
 	void OpenGLFramebuffer::Unbind() const {
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		Render::Renderer::Submit([]() {
+			Render::OpenGLStateCache::BindFramebuffer(0);
+		});
 	}
 
 	void OpenGLFramebuffer::BindTexture(uint32_t attachmentTexture, uint32_t slot) const {
@@ -182,8 +209,9 @@ namespace Snow {
 		else
 			rendererID = m_ColorAttachments[attachmentTexture];
 
-		glActiveTexture(GL_TEXTURE0 + slot);
-		glBindTexture(Utils::TextureTarget(m_Specification.Samples > 1), rendererID);
+		Render::Renderer::Submit([rendererID, slot, target = Utils::TextureTarget(m_Specification.Samples > 1)]() {
+			Render::OpenGLStateCache::BindTexture(slot, target, rendererID);
+		});
 	}
 
 
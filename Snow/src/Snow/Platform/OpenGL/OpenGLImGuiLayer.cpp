@@ -2,6 +2,7 @@
 #include "Snow/Platform/OpenGL/OpenGLImGuiLayer.h"
 
 #include "Snow/Core/Application.h"
+#include "Snow/Render/Renderer.h"
 
 
 #include <examples/imgui_impl_opengl3.cpp>
@@ -10,6 +11,22 @@
 #include <ImGuizmo.h>
 
 namespace Snow {
+    // The draw lists are rebuilt next frame while the render thread may still be drawing these, so it gets a copy
+    static ImDrawData* CloneDrawData(const ImDrawData* drawData) {
+        ImDrawData* copy = IM_NEW(ImDrawData)(*drawData);
+        copy->CmdLists = drawData->CmdListsCount ? new ImDrawList*[drawData->CmdListsCount] : nullptr;
+        for (int i = 0; i < drawData->CmdListsCount; i++)
+            copy->CmdLists[i] = drawData->CmdLists[i]->CloneOutput();
+        return copy;
+    }
+
+    static void DeleteDrawData(ImDrawData* drawData) {
+        for (int i = 0; i < drawData->CmdListsCount; i++)
+            IM_DELETE(drawData->CmdLists[i]);
+        delete[] drawData->CmdLists;
+        IM_DELETE(drawData);
+    }
+
     OpenGLImGuiLayer::OpenGLImGuiLayer() {
         m_Name = "OpenGLImGuiLayer";
     }
@@ -20,7 +37,9 @@ namespace Snow {
         ImGuiIO& io = ImGui::GetIO();
         io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
         io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
-        io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
+        // Platform windows render from the main thread with their own contexts, not while a render thread owns the context
+        if (!Render::RenderThread::IsRunning())
+            io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
         ImGui::StyleColorsClassic();
         ImGuiStyle& style = ImGui::GetStyle();
         if(io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable) {
@@ -34,7 +53,12 @@ namespace Snow {
 #elif defined(SNOW_WINDOW_GLFW)
         ImGui_ImplGlfw_InitForOpenGL((GLFWwindow*)window->GetWindowHandle(), true);
 #endif
-        ImGui_ImplOpenGL3_Init("#version 430");
+        Render::Renderer::Submit([]() {
+            ImGui_ImplOpenGL3_Init("#version 430");
+            // Font texture and shaders are made here, NewFrame only creates them while they are missing
+            ImGui_ImplOpenGL3_CreateDeviceObjects();
+        });
+        Render::RenderThread::Flush();
     }
 
     void OpenGLImGuiLayer::OnDetach() {
@@ -44,7 +68,10 @@ namespace Snow {
         ImGui_ImplGlfw_Shutdown();
 #endif
 
-        ImGui_ImplOpenGL3_Shutdown();
+        Render::Renderer::Submit([]() {
+            ImGui_ImplOpenGL3_Shutdown();
+        });
+        Render::RenderThread::Flush();
         ImGui::DestroyContext();
     }
 
@@ -67,7 +94,14 @@ namespace Snow {
         io.DisplaySize = ImVec2(window->GetWidth(), window->GetHeight());
 
         ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        if (Render::RenderThread::IsRecording()) {
+            Render::Renderer::Submit([drawData = CloneDrawData(ImGui::GetDrawData())]() {
+                ImGui_ImplOpenGL3_RenderDrawData(drawData);
+                DeleteDrawData(drawData);
+            });
+        }
+        else
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
         if(io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable) {
 #if defined(SNOW_WINDOW_GLFW)
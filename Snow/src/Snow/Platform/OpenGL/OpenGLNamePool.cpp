@@ -0,0 +1,79 @@
+#include <spch.h>
+#include "Snow/Platform/OpenGL/OpenGLNamePool.h"
+
+#include "Snow/Render/Renderer.h"
+
+#include <glad/glad.h>
+
+#include <mutex>
+
+namespace Snow {
+    namespace Render {
+        struct OpenGLNamePoolData {
+            std::mutex Mutex;
+            std::array<std::vector<uint32_t>, (size_t)OpenGLObjectType::Count> Names;
+        };
+        static OpenGLNamePoolData s_Data;
+
+        static void CreateObjects(OpenGLObjectType type, uint32_t count, uint32_t* outNames) {
+            switch (type) {
+            case OpenGLObjectType::Buffer:   glCreateBuffers(count, outNames); break;
+            case OpenGLObjectType::Texture2D:   glCreateTextures(GL_TEXTURE_2D, count, outNames); break;
+            case OpenGLObjectType::Texture2DArray:   glCreateTextures(GL_TEXTURE_2D_ARRAY, count, outNames); break;
+            case OpenGLObjectType::TextureCube:   glCreateTextures(GL_TEXTURE_CUBE_MAP, count, outNames); break;
+            case OpenGLObjectType::Texture2DMultisample:   glCreateTextures(GL_TEXTURE_2D_MULTISAMPLE, count, outNames); break;
+            case OpenGLObjectType::Framebuffer:   glCreateFramebuffers(count, outNames); break;
+            case OpenGLObjectType::VertexArray:   glCreateVertexArrays(count, outNames); break;
+            case OpenGLObjectType::Program: {
+                for (uint32_t i = 0; i < count; i++)
+                    outNames[i] = glCreateProgram();
+                break;
+            }
+            }
+        }
+
+        uint32_t OpenGLNamePool::Create(OpenGLObjectType type) {
+            if (!RenderThread::IsRecording()) {
+                uint32_t name = 0;
+                CreateObjects(type, 1, &name);
+                return name;
+            }
+
+            std::unique_lock<std::mutex> lock(s_Data.Mutex);
+            std::vector<uint32_t>& names = s_Data.Names[(size_t)type];
+            if (names.empty()) {
+                // More objects were created this frame than the pool holds, run what was recorded and refill right away
+                lock.unlock();
+                Renderer::Submit([]() { Refill(); });
+                RenderThread::Flush();
+                lock.lock();
+            }
+
+            uint32_t name = names.back();
+            names.pop_back();
+            return name;
+        }
+
+        void OpenGLNamePool::Refill() {
+            // Only recording takes names from the pools
+            if (!RenderThread::IsRenderThread())
+                return;
+
+            for (size_t type = 0; type < (size_t)OpenGLObjectType::Count; type++) {
+                uint32_t count;
+                {
+                    std::lock_guard<std::mutex> lock(s_Data.Mutex);
+                    count = PoolSize - std::min((uint32_t)s_Data.Names[type].size(), PoolSize);
+                }
+                if (!count)
+                    continue;
+
+                std::array<uint32_t, PoolSize> created;
+                CreateObjects((OpenGLObjectType)type, count, created.data());
+
+                std::lock_guard<std::mutex> lock(s_Data.Mutex);
+                s_Data.Names[type].insert(s_Data.Names[type].end(), created.begin(), created.begin() + count);
+            }
+        }
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace Snow {
+    namespace Render {
+        enum class OpenGLObjectType {
+            Buffer = 0, Texture2D, Texture2DArray, TextureCube, Texture2DMultisample, Framebuffer, VertexArray, Program,
+            Count
+        };
+
+        // Objects created ahead of time on the render thread, so the main thread can name the objects it records
+        // commands for straight away. Every object is created with its glCreate* function, the same as a direct call
+        // would. Without a render thread, or on it, objects are created in place.
+        class OpenGLNamePool {
+        public:
+            static uint32_t Create(OpenGLObjectType type);
+
+            // Render thread, tops every pool back up to PoolSize
+            static void Refill();
+
+            static constexpr uint32_t PoolSize = 64;
+        };
+    }
+}
@@ -1,7 +1,11 @@
 #include <spch.h>
 #include "Snow/Platform/OpenGL/OpenGLPipeline.h"
 
+#include "Snow/Render/Renderer.h"
+
+#include "Snow/Platform/OpenGL/OpenGLNamePool.h"
 #include "Snow/Platform/OpenGL/OpenGLShader.h"
+#include "Snow/Platform/OpenGL/OpenGLStateCache.h"
 
 #include <glad/glad.h>
 
@@ -10,15 +14,6 @@
 namespace Snow {
     namespace Render {
 
-        OpenGLPipeline::OpenGLPipeline(const PipelineSpecification& spec) :
-            m_Specification(spec) {
-
-            glGenVertexArrays(1, &m_PipelineVertexArrayHandle);
-            glBindVertexArray(m_PipelineVertexArrayHandle);
-
-            
-        }
-
         static GLenum ShaderDataTypeToOpenGLBaseType(AttribType type) {
             switch (type) {
             case AttribType::Float: return GL_FLOAT;
@@ -31,35 +26,65 @@ namespace Snow {
             case AttribType::Int2:  return GL_INT;
             case AttribType::Int3:  return GL_INT;
             case AttribType::Int4:  return GL_INT;
+            case AttribType::UInt:  return GL_UNSIGNED_INT;
             case AttribType::Bool: return GL_BOOL;
+            case AttribType::Half2: return GL_FLOAT;
+            case AttribType::Short2: return GL_SHORT;
+            case AttribType::UShort4: return GL_UNSIGNED_SHORT;
             }
         }
 
+        OpenGLPipeline::OpenGLPipeline(const PipelineSpecification& spec) :
+            m_Specification(spec) {
+
+            m_PipelineVertexArrayHandle = OpenGLNamePool::Create(OpenGLObjectType::VertexArray);
+
+            auto attributes = std::make_shared<std::vector<OpenGLVertexAttribute>>();
+            for (const auto& element : m_Specification.Layout) {
+                OpenGLVertexAttribute& attribute = attributes->emplace_back();
+                attribute.Type = OpenGLBufferAttribType(element.Type);
+                attribute.ComponentCount = element.GetComponentCount();
+                attribute.Offset = element.Offset;
+                attribute.Normalized = element.Normalized;
+
+                // Shorts are read as floats when normalized and as integers otherwise
+                GLenum glBaseType = ShaderDataTypeToOpenGLBaseType(element.Type);
+                if ((glBaseType == GL_SHORT || glBaseType == GL_UNSIGNED_SHORT) && element.Normalized)
+                    glBaseType = GL_FLOAT;
+                attribute.Integer = glBaseType == GL_UNSIGNED_SHORT || glBaseType == GL_SHORT || glBaseType == GL_UNSIGNED_INT || glBaseType == GL_INT;
+            }
+            m_Attributes = attributes;
+        }
+
+        OpenGLPipeline::~OpenGLPipeline() {
+            Renderer::Submit([vertexArray = m_PipelineVertexArrayHandle]() {
+                OpenGLStateCache::DeleteVertexArrays(1, &vertexArray);
+            });
+        }
+
         void OpenGLPipeline::Bind() const {
-            
-            uint32_t attribIndex = 0;
-            for(const auto& element : m_Specification.Layout) {
-                auto glBaseType = ShaderDataTypeToOpenGLBaseType(element.Type);
-                glEnableVertexAttribArray(attribIndex);
-                switch (glBaseType) {
-                case GL_INT: {
-                    glVertexAttribIPointer(attribIndex, 
-                        element.GetComponentCount(), OpenGLBufferAttribType(element.Type), 
-                        m_Specification.Layout.GetStride(), 
-                        (const void*)(intptr_t)element.Offset);
-                    break;
+            uint32_t stride = m_Specification.Layout.GetStride();
+            uint32_t divisor = m_Specification.PerInstance ? 1 : 0;
+            Renderer::Submit([vertexArray = m_PipelineVertexArrayHandle, attributes = m_Attributes, stride, divisor]() {
+                OpenGLStateCache::BindVertexArray(vertexArray);
+
+                uint32_t attribCalls = (uint32_t)attributes->size() * 3;
+                if (!OpenGLStateCache::UpdateVertexArrayBuffer()) {
+                    OpenGLStateCache::AddCalls(attribCalls, true);
+                    return;
                 }
-                case GL_FLOAT: {
-                    glVertexAttribPointer(attribIndex,
-                        element.GetComponentCount(), OpenGLBufferAttribType(element.Type),
-                        element.Normalized ? GL_TRUE : GL_FALSE,
-                        m_Specification.Layout.GetStride(),
-                        (const void*)(intptr_t)element.Offset);
-                    break;
+                OpenGLStateCache::AddCalls(attribCalls, false);
+
+                for (uint32_t attribIndex = 0; attribIndex < attributes->size(); attribIndex++) {
+                    const OpenGLVertexAttribute& attribute = (*attributes)[attribIndex];
+                    glEnableVertexAttribArray(attribIndex);
+                    glVertexAttribDivisor(attribIndex, divisor);
+                    if (attribute.Integer)
+                        glVertexAttribIPointer(attribIndex, attribute.ComponentCount, attribute.Type, stride, (const void*)(intptr_t)attribute.Offset);
+                    else
+                        glVertexAttribPointer(attribIndex, attribute.ComponentCount, attribute.Type, attribute.Normalized ? GL_TRUE : GL_FALSE, stride, (const void*)(intptr_t)attribute.Offset);
                 }
-                }
-                attribIndex++;
-            }
+            });
         }
 
         
@@ -87,6 +112,10 @@ namespace Snow {
             case AttribType::Int2: return GL_INT;
             case AttribType::Int3: return GL_INT;
             case AttribType::Int4: return GL_INT;
+            case AttribType::UInt: return GL_UNSIGNED_INT;
+            case AttribType::Half2: return GL_HALF_FLOAT;
+            case AttribType::Short2: return GL_SHORT;
+            case AttribType::UShort4: return GL_UNSIGNED_SHORT;
             }
             SNOW_CORE_ERROR("Unknown AttribType for glVertexAttribPointer");
             return 0;
@@ -9,9 +9,19 @@
 
 namespace Snow {
     namespace Render {
+        struct OpenGLVertexAttribute {
+            GLenum Type;
+            uint32_t ComponentCount;
+            uint32_t Offset;
+            bool Normalized;
+            // Read as integers instead of being converted to floats
+            bool Integer;
+        };
+
         class OpenGLPipeline : public Pipeline {
         public:
             OpenGLPipeline(const PipelineSpecification& spec);
+            ~OpenGLPipeline();
 
             void Bind() const override;
 
@@ -33,6 +43,9 @@ namespace Snow {
             uint32_t m_PipelineVertexArrayHandle;
             uint32_t m_PipelineHandle;
 
+            // Resolved from the layout once, Bind hands it to the render thread with every bind
+            std::shared_ptr<const std::vector<OpenGLVertexAttribute>> m_Attributes;
+
             
         };
     }
@@ -7,6 +7,9 @@
 #include "Snow/Platform/OpenGL/OpenGLContext.h"
 
 #include "Snow/Platform/OpenGL/OpenGLBuffer.h"
+#include "Snow/Platform/OpenGL/OpenGLNamePool.h"
+#include "Snow/Platform/OpenGL/OpenGLShader.h"
+#include "Snow/Platform/OpenGL/OpenGLStateCache.h"
 
 #include <glad/glad.h>
 
@@ -37,52 +40,75 @@ namespace Snow {
         }
 
         void OpenGLRenderCommand::Init() {
-            glEnable(GL_DEBUG_OUTPUT);
-            glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
-            glDebugMessageCallback(GLLogMessage, nullptr);
+            Renderer::Submit([]() {
+                glEnable(GL_DEBUG_OUTPUT);
+                glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+                glDebugMessageCallback(GLLogMessage, nullptr);
 
-            glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, NULL, GL_FALSE);
+                glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, NULL, GL_FALSE);
 
-            glEnable(GL_CULL_FACE);
-            glCullFace(GL_BACK);
+                OpenGLStateCache::SetCapability(GL_CULL_FACE, true);
+                OpenGLStateCache::SetCullFace(GL_BACK);
+            });
         }
 
         void OpenGLRenderCommand::DrawIndexed(uint32_t count, PrimitiveType type) {
-            glDrawElements(GetPrimitiveType(type), count, GL_UNSIGNED_INT, nullptr);
+            Renderer::Submit([count, mode = GetPrimitiveType(type)]() {
+                glDrawElements(mode, count, GL_UNSIGNED_INT, nullptr);
+            });
+        }
+
+        void OpenGLRenderCommand::DrawIndexedInstanced(uint32_t count, uint32_t instanceCount, PrimitiveType type, uint32_t baseInstance) {
+            Renderer::Submit([count, instanceCount, mode = GetPrimitiveType(type), baseInstance]() {
+                glDrawElementsInstancedBaseInstance(mode, count, GL_UNSIGNED_INT, nullptr, instanceCount, baseInstance);
+            });
         }
 
         void OpenGLRenderCommand::SetClearColor(const glm::vec4& color) {
-            glClearColor(color.r, color.g, color.b, color.a);
+            Renderer::Submit([color]() {
+                glClearColor(color.r, color.g, color.b, color.a);
+            });
         }
 
         void OpenGLRenderCommand::Clear() {
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
-            
+            Renderer::Submit([]() {
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+            });
         }
 
         void OpenGLRenderCommand::SetViewport(uint32_t width, uint32_t height) {
-            glViewport(0, 0, width, height);
+            Renderer::Submit([width, height]() {
+                OpenGLStateCache::SetViewport(0, 0, width, height);
+            });
         }
 
         void OpenGLRenderCommand::SetBlending(bool blend) {
-            if (blend) {
-                glEnable(GL_BLEND);
-                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-            }
-            else
-                glDisable(GL_BLEND);
+            Renderer::Submit([blend]() {
+                OpenGLStateCache::SetCapability(GL_BLEND, blend);
+                if (blend)
+                    OpenGLStateCache::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            });
         }
-        void OpenGLRenderCommand::SetDepthTesting(bool depthTest) {
-            if (depthTest)
-                glEnable(GL_DEPTH_TEST);
-            else
-                glDisable(GL_DEPTH_TEST);
 
+        void OpenGLRenderCommand::SetDepthTesting(bool depthTest) {
+            Renderer::Submit([depthTest]() {
+                OpenGLStateCache::SetCapability(GL_DEPTH_TEST, depthTest);
+            });
         }
 
         void OpenGLRenderCommand::SwapBuffers() {
-            OpenGLContext* glContext = static_cast<OpenGLContext*>(Render::Renderer::GetContext());
-            glContext->GetSwapChain().SwapBuffers();
+            OpenGLShader::NextFrame();
+            Renderer::Submit([]() {
+                OpenGLContext* glContext = static_cast<OpenGLContext*>(Render::Renderer::GetContext());
+                glContext->GetSwapChain().SwapBuffers();
+                OpenGLStateCache::NextFrame();
+                // Names the next frame records with are made while the GPU works on this one
+                OpenGLNamePool::Refill();
+            });
+        }
+
+        RenderStateStatistics OpenGLRenderCommand::GetStateStatistics() const {
+            return OpenGLStateCache::GetStatistics();
         }
     }
 }
\ No newline at end of file
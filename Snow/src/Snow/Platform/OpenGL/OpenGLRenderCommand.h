@@ -17,6 +17,7 @@ namespace Snow {
             void Clear() override;
 
             void DrawIndexed(uint32_t count, PrimitiveType type) override;
+            void DrawIndexedInstanced(uint32_t count, uint32_t instanceCount, PrimitiveType type, uint32_t baseInstance) override;
 
             void SetBlending(bool blend) override;
             void SetDepthTesting(bool depthTest) override;
@@ -27,6 +28,8 @@ namespace Snow {
 
             void SwapBuffers() override;
 
+            RenderStateStatistics GetStateStatistics() const override;
+
         private:
 
         };
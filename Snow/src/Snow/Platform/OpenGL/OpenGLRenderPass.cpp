@@ -2,6 +2,8 @@
 
 #include "Snow/Platform/OpenGL/OpenGLRenderPass.h"
 
+#include "Snow/Render/Renderer.h"
+
 #include "Snow/Platform/OpenGL/OpenGLFramebuffer.h"
 
 #include <glad/glad.h>
@@ -15,17 +17,18 @@ namespace Snow {
 	void OpenGLRenderPass::BeginPass() {
 		auto glFramebuffer = m_Specification.TargetFramebuffer.As<OpenGLFramebuffer>();
 		GLenum clearBit = 0;
-		if (glFramebuffer->GetColorAttachments().size()) {
-			auto c = glFramebuffer->GetSpecification().ClearColor;
+		if (glFramebuffer->GetColorAttachments().size())
 			clearBit |= GL_COLOR_BUFFER_BIT;
-			glClearColor(c.r, c.g, c.b, c.a);
-		}
 
 		if (glFramebuffer->GetDepthAttachment() != 0) {
 			clearBit |= GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT;
 		}
 
-		glClear(clearBit);
+		Render::Renderer::Submit([clearBit, c = glFramebuffer->GetSpecification().ClearColor]() {
+			if (clearBit & GL_COLOR_BUFFER_BIT)
+				glClearColor(c.r, c.g, c.b, c.a);
+			glClear(clearBit);
+		});
 	}
 
 	void OpenGLRenderPass::EndPass() {
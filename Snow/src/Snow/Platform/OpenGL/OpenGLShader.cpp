@@ -2,6 +2,12 @@
 
 #include "Snow/Platform/OpenGL/OpenGLShader.h"
 
+#include "Snow/Render/Renderer.h"
+#include "Snow/Render/Shader/ShaderCompiler.h"
+
+#include "Snow/Platform/OpenGL/OpenGLNamePool.h"
+#include "Snow/Platform/OpenGL/OpenGLStateCache.h"
+
 #include <glad/glad.h>
 
 #include <shaderc.hpp>
@@ -12,23 +18,85 @@
 
 namespace Snow {
     namespace Render {
-        std::vector<std::string> SplitString(const std::string& string, const char* delimiter) {
-            std::vector<std::string> result;
-            std::string::size_type pos = 0;
-            std::string::size_type prev = 0;
-            while ((pos = string.find('\n', prev)) != std::string::npos) {
-                result.push_back(string.substr(prev, pos - prev));
-                prev = pos + 1;
+        // Everything besides the source that changes what a stage compiles to, hashed into the key of its cache
+        struct StageCompileOptions {
+            shaderc_target_env TargetEnv;
+            shaderc_env_version EnvVersion;
+            shaderc_optimization_level OptimizationLevel;
+            uint32_t Version; // Bumped when the compile steps themselves change
+        };
+        static constexpr StageCompileOptions s_SPIRVOptions = { shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_2, shaderc_optimization_level_zero, 1 };
+        // The OpenGL stages are cross-compiled from the SPIR-V rather than built by shaderc, only the version is used
+        static constexpr StageCompileOptions s_GLSLOptions = { shaderc_target_env_opengl_compat, shaderc_env_version_opengl_4_5, shaderc_optimization_level_zero, 2 };
+
+        // Cached files start with the key of what they were built from, a stale file or one from before keys reads as a miss
+        struct CacheHeader {
+            uint32_t Magic;
+            uint32_t Format; // Program binary format, 0 for stages
+            uint64_t Key;
+        };
+        static constexpr uint32_t CacheMagic = 0x43534e53; // "SNSC"
+
+        // FNV-1a, continued from hash
+        static uint64_t HashBytes(uint64_t hash, const void* data, size_t size) {
+            for (size_t i = 0; i < size; i++) {
+                hash ^= ((const uint8_t*)data)[i];
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        static uint64_t HashString(uint64_t hash, const char* string) {
+            return string ? HashBytes(hash, string, strlen(string)) : hash;
+        }
+
+        static uint64_t GetStageKey(const std::string& source, ShaderType type, const StageCompileOptions& options) {
+            uint64_t hash = HashBytes(14695981039346656037ull, source.data(), source.size());
+            hash = HashBytes(hash, &type, sizeof(ShaderType));
+            return HashBytes(hash, &options, sizeof(StageCompileOptions));
+        }
+
+        static std::string GetCachePath(const std::string& shaderPath, const char* extension) {
+            std::filesystem::path filePath = shaderPath;
+            return (filePath.parent_path() / "cached" / (filePath.filename().string() + extension)).string();
+        }
+
+        template<typename T>
+        static bool ReadCache(const std::string& path, uint64_t key, std::vector<T>& outData, uint32_t* outFormat = nullptr) {
+            FILE* f = fopen(path.c_str(), "rb");
+            if (!f)
+                return false;
+
+            fseek(f, 0, SEEK_END);
+            uint64_t size = ftell(f);
+            fseek(f, 0, SEEK_SET);
+
+            CacheHeader header;
+            bool valid = size > sizeof(CacheHeader) && fread(&header, sizeof(CacheHeader), 1, f) == 1 && header.Magic == CacheMagic && header.Key == key;
+            if (valid) {
+                outData.resize((size - sizeof(CacheHeader)) / sizeof(T));
+                valid = fread(outData.data(), sizeof(T), outData.size(), f) == outData.size();
+                if (outFormat)
+                    *outFormat = header.Format;
             }
-            //result.push_back(string.substr(prev));
-            return result;
+            fclose(f);
+
+            if (!valid)
+                outData.clear();
+            return valid;
         }
 
-        shaderc_shader_kind OpenGLShader::SnowShaderTypeToShaderC(ShaderType type) {
-            switch(type){
-                case ShaderType::Vertex:    return shaderc_shader_kind::shaderc_glsl_vertex_shader;
-                case ShaderType::Pixel:     return shaderc_shader_kind::shaderc_glsl_fragment_shader;
+        static void WriteCache(const std::string& path, uint64_t key, const void* data, uint64_t size, uint32_t format = 0) {
+            FILE* f = fopen(path.c_str(), "wb");
+            if (!f) {
+                SNOW_CORE_WARN("Could not write shader cache {0}", path);
+                return;
             }
+
+            CacheHeader header = { CacheMagic, format, key };
+            fwrite(&header, sizeof(CacheHeader), 1, f);
+            fwrite(data, 1, size, f);
+            fclose(f);
         }
 
         OpenGLShader::OpenGLShader(const std::initializer_list<ShaderModule>& shaderModules) :
@@ -46,50 +114,68 @@ namespace Snow {
             Reload();
         }
 
+        OpenGLShader::~OpenGLShader() {
+            // The stage jobs write into this shader
+            Core::JobSystem::Wait(m_CompileJobs);
+            auto it = std::find(m_CompilingShaders.begin(), m_CompilingShaders.end(), this);
+            if (it != m_CompilingShaders.end())
+                m_CompilingShaders.erase(it);
+        }
+
         void OpenGLShader::Bind() const {
-            glUseProgram(m_RendererID);
+            FinishCompiles();
+            Renderer::Submit([rendererID = m_RendererID]() {
+                OpenGLStateCache::UseProgram(rendererID);
+            });
         }
 
         void OpenGLShader::Reload() {
-            if (m_ShaderModules.size() > 1) {
-                for (auto& [type, path] : m_ShaderModules) {
-                    m_ShaderSources.push_back(ReadShaderFromFile(path));
-                    m_ShaderTypes.push_back(type);
-                    
-                }
-                Load();
-                m_Reloaded = true;
-            }
-            else if (m_ShaderModules.size() == 1) {
-                
-                const auto& source = ReadShaderFromFile(m_ShaderModules[0].second);
-                PreProcess(source);
-                
-                
+            FinishCompiles();
+            m_ReloadCount++;
+            ShaderCompiler::LoadSources(m_ShaderModules, m_ShaderSources, m_ShaderTypes);
+            if (!m_ShaderSources.empty()) {
+                if (m_ShaderModules.size() == 1)
+                    SetStagePaths();
+
                 Load();
                 m_Reloaded = true;
             }
             else {
                 m_Reloaded = false;
+                m_GLSLSourceData.clear();
                 SNOW_CORE_ERROR("Shader failed to reload!");
             }
 
-            LinkShaders();
+            // Linked once the stages have been cross-compiled
+            m_CompilingShaders.push_back(this);
+        }
 
-            SPIRVReflection();
+        void OpenGLShader::FinishCompiles() {
+            std::vector<OpenGLShader*> shaders;
+            std::swap(shaders, m_CompilingShaders);
+            for (OpenGLShader* shader : shaders) {
+                Core::JobSystem::Wait(shader->m_CompileJobs);
+                shader->LinkShaders();
+                shader->SPIRVReflection();
+            }
         }
 
         void OpenGLShader::Load() {
             m_SPIRVBinaryData.resize(m_ShaderSources.size());
-            m_GLSLBinaryData.resize(m_ShaderSources.size());
             m_GLSLSourceData.resize(m_ShaderSources.size());
 
-            m_ShaderIDs.resize(m_ShaderSources.size());
+            for (const std::string& path : m_Paths) {
+                std::filesystem::path cachedPath = std::filesystem::path(path).parent_path() / "cached";
+                if (!std::filesystem::is_directory(cachedPath))
+                    std::filesystem::create_directory(cachedPath);
+            }
 
+            // Stages only touch their own slots, the vectors are not resized until the jobs are done
             for (uint32_t i = 0; i < m_ShaderSources.size(); i++) {
-                CreateSPIRVBinaryCache(i);
-                CreateGLSLBinaryCache(i);
-                CreateOpenGLShaderModule(i, false);
+                Core::JobSystem::Run([this, i]() {
+                    CreateSPIRVBinaryCache(i);
+                    CreateGLSLBinaryCache(i);
+                }, &m_CompileJobs);
             }
             //GLSLReflect();
 
@@ -97,302 +183,233 @@ namespace Snow {
         }
 
         const ShaderUniformBuffer& OpenGLShader::GetUniformBuffer(const std::string& name) const {
-            for (auto& [bindingPoint, ub] : m_UniformBuffers) {
-                if (ub.Name == name) {
-                    return ub;
-                }
-            }
+            FinishCompiles();
+            uint32_t bindingPoint = GetUniformBufferBinding(name);
+            if (bindingPoint != InvalidBinding)
+                return m_UniformBuffers[bindingPoint];
+
             SNOW_CORE_WARN("Could not find uniform buffer, returning UBO 0");
             return m_UniformBuffers[0];
         }
 
-        void OpenGLShader::SetUniformBufferData(const std::string& uniformBufferName, void* data, uint32_t size) {
-            uint8_t* buffer = new uint8_t[size];
-            memcpy(buffer, data, size);
-
-            ShaderUniformBuffer* uniformBuffer = nullptr;
-            for (auto& [bindingPoint, ub] : m_UniformBuffers) {
-                if (ub.Name == uniformBufferName) {
-                    uniformBuffer = &ub;
-                    break;
-                }
-            }
-            if (uniformBuffer == nullptr)
-                return;
+        const std::unordered_map<std::string, ShaderResource>& OpenGLShader::GetResources() const {
+            FinishCompiles();
+            return m_Resources;
+        }
 
-            glBindBuffer(GL_UNIFORM_BUFFER, uniformBuffer->RendererID);
-            glBufferSubData(GL_UNIFORM_BUFFER, 0, size, buffer);
-            glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        uint32_t OpenGLShader::GetUniformBufferBinding(const std::string& name) const {
+            FinishCompiles();
+            auto it = m_UniformBufferBindings.find(name);
+            return it != m_UniformBufferBindings.end() ? it->second : InvalidBinding;
+        }
 
-            delete[] buffer;
+        void OpenGLShader::SetUniformBufferData(const std::string& uniformBufferName, void* data, uint32_t size) {
+            SetUniformBufferData(GetUniformBufferBinding(uniformBufferName), data, size);
         }
 
         void OpenGLShader::SetUniformBufferData(uint32_t bindingPoint, void* data, uint32_t size) {
-            uint8_t* buffer = new uint8_t[size];
-            memcpy(buffer, data, size);
-
-
-            ShaderUniformBuffer* uniformBuffer = &m_UniformBuffers[bindingPoint];
+            FinishCompiles();
+            auto it = m_UniformBuffers.find(bindingPoint);
+            if (it == m_UniformBuffers.end())
+                return;
 
-            glBindBuffer(GL_UNIFORM_BUFFER, uniformBuffer->RendererID);
-            glBufferSubData(GL_UNIFORM_BUFFER, 0, size, buffer);
-            glBindBuffer(GL_UNIFORM_BUFFER, 0);
+            const ShaderUniformBuffer& uniformBuffer = it->second;
+            if (!m_UniformRing)
+                m_UniformRing = Core::CreateScope<OpenGLUniformBufferRing>(UniformRingFrameSize, UniformRingFrameCount);
+            if (m_UniformRing->Bind(bindingPoint, data, size, uniformBuffer.Size))
+                return;
 
-            delete[] buffer;
-            //glBindBuffer(GL_UNIFORM_BUFFER, 0);
+            // The ring is full for this frame, fall back to updating the buffer in place
+            const void* commandData = Renderer::CopyCommandData(data, size);
+            Renderer::Submit([rendererID = uniformBuffer.RendererID, bindingPoint, commandData, size]() {
+                glNamedBufferSubData(rendererID, 0, size, commandData);
+                OpenGLStateCache::BindUniformBuffer(bindingPoint, rendererID);
+            });
         }
 
-        void OpenGLShader::PreProcess(const std::string& source) {
-            const char* typeToken = "#type";
-            size_t typeTokenLength = strlen(typeToken);
-            size_t pos = source.find(typeToken, 0);
-            while (pos != std::string::npos) {
-                size_t eol = source.find_first_of("\r\n", pos);
-                SNOW_CORE_ASSERT(eol != std::string::npos, "Syntax Error");
-                size_t begin = pos + typeTokenLength + 1;
-                std::string type = source.substr(begin, eol - begin);
-                SNOW_CORE_ASSERT(type == "vertex" || type == "pixel" || type == "fragment" || type == "compute" || type == "geometry", "Invalid shader type");
-
-                size_t nextLinePos = source.find_first_not_of("\r\n", eol);
-                pos = source.find(typeToken, nextLinePos);
-                auto shaderType = ShaderTypeFromString(type);
-                m_ShaderSources.push_back(source.substr(nextLinePos, pos - (nextLinePos == std::string::npos ? source.size() - 1 : nextLinePos)));
-                m_ShaderTypes.push_back(shaderType);
-                
-            }
+        void OpenGLShader::NextFrame() {
+            if (m_UniformRing)
+                m_UniformRing->NextFrame();
+        }
 
-            std::string originalPath = m_Paths[0];
+        void OpenGLShader::SetStagePaths() {
+            std::string originalPath = m_ShaderModules[0].second;
             m_Paths.resize(m_ShaderSources.size());
             size_t found = originalPath.find_last_of("/\\");
             std::string parentPath = found != std::string::npos ? originalPath.substr(0, found + 1) : originalPath;
             for (uint32_t i = 0; i < m_ShaderSources.size(); i++)
-                m_Paths[i] = std::string(parentPath + m_Name + "." + ShaderTypeToString(m_ShaderTypes[i]) + ".glsl");
+                m_Paths[i] = std::string(parentPath + m_Name + "." + ShaderCompiler::ShaderTypeToString(m_ShaderTypes[i]) + ".glsl");
         }
 
+        // Job system
         void OpenGLShader::CreateSPIRVBinaryCache(uint32_t shaderIndex) {
-            {
-                std::filesystem::path directoryPath = m_Paths[shaderIndex];
-                if (!std::filesystem::is_directory(directoryPath.parent_path() / "cached")) {
-                    std::string dirPath = (directoryPath.parent_path() / "cached").string();
-                    std::filesystem::create_directory(directoryPath.parent_path() / "cached");
-                }
-                {
-                    std::filesystem::path filePath = m_Paths[shaderIndex];
-                    auto path = filePath.parent_path() / "cached" / (filePath.filename().string() + ".cached_vulkan");
-                    std::string cachedFilePath = path.string();
-
-                    FILE* f = fopen(cachedFilePath.c_str(), "rb");
-                    if (f) {
-                        fseek(f, 0, SEEK_END);
-                        uint64_t size = ftell(f);
-                        fseek(f, 0, SEEK_SET);
-                        m_SPIRVBinaryData[shaderIndex] = std::vector<uint32_t>(size / sizeof(uint32_t));
-                        fread(m_SPIRVBinaryData[shaderIndex].data(), sizeof(uint32_t), m_SPIRVBinaryData[shaderIndex].size(), f);
-                        fclose(f);
-                    }
-                }
-            }
-
-            if (m_SPIRVBinaryData[shaderIndex].size() == 0) {
-                shaderc::Compiler compiler;
-                shaderc::CompileOptions options;
-                options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_2);
-                options.SetOptimizationLevel(shaderc_optimization_level_zero);
-
-                const bool optimize = false;
-                if (optimize)
-                    options.SetOptimizationLevel(shaderc_optimization_level_performance);
-
-
+            uint64_t key = GetStageKey(m_ShaderSources[shaderIndex], m_ShaderTypes[shaderIndex], s_SPIRVOptions);
+            std::string cachedFilePath = GetCachePath(m_Paths[shaderIndex], ".cached_vulkan");
+            if (ReadCache(cachedFilePath, key, m_SPIRVBinaryData[shaderIndex]))
+                return;
 
-                shaderc::SpvCompilationResult module = compiler.CompileGlslToSpv(m_ShaderSources[shaderIndex], SnowShaderTypeToShaderC(m_ShaderTypes[shaderIndex]), m_Paths[shaderIndex].c_str(), options);
+            shaderc::Compiler compiler;
+            shaderc::CompileOptions options;
+            options.SetTargetEnvironment(s_SPIRVOptions.TargetEnv, s_SPIRVOptions.EnvVersion);
+            options.SetOptimizationLevel(s_SPIRVOptions.OptimizationLevel);
 
-                if (module.GetCompilationStatus() != shaderc_compilation_status_success) {
-                    SNOW_CORE_ERROR(module.GetErrorMessage());
-                }
+            shaderc::SpvCompilationResult module = compiler.CompileGlslToSpv(m_ShaderSources[shaderIndex], ShaderCompiler::ShaderTypeToShaderC(m_ShaderTypes[shaderIndex]), m_Paths[shaderIndex].c_str(), options);
 
-                m_SPIRVBinaryData[shaderIndex] = std::vector<uint32_t>(module.cbegin(), module.cend());
-                
-                {
-                    std::filesystem::path filePath = m_Paths[shaderIndex];
-                    auto path = filePath.parent_path() / "cached" / (filePath.filename().string() + ".cached_vulkan");
-                    std::string cachedFilePath = path.string();
-
-                    FILE* f = fopen(cachedFilePath.c_str(), "wb");
-                    fwrite(m_SPIRVBinaryData[shaderIndex].data(), sizeof(uint32_t), m_SPIRVBinaryData[shaderIndex].size(), f);
-                    fclose(f);
-                }
+            if (module.GetCompilationStatus() != shaderc_compilation_status_success) {
+                SNOW_CORE_ERROR(module.GetErrorMessage());
+                m_SPIRVBinaryData[shaderIndex].clear();
+                return;
             }
+
+            m_SPIRVBinaryData[shaderIndex] = std::vector<uint32_t>(module.cbegin(), module.cend());
+            WriteCache(cachedFilePath, key, m_SPIRVBinaryData[shaderIndex].data(), m_SPIRVBinaryData[shaderIndex].size() * sizeof(uint32_t));
         }
 
+        // Job system, OpenGL compiles the GLSL cross-compiled from the Vulkan SPIR-V. The sources are written against
+        // Vulkan GLSL for shaderc, built-ins like gl_VertexIndex and gl_InstanceIndex only exist there.
         void OpenGLShader::CreateGLSLBinaryCache(uint32_t shaderIndex) {
-            {
-                std::filesystem::path filePath = m_Paths[shaderIndex];
-                auto path = filePath.parent_path() / "cached" / (filePath.filename().string() + ".cached_glsl");
-                std::string cachedFilePath = path.string();
-
-                FILE* f = fopen(cachedFilePath.c_str(), "rb");
-                if (f) {
-                    fseek(f, 0, SEEK_END);
-                    uint64_t size = ftell(f);
-                    fseek(f, 0, SEEK_SET);
-                    m_GLSLBinaryData[shaderIndex] = std::vector<uint32_t>(size / sizeof(uint32_t));
-                    fread(m_GLSLBinaryData[shaderIndex].data(), sizeof(uint32_t), m_GLSLBinaryData[shaderIndex].size(), f);
-                    fclose(f);
-                }
+            uint64_t key = GetStageKey(m_ShaderSources[shaderIndex], m_ShaderTypes[shaderIndex], s_GLSLOptions);
+            std::string cachedFilePath = GetCachePath(m_Paths[shaderIndex], ".cached_glsl");
+            std::vector<char> cached;
+            if (ReadCache(cachedFilePath, key, cached)) {
+                m_GLSLSourceData[shaderIndex].assign(cached.begin(), cached.end());
+                return;
             }
 
-            if (m_GLSLBinaryData[shaderIndex].size() == 0) {
-                shaderc::Compiler compiler;
-                shaderc::CompileOptions options;
-                options.SetTargetEnvironment(shaderc_target_env_opengl_compat, shaderc_env_version_opengl_4_5);
-
-                spirv_cross::CompilerGLSL compilerGLSL(m_SPIRVBinaryData[shaderIndex]);
-
-                std::string source = compilerGLSL.compile();
-                m_GLSLSourceData[shaderIndex] = SplitString(source, "\r\n");
-
-                printf("====================\n");
-                printf("Shader:\n%s\n", source.data());
-                printf("====================\n");
-
-                
-
-                shaderc::SpvCompilationResult module = compiler.CompileGlslToSpv(source, SnowShaderTypeToShaderC(m_ShaderTypes[shaderIndex]), m_Paths[shaderIndex].c_str(), options);
-
-                if (module.GetCompilationStatus() != shaderc_compilation_status_success) {
-                    SNOW_CORE_ERROR(module.GetErrorMessage());
-                }
-
-                m_GLSLBinaryData[shaderIndex] = std::vector<uint32_t>(module.begin(), module.end());
+            m_GLSLSourceData[shaderIndex].clear();
+            if (m_SPIRVBinaryData[shaderIndex].empty())
+                return;
 
-                {
-                    std::filesystem::path filePath = m_Paths[shaderIndex];
-                    auto path = filePath.parent_path() / "cached" / (filePath.filename().string() + ".cached_glsl");
-                    std::string cachedFilePath = path.string();
+            spirv_cross::CompilerGLSL compilerGLSL(m_SPIRVBinaryData[shaderIndex]);
+            // Instanced draws index their per-instance data from zero, so gl_InstanceIndex can map straight to gl_InstanceID
+            spirv_cross::CompilerGLSL::Options glslOptions = compilerGLSL.get_common_options();
+            glslOptions.vertex.support_nonzero_base_instance = false;
+            compilerGLSL.set_common_options(glslOptions);
 
-                    FILE* f = fopen(cachedFilePath.c_str(), "wb");
-                    fwrite(m_GLSLBinaryData[shaderIndex].data(), sizeof(uint32_t), m_GLSLBinaryData[shaderIndex].size(), f);
-                    fclose(f);
-                }
-            }
+            m_GLSLSourceData[shaderIndex] = compilerGLSL.compile();
+            WriteCache(cachedFilePath, key, m_GLSLSourceData[shaderIndex].data(), m_GLSLSourceData[shaderIndex].size());
         }
 
         void OpenGLShader::GLSLReflect() {
             
         }
 
-        void OpenGLShader::CreateOpenGLShaderModule(uint32_t shaderIndex, bool spirvModule) {
-            m_ShaderIDs[shaderIndex] = glCreateShader(GetShaderType(m_ShaderTypes[shaderIndex]));
+        // Render thread, returns the compiled shader object
+        static uint32_t CreateOpenGLShaderModule(GLenum glType, ShaderType type, const std::string& shaderSource, const std::string& path) {
+            uint32_t shaderID = glCreateShader(glType);
 
-            if (spirvModule) {
-                glShaderBinary(1, &m_ShaderIDs[shaderIndex], GL_SHADER_BINARY_FORMAT_SPIR_V, m_GLSLSourceData[shaderIndex].data(), m_GLSLSourceData[shaderIndex].size() * sizeof(uint32_t));
-                glSpecializeShader(m_ShaderIDs[shaderIndex], "main", 0, nullptr, nullptr);
+            const GLchar* source = (const GLchar*)shaderSource.c_str();
+            glShaderSource(shaderID, 1, &source, 0);
 
-                glCompileShader(m_ShaderIDs[shaderIndex]);
-                GLint isCompiled = 0;
-                glGetShaderiv(m_ShaderIDs[shaderIndex], GL_COMPILE_STATUS, &isCompiled);
-                if (isCompiled == GL_FALSE) {
-                    GLint maxLength = 0;
-                    glGetShaderiv(m_ShaderIDs[shaderIndex], GL_INFO_LOG_LENGTH, &maxLength);
-
-                    std::vector<GLchar> infoLog(maxLength);
-                    glGetShaderInfoLog(m_ShaderIDs[shaderIndex], maxLength, &maxLength, &infoLog[0]);
-                    SNOW_CORE_ERROR("Shader compilation failed {0}, Shader Path {1}, Shader Type {2}", &infoLog[0], m_Paths[shaderIndex], m_ShaderTypes[shaderIndex]);
-                    glDeleteShader(m_ShaderIDs[shaderIndex]);
-                }
+            glCompileShader(shaderID);
+            GLint isCompiled = 0;
+            glGetShaderiv(shaderID, GL_COMPILE_STATUS, &isCompiled);
+            if (isCompiled == GL_FALSE) {
+                GLint maxLength = 0;
+                glGetShaderiv(shaderID, GL_INFO_LOG_LENGTH, &maxLength);
 
-                SNOW_CORE_TRACE("Created SPIRV module for OpenGL Shader {0}", m_Paths[shaderIndex]);
-                SNOW_CORE_TRACE("   size in bytes: {0}", m_GLSLBinaryData[shaderIndex].size() * sizeof(uint32_t));
+                std::vector<GLchar> infoLog(maxLength);
+                glGetShaderInfoLog(shaderID, maxLength, &maxLength, &infoLog[0]);
+                SNOW_CORE_ERROR("Shader compilation failed {0}, Shader Path {1}, Shader Type {2}", &infoLog[0], path, type);
+                glDeleteShader(shaderID);
             }
-            else {
-                const GLchar* source = (const GLchar*)m_ShaderSources[shaderIndex].c_str();
-
-                glShaderSource(m_ShaderIDs[shaderIndex], 1, &source, 0);
-
-                glCompileShader(m_ShaderIDs[shaderIndex]);
-                GLint isCompiled = 0;
-                glGetShaderiv(m_ShaderIDs[shaderIndex], GL_COMPILE_STATUS, &isCompiled);
-                if (isCompiled == GL_FALSE) {
-                    GLint maxLength = 0;
-                    glGetShaderiv(m_ShaderIDs[shaderIndex], GL_INFO_LOG_LENGTH, &maxLength);
+            return shaderID;
+        }
 
-                    std::vector<GLchar> infoLog(maxLength);
-                    glGetShaderInfoLog(m_ShaderIDs[shaderIndex], maxLength, &maxLength, &infoLog[0]);
-                    SNOW_CORE_ERROR("Shader compilation failed {0}, Shader Path {1}, Shader Type {2}", &infoLog[0], m_Paths[shaderIndex], m_ShaderTypes[shaderIndex]);
-                    glDeleteShader(m_ShaderIDs[shaderIndex]);
-                }
-            }
+        // Render thread, the driver is part of the key since binaries only load on the driver that wrote them
+        static uint64_t GetProgramKey(uint64_t sourceKey) {
+            uint64_t hash = HashString(sourceKey, (const char*)glGetString(GL_VENDOR));
+            hash = HashString(hash, (const char*)glGetString(GL_RENDERER));
+            return HashString(hash, (const char*)glGetString(GL_VERSION));
         }
 
-        static UniformType SPIRVTypeToShaderUniformType(spirv_cross::SPIRType type) {
-            UniformType retType = UniformType::None;
-            switch (type.basetype) {
-            case spirv_cross::SPIRType::Boolean:    retType = UniformType::Bool; break;
-            case spirv_cross::SPIRType::Int: {
-                if (type.vecsize == 1)   retType = UniformType::Int;
-                else if (type.vecsize == 2)   retType = UniformType::Int2;
-                else if (type.vecsize == 3)   retType = UniformType::Int3;
-                else if (type.vecsize == 4)   retType = UniformType::Int4;
-                break;
-            }
-            case spirv_cross::SPIRType::Float: {
-                if (type.vecsize == 1)   retType = UniformType::Float;
-                else if (type.vecsize == 2)   retType = UniformType::Float2;
-                else if (type.vecsize == 3) {
-                    retType = UniformType::Float3;
+        // Render thread
+        static bool LoadProgramBinary(uint32_t program, const std::string& path, uint64_t key) {
+            std::vector<uint8_t> binary;
+            uint32_t format = 0;
+            if (!ReadCache(path, key, binary, &format))
+                return false;
 
+            glProgramBinary(program, format, binary.data(), (GLsizei)binary.size());
+            GLint isLinked = 0;
+            glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
+            return isLinked == GL_TRUE;
+        }
 
-                    if (type.columns == 3)  retType = UniformType::Mat3x3;
-                }
-                else if (type.vecsize == 4) {
-                    retType = UniformType::Float4;
+        // Render thread
+        static void SaveProgramBinary(uint32_t program, const std::string& path, uint64_t key) {
+            GLint length = 0;
+            glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+            if (length == 0)
+                return;
 
-                    if (type.columns == 4)  retType = UniformType::Mat4x4;
-                }
-                break;
-            }
-            case spirv_cross::SPIRType::Struct:
-                retType = UniformType::Struct;
-                break;
-            }
-            return retType;
+            std::vector<uint8_t> binary(length);
+            GLenum format = 0;
+            glGetProgramBinary(program, length, &length, &format, binary.data());
+            WriteCache(path, key, binary.data(), length, format);
         }
 
         void OpenGLShader::LinkShaders() {
 
-            m_RendererID = glCreateProgram();
+            m_RendererID = OpenGLNamePool::Create(OpenGLObjectType::Program);
             SNOW_CORE_TRACE("Created program for pipeline");
-            for (auto shaderID : m_ShaderIDs) {
-                glAttachShader(m_RendererID, shaderID);
+
+            std::vector<GLenum> glTypes;
+            uint64_t sourceKey = 14695981039346656037ull;
+            for (uint32_t i = 0; i < m_ShaderTypes.size(); i++) {
+                glTypes.push_back(GetShaderType(m_ShaderTypes[i]));
+                sourceKey = HashBytes(sourceKey, &glTypes[i], sizeof(GLenum));
+                sourceKey = HashBytes(sourceKey, m_GLSLSourceData[i].data(), m_GLSLSourceData[i].size());
             }
+            std::string cachePath = GetCachePath(m_Paths[0], ".cached_program");
+
+            // Compiled and linked where the context is current, reflection only needs the SPIR-V. A program
+            // binary cached from the same sources and driver skips both.
+            Renderer::Submit([rendererID = m_RendererID, sources = m_GLSLSourceData, types = m_ShaderTypes, glTypes = std::move(glTypes), paths = m_Paths, sourceKey, cachePath]() {
+                GLint binaryFormatCount = 0;
+                glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatCount);
+                uint64_t programKey = binaryFormatCount > 0 ? GetProgramKey(sourceKey) : 0;
+                if (binaryFormatCount > 0 && LoadProgramBinary(rendererID, cachePath, programKey))
+                    return;
+
+                std::vector<uint32_t> shaderIDs;
+                for (uint32_t i = 0; i < sources.size(); i++)
+                    shaderIDs.push_back(CreateOpenGLShaderModule(glTypes[i], types[i], sources[i], paths[i]));
+
+                for (auto shaderID : shaderIDs) {
+                    glAttachShader(rendererID, shaderID);
+                }
 
-            glLinkProgram(m_RendererID);
-            GLint isLinked = 0;
-            glGetProgramiv(m_RendererID, GL_LINK_STATUS, &isLinked);
-            if (isLinked == GL_FALSE) {
-                GLint maxLength = 0;
-                glGetProgramiv(m_RendererID, GL_INFO_LOG_LENGTH, &maxLength);
+                if (binaryFormatCount > 0)
+                    glProgramParameteri(rendererID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+                glLinkProgram(rendererID);
+                GLint isLinked = 0;
+                glGetProgramiv(rendererID, GL_LINK_STATUS, &isLinked);
+                if (isLinked == GL_FALSE) {
+                    GLint maxLength = 0;
+                    glGetProgramiv(rendererID, GL_INFO_LOG_LENGTH, &maxLength);
 
-                std::vector<GLchar> infoLog(maxLength);
-                glGetProgramInfoLog(m_RendererID, maxLength, &maxLength, &infoLog[0]);
-                SNOW_CORE_ERROR("Program linking failed:\n{0}", &infoLog[0]);
+                    std::vector<GLchar> infoLog(maxLength);
+                    glGetProgramInfoLog(rendererID, maxLength, &maxLength, &infoLog[0]);
+                    SNOW_CORE_ERROR("Program linking failed:\n{0}", &infoLog[0]);
 
-                glDeleteProgram(m_RendererID);
+                    OpenGLStateCache::DeleteProgram(rendererID);
 
-                for (auto shaderID : m_ShaderIDs) {
-                    glDeleteShader(shaderID);
-                    glDetachShader(m_RendererID, shaderID);
+                    for (auto shaderID : shaderIDs) {
+                        glDeleteShader(shaderID);
+                        glDetachShader(rendererID, shaderID);
+                    }
                 }
-            }
-            for (auto shaderID : m_ShaderIDs) {
-                glDetachShader(m_RendererID, shaderID);
-            }
+                else if (binaryFormatCount > 0) {
+                    SaveProgramBinary(rendererID, cachePath, programKey);
+                }
+                for (auto shaderID : shaderIDs) {
+                    glDetachShader(rendererID, shaderID);
+                }
+            });
         }
 
         void OpenGLShader::SPIRVReflection() {
-            glUseProgram(m_RendererID);
-
             std::vector<spirv_cross::SPIRType> outputAttributes;
 
             for (uint32_t shaderTypeIndex = 0; shaderTypeIndex < m_ShaderTypes.size(); shaderTypeIndex++) {
@@ -456,109 +473,45 @@ namespace Snow {
                         auto offset = compiler.type_struct_member_offset(bufferType, i);
 
                         std::string uniformName = bufferName + "." + memberName;
-                        buffer.Uniforms[uniformName] = ShaderUniform(uniformName, SPIRVTypeToShaderUniformType(type), size, offset);
+                        buffer.Uniforms[uniformName] = ShaderUniform(uniformName, ShaderCompiler::GetUniformType(type), size, offset);
                     }
                 }
 
-                uint32_t bufferIndex = 0;
                 for (const spirv_cross::Resource& resource : res.uniform_buffers) {
-                    auto& bufferType = compiler.get_type(resource.base_type_id);
-                    int memberCount = bufferType.member_types.size();
                     uint32_t bindingPoint = compiler.get_decoration(resource.id, spv::DecorationBinding);
+                    if (m_UniformBuffers.find(bindingPoint) != m_UniformBuffers.end())
+                        continue;
 
-                    if (m_UniformBuffers.find(bindingPoint) == m_UniformBuffers.end()) {
-                        ShaderUniformBuffer& buffer = m_UniformBuffers[bindingPoint];
-                        buffer.Name = resource.name;
-                        buffer.BindingPoint = bindingPoint;
-                        buffer.Size = compiler.get_declared_struct_size(bufferType);
-
-                        uint32_t uniformCount = compiler.get_type(resource.base_type_id).member_types.size();
-                        for (uint32_t i = 0; i < uniformCount; i++) {
-                            std::string name = compiler.get_member_name(resource.base_type_id, i);
-                            UniformType type = SPIRVTypeToShaderUniformType(compiler.get_type(compiler.get_type(resource.base_type_id).member_types[i]));
-                            uint32_t size = compiler.get_declared_struct_member_size(compiler.get_type(resource.base_type_id), i);
-                            uint32_t offset = compiler.type_struct_member_offset(compiler.get_type(resource.base_type_id), i);
-
-                            ShaderStruct sstruct = ShaderStruct(name);
-                            if (type == UniformType::Struct) {
-                                auto structType = compiler.get_type(compiler.get_type(resource.base_type_id).member_types[i]);
-
-
-                                spirv_cross::TypeID typeID = compiler.get_type(resource.base_type_id).member_types[i];
-                                spirv_cross::SPIRType SPIRtype = compiler.get_type(compiler.get_type(resource.base_type_id).member_types[i]);
-
-                                uint32_t count = 1;
-                                if (SPIRtype.array.size() == 1) {
-                                    count = SPIRtype.array[0];
-                                }
-                                else if (SPIRtype.array.size() == 0) {
-                                    count = 1;
-                                }
-
-                                uint32_t memberCount = compiler.get_type(typeID).member_types.size();
-                                for (uint32_t j = 0; j < memberCount; j++) {
-                                    const auto& name = compiler.get_member_name(typeID, j);
-                                    UniformType UniformType = SPIRVTypeToShaderUniformType(compiler.get_type(compiler.get_type(typeID).member_types[j]));
-                                    uint32_t size = compiler.get_declared_struct_member_size(compiler.get_type(typeID), j);
-                                    uint32_t offset = compiler.type_struct_member_offset(compiler.get_type(typeID), j);
-
-                                    sstruct.AddUniform(ShaderUniform(name, UniformType, size, offset));
-                                }
-                                buffer.Uniforms.push_back(ShaderUniform(name, &sstruct, count));
-                            }
-                            else {
-                                buffer.Uniforms.push_back(ShaderUniform(name, type, size, offset));
-                            }
-
-
-                        }
-
-                        // move uniform buffers to their own class
-                        glGenBuffers(1, &buffer.RendererID);
-                        glBindBuffer(GL_UNIFORM_BUFFER, buffer.RendererID);
-                        glBufferData(GL_UNIFORM_BUFFER, buffer.Size, nullptr, GL_DYNAMIC_DRAW);
-                        glBindBufferBase(GL_UNIFORM_BUFFER, buffer.BindingPoint, buffer.RendererID);
+                    ShaderUniformBuffer& buffer = m_UniformBuffers[bindingPoint];
+                    ShaderCompiler::ReflectUniformBuffer(compiler, resource, m_ShaderTypes[shaderTypeIndex], buffer);
+                    m_UniformBufferBindings[buffer.Name] = bindingPoint;
 
-                        SNOW_CORE_TRACE("Created Uniform buffer {0} at binding point {1}, size is {2} bytes", buffer.Name, buffer.BindingPoint, buffer.Size);
+                    // move uniform buffers to their own class
+                    buffer.RendererID = OpenGLNamePool::Create(OpenGLObjectType::Buffer);
+                    Renderer::Submit([rendererID = buffer.RendererID, size = buffer.Size, bindingPoint = buffer.BindingPoint]() {
+                        glNamedBufferData(rendererID, size, nullptr, GL_DYNAMIC_DRAW);
+                        OpenGLStateCache::BindUniformBuffer(bindingPoint, rendererID);
+                    });
 
-                        glBindBuffer(GL_UNIFORM_BUFFER, 0);
-                    }
+                    SNOW_CORE_TRACE("Created Uniform buffer {0} at binding point {1}, size is {2} bytes", buffer.Name, buffer.BindingPoint, buffer.Size);
                 }
 
-                int32_t sampler = 0;
                 for (const spirv_cross::Resource& resource : res.sampled_images) {
-                    const auto& resourceType = compiler.get_type(resource.type_id);
-                    auto binding = compiler.get_decoration(resource.id, spv::DecorationBinding);
-                    const auto& name = resource.name;
-
-                    int location = compiler.get_decoration(resource.id, spv::DecorationLocation);
-
-                    int arrayCount = 0;
-                    int* samplers;
-                    if (resourceType.array.size() == 1) {
-                        arrayCount = resourceType.array[0];
-                        samplers = new int[arrayCount];
-
-                        for (uint32_t i = 0; i < arrayCount; i++) {
+                    ShaderResource shaderResource = ShaderCompiler::ReflectResource(compiler, resource, m_ShaderTypes[shaderTypeIndex]);
+                    m_Resources[resource.name] = shaderResource;
+
+                    // Sampler arrays take consecutive texture units from their binding
+                    uint32_t binding = shaderResource.GetRegister();
+                    uint32_t arrayCount = shaderResource.GetCount();
+                    if (arrayCount > 1) {
+                        std::vector<int> samplers(arrayCount);
+                        for (uint32_t i = 0; i < arrayCount; i++)
                             samplers[i] = binding + i;
-                        }
+                        SetUniformIntArray(resource.name, samplers.data(), arrayCount);
+                    }
+                    else if (arrayCount == 1) {
+                        SetUniform(resource.name, (int)binding);
                     }
-                    else if (resourceType.array.size() == 0)
-                        arrayCount = 1;
-
-
-
-
-
-                    m_Resources[name] = ShaderResource(name, m_ShaderTypes[shaderTypeIndex], Render::ResourceType::Texture2D, binding, arrayCount);
-                    if (arrayCount > 1)
-                        SetUniformIntArray(name, samplers, arrayCount);
-                    else if (arrayCount == 1)
-                        SetUniform(name, binding);
-
-                    //SNOW_CORE_INFO("   Binding resource {0}, at location {1}", name, location);
-
-
                 }
 
                 //SNOW_CORE_INFO("=======================");
@@ -566,22 +519,6 @@ namespace Snow {
             }
         }
 
-        std::string OpenGLShader::ReadShaderFromFile(const std::string& path) {
-            std::string result;
-            std::ifstream inFile(path, std::ios::in | std::ios::binary);
-            if(inFile.is_open()) {
-                inFile.seekg(0, std::ios::end);
-                result.resize(inFile.tellg());
-                inFile.seekg(0, std::ios::beg);
-                inFile.read(&result[0], result.size());
-            }
-            else {
-                SNOW_CORE_ERROR("Could not read file. (Path):{0}", path);
-            }
-            inFile.close();
-            return result;
-        }
-
         GLenum OpenGLShader::GetShaderType(ShaderType type) {
             switch(type) {
             case ShaderType::Vertex:    return GL_VERTEX_SHADER;
@@ -590,26 +527,8 @@ namespace Snow {
             }
         }
 
-        ShaderType OpenGLShader::ShaderTypeFromString(const std::string& type) {
-            if (type == "vertex")
-                return ShaderType::Vertex;
-            if (type == "fragment" || type == "pixel")
-                return ShaderType::Pixel;
-            if (type == "compute")
-                return ShaderType::Compute;
-        }
-
-        std::string OpenGLShader::ShaderTypeToString(ShaderType type) {
-            switch (type) {
-            case ShaderType::Vertex:    return "vertex";
-            case ShaderType::Pixel:    return "pixel";
-            case ShaderType::Compute:    return "compute";
-            case ShaderType::Geometry:    return "geometry";
-            }
-        }
-
-        uint32_t OpenGLShader::GetUniformLocation(const std::string& name) {
-            GLint GLlocation = glGetUniformLocation(m_RendererID, name.c_str());
+        uint32_t OpenGLShader::GetUniformLocation(uint32_t program, const std::string& name) {
+            GLint GLlocation = glGetUniformLocation(program, name.c_str());
 
             if (GLlocation == -1) {
                 SNOW_CORE_WARN("Uniform {0} could not be found in current pipeline", name);
@@ -617,58 +536,85 @@ namespace Snow {
             return (uint32_t)GLlocation;
         }
 
+        // Uniforms are set on the program directly, it does not have to be bound when the command runs
         void OpenGLShader::SetUniform(const std::string& name, int value) {
-            glUniform1i(GetUniformLocation(name), value);
+            Renderer::Submit([program = m_RendererID, name, value]() {
+                glProgramUniform1i(program, GetUniformLocation(program, name), value);
+            });
         }
 
         void OpenGLShader::SetUniform(const std::string& name, uint32_t value) {
-            glUniform1ui(GetUniformLocation(name), value);
+            Renderer::Submit([program = m_RendererID, name, value]() {
+                glProgramUniform1ui(program, GetUniformLocation(program, name), value);
+            });
         }
 
         void OpenGLShader::SetUniform(const std::string& name, float value) {
-            glUniform1f(GetUniformLocation(name), value);
+            Renderer::Submit([program = m_RendererID, name, value]() {
+                glProgramUniform1f(program, GetUniformLocation(program, name), value);
+            });
         }
 
         void OpenGLShader::SetUniform(const std::string& name, const glm::vec2& value) {
-            glUniform2f(GetUniformLocation(name), value.x, value.y);
+            Renderer::Submit([program = m_RendererID, name, value]() {
+                glProgramUniform2f(program, GetUniformLocation(program, name), value.x, value.y);
+            });
         }
 
         void OpenGLShader::SetUniform(const std::string& name, const glm::vec3& value) {
-            glUniform3f(GetUniformLocation(name), value.x, value.y, value.z);
+            Renderer::Submit([program = m_RendererID, name, value]() {
+                glProgramUniform3f(program, GetUniformLocation(program, name), value.x, value.y, value.z);
+            });
         }
 
         void OpenGLShader::SetUniform(const std::string& name, const glm::vec4& value) {
-            glUniform4f(GetUniformLocation(name), value.x, value.y, value.z, value.w);
+            Renderer::Submit([program = m_RendererID, name, value]() {
+                glProgramUniform4f(program, GetUniformLocation(program, name), value.x, value.y, value.z, value.w);
+            });
         }
 
         void OpenGLShader::SetUniformIntArray(const std::string& name, int* values, uint32_t count) {
-            glUniform1iv(GetUniformLocation(name), count, values);
+            const void* commandData = Renderer::CopyCommandData(values, count * sizeof(int));
+            Renderer::Submit([program = m_RendererID, name, commandData, count]() {
+                glProgramUniform1iv(program, GetUniformLocation(program, name), count, (const GLint*)commandData);
+            });
         }
 
         void OpenGLShader::UploadUniformInt(uint32_t location, int32_t value) {
-            glUniform1i(location, value);
+            Renderer::Submit([program = m_RendererID, location, value]() {
+                glProgramUniform1i(program, location, value);
+            });
         }
 
         void OpenGLShader::UploadUniformFloat(uint32_t location, float value) {
-            glUniform1f(location, value);
+            Renderer::Submit([program = m_RendererID, location, value]() {
+                glProgramUniform1f(program, location, value);
+            });
         }
 
         void OpenGLShader::UploadUniformFloat2(uint32_t location, const glm::vec2& value) {
-            glUniform2f(location, value.x, value.y);
+            Renderer::Submit([program = m_RendererID, location, value]() {
+                glProgramUniform2f(program, location, value.x, value.y);
+            });
         }
 
         void OpenGLShader::UploadUniformFloat3(uint32_t location, const glm::vec3& value) {
-            glUniform3f(location, value.x, value.y, value.z);
+            Renderer::Submit([program = m_RendererID, location, value]() {
+                glProgramUniform3f(program, location, value.x, value.y, value.z);
+            });
         }
 
         void OpenGLShader::UploadUniformFloat4(uint32_t location, const glm::vec4& value) {
-            glUniform4f(location, value.x, value.y, value.z, value.w);
+            Renderer::Submit([program = m_RendererID, location, value]() {
+                glProgramUniform4f(program, location, value.x, value.y, value.z, value.w);
+            });
         }
 
         void OpenGLShader::UploadUniformIntArray(uint32_t location, int32_t* values, uint32_t count) {
-            glUniform1iv(location, count, values);
+            const void* commandData = Renderer::CopyCommandData(values, count * sizeof(int32_t));
+            Renderer::Submit([program = m_RendererID, location, commandData, count]() {
+                glProgramUniform1iv(program, location, count, (const GLint*)commandData);
+            });
         }
-
-
     }
 }
\ No newline at end of file
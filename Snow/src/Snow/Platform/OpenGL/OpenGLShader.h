@@ -3,6 +3,10 @@
 #include "Snow/Render/Shader/Shader.h"
 #include "Snow/Render/Shader/ShaderUniform.h"
 
+#include "Snow/Core/JobSystem.h"
+
+#include "Snow/Platform/OpenGL/OpenGLBuffer.h"
+
 #include <glad/glad.h>
 
 #include <shaderc/shaderc.hpp>
@@ -14,16 +18,25 @@ namespace Snow {
         class OpenGLShader : public Shader {
         public:
             OpenGLShader(const std::initializer_list<ShaderModule>& shaderModules);
+            ~OpenGLShader();
 
             void Bind() const override;
             void Reload() override;
 
             virtual const ShaderUniformBuffer& GetUniformBuffer(const std::string& name) const override;
-            virtual const std::unordered_map<std::string, ShaderResource>& GetResources() const override { return m_Resources; }
+            virtual const std::unordered_map<std::string, ShaderResource>& GetResources() const override;
+
+            virtual uint32_t GetUniformBufferBinding(const std::string& name) const override;
 
             virtual void SetUniformBufferData(const std::string& uniformBufferName, void* data, uint32_t size) override;
             virtual void SetUniformBufferData(uint32_t bindingPoint, void* data, uint32_t size) override;
 
+            // Starts writing uniform updates to the next region of the ring, called once the frame is submitted
+            static void NextFrame();
+
+            static constexpr uint32_t UniformRingFrameSize = 4 * 1024 * 1024;
+            static constexpr uint32_t UniformRingFrameCount = 3;
+
             uint32_t GetShaderID() const { return m_RendererID; }
 
             //const ShaderType GetType() const override { return m_Type; }
@@ -32,33 +45,31 @@ namespace Snow {
             const std::string& GetName() const override { return m_Name; }
 
             //const std::vector<uint32_t>& GetSPIRVBinaryData() const { return m_SPIRVBinaryData; }
-            //const std::vector<uint32_t>& GetGLSLBinaryData() const { return m_GLSLBinaryData; }
-            //const std::vector<std::string>& GetGLSLSourceDataString() const { return m_GLSLSourceData; }
+            //const std::vector<std::string>& GetGLSLSourceData() const { return m_GLSLSourceData; }
 
         private:
 
-            shaderc_shader_kind SnowShaderTypeToShaderC(ShaderType type);
-
             void CreateSPIRVBinaryCache(uint32_t shaderIndex);
             void CreateGLSLBinaryCache(uint32_t shaderIndex);
-            void CreateOpenGLShaderModule(uint32_t shaderIndex, bool spirvModule);
 
             void LinkShaders();
 
+            // Reflects every shader whose stages were compiling, in the order they were created. Called before
+            // anything reads what reflection fills in, the uniform buffers are shared between shaders.
+            static void FinishCompiles();
+
             void SPIRVReflection();
             void OpenGLReflection();
             void GLSLReflect();
 
             GLenum GetShaderType(ShaderType type);
-            ShaderType ShaderTypeFromString(const std::string& type);
-            std::string ShaderTypeToString(ShaderType type);
 
             void Load();
-            void PreProcess(const std::string& source);
+            // Single file shaders cache each of their stages under a path of its own
+            void SetStagePaths();
 
-            std::string ReadShaderFromFile(const std::string& path);
-
-            uint32_t GetUniformLocation(const std::string& name);
+            // Render thread
+            static uint32_t GetUniformLocation(uint32_t program, const std::string& name);
 
             void SetUniform(const std::string& name, int value);
             void SetUniform(const std::string& name, uint32_t value);
@@ -85,15 +96,20 @@ namespace Snow {
             std::vector<ShaderType> m_ShaderTypes;
 
             uint32_t m_RendererID = 0;
-            std::vector<uint32_t> m_ShaderIDs;
 
             bool m_Reloaded = false;
 
             std::vector<std::vector<uint32_t>> m_SPIRVBinaryData; // vector of uint32_t is the spirv module, vector of modules
-            std::vector<std::vector<uint32_t>> m_GLSLBinaryData; // vector of uint32_t is the glsl module, vector of those
-            std::vector<std::vector<std::string>> m_GLSLSourceData; // vector of string is the file, line by line,  vector of those
+            std::vector<std::string> m_GLSLSourceData; // OpenGL GLSL cross-compiled from each spirv module
+
+            // Stages compile on the job system, the shader is reflected once they are done
+            Core::JobCounter m_CompileJobs;
+            inline static std::vector<OpenGLShader*> m_CompilingShaders;
 
             inline static std::unordered_map<uint32_t, ShaderUniformBuffer> m_UniformBuffers;
+            inline static std::unordered_map<std::string, uint32_t> m_UniformBufferBindings;
+            // Uniform buffers are shared by every shader, so are the per-frame slices their updates are written to
+            inline static Core::Scope<OpenGLUniformBufferRing> m_UniformRing;
             std::unordered_map<std::string, ShaderBuffer> m_Buffers;
             std::unordered_map<std::string, ShaderResource> m_Resources;
             std::unordered_map<std::string, GLint> m_UniformLocations;
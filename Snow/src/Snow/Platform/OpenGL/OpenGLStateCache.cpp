@@ -0,0 +1,334 @@
+#include <spch.h>
+#include "Snow/Platform/OpenGL/OpenGLStateCache.h"
+
+#include <array>
+#include <atomic>
+#include <unordered_map>
+
+namespace Snow {
+    namespace Render {
+        static constexpr uint32_t NoObject = OpenGLStateCache::NoObject;
+        static constexpr int8_t Unknown = -1;
+
+        enum TextureTargetIndex {
+            Texture2DIndex = 0, Texture2DArrayIndex, TextureCubeIndex, Texture2DMultisampleIndex, TextureTargetCount
+        };
+
+        struct UniformBinding {
+            uint32_t Buffer = NoObject;
+            // Whole buffers are bound with a size of 0
+            uint32_t Offset = 0, Size = 0;
+        };
+
+        struct OpenGLState {
+            uint32_t Program = NoObject;
+            uint32_t VertexArray = NoObject;
+            uint32_t ArrayBuffer = NoObject;
+            uint32_t ElementArrayBuffer = NoObject;
+            uint32_t UniformBuffer = NoObject;
+            std::array<UniformBinding, OpenGLStateCache::MaxUniformBindings> UniformBindings;
+
+            uint32_t ActiveTextureUnit = NoObject;
+            std::array<std::array<uint32_t, TextureTargetCount>, OpenGLStateCache::MaxTextureUnits> Textures;
+
+            uint32_t Framebuffer = NoObject;
+
+            int8_t Blend = Unknown, DepthTest = Unknown, CullFace = Unknown;
+            uint32_t BlendSource = NoObject, BlendDestination = NoObject;
+            uint32_t CullFaceMode = NoObject;
+            std::array<int32_t, 4> Viewport = { 0, 0, -1, -1 };
+
+            OpenGLState() {
+                for (auto& unit : Textures)
+                    unit.fill(NoObject);
+            }
+        };
+
+        // Array buffer the attribute pointers of a vertex array were set up with, and the buffer generation then
+        struct VertexArrayBuffer {
+            uint32_t Buffer = NoObject;
+            uint32_t Generation = 0;
+        };
+
+        static OpenGLState s_State;
+        static std::unordered_map<uint32_t, VertexArrayBuffer> s_VertexArrayBuffers;
+        // Changes whenever a buffer is deleted, as GL hands the name out again
+        static uint32_t s_BufferGeneration = 0;
+        static RenderStateStatistics s_Stats;
+        // Read by the main thread while the render thread counts the next frame
+        static std::atomic<uint32_t> s_LastFrameCalls{ 0 };
+        static std::atomic<uint32_t> s_LastFrameSkipped{ 0 };
+
+        // Counts the call and returns whether it has to be made
+        static bool UpdateSlot(uint32_t& cached, uint32_t value) {
+            s_Stats.Calls++;
+            if (cached == value && value != NoObject) {
+                s_Stats.Skipped++;
+                return false;
+            }
+            cached = value;
+            return true;
+        }
+
+        static uint32_t* GetBufferSlot(GLenum target) {
+            switch (target) {
+            case GL_ARRAY_BUFFER:   return &s_State.ArrayBuffer;
+            case GL_ELEMENT_ARRAY_BUFFER:   return &s_State.ElementArrayBuffer;
+            case GL_UNIFORM_BUFFER:   return &s_State.UniformBuffer;
+            }
+            return nullptr;
+        }
+
+        static int GetTextureTargetIndex(GLenum target) {
+            switch (target) {
+            case GL_TEXTURE_2D:   return Texture2DIndex;
+            case GL_TEXTURE_2D_ARRAY:   return Texture2DArrayIndex;
+            case GL_TEXTURE_CUBE_MAP:   return TextureCubeIndex;
+            case GL_TEXTURE_2D_MULTISAMPLE:   return Texture2DMultisampleIndex;
+            }
+            return -1;
+        }
+
+        static int8_t* GetCapabilitySlot(GLenum capability) {
+            switch (capability) {
+            case GL_BLEND:   return &s_State.Blend;
+            case GL_DEPTH_TEST:   return &s_State.DepthTest;
+            case GL_CULL_FACE:   return &s_State.CullFace;
+            }
+            return nullptr;
+        }
+
+        void OpenGLStateCache::UseProgram(uint32_t program) {
+            if (UpdateSlot(s_State.Program, program))
+                glUseProgram(program);
+        }
+
+        void OpenGLStateCache::BindVertexArray(uint32_t vertexArray) {
+            if (UpdateSlot(s_State.VertexArray, vertexArray)) {
+                glBindVertexArray(vertexArray);
+                s_State.ElementArrayBuffer = NoObject;
+            }
+        }
+
+        void OpenGLStateCache::BindBuffer(GLenum target, uint32_t buffer) {
+            uint32_t* slot = GetBufferSlot(target);
+            if (!slot) {
+                s_Stats.Calls++;
+                glBindBuffer(target, buffer);
+                return;
+            }
+
+            if (UpdateSlot(*slot, buffer))
+                glBindBuffer(target, buffer);
+        }
+
+        uint32_t OpenGLStateCache::GetBoundBuffer(GLenum target) {
+            uint32_t* slot = GetBufferSlot(target);
+            return slot ? *slot : NoObject;
+        }
+
+        static void BindUniformBufferSlot(uint32_t bindingPoint, uint32_t buffer, uint32_t offset, uint32_t size) {
+            s_Stats.Calls++;
+            if (bindingPoint < OpenGLStateCache::MaxUniformBindings) {
+                UniformBinding& binding = s_State.UniformBindings[bindingPoint];
+                if (binding.Buffer == buffer && binding.Offset == offset && binding.Size == size && buffer != NoObject) {
+                    s_Stats.Skipped++;
+                    return;
+                }
+                binding = { buffer, offset, size };
+            }
+
+            if (size)
+                glBindBufferRange(GL_UNIFORM_BUFFER, bindingPoint, buffer, offset, size);
+            else
+                glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, buffer);
+            s_State.UniformBuffer = buffer;
+        }
+
+        void OpenGLStateCache::BindUniformBuffer(uint32_t bindingPoint, uint32_t buffer) {
+            BindUniformBufferSlot(bindingPoint, buffer, 0, 0);
+        }
+
+        void OpenGLStateCache::BindUniformBufferRange(uint32_t bindingPoint, uint32_t buffer, uint32_t offset, uint32_t size) {
+            BindUniformBufferSlot(bindingPoint, buffer, offset, size);
+        }
+
+        void OpenGLStateCache::BindTexture(uint32_t unit, GLenum target, uint32_t texture) {
+            s_Stats.Calls++;
+            int index = GetTextureTargetIndex(target);
+            bool tracked = unit < MaxTextureUnits && index >= 0;
+            if (tracked && s_State.Textures[unit][index] == texture && texture != NoObject) {
+                s_Stats.Skipped++;
+                return;
+            }
+
+            if (s_State.ActiveTextureUnit != unit) {
+                glActiveTexture(GL_TEXTURE0 + unit);
+                s_State.ActiveTextureUnit = unit;
+            }
+            glBindTexture(target, texture);
+            if (tracked)
+                s_State.Textures[unit][index] = texture;
+        }
+
+        void OpenGLStateCache::BindTexture(GLenum target, uint32_t texture) {
+            uint32_t unit = s_State.ActiveTextureUnit;
+            int index = GetTextureTargetIndex(target);
+            if (unit >= MaxTextureUnits || index < 0) {
+                s_Stats.Calls++;
+                glBindTexture(target, texture);
+                return;
+            }
+
+            if (UpdateSlot(s_State.Textures[unit][index], texture))
+                glBindTexture(target, texture);
+        }
+
+        void OpenGLStateCache::BindFramebuffer(uint32_t framebuffer) {
+            if (UpdateSlot(s_State.Framebuffer, framebuffer))
+                glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        }
+
+        void OpenGLStateCache::SetCapability(GLenum capability, bool enabled) {
+            s_Stats.Calls++;
+            int8_t* slot = GetCapabilitySlot(capability);
+            if (slot && *slot == (int8_t)enabled) {
+                s_Stats.Skipped++;
+                return;
+            }
+
+            if (slot)
+                *slot = (int8_t)enabled;
+            if (enabled)
+                glEnable(capability);
+            else
+                glDisable(capability);
+        }
+
+        void OpenGLStateCache::SetBlendFunc(GLenum source, GLenum destination) {
+            s_Stats.Calls++;
+            if (s_State.BlendSource == source && s_State.BlendDestination == destination) {
+                s_Stats.Skipped++;
+                return;
+            }
+
+            s_State.BlendSource = source;
+            s_State.BlendDestination = destination;
+            glBlendFunc(source, destination);
+        }
+
+        void OpenGLStateCache::SetCullFace(GLenum face) {
+            s_Stats.Calls++;
+            if (s_State.CullFaceMode == face) {
+                s_Stats.Skipped++;
+                return;
+            }
+
+            s_State.CullFaceMode = face;
+            glCullFace(face);
+        }
+
+        void OpenGLStateCache::SetViewport(int32_t x, int32_t y, int32_t width, int32_t height) {
+            s_Stats.Calls++;
+            std::array<int32_t, 4> viewport = { x, y, width, height };
+            if (s_State.Viewport == viewport) {
+                s_Stats.Skipped++;
+                return;
+            }
+
+            s_State.Viewport = viewport;
+            glViewport(x, y, width, height);
+        }
+
+        void OpenGLStateCache::DeleteBuffers(uint32_t count, const uint32_t* buffers) {
+            // Deleted buffers are unbound from every binding of the context, bound ranges included
+            for (uint32_t i = 0; i < count; i++) {
+                for (uint32_t* slot : { &s_State.ArrayBuffer, &s_State.ElementArrayBuffer, &s_State.UniformBuffer }) {
+                    if (*slot == buffers[i])
+                        *slot = 0;
+                }
+                for (auto& binding : s_State.UniformBindings) {
+                    if (binding.Buffer == buffers[i])
+                        binding = { 0, 0, 0 };
+                }
+            }
+            glDeleteBuffers(count, buffers);
+            s_BufferGeneration++;
+        }
+
+        void OpenGLStateCache::DeleteTextures(uint32_t count, const uint32_t* textures) {
+            for (uint32_t i = 0; i < count; i++) {
+                for (auto& unit : s_State.Textures) {
+                    for (uint32_t& texture : unit) {
+                        if (texture == textures[i])
+                            texture = 0;
+                    }
+                }
+            }
+            glDeleteTextures(count, textures);
+        }
+
+        void OpenGLStateCache::DeleteFramebuffers(uint32_t count, const uint32_t* framebuffers) {
+            for (uint32_t i = 0; i < count; i++) {
+                if (s_State.Framebuffer == framebuffers[i])
+                    s_State.Framebuffer = 0;
+            }
+            glDeleteFramebuffers(count, framebuffers);
+        }
+
+        void OpenGLStateCache::DeleteVertexArrays(uint32_t count, const uint32_t* vertexArrays) {
+            for (uint32_t i = 0; i < count; i++) {
+                if (s_State.VertexArray == vertexArrays[i]) {
+                    s_State.VertexArray = 0;
+                    s_State.ElementArrayBuffer = 0;
+                }
+                s_VertexArrayBuffers.erase(vertexArrays[i]);
+            }
+            glDeleteVertexArrays(count, vertexArrays);
+        }
+
+        void OpenGLStateCache::DeleteProgram(uint32_t program) {
+            // A current program is only flagged for deletion, its name stays taken until another one is used
+            if (s_State.Program == program)
+                s_State.Program = NoObject;
+            glDeleteProgram(program);
+        }
+
+        bool OpenGLStateCache::UpdateVertexArrayBuffer() {
+            if (s_State.VertexArray == NoObject || s_State.ArrayBuffer == NoObject)
+                return true;
+
+            VertexArrayBuffer& attribBuffer = s_VertexArrayBuffers[s_State.VertexArray];
+            if (attribBuffer.Buffer == s_State.ArrayBuffer && attribBuffer.Generation == s_BufferGeneration)
+                return false;
+
+            attribBuffer.Buffer = s_State.ArrayBuffer;
+            attribBuffer.Generation = s_BufferGeneration;
+            return true;
+        }
+
+        void OpenGLStateCache::AddCalls(uint32_t calls, bool skipped) {
+            s_Stats.Calls += calls;
+            if (skipped)
+                s_Stats.Skipped += calls;
+        }
+
+        void OpenGLStateCache::Invalidate() {
+            s_State = {};
+            s_VertexArrayBuffers.clear();
+        }
+
+        void OpenGLStateCache::NextFrame() {
+            s_LastFrameCalls = s_Stats.Calls;
+            s_LastFrameSkipped = s_Stats.Skipped;
+            s_Stats = {};
+        }
+
+        RenderStateStatistics OpenGLStateCache::GetStatistics() {
+            RenderStateStatistics stats;
+            stats.Calls = s_LastFrameCalls;
+            stats.Skipped = s_LastFrameSkipped;
+            return stats;
+        }
+    }
+}
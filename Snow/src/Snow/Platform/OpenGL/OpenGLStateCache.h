@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Snow/Render/RenderCommand.h"
+
+#include <glad/glad.h>
+
+namespace Snow {
+    namespace Render {
+        // Shadow copy of the bindings and fixed function state the OpenGL backend sets. Every bind in the backend goes
+        // through here, and calls that would set what is already current are skipped. Code changing state behind its back
+        // has to restore it or call Invalidate, the ImGui renderer restores everything it touches. Only the thread owning
+        // the context may use it, apart from GetStatistics.
+        class OpenGLStateCache {
+        public:
+            static void UseProgram(uint32_t program);
+            // Which element array buffer is bound belongs to the vertex array, it is forgotten when the vertex array changes
+            static void BindVertexArray(uint32_t vertexArray);
+
+            // GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER and GL_UNIFORM_BUFFER are tracked, other targets always bind
+            static void BindBuffer(GLenum target, uint32_t buffer);
+            // The buffer the target is known to hold, NoObject if it is not tracked or unknown
+            static uint32_t GetBoundBuffer(GLenum target);
+            // Indexed uniform buffer bindings, these also bind the buffer to GL_UNIFORM_BUFFER like GL does
+            static void BindUniformBuffer(uint32_t bindingPoint, uint32_t buffer);
+            static void BindUniformBufferRange(uint32_t bindingPoint, uint32_t buffer, uint32_t offset, uint32_t size);
+
+            // Makes unit active only when the binding has to change
+            static void BindTexture(uint32_t unit, GLenum target, uint32_t texture);
+            // Binds to whichever unit is active, for creating and uploading textures
+            static void BindTexture(GLenum target, uint32_t texture);
+            static void BindFramebuffer(uint32_t framebuffer);
+
+            // GL_BLEND, GL_DEPTH_TEST and GL_CULL_FACE are tracked, other capabilities are always set
+            static void SetCapability(GLenum capability, bool enabled);
+            static void SetBlendFunc(GLenum source, GLenum destination);
+            static void SetCullFace(GLenum face);
+            static void SetViewport(int32_t x, int32_t y, int32_t width, int32_t height);
+
+            // Objects are dropped from the cache as they are deleted, GL hands their names out again
+            static void DeleteBuffers(uint32_t count, const uint32_t* buffers);
+            static void DeleteTextures(uint32_t count, const uint32_t* textures);
+            static void DeleteFramebuffers(uint32_t count, const uint32_t* framebuffers);
+            static void DeleteVertexArrays(uint32_t count, const uint32_t* vertexArrays);
+            static void DeleteProgram(uint32_t program);
+            // Whether the attribute pointers of the bound vertex array have to be set up. They are kept in the vertex
+            // array along with the array buffer bound when they were set, so only another buffer needs them set again.
+            static bool UpdateVertexArrayBuffer();
+
+            // For callers that skip redundant calls on state they track themselves, such as vertex attribute setup
+            static void AddCalls(uint32_t calls, bool skipped);
+
+            // Forgets everything, the next call for any state goes through to GL
+            static void Invalidate();
+
+            // Starts counting a new frame, GetStatistics returns the counts of the frame that just ended
+            static void NextFrame();
+            static RenderStateStatistics GetStatistics();
+
+            static constexpr uint32_t NoObject = UINT32_MAX;
+            static constexpr uint32_t MaxTextureUnits = 32;
+            static constexpr uint32_t MaxUniformBindings = 16;
+        };
+    }
+}
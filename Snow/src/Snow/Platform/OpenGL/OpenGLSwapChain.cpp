@@ -11,7 +11,7 @@
     #include <glad/glad_glx.h>
 #endif
 
-#include "Snow/Core/Application.h"
+#include "Snow/Render/Renderer.h"
 
 namespace Snow {
     namespace Render {
@@ -22,16 +22,17 @@ namespace Snow {
 
         void OpenGLSwapChain::SwapBuffers() {
 
-            Ref<Core::Window> window = Core::Application::Get().GetWindow();
+            // Taken from the context rather than the application's window, this runs on the render thread when there is one
+            void* windowHandle = Renderer::GetContext()->GetSpecification().WindowHandle;
 #if defined(SNOW_WINDOW_WIN32)
-            auto dc = GetDC((HWND)window->GetWindowHandle());
+            auto dc = GetDC((HWND)windowHandle);
             
             ::SwapBuffers(dc);
 #elif defined(SNOW_WINDOW_GLFW)
-            glfwSwapBuffers((GLFWwindow*)window->GetWindowHandle());
+            glfwSwapBuffers((GLFWwindow*)windowHandle);
 #elif defined(SNOW_WINDOW_XLIB)
             SNOW_CORE_TRACE("BRUH");
-            glXSwapBuffers(XOpenDisplay(0), (::Window)window->GetWindowHandle());
+            glXSwapBuffers(XOpenDisplay(0), (::Window)windowHandle);
 #endif
 
 
@@ -1,9 +1,24 @@
 #include <spch.h>
 #include "Snow/Platform/OpenGL/OpenGLTexture.h"
 
+#include "Snow/Render/Renderer.h"
+
+#include "Snow/Platform/OpenGL/OpenGLNamePool.h"
+#include "Snow/Platform/OpenGL/OpenGLStateCache.h"
+
 #include <glad/glad.h>
 
-#include <stb_image.h>
+#include <glm/glm.hpp>
+
+// EXT_texture_compression_s3tc and EXT_texture_sRGB, not part of the core profile glad was generated for
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
 
 namespace Snow {
     namespace Render {
@@ -28,64 +43,142 @@ namespace Snow {
         OpenGLTexture2D::OpenGLTexture2D(API::TextureFormat format, uint32_t width, uint32_t height, API::TextureWrap wrap) :
             m_Format(format), m_Width(width), m_Height(height), m_Wrap(wrap), m_Locked(false) {
 
-            
-
-            glGenTextures(1, &m_RendererID);
-            glBindTexture(GL_TEXTURE_2D, m_RendererID);
-
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, SnowToOpenGLWrap(m_Wrap));
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, SnowToOpenGLWrap(m_Wrap));
+            m_RendererID = OpenGLNamePool::Create(OpenGLObjectType::Texture2D);
+            Renderer::Submit([rendererID = m_RendererID, glFormat = SnowToOpenGLFormat(m_Format), glWrap = SnowToOpenGLWrap(m_Wrap), width, height]() {
+                OpenGLStateCache::BindTexture(GL_TEXTURE_2D, rendererID);
 
-            glTexImage2D(GL_TEXTURE_2D, 0, SnowToOpenGLFormat(m_Format), m_Width, m_Height, 0, SnowToOpenGLFormat(m_Format), GL_UNSIGNED_BYTE, nullptr);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, glWrap);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, glWrap);
 
-            glBindTexture(GL_TEXTURE_2D, 0);
+                glTexImage2D(GL_TEXTURE_2D, 0, glFormat, width, height, 0, glFormat, GL_UNSIGNED_BYTE, nullptr);
+            });
 
             m_ImageData.Allocate(width * height * API::Texture::GetBPP(m_Format));
         }
 
         OpenGLTexture2D::OpenGLTexture2D(const std::string& path, bool srgb) :
-            m_Path(path), m_Locked(false) {
-            int width, height, channels;
-            stbi_set_flip_vertically_on_load(true);
+            OpenGLTexture2D(path, API::Image::LoadCooked(path, srgb), srgb) {}
 
-            m_ImageData.Data = stbi_load(path.c_str(), &width, &height, &channels, srgb ? STBI_rgb : STBI_rgb_alpha);
-            m_Format = channels == 4 ? API::TextureFormat::RGBA : API::TextureFormat::RGB;
+        OpenGLTexture2D::OpenGLTexture2D(const std::string& path, const API::Image& image, bool srgb) :
+            m_Path(path), m_Wrap(API::TextureWrap::Clamp), m_SRGB(srgb), m_Locked(false) {
+            m_RendererID = OpenGLNamePool::Create(OpenGLObjectType::Texture2D);
+            SetImage(image);
+        }
+
+        static GLenum SnowToOpenGLCompressedFormat(API::TextureFormat format, bool srgb) {
+            switch(format) {
+            case API::TextureFormat::BC1:   return srgb ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+            case API::TextureFormat::BC3:   return srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            case API::TextureFormat::BC5:   return GL_COMPRESSED_RG_RGTC2;
+            case API::TextureFormat::BC7:   return srgb ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;
+            case API::TextureFormat::ETC2:   return srgb ? GL_COMPRESSED_SRGB8_ETC2 : GL_COMPRESSED_RGB8_ETC2;
+            case API::TextureFormat::ETC2Alpha:   return srgb ? GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC : GL_COMPRESSED_RGBA8_ETC2_EAC;
+            }
+            return 0;
+        }
 
-            if(!m_ImageData.Data)
+        // Pixel layout of a decoded image, and the internal format it is stored with
+        static void GetImageFormats(const API::Image& image, bool srgb, GLenum& outInternalFormat, GLenum& outFormat) {
+            if (image.IsCompressed()) {
+                outInternalFormat = SnowToOpenGLCompressedFormat(image.Format, srgb);
+                outFormat = 0;
                 return;
+            }
 
-            m_Width = width;
-            m_Height = height;
+            bool alpha = image.Format == API::TextureFormat::RGBA;
+            outFormat = alpha ? GL_RGBA : GL_RGB;
+            if (srgb)
+                outInternalFormat = alpha ? GL_SRGB8_ALPHA8 : GL_SRGB8;
+            else
+                outInternalFormat = outFormat;
+        }
 
-            glGenTextures(1, &m_RendererID);
-            glBindTexture(GL_TEXTURE_2D, m_RendererID);
+        // Gives levels [first, last) no storage. They lie outside the BASE_LEVEL to MAX_LEVEL range afterwards, so their
+        // format does not affect completeness.
+        static void FreeLevels(uint32_t first, uint32_t last) {
+            for (uint32_t level = first; level < last; level++)
+                glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        }
 
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        void OpenGLTexture2D::SetImage(const API::Image& image) {
+            m_ImageVersion++;
+            m_Format = image.Format;
+            m_Width = std::max(image.Width >> image.FirstMip, 1u);
+            m_Height = std::max(image.Height >> image.FirstMip, 1u);
+
+            uint32_t freeFirst = m_ResidentMip, freeLast = m_ResidentMip < image.FirstMip ? std::min(image.FirstMip, m_MipCount) : m_ResidentMip;
+            m_MipCount = image.MipCount;
+            m_ResidentMip = image.FirstMip;
+
+            GLenum internalFormat, format;
+            GetImageFormats(image, m_SRGB, internalFormat, format);
+
+            // Precomputed chains are uploaded level by level from the first one the image holds, a lone uncompressed
+            // level gets its mips generated
+            bool generateMips = image.MipCount == 1 && !image.IsCompressed();
+
+            const void* pixels = Renderer::CopyCommandData(image.Pixels.data(), (uint32_t)image.Pixels.size());
+            Renderer::Submit([rendererID = m_RendererID, imageFormat = image.Format, compressed = image.IsCompressed(), firstMip = image.FirstMip,
+                mipCount = image.MipCount, width = m_Width, height = m_Height, internalFormat, format, generateMips, freeFirst, freeLast, pixels]() mutable {
+                OpenGLStateCache::BindTexture(GL_TEXTURE_2D, rendererID);
+                FreeLevels(freeFirst, freeLast);
+
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, firstMip);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, generateMips ? 1000 : mipCount - 1);
+
+                glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+                const uint8_t* levelPixels = (const uint8_t*)pixels;
+                for (uint32_t level = firstMip; level < mipCount; level++) {
+                    uint32_t size = API::Texture::GetImageSize(imageFormat, width, height);
+                    if (compressed)
+                        glCompressedTexImage2D(GL_TEXTURE_2D, level, internalFormat, width, height, 0, size, levelPixels);
+                    else
+                        glTexImage2D(GL_TEXTURE_2D, level, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, levelPixels);
+
+                    levelPixels += size;
+                    width = std::max(width / 2, 1u);
+                    height = std::max(height / 2, 1u);
+                }
+                glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+                if (generateMips)
+                    glGenerateMipmap(GL_TEXTURE_2D);
+            });
+        }
 
-            GLenum internalFormat = SnowToOpenGLFormat(m_Format);
-            GLenum format = srgb ? GL_SRGB8 : (SnowToOpenGLFormat(m_Format));
-            GLenum type = internalFormat == GL_RGBA16F ? GL_FLOAT : GL_UNSIGNED_BYTE;
+        void OpenGLTexture2D::EvictMips(uint32_t mip) {
+            if (mip <= m_ResidentMip || mip >= m_MipCount)
+                return;
 
-            glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, m_Width, m_Height, 0, format, type, m_ImageData.Data);
-            glGenerateMipmap(GL_TEXTURE_2D);
-            glBindTexture(GL_TEXTURE_2D, 0);
+            Renderer::Submit([rendererID = m_RendererID, residentMip = m_ResidentMip, mip]() {
+                OpenGLStateCache::BindTexture(GL_TEXTURE_2D, rendererID);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, mip);
+                FreeLevels(residentMip, mip);
+            });
 
-            stbi_image_free(m_ImageData.Data);
+            m_Width = std::max(m_Width >> (mip - m_ResidentMip), 1u);
+            m_Height = std::max(m_Height >> (mip - m_ResidentMip), 1u);
+            m_ResidentMip = mip;
         }
 
         OpenGLTexture2D::~OpenGLTexture2D() {
-            glDeleteTextures(1, &m_RendererID);
+            Renderer::Submit([rendererID = m_RendererID]() {
+                OpenGLStateCache::DeleteTextures(1, &rendererID);
+            });
         }
 
         void OpenGLTexture2D::Bind(uint32_t slot) const {
-            glActiveTexture(GL_TEXTURE0 + slot);
-            glBindTexture(GL_TEXTURE_2D, m_RendererID);
+            Renderer::Submit([rendererID = m_RendererID, slot]() {
+                OpenGLStateCache::BindTexture(slot, GL_TEXTURE_2D, rendererID);
+            });
         }
 
         void OpenGLTexture2D::ResizeBuffer(uint32_t width, uint32_t height) {
@@ -104,34 +197,210 @@ namespace Snow {
         }
 
         void OpenGLTexture2D::Unlock() {
-            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_Width, m_Height, SnowToOpenGLFormat(m_Format), GL_UNSIGNED_BYTE, m_ImageData.Data);
+            const void* data = Renderer::CopyCommandData(m_ImageData.Data, m_Width * m_Height * API::Texture::GetBPP(m_Format));
+            Renderer::Submit([rendererID = m_RendererID, glFormat = SnowToOpenGLFormat(m_Format), width = m_Width, height = m_Height, data]() {
+                OpenGLStateCache::BindTexture(GL_TEXTURE_2D, rendererID);
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, glFormat, GL_UNSIGNED_BYTE, data);
+            });
             m_Locked = false;
         }
 
         void OpenGLTexture2D::SetData(void* data, uint32_t size) {
             uint32_t bbp = SnowToOpenGLFormat(m_Format) == GL_RGBA ? 4 : 3;
             if (!(size == m_Width * m_Height * bbp)) SNOW_CORE_ERROR("Data must be entire texture");
-            glBindTexture(GL_TEXTURE_2D, m_RendererID);
-            glTexImage2D(GL_TEXTURE_2D, 0, SnowToOpenGLFormat(m_Format), m_Width, m_Height, 0, SnowToOpenGLFormat(m_Format), GL_UNSIGNED_BYTE, data);
-            glBindTexture(GL_TEXTURE_2D, 0);
+            const void* commandData = Renderer::CopyCommandData(data, size);
+            Renderer::Submit([rendererID = m_RendererID, glFormat = SnowToOpenGLFormat(m_Format), width = m_Width, height = m_Height, commandData]() {
+                OpenGLStateCache::BindTexture(GL_TEXTURE_2D, rendererID);
+                glTexImage2D(GL_TEXTURE_2D, 0, glFormat, width, height, 0, glFormat, GL_UNSIGNED_BYTE, commandData);
+            });
         }
 
-        OpenGLTextureCube::OpenGLTextureCube(const std::string& path, bool srgb) :
-            m_Path(path) {
+        // Fills the region of the image with the sampler placed at the offset, texels of the region outside of it repeat
+        // its nearest edge texel. Block compressed and other formats are decoded on the way, sRGB ones to linear values.
+        // texelFetch reads relative to the base level, so it always reads the most detailed resident one.
+        static const char* s_ConvertShaderSource = R"(
+            #version 450 core
+            layout(local_size_x = 8, local_size_y = 8) in;
+
+            layout(binding = 0) uniform sampler2D u_Source;
+            layout(binding = 0, rgba8) uniform writeonly image2D u_Target;
+            layout(location = 0) uniform ivec2 u_Offset;
+            layout(location = 1) uniform ivec4 u_Region; // xy first texel, zw one past the last
+
+            void main() {
+                ivec2 texel = u_Region.xy + ivec2(gl_GlobalInvocationID.xy);
+                if (any(greaterThanEqual(texel, u_Region.zw)))
+                    return;
+
+                ivec2 sourceTexel = clamp(texel - u_Offset, ivec2(0), textureSize(u_Source, 0) - 1);
+                imageStore(u_Target, texel, texelFetch(u_Source, sourceTexel, 0));
+            }
+        )";
+
+        // Built on the render thread the first time a copy needs it, the context frees it along with itself
+        static uint32_t GetConvertProgram() {
+            static uint32_t program = 0;
+            if (program)
+                return program;
+
+            uint32_t shader = glCreateShader(GL_COMPUTE_SHADER);
+            glShaderSource(shader, 1, &s_ConvertShaderSource, nullptr);
+            glCompileShader(shader);
+
+            program = glCreateProgram();
+            glAttachShader(program, shader);
+            glLinkProgram(program);
+            glDetachShader(program, shader);
+            glDeleteShader(shader);
+
+            GLint linked = 0;
+            glGetProgramiv(program, GL_LINK_STATUS, &linked);
+            if (!linked)
+                SNOW_CORE_ERROR("Could not build the texture conversion program");
+            return program;
+        }
 
-            int width, height, channels;
-            stbi_set_flip_vertically_on_load(true);
+        // Texels in the same format and color space are copied as is, anything else is converted by a compute pass, so
+        // the target always ends up holding what sampling the source returns. Edge texels are repeated extrude texels out
+        // from the source, clipped to the target. Both stay on the GPU, the render thread never waits for the copy.
+        static void CopyTextureImage(const Ref<API::Texture2D>& source, uint32_t target, GLenum targetType, API::TextureFormat targetFormat, bool targetSRGB,
+            uint32_t targetWidth, uint32_t targetHeight, uint32_t x, uint32_t y, uint32_t layer, uint32_t extrude) {
+            bool sourceSRGB = ((const OpenGLTexture2D*)source.Raw())->IsSRGB();
+            bool copy = source->GetFormat() == targetFormat && sourceSRGB == targetSRGB && extrude == 0;
+            if (!copy && (targetFormat != API::TextureFormat::RGBA || targetSRGB)) {
+                SNOW_CORE_ERROR("Textures can only be converted into linear RGBA textures");
+                return;
+            }
 
-            m_ImageData.Data = stbi_load(path.c_str(), &width, &height, &channels, srgb ? STBI_rgb : STBI_rgb_alpha);
-            m_Format = channels == 4 ? API::TextureFormat::RGBA : API::TextureFormat::RGB;
+            uint32_t width = source->GetWidth();
+            uint32_t height = source->GetHeight();
+            glm::ivec4 region = {
+                (int)(x > extrude ? x - extrude : 0), (int)(y > extrude ? y - extrude : 0),
+                (int)std::min<uint64_t>((uint64_t)x + width + extrude, targetWidth), (int)std::min<uint64_t>((uint64_t)y + height + extrude, targetHeight)
+            };
+
+            Renderer::Submit([sourceID = source->GetRendererID(), width, height, level = source->GetResidentMip(),
+                copy, target, targetType, x, y, layer, region]() {
+                if (copy) {
+                    glCopyImageSubData(sourceID, GL_TEXTURE_2D, level, 0, 0, 0,
+                        target, targetType, 0, x, y, layer, width, height, 1);
+                    return;
+                }
+
+                // Unlayered binding writes the one layer as a 2D image, which also covers plain 2D targets
+                OpenGLStateCache::UseProgram(GetConvertProgram());
+                OpenGLStateCache::BindTexture(0, GL_TEXTURE_2D, sourceID);
+                glBindImageTexture(0, target, 0, GL_FALSE, layer, GL_WRITE_ONLY, GL_RGBA8);
+                glUniform2i(0, x, y);
+                glUniform4i(1, region.x, region.y, region.z, region.w);
+                glDispatchCompute((region.z - region.x + 7) / 8, (region.w - region.y + 7) / 8, 1);
+                glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT);
+            });
+        }
 
-            if (!m_ImageData.Data)
+        void OpenGLTexture2D::CopyFrom(const Ref<API::Texture2D>& source, uint32_t x, uint32_t y) {
+            if (x + source->GetWidth() > m_Width || y + source->GetHeight() > m_Height) {
+                SNOW_CORE_ERROR("Texture copy does not fit into the destination texture");
                 return;
+            }
 
-            m_Width = width;
-            m_Height = height;
+            CopyTextureImage(source, m_RendererID, GL_TEXTURE_2D, m_Format, m_SRGB, m_Width, m_Height, x, y, 0, 0);
+        }
+
+        static GLenum SnowToOpenGLSizedFormat(API::TextureFormat format) {
+            switch(format) {
+            case API::TextureFormat::RGB:   return GL_RGB8;
+            case API::TextureFormat::RGBA:   return GL_RGBA8;
+            case API::TextureFormat::Float16:   return GL_RGBA16F;
+            }
+            return 0;
+        }
 
-            std::array<byte*, 6> cubeTextureData;
+        OpenGLTexture2DArray::OpenGLTexture2DArray(API::TextureFormat format, uint32_t width, uint32_t height, uint32_t layers) :
+            m_Format(format), m_Width(width), m_Height(height), m_Layers(layers) {
+            m_MipCount = 1;
+            while ((std::max(m_Width, m_Height) >> m_MipCount) > 0)
+                m_MipCount++;
+            m_RendererID = CreateStorage(m_Layers);
+        }
+
+        OpenGLTexture2DArray::~OpenGLTexture2DArray() {
+            Renderer::Submit([rendererID = m_RendererID]() {
+                OpenGLStateCache::DeleteTextures(1, &rendererID);
+            });
+        }
+
+        uint32_t OpenGLTexture2DArray::CreateStorage(uint32_t layers) const {
+            uint32_t rendererID = OpenGLNamePool::Create(OpenGLObjectType::Texture2DArray);
+            Renderer::Submit([rendererID, sizedFormat = SnowToOpenGLSizedFormat(m_Format), width = m_Width, height = m_Height, mipCount = m_MipCount, layers]() {
+                OpenGLStateCache::BindTexture(GL_TEXTURE_2D_ARRAY, rendererID);
+
+                glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+                glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+                glTexStorage3D(GL_TEXTURE_2D_ARRAY, mipCount, sizedFormat, width, height, layers);
+            });
+            return rendererID;
+        }
+
+        void OpenGLTexture2DArray::Bind(uint32_t slot) const {
+            // Layers written since the last bind are filtered down once for all of them
+            Renderer::Submit([rendererID = m_RendererID, slot, generateMips = m_MipsDirty]() {
+                if (generateMips)
+                    glGenerateTextureMipmap(rendererID);
+                OpenGLStateCache::BindTexture(slot, GL_TEXTURE_2D_ARRAY, rendererID);
+            });
+            m_MipsDirty = false;
+        }
+
+        void OpenGLTexture2DArray::SetLayer(uint32_t layer, const Ref<API::Texture2D>& source, uint32_t x, uint32_t y, uint32_t extrude) {
+            if (layer >= m_Layers || x + source->GetWidth() > m_Width || y + source->GetHeight() > m_Height) {
+                SNOW_CORE_ERROR("Texture does not fit into texture array layer {0}", layer);
+                return;
+            }
+
+            CopyTextureImage(source, m_RendererID, GL_TEXTURE_2D_ARRAY, m_Format, false, m_Width, m_Height, x, y, layer, extrude);
+            m_MipsDirty = true;
+        }
+
+        void OpenGLTexture2DArray::Resize(uint32_t layers) {
+            uint32_t rendererID = CreateStorage(layers);
+            uint32_t copyLayers = std::min(layers, m_Layers);
+            Renderer::Submit([oldRendererID = m_RendererID, rendererID, width = m_Width, height = m_Height, mipCount = m_MipCount, copyLayers]() {
+                for (uint32_t level = 0; copyLayers && level < mipCount; level++)
+                    glCopyImageSubData(oldRendererID, GL_TEXTURE_2D_ARRAY, level, 0, 0, 0,
+                        rendererID, GL_TEXTURE_2D_ARRAY, level, 0, 0, 0, std::max(width >> level, 1u), std::max(height >> level, 1u), copyLayers);
+
+                OpenGLStateCache::DeleteTextures(1, &oldRendererID);
+            });
+            m_RendererID = rendererID;
+            m_Layers = layers;
+        }
+
+        OpenGLTextureCube::OpenGLTextureCube(const std::string& path, bool srgb) :
+            OpenGLTextureCube(path, API::Image::Load(path, srgb), srgb) {}
+
+        OpenGLTextureCube::OpenGLTextureCube(const std::string& path, const API::Image& image, bool srgb) :
+            m_Path(path), m_Wrap(API::TextureWrap::Clamp), m_SRGB(srgb) {
+            m_RendererID = OpenGLNamePool::Create(OpenGLObjectType::TextureCube);
+            SetImage(image);
+        }
+
+        void OpenGLTextureCube::SetImage(const API::Image& image) {
+            if (image.IsCompressed()) {
+                SNOW_CORE_ERROR("Cube map {0} cannot be built from a block compressed image", m_Path);
+                SetImage(API::Image::White());
+                return;
+            }
+
+            m_Format = image.Format;
+            m_Width = image.Width;
+            m_Height = image.Height;
+
+            uint32_t channels = API::Texture::GetBPP(m_Format);
+            std::array<std::vector<byte>, 6> cubeTextureData;
 
             uint32_t cx = 0, cy = 0;
             uint32_t yLoop = 0, xLoop = 0;
@@ -148,6 +417,13 @@ namespace Snow {
                 yLoop = 4;
                 xLoop = 3;
             }
+            else {
+                // Not a cross, placeholders use the whole image for every face
+                cx = m_Width;
+                cy = m_Height;
+                for (auto& faceData : cubeTextureData)
+                    faceData = image.Pixels;
+            }
 
             for (uint32_t sy = 0; sy < yLoop; sy++) {
                 for (uint32_t sx = 0; sx < xLoop; sx++) {
@@ -163,62 +439,55 @@ namespace Snow {
                                 continue;
                         }
                     }
-                    size_t totalbits = (cx * cy * channels);
-                    cubeTextureData[face] = new byte[totalbits];
-                    uint32_t index = 0;
+                    cubeTextureData[face].resize(cx * cy * channels);
                     for (uint32_t y = 0; y < cy; y++) {
-                        uint32_t offset = y;
-
-                        uint32_t yp = sy * cy + offset;
+                        uint32_t yp = sy * cy + y;
                         for (uint32_t x = 0; x < cx; x++) {
-                            offset = x;
-
-                            uint32_t xp = sx * cx + offset;
+                            uint32_t xp = sx * cx + x;
                             for (uint32_t c = 0; c < channels; c++)
-                                cubeTextureData[face][(x + y * cx) * channels + c] = m_ImageData.Data[(xp + yp * m_Width) * channels + c];
+                                cubeTextureData[face][(x + y * cx) * channels + c] = image.Pixels[(xp + yp * m_Width) * channels + c];
                         }
                     }
                     face++;
                 }
             }
 
-            glGenTextures(1, &m_RendererID);
-            glBindTexture(GL_TEXTURE_CUBE_MAP, m_RendererID);
-
-            GLenum internalFormat = SnowToOpenGLFormat(m_Format);
-            GLenum format = srgb ? GL_SRGB8 : (SnowToOpenGLFormat(m_Format));
-            GLenum type = internalFormat == GL_RGBA16F ? GL_FLOAT : GL_UNSIGNED_BYTE;
-
-            glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-            glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            
-
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X, 0, internalFormat, cx, cy, 0, format, type, cubeTextureData[3]);
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_NEGATIVE_X, 0, internalFormat, cx, cy, 0, format, type, cubeTextureData[1]);
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_Y, 0, internalFormat, cx, cy, 0, format, type, cubeTextureData[0]);
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_NEGATIVE_Y, 0, internalFormat, cx, cy, 0, format, type, cubeTextureData[xLoop == 4 ? 5 : 4]);
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_Z, 0, internalFormat, cx, cy, 0, format, type, cubeTextureData[2]);
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_NEGATIVE_Z, 0, internalFormat, cx, cy, 0, format, type, cubeTextureData[xLoop == 4 ? 4 : 5]);
-
-            glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
-
-            for (uint32_t f = 0; f < 6; f++) {
-                delete[] cubeTextureData[f];
-            }
-            
-
-            stbi_image_free(m_ImageData.Data);
+            GLenum internalFormat, format;
+            GetImageFormats(image, m_SRGB, internalFormat, format);
+
+            // In GL face order: +X, -X, +Y, -Y, +Z, -Z
+            uint32_t faceSize = cx * cy * channels;
+            const uint32_t faceOrder[6] = { 3, 1, 0, xLoop == 4 ? 5u : 4u, 2, xLoop == 4 ? 4u : 5u };
+            std::array<const void*, 6> faces;
+            for (uint32_t i = 0; i < 6; i++)
+                faces[i] = Renderer::CopyCommandData(cubeTextureData[faceOrder[i]].data(), faceSize);
+
+            Renderer::Submit([rendererID = m_RendererID, internalFormat, format, cx, cy, faces]() {
+                OpenGLStateCache::BindTexture(GL_TEXTURE_CUBE_MAP, rendererID);
+
+                glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+                glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+                glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+                for (uint32_t i = 0; i < 6; i++)
+                    glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, internalFormat, cx, cy, 0, format, GL_UNSIGNED_BYTE, faces[i]);
+                glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+                glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+            });
         }
 
         OpenGLTextureCube::~OpenGLTextureCube() {
-            glDeleteTextures(1, &m_RendererID);
+            Renderer::Submit([rendererID = m_RendererID]() {
+                OpenGLStateCache::DeleteTextures(1, &rendererID);
+            });
         }
 
         void OpenGLTextureCube::Bind(uint32_t slot) const {
-            glActiveTexture(GL_TEXTURE0 + slot);
-            glBindTexture(GL_TEXTURE_CUBE_MAP, m_RendererID);
+            Renderer::Submit([rendererID = m_RendererID, slot]() {
+                OpenGLStateCache::BindTexture(slot, GL_TEXTURE_CUBE_MAP, rendererID);
+            });
         }
     }
 }
\ No newline at end of file
@@ -9,8 +9,11 @@ namespace Snow {
         public:
             OpenGLTexture2D(API::TextureFormat format, uint32_t width, uint32_t height, API::TextureWrap wrap);
             OpenGLTexture2D(const std::string& path, bool srgb);
+            OpenGLTexture2D(const std::string& path, const API::Image& image, bool srgb);
             virtual ~OpenGLTexture2D();
 
+            void SetImage(const API::Image& image) override;
+
             void Bind(uint32_t slot) const override;
             void ResizeBuffer(uint32_t width, uint32_t height) override;
             Buffer GetWriteableBuffer() override;
@@ -19,37 +22,80 @@ namespace Snow {
             void Unlock() override;
 
             void SetData(void* data, uint32_t size) override;
+            void CopyFrom(const Ref<API::Texture2D>& source, uint32_t x, uint32_t y) override;
 
             API::TextureFormat GetFormat() const override { return m_Format; }
             uint32_t GetWidth() const override { return m_Width; }
             uint32_t GetHeight() const override { return m_Height; }
 
+            uint32_t GetMipCount() const override { return m_MipCount; }
+            uint32_t GetResidentMip() const override { return m_ResidentMip; }
+            void EvictMips(uint32_t mip) override;
+
             const std::string& GetPath() const override { return m_Path; }
 
             uint32_t GetRendererID() const override { return m_RendererID; }
 
+            // Sampling decodes the texels to linear values
+            bool IsSRGB() const { return m_SRGB; }
+
         private:
             uint32_t m_RendererID;
             API::TextureFormat m_Format;
             API::TextureWrap m_Wrap;
             uint32_t m_Width, m_Height;
+            uint32_t m_MipCount = 1;
+            uint32_t m_ResidentMip = 0;
 
             std::string m_Path;
 
             Buffer m_ImageData;
 
+            bool m_SRGB = false;
             bool m_Locked;
 
         };
 
+        class OpenGLTexture2DArray : public API::Texture2DArray {
+        public:
+            OpenGLTexture2DArray(API::TextureFormat format, uint32_t width, uint32_t height, uint32_t layers);
+            virtual ~OpenGLTexture2DArray();
+
+            void Bind(uint32_t slot) const override;
+
+            void SetLayer(uint32_t layer, const Ref<API::Texture2D>& source, uint32_t x, uint32_t y, uint32_t extrude = 0) override;
+            void Resize(uint32_t layers) override;
+
+            API::TextureFormat GetFormat() const override { return m_Format; }
+            uint32_t GetWidth() const override { return m_Width; }
+            uint32_t GetHeight() const override { return m_Height; }
+            uint32_t GetLayerCount() const override { return m_Layers; }
+
+            uint32_t GetRendererID() const { return m_RendererID; }
+
+        private:
+            uint32_t CreateStorage(uint32_t layers) const;
+
+            uint32_t m_RendererID;
+            API::TextureFormat m_Format;
+            uint32_t m_Width, m_Height;
+            uint32_t m_Layers;
+            uint32_t m_MipCount;
+            // Set by SetLayer, the mip chain is rebuilt on the next Bind
+            mutable bool m_MipsDirty = false;
+        };
+
         class OpenGLTextureCube : public API::TextureCube {
         public:
             OpenGLTextureCube(const std::string& path, bool srgb);
+            OpenGLTextureCube(const std::string& path, const API::Image& image, bool srgb);
 
             uint32_t GetRendererID() const { return m_RendererID; }
 
             virtual ~OpenGLTextureCube();
 
+            void SetImage(const API::Image& image) override;
+
             void Bind(uint32_t slot) const override;
 
             API::TextureFormat GetFormat() const override { return m_Format; }
@@ -66,7 +112,7 @@ namespace Snow {
 
             std::string m_Path;
 
-            Buffer m_ImageData;
+            bool m_SRGB = false;
         };
     }
 }
\ No newline at end of file
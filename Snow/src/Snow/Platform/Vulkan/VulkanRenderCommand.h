@@ -11,6 +11,7 @@ namespace Snow {
             VulkanRenderCommand();
 
             virtual void DrawIndexed(uint32_t indexCount, PrimitiveType type) override {}
+            virtual void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, PrimitiveType type, uint32_t baseInstance) override {}
 
             virtual void SetViewport(uint32_t width, uint32_t height) override;
 
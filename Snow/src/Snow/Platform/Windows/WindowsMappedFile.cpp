@@ -0,0 +1,45 @@
+#include <spch.h>
+
+#include "Snow/Utils/MappedFile.h"
+
+#include <Windows.h>
+
+namespace Snow {
+	namespace Utils {
+		MappedFile::MappedFile(const std::string& filepath) {
+			HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (file == INVALID_HANDLE_VALUE) {
+				// Missing files are an expected answer for callers probing caches or optional sources
+				DWORD error = GetLastError();
+				if (error != ERROR_FILE_NOT_FOUND && error != ERROR_PATH_NOT_FOUND)
+					SNOW_CORE_ERROR("Could not open file {0}", filepath);
+				return;
+			}
+			m_FileHandle = file;
+
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+				return;
+
+			HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (!mapping) {
+				SNOW_CORE_ERROR("Could not map file {0}", filepath);
+				return;
+			}
+			m_MappingHandle = mapping;
+
+			m_Data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			if (m_Data)
+				m_Size = (uint64_t)size.QuadPart;
+		}
+
+		MappedFile::~MappedFile() {
+			if (m_Data)
+				UnmapViewOfFile(m_Data);
+			if (m_MappingHandle)
+				CloseHandle((HANDLE)m_MappingHandle);
+			if (m_FileHandle)
+				CloseHandle((HANDLE)m_FileHandle);
+		}
+	}
+}
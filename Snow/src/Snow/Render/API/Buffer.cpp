@@ -4,6 +4,7 @@
 #include "Snow/Render/Renderer.h"
 
 #include "Snow/Platform/OpenGL/OpenGLBuffer.h"
+#include "Snow/Platform/Null/NullBuffer.h"
 
 #if defined(SNOW_PLATFORM_WINDOWS)
     #include "Snow/Platform/DirectX11/DirectXBuffer.h"
@@ -15,6 +16,7 @@ namespace Snow {
             Ref<VertexBuffer> VertexBuffer::Create(void* data, uint32_t size) {
                 switch(Renderer::GetRenderAPI()) {
                     case RenderAPIType::OpenGL: return Ref<OpenGLVertexBuffer>::Create(data, size);
+                    case RenderAPIType::Null:   return Ref<NullVertexBuffer>::Create(data, size);
 #if defined(SNOW_PLATFORM_WINDOWS)
                     case RenderAPIType::DirectX:    return Ref<DirectX11VertexBuffer>::Create(data, size);
 #endif
@@ -22,9 +24,27 @@ namespace Snow {
                 return nullptr;
             }
 
+            Ref<StreamingVertexBuffer> StreamingVertexBuffer::Create(uint32_t frameSize, uint32_t frameCount) {
+                switch(Renderer::GetRenderAPI()) {
+                    case RenderAPIType::OpenGL: return Ref<OpenGLStreamingVertexBuffer>::Create(frameSize, frameCount);
+                    case RenderAPIType::Null:   return Ref<NullStreamingVertexBuffer>::Create(frameSize, frameCount);
+                }
+                SNOW_CORE_ERROR("Streaming vertex buffers are not supported by this render API");
+                return nullptr;
+            }
+
+            Ref<UniformBuffer> UniformBuffer::Create(uint32_t size) {
+                switch(Renderer::GetRenderAPI()) {
+                    case RenderAPIType::OpenGL: return Ref<OpenGLUniformBuffer>::Create(size);
+                    case RenderAPIType::Null:   return Ref<NullUniformBuffer>::Create(size);
+                }
+                return nullptr;
+            }
+
             Ref<IndexBuffer> IndexBuffer::Create(void* data, uint32_t size) {
                 switch(Renderer::GetRenderAPI()) {
                     case RenderAPIType::OpenGL: return Ref<OpenGLIndexBuffer>::Create(data, size);
+                    case RenderAPIType::Null:   return Ref<NullIndexBuffer>::Create(data, size);
 #if defined(SNOW_PLATFORM_WINDOWS)
                     case RenderAPIType::DirectX:    return Ref<DirectX11IndexBuffer>::Create(data, size);
 #endif
@@ -20,6 +20,43 @@ namespace Snow {
 
 
 
+            // Ring of per-frame regions that stays mapped for the lifetime of the buffer.
+            // Callers write vertex data straight into the returned memory and commit what they used.
+            class StreamingVertexBuffer : public RefCounted {
+            public:
+                virtual ~StreamingVertexBuffer() = default;
+
+                virtual void Bind() const = 0;
+
+                // Returns the unused remainder of the current frame region, aligned to stride. maxElements
+                // receives how many elements of that stride still fit
+                virtual void* Map(uint32_t stride, uint32_t& maxElements) = 0;
+                // Marks count elements written since the last Map as used, returns the index of the first one
+                virtual uint32_t Commit(uint32_t count) = 0;
+
+                // Fences the current region and moves on to the next, waiting only if the GPU still reads it
+                virtual void NextFrame() = 0;
+                // Reallocates every region with a new size, anything not yet committed is lost
+                virtual void Resize(uint32_t frameSize) = 0;
+
+                virtual uint32_t GetFrameSize() const = 0;
+
+                static Ref<StreamingVertexBuffer> Create(uint32_t frameSize, uint32_t frameCount = 3);
+            };
+
+            // Uniform data that stays the same over many frames, such as a material's values. It is only uploaded when
+            // SetData is called and bound as is afterwards.
+            class UniformBuffer : public RefCounted {
+            public:
+                virtual ~UniformBuffer() = default;
+
+                virtual void Bind(uint32_t bindingPoint) const = 0;
+
+                virtual void SetData(const void* data, uint32_t size) = 0;
+
+                static Ref<UniformBuffer> Create(uint32_t size);
+            };
+
             class IndexBuffer : public RefCounted {
             public:
                 virtual ~IndexBuffer() = default;
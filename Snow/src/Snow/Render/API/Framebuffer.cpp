@@ -4,6 +4,7 @@
 #include "Snow/Render/Renderer.h"
 
 #include "Snow/Platform/OpenGL/OpenGLFramebuffer.h"
+#include "Snow/Platform/Null/NullFramebuffer.h"
 
 #if defined SNOW_PLATFORM_WINDOWS
 	#include "Snow/Platform/DirectX11/DirectXFramebuffer.h"
@@ -18,6 +19,7 @@ namespace Snow {
 			switch (Renderer::GetRenderAPI()) {
 			case RenderAPIType::None:	return nullptr;
 			case RenderAPIType::OpenGL:	result = Ref<OpenGLFramebuffer>::Create(spec); break;
+			case RenderAPIType::Null:	result = Ref<NullFramebuffer>::Create(spec); break;
 #if defined SNOW_PLATFORM_WINDOWS
 			case RenderAPIType::DirectX:	result = Ref<DirectX11Framebuffer>::Create(spec); break;
 #endif
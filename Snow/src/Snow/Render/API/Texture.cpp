@@ -2,12 +2,20 @@
 #include "Snow/Render/API/Texture.h"
 
 #include "Snow/Platform/OpenGL/OpenGLTexture.h"
+#include "Snow/Platform/Null/NullTexture.h"
 
 #if defined(SNOW_PLATFORM_WINDOWS)
 #include "Snow/Platform/DirectX11/DirectXTexture.h"
 #endif
 
 #include "Snow/Render/Renderer.h"
+#include "Snow/Render/TextureCompressor.h"
+#include "Snow/Render/TextureFile.h"
+#include "Snow/Utils/MappedFile.h"
+
+#include <stb_image.h>
+
+#include <filesystem>
 
 namespace Snow {
     namespace Render {
@@ -16,6 +24,7 @@ namespace Snow {
                 switch(Render::Renderer::GetRenderAPI()) {
                 case RenderAPIType::None:   return nullptr;
                 case RenderAPIType::OpenGL: return Ref<OpenGLTexture2D>::Create(format, width, height, wrap);
+                case RenderAPIType::Null:   return Ref<NullTexture2D>::Create(format, width, height, wrap);
 #if defined(SNOW_PLATFORM_WINDOWS)
                 case RenderAPIType::DirectX:    return Ref<DirectX11Texture2D>::Create(format, width, height, wrap);
 #endif
@@ -26,17 +35,149 @@ namespace Snow {
                 switch(Render::Renderer::GetRenderAPI()) {
                 case RenderAPIType::None:   return nullptr;
                 case RenderAPIType::OpenGL: return Ref<OpenGLTexture2D>::Create(path, srgb);
+                case RenderAPIType::Null:   return Ref<NullTexture2D>::Create(path, srgb);
 #if defined(SNOW_PLATFORM_WINDOWS)
                 case RenderAPIType::DirectX:    return Ref<DirectX11Texture2D>::Create(path, srgb);
 #endif
                 }
             }
 
+            Ref<Texture2D> Texture2D::CreatePlaceholder(const std::string& path, bool srgb) {
+                switch(Render::Renderer::GetRenderAPI()) {
+                case RenderAPIType::None:   return nullptr;
+                case RenderAPIType::OpenGL: return Ref<OpenGLTexture2D>::Create(path, Image::White(), srgb);
+                case RenderAPIType::Null:   return Ref<NullTexture2D>::Create(path, Image::White());
+#if defined(SNOW_PLATFORM_WINDOWS)
+                // DirectX11 textures cannot be refilled yet, so the file is loaded up front
+                case RenderAPIType::DirectX:    return Ref<DirectX11Texture2D>::Create(path, srgb);
+#endif
+                }
+            }
+
+            Ref<Texture2DArray> Texture2DArray::Create(TextureFormat format, uint32_t width, uint32_t height, uint32_t layers) {
+                switch (Render::Renderer::GetRenderAPI()) {
+                case RenderAPIType::None:   return nullptr;
+                case RenderAPIType::OpenGL: return Ref<OpenGLTexture2DArray>::Create(format, width, height, layers);
+                case RenderAPIType::Null:   return Ref<NullTexture2DArray>::Create(format, width, height, layers);
+                }
+                SNOW_CORE_ERROR("Texture arrays are not supported by this render API");
+                return nullptr;
+            }
+
             Ref<TextureCube> TextureCube::Create(const std::string& path, bool srgb) {
                 switch (Render::Renderer::GetRenderAPI()) {
                 case RenderAPIType::None:   return nullptr;
                 case RenderAPIType::OpenGL: return Ref<OpenGLTextureCube>::Create(path, srgb);
+                case RenderAPIType::Null:   return Ref<NullTextureCube>::Create(path, srgb);
+                }
+            }
+
+            Ref<TextureCube> TextureCube::CreatePlaceholder(const std::string& path, bool srgb) {
+                switch (Render::Renderer::GetRenderAPI()) {
+                case RenderAPIType::None:   return nullptr;
+                case RenderAPIType::OpenGL: return Ref<OpenGLTextureCube>::Create(path, Image::White(), srgb);
+                case RenderAPIType::Null:   return Ref<NullTextureCube>::Create(path, Image::White());
+                }
+            }
+
+            Image Image::Load(const std::string& path, bool srgb) {
+                std::string extension = std::filesystem::path(path).extension().string();
+                std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+                if (extension == ".ktx2" || extension == ".dds") {
+                    Image image;
+                    bool loaded = extension == ".ktx2" ? TextureFile::ReadKTX2(path, image) : TextureFile::ReadDDS(path, image);
+                    if (!loaded) {
+                        SNOW_CORE_ERROR("Could not load image {0}", path);
+                        return White();
+                    }
+                    return image;
+                }
+
+                int width, height, channels;
+                int components = srgb ? STBI_rgb : STBI_rgb_alpha;
+                stbi_uc* data = stbi_load(path.c_str(), &width, &height, &channels, components);
+                if (!data) {
+                    SNOW_CORE_ERROR("Could not load image {0}: {1}", path, stbi_failure_reason());
+                    return White();
+                }
+
+                Image image;
+                image.Width = width;
+                image.Height = height;
+                image.Format = components == STBI_rgb_alpha ? TextureFormat::RGBA : TextureFormat::RGB;
+
+                // Flipped while copying instead of through stbi_set_flip_vertically_on_load, which is global state shared by every thread
+                size_t rowSize = (size_t)width * components;
+                image.Pixels.resize(rowSize * height);
+                for (int y = 0; y < height; y++)
+                    memcpy(image.Pixels.data() + rowSize * y, data + rowSize * (height - 1 - y), rowSize);
+
+                stbi_image_free(data);
+                return image;
+            }
+
+            Image Image::LoadCooked(const std::string& path, bool srgb, uint32_t maxSize) {
+                std::string cookedPath = TextureFile::GetCookedPath(path, srgb);
+                if (cookedPath.empty())
+                    return Load(path, srgb);
+
+                Image image;
+                if (cookedPath == path) {
+                    if (TextureFile::ReadKTX2(path, image, nullptr, maxSize))
+                        return image;
+                    SNOW_CORE_ERROR("Could not load image {0}", path);
+                    return White();
                 }
+
+                // A missing source (shipped builds) hashes to 0 and trusts whatever was cooked
+                uint64_t sourceHash = Utils::HashFile(path);
+                uint64_t cookedHash = 0;
+                if (std::filesystem::exists(cookedPath) && TextureFile::ReadKTX2(cookedPath, image, &cookedHash, maxSize) && (sourceHash == 0 || cookedHash == sourceHash))
+                    return image;
+
+                image = Load(path, srgb);
+                if (sourceHash == 0)
+                    return image;
+
+                TextureFormat format = TextureCompressor::ChooseFormat(image, srgb);
+                image = TextureCompressor::Compress(image, format, srgb);
+                TextureFile::WriteKTX2(cookedPath, image, srgb, sourceHash);
+                image.DropMips(image.GetMipForSize(maxSize));
+                return image;
+            }
+
+            Image Image::White() {
+                Image image;
+                image.Width = 1;
+                image.Height = 1;
+                image.Format = TextureFormat::RGBA;
+                image.Pixels = { 0xff, 0xff, 0xff, 0xff };
+                return image;
+            }
+
+            bool Image::IsCompressed() const {
+                return Texture::GetBlockSize(Format) != 0;
+            }
+
+            uint32_t Image::GetMipForSize(uint32_t maxSize) const {
+                if (maxSize == 0)
+                    return 0;
+
+                uint32_t mip = 0;
+                while (mip + 1 < MipCount && std::max(Width >> mip, Height >> mip) > maxSize)
+                    mip++;
+                return mip;
+            }
+
+            void Image::DropMips(uint32_t mip) {
+                if (mip <= FirstMip || mip >= MipCount)
+                    return;
+
+                size_t dropped = 0;
+                for (uint32_t level = FirstMip; level < mip; level++)
+                    dropped += Texture::GetImageSize(Format, std::max(Width >> level, 1u), std::max(Height >> level, 1u));
+                Pixels.erase(Pixels.begin(), Pixels.begin() + dropped);
+                FirstMip = mip;
             }
 
             uint32_t Texture::GetBPP(TextureFormat format) {
@@ -46,6 +187,27 @@ namespace Snow {
                 }
                 return 0;
             }
+
+            uint32_t Texture::GetBlockSize(TextureFormat format) {
+                switch(format){
+                case TextureFormat::BC1:        return 8;
+                case TextureFormat::BC3:        return 16;
+                case TextureFormat::BC5:        return 16;
+                case TextureFormat::BC7:        return 16;
+                case TextureFormat::ETC2:       return 8;
+                case TextureFormat::ETC2Alpha:  return 16;
+                }
+                return 0;
+            }
+
+            uint32_t Texture::GetImageSize(TextureFormat format, uint32_t width, uint32_t height) {
+                uint32_t blockSize = GetBlockSize(format);
+                if (blockSize != 0)
+                    return ((width + 3) / 4) * ((height + 3) / 4) * blockSize;
+                if (format == TextureFormat::Float16)
+                    return width * height * 8;
+                return width * height * GetBPP(format);
+            }
         }
     }
 }
\ No newline at end of file
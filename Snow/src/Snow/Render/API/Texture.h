@@ -4,6 +4,7 @@
 #include "Snow/Core/Buffer.h"
 
 #include <string>
+#include <vector>
 
 namespace Snow {
     namespace Render {
@@ -13,7 +14,15 @@ namespace Snow {
                 None = 0,
                 RGB = 1,
                 RGBA = 2,
-                Float16 = 3
+                Float16 = 3,
+
+                // Block compressed, 4x4 texels per block
+                BC1 = 4,        // opaque RGB, 8 bytes
+                BC3 = 5,        // RGBA, 16 bytes
+                BC5 = 6,        // two channels, 16 bytes, used for normal maps
+                BC7 = 7,        // RGBA, 16 bytes
+                ETC2 = 8,       // opaque RGB, 8 bytes
+                ETC2Alpha = 9   // RGBA, 16 bytes
             };
 
             enum class TextureWrap {
@@ -22,6 +31,32 @@ namespace Snow {
                 Repeat = 2
             };
 
+            // Decoded pixels of an image file with the rows flipped bottom to top. Decoding only touches the CPU, so it can run on any thread.
+            struct Image {
+                // Levels FirstMip to MipCount - 1 back to back, largest first. A single uncompressed level gets its mips
+                // generated on upload. Width and Height are always those of level 0, even when it was not loaded.
+                std::vector<uint8_t> Pixels;
+                uint32_t Width = 0, Height = 0;
+                uint32_t MipCount = 1;
+                uint32_t FirstMip = 0;
+                TextureFormat Format = TextureFormat::RGBA;
+
+                // A file that fails to decode comes back as White so no texture is ever left without storage.
+                // .ktx2 and .dds files load with the mip chain they were saved with.
+                static Image Load(const std::string& path, bool srgb = false);
+                // Loads the block compressed copy cooked into a cached folder next to path, cooking it first when it
+                // is missing or older than path. Levels wider or taller than maxSize are left out unless it is 0.
+                static Image LoadCooked(const std::string& path, bool srgb = false, uint32_t maxSize = 0);
+                static Image White();
+
+                bool IsCompressed() const;
+
+                // Most detailed level no wider or taller than maxSize, 0 when maxSize is 0
+                uint32_t GetMipForSize(uint32_t maxSize) const;
+                // Frees the levels more detailed than mip
+                void DropMips(uint32_t mip);
+            };
+
             class Texture : public RefCounted {
             public:
                 virtual ~Texture() {}
@@ -34,12 +69,29 @@ namespace Snow {
                 virtual uint32_t GetHeight() const = 0;
 
                 static uint32_t GetBPP(TextureFormat format);
+                // Bytes per 4x4 block, 0 for formats that are not block compressed
+                static uint32_t GetBlockSize(TextureFormat format);
+                // Bytes one level of width x height takes
+                static uint32_t GetImageSize(TextureFormat format, uint32_t width, uint32_t height);
             };
 
             class Texture2D : public Texture {
             public:
                 static Ref<Texture2D> Create(TextureFormat format, uint32_t width, uint32_t height, TextureWrap wrap = TextureWrap::Clamp);
                 static Ref<Texture2D> Create(const std::string& path, bool srgb = false);
+                // Reports path but holds a single white texel until SetImage fills it in, used for files still loading
+                static Ref<Texture2D> CreatePlaceholder(const std::string& path, bool srgb = false);
+
+                // Replaces the size, format and contents, the texture keeps its identity so everything holding it sees the new image.
+                // Only the levels the image holds are resident afterwards.
+                virtual void SetImage(const Image& image) = 0;
+
+                // Levels in the texture's complete mip chain, and the most detailed one resident. GetWidth and GetHeight
+                // report the size of the resident level.
+                virtual uint32_t GetMipCount() const = 0;
+                virtual uint32_t GetResidentMip() const = 0;
+                // Frees the levels more detailed than mip
+                virtual void EvictMips(uint32_t mip) = 0;
 
                 virtual void ResizeBuffer(uint32_t width, uint32_t height) = 0;
 
@@ -47,6 +99,8 @@ namespace Snow {
                 virtual void Unlock() = 0;
 
                 virtual void SetData(void* data, uint32_t size) = 0;
+                // Copies all of source into this texture with its lower left corner at x, y
+                virtual void CopyFrom(const Ref<Texture2D>& source, uint32_t x, uint32_t y) = 0;
 
                 virtual uint32_t GetRendererID() const = 0;
 
@@ -55,14 +109,35 @@ namespace Snow {
 
                 virtual const std::string& GetPath() const = 0;
 
+                // Goes up every time SetImage replaces the contents, copies taken of the texture before are stale
+                uint32_t GetImageVersion() const { return m_ImageVersion; }
+
+            protected:
+                uint32_t m_ImageVersion = 0;
             };
 
-            class TextureCube : public Texture {
+            // Stack of equally sized layers sampled through a single binding
+            class Texture2DArray : public Texture {
             public:
-                static Ref<TextureCube> Create(const std::string& path, bool srgb = false);
+                static Ref<Texture2DArray> Create(TextureFormat format, uint32_t width, uint32_t height, uint32_t layers);
+
+                virtual uint32_t GetLayerCount() const = 0;
 
+                // Copies all of source into a layer with its lower left corner at x, y. The edge texels are repeated up to
+                // extrude texels out on every side, clipped to the layer, so filtering and mips past the edges see the
+                // edges instead of whatever is beside them. Layers hold linear values and a full mip chain.
+                virtual void SetLayer(uint32_t layer, const Ref<Texture2D>& source, uint32_t x, uint32_t y, uint32_t extrude = 0) = 0;
+                // Changes the layer count, keeping the contents of the layers that remain
+                virtual void Resize(uint32_t layers) = 0;
+            };
 
+            class TextureCube : public Texture {
+            public:
+                static Ref<TextureCube> Create(const std::string& path, bool srgb = false);
+                static Ref<TextureCube> CreatePlaceholder(const std::string& path, bool srgb = false);
 
+                // Image is a cross layout, 4x3 or 3x4 faces
+                virtual void SetImage(const Image& image) = 0;
             };
         }
     }
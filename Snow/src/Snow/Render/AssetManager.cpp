@@ -0,0 +1,266 @@
+#include <spch.h>
+#include "Snow/Render/AssetManager.h"
+
+#include "Snow/Core/JobSystem.h"
+
+#include "Snow/Render/Renderer2D.h"
+#include "Snow/Render/TextureFile.h"
+#include "Snow/Render/TextureStreamer.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+namespace Snow {
+	namespace Render {
+		// Load runs as a background job and must only touch the CPU side of the asset. Upload holds the asset's Ref and
+		// runs on the main thread. Requests are handed between threads whole, so Refs are never copied or released off
+		// the main thread.
+		struct LoadRequest {
+			std::function<void()> Load;
+			std::function<void()> Upload;
+		};
+
+		struct AssetManagerData {
+			bool Running = false;
+
+			// Main thread only. Requests wait here until fewer than MaxQueuedUploads are loading or waiting for upload.
+			std::deque<std::unique_ptr<LoadRequest>> LoadQueue;
+			uint32_t DispatchedLoads = 0;
+			Core::JobCounter LoadJobs;
+
+			std::mutex UploadMutex;
+			std::deque<std::unique_ptr<LoadRequest>> UploadQueue;
+
+			std::atomic<uint32_t> PendingCount{ 0 };
+			float UploadBudget = 2.0f;
+
+			// Main thread only. Entries whose asset has been released are pruned every PruneInterval updates.
+			std::unordered_map<AssetHandle, WeakRef<RefCounted>> Cache;
+			uint32_t UpdatesSincePrune = 0;
+			static constexpr uint32_t PruneInterval = 120;
+		};
+		static AssetManagerData s_Data;
+
+		// Hands queued requests to the job system while there is room for their results
+		static void DispatchLoads() {
+			while (!s_Data.LoadQueue.empty() && s_Data.DispatchedLoads < AssetManager::MaxQueuedUploads) {
+				LoadRequest* request = s_Data.LoadQueue.front().release();
+				s_Data.LoadQueue.pop_front();
+				s_Data.DispatchedLoads++;
+
+				Core::JobSystem::RunBackground([request]() {
+					request->Load();
+
+					std::lock_guard<std::mutex> lock(s_Data.UploadMutex);
+					s_Data.UploadQueue.emplace_back(request);
+				}, &s_Data.LoadJobs);
+			}
+		}
+
+		static void Enqueue(std::unique_ptr<LoadRequest> request) {
+			s_Data.PendingCount++;
+
+			// Before Init and after Shutdown the request completes in place
+			if (!s_Data.Running) {
+				request->Load();
+				request->Upload();
+				s_Data.PendingCount--;
+				return;
+			}
+
+			s_Data.LoadQueue.push_back(std::move(request));
+			DispatchLoads();
+		}
+
+		void AssetManager::Submit(std::function<void()> load, std::function<void()> upload) {
+			auto request = std::make_unique<LoadRequest>();
+			request->Load = std::move(load);
+			request->Upload = std::move(upload);
+			Enqueue(std::move(request));
+		}
+
+		void AssetManager::Init() {
+			s_Data.Running = true;
+		}
+
+		void AssetManager::Shutdown() {
+			s_Data.Running = false;
+			Core::JobSystem::Wait(s_Data.LoadJobs);
+
+			s_Data.LoadQueue.clear();
+			s_Data.UploadQueue.clear();
+			s_Data.DispatchedLoads = 0;
+			s_Data.PendingCount = 0;
+			s_Data.Cache.clear();
+		}
+
+		// The resident asset for handle, or nullptr if it was never loaded or has since been released
+		template<typename T>
+		static Ref<T> FindCached(AssetHandle handle) {
+			auto it = s_Data.Cache.find(handle);
+			if (it == s_Data.Cache.end())
+				return nullptr;
+
+			Ref<T> asset = it->second.Lock<T>();
+			if (!asset)
+				s_Data.Cache.erase(it);
+			return asset;
+		}
+
+		template<typename T>
+		static void AddCached(AssetHandle handle, const Ref<T>& asset) {
+			s_Data.Cache[handle] = WeakRef<RefCounted>(asset);
+		}
+
+		Ref<API::Texture2D> AssetManager::LoadTexture2D(const std::string& path, bool srgb) {
+			AssetHandle handle = GetHandle(AssetType::Texture2D, path, srgb);
+			if (Ref<API::Texture2D> cached = FindCached<API::Texture2D>(handle))
+				return cached;
+
+			Ref<API::Texture2D> texture = API::Texture2D::CreatePlaceholder(path, srgb);
+			if (!texture)
+				return nullptr;
+			AddCached(handle, texture);
+
+			auto image = std::make_shared<API::Image>();
+			auto request = std::make_unique<LoadRequest>();
+			request->Load = [image, path, srgb]() {
+				*image = API::Image::LoadCooked(path, srgb, TextureStreamer::MinResidentSize);
+			};
+			request->Upload = [image, texture, path, srgb]() mutable {
+				texture->SetImage(*image);
+				// Renderer2D copied the placeholder into a texture page, the real image has to be copied again
+				Renderer2D::ReleaseTexture(texture);
+				// Finer levels were left out and are streamed in once the texture is drawn large enough to need them
+				if (image->FirstMip > 0)
+					TextureStreamer::Register(texture, TextureFile::GetCookedPath(path, srgb), image->Width, image->Height);
+			};
+			Enqueue(std::move(request));
+
+			return texture;
+		}
+
+		Ref<API::TextureCube> AssetManager::LoadTextureCube(const std::string& path, bool srgb) {
+			AssetHandle handle = GetHandle(AssetType::TextureCube, path, srgb);
+			if (Ref<API::TextureCube> cached = FindCached<API::TextureCube>(handle))
+				return cached;
+
+			Ref<API::TextureCube> texture = API::TextureCube::CreatePlaceholder(path, srgb);
+			if (!texture)
+				return nullptr;
+			AddCached(handle, texture);
+
+			auto image = std::make_shared<API::Image>();
+			auto request = std::make_unique<LoadRequest>();
+			request->Load = [image, path, srgb]() {
+				*image = API::Image::Load(path, srgb);
+			};
+			request->Upload = [image, texture]() mutable {
+				texture->SetImage(*image);
+			};
+			Enqueue(std::move(request));
+
+			return texture;
+		}
+
+		Ref<Mesh> AssetManager::LoadMesh(const std::string& path, VertexFormat format) {
+			AssetHandle handle = GetHandle(AssetType::Mesh, path, (uint32_t)format);
+			if (Ref<Mesh> cached = FindCached<Mesh>(handle))
+				return cached;
+
+			Ref<Mesh> mesh = Ref<Mesh>::Create(path, format, true);
+			AddCached(handle, mesh);
+
+			// The renderer ignores the mesh until it is loaded, so the load job can fill it in through a plain pointer
+			Mesh* target = mesh.Raw();
+			auto request = std::make_unique<LoadRequest>();
+			request->Load = [target]() {
+				target->LoadData();
+			};
+			request->Upload = [mesh]() mutable {
+				mesh->CreateResources();
+			};
+			Enqueue(std::move(request));
+
+			return mesh;
+		}
+
+		void AssetManager::Update() {
+			if (++s_Data.UpdatesSincePrune >= AssetManagerData::PruneInterval) {
+				s_Data.UpdatesSincePrune = 0;
+				for (auto it = s_Data.Cache.begin(); it != s_Data.Cache.end();) {
+					if (it->second.IsValid())
+						++it;
+					else
+						it = s_Data.Cache.erase(it);
+				}
+			}
+
+			auto start = std::chrono::steady_clock::now();
+			while (true) {
+				std::unique_ptr<LoadRequest> request;
+				{
+					std::lock_guard<std::mutex> lock(s_Data.UploadMutex);
+					if (s_Data.UploadQueue.empty())
+						break;
+
+					request = std::move(s_Data.UploadQueue.front());
+					s_Data.UploadQueue.pop_front();
+				}
+				s_Data.DispatchedLoads--;
+
+				request->Upload();
+				s_Data.PendingCount--;
+
+				float elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+				if (elapsed >= s_Data.UploadBudget)
+					break;
+			}
+
+			DispatchLoads();
+		}
+
+		void AssetManager::SetUploadBudget(float milliseconds) {
+			s_Data.UploadBudget = milliseconds;
+		}
+
+		uint32_t AssetManager::GetPendingCount() {
+			return s_Data.PendingCount;
+		}
+
+		AssetHandle AssetManager::GetHandle(AssetType type, const std::string& path, uint32_t settings) {
+			// "assets/./a.png" and "assets\a.png" name the same file
+			std::string normalized = std::filesystem::path(path).lexically_normal().generic_string();
+
+			// FNV-1a over the type, settings and path
+			uint64_t hash = 14695981039346656037ull;
+			auto hashBytes = [&hash](const void* data, size_t size) {
+				for (size_t i = 0; i < size; i++) {
+					hash ^= ((const uint8_t*)data)[i];
+					hash *= 1099511628211ull;
+				}
+			};
+			hashBytes(&type, sizeof(AssetType));
+			hashBytes(&settings, sizeof(uint32_t));
+			hashBytes(normalized.data(), normalized.size());
+			return hash;
+		}
+
+		bool AssetManager::IsResident(AssetHandle handle) {
+			auto it = s_Data.Cache.find(handle);
+			return it != s_Data.Cache.end() && it->second.IsValid();
+		}
+
+		uint32_t AssetManager::GetResidentCount() {
+			uint32_t count = 0;
+			for (auto& [handle, asset] : s_Data.Cache)
+				count += asset.IsValid() ? 1 : 0;
+			return count;
+		}
+	}
+}
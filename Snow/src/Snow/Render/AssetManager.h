@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Snow/Core/Ref.h"
+
+#include "Snow/Render/Mesh.h"
+#include "Snow/Render/API/Texture.h"
+
+#include <functional>
+#include <string>
+
+namespace Snow {
+	namespace Render {
+		enum class AssetType : uint8_t {
+			Texture2D, TextureCube, Mesh
+		};
+
+		// Identifies an asset by type, normalized path and import settings, the same file always maps to the same handle
+		using AssetHandle = uint64_t;
+
+		// Loads assets without stalling the main thread. Files are read and decoded, and meshes cooked, as background jobs
+		// on the job system, and every Load returns a placeholder straight away, which Update fills in on the main thread
+		// once its data is ready.
+		// Loaded assets are cached weakly by handle, so loading a file that is still resident returns the same object.
+		class AssetManager {
+		public:
+			// Loads run on the job system, which has to be started first and stopped after
+			static void Init();
+			static void Shutdown();
+
+			// Single white texel until loaded
+			static Ref<API::Texture2D> LoadTexture2D(const std::string& path, bool srgb = false);
+			static Ref<API::TextureCube> LoadTextureCube(const std::string& path, bool srgb = false);
+			// Reports IsLoaded false, and is not drawn, until loaded
+			static Ref<Mesh> LoadMesh(const std::string& path, VertexFormat format = VertexFormat::Full);
+
+			// Runs load as a background job and upload on the main thread once load is done, following the same rules as the
+			// asset loads: load must only touch CPU side data and only upload may hold Refs
+			static void Submit(std::function<void()> load, std::function<void()> upload);
+
+			// Finishes decoded assets on the main thread until the upload budget for this frame is spent
+			static void Update();
+
+			// Milliseconds Update may spend on uploads each frame, at least one upload always runs
+			static void SetUploadBudget(float milliseconds);
+			// Assets requested but not yet uploaded
+			static uint32_t GetPendingCount();
+
+			// settings packs the import options, srgb for textures and the VertexFormat for meshes
+			static AssetHandle GetHandle(AssetType type, const std::string& path, uint32_t settings = 0);
+			static bool IsResident(AssetHandle handle);
+			// Cached assets that something still holds
+			static uint32_t GetResidentCount();
+
+			// Assets loading or decoded and waiting for the main thread, further requests wait to be handed to the job
+			// system so memory stays bounded
+			static constexpr uint32_t MaxQueuedUploads = 8;
+		};
+	}
+}
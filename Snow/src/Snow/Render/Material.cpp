@@ -16,9 +16,37 @@ namespace Snow {
 
 		void Material::AllocateStorage() {
 			const auto& uniformBuffer = m_Shader->GetUniformBuffer("Material");
+			m_UniformBufferBinding = m_Shader->GetUniformBufferBinding("Material");
 
 			m_UniformStorageBuffer.Allocate(uniformBuffer.Size);
 			m_UniformStorageBuffer.ZeroInitialize();
+
+			if (uniformBuffer.Uniforms.size() > MaxUniforms)
+				SNOW_CORE_WARN("Shader {0} has {1} material uniforms, the ones past {2} share one override flag", m_Shader->GetName(), uniformBuffer.Uniforms.size(), MaxUniforms - 1);
+		}
+
+		MaterialPropertyID Material::GetPropertyID(const std::string& name) const {
+			MaterialPropertyID id;
+			if (m_UniformBufferBinding != Shader::InvalidBinding) {
+				const auto& uniforms = m_Shader->GetUniformBuffer("Material").Uniforms;
+				for (uint32_t i = 0; i < uniforms.size(); i++) {
+					if (uniforms[i].GetName() != name)
+						continue;
+
+					id.Uniform = std::min(i, MaxUniforms - 1);
+					id.Offset = uniforms[i].GetOffset();
+					id.Size = uniforms[i].GetSize();
+					return id;
+				}
+			}
+
+			for (const auto& [n, resource] : m_Shader->GetResources()) {
+				if (resource.GetName() == name) {
+					id.Register = resource.GetRegister();
+					break;
+				}
+			}
+			return id;
 		}
 
 		const ShaderUniform* Material::FindUniformDecl(const std::string& name) {
@@ -45,7 +73,7 @@ namespace Snow {
 		void Material::Bind() {
 			m_Shader->Bind();
 
-			m_Shader->SetUniformBufferData("Material", m_UniformStorageBuffer.Data, m_UniformStorageBuffer.Size);
+			m_Shader->SetUniformBufferData(m_UniformBufferBinding, m_UniformStorageBuffer.Data, m_UniformStorageBuffer.Size);
 
 			BindTextures();
 		}
@@ -77,20 +105,74 @@ namespace Snow {
 
 			m_UniformStorageBuffer.Allocate(uniformBuffer.Size);
 			m_UniformStorageBuffer.ZeroInitialize();
+
+			if (m_Material->m_UniformBufferBinding != Shader::InvalidBinding && uniformBuffer.Size)
+				m_UniformBuffer = API::UniformBuffer::Create(uniformBuffer.Size);
+			m_Dirty = true;
+			m_ContentKeyDirty = true;
+		}
+
+		void MaterialInstance::OnMaterialValueUpdated(MaterialPropertyID id) {
+			if (m_OverriddenValues.test(id.Uniform))
+				return;
+
+			auto& buffer = m_UniformStorageBuffer;
+			auto& materialBuffer = m_Material->m_UniformStorageBuffer;
+			buffer.Write(materialBuffer.Data + id.Offset, id.Size, id.Offset);
+			m_Dirty = true;
+			m_ContentKeyDirty = true;
 		}
 
-		void MaterialInstance::OnMaterialValueUpdated(const ShaderUniform& uniform) {
-			if (m_OverriddenValues.find(uniform.GetName()) == m_OverriddenValues.end()) {
-				auto& buffer = m_UniformStorageBuffer;
-				auto& materialBuffer = m_Material->m_UniformStorageBuffer;
-				buffer.Write(materialBuffer.Data + uniform.GetOffset(), uniform.GetSize(), uniform.GetOffset());
+		uint64_t MaterialInstance::GetContentKey() {
+			if (!m_ContentKeyDirty)
+				return m_ContentKey;
+
+			// FNV-1a over the material, the instance's values and its texture pointers
+			uint64_t hash = 14695981039346656037ull;
+			auto hashBytes = [&hash](const void* data, size_t size) {
+				for (size_t i = 0; i < size; i++) {
+					hash ^= ((const uint8_t*)data)[i];
+					hash *= 1099511628211ull;
+				}
+			};
+			const Material* material = m_Material.Raw();
+			hashBytes(&material, sizeof(const Material*));
+			hashBytes(m_UniformStorageBuffer.Data, m_UniformStorageBuffer.Size);
+			for (auto& texture : m_Textures) {
+				const API::Texture* raw = texture.Raw();
+				hashBytes(&raw, sizeof(const API::Texture*));
 			}
+
+			m_ContentKey = hash;
+			m_ContentKeyDirty = false;
+			return m_ContentKey;
 		}
 
-		void MaterialInstance::Bind() {
-			m_Material->GetShader()->Bind();
+		bool MaterialInstance::DrawsLike(const MaterialInstance& other) const {
+			if (this == &other)
+				return true;
+
+			if (m_Material.Raw() != other.m_Material.Raw() || m_Textures.size() != other.m_Textures.size()
+				|| m_UniformStorageBuffer.Size != other.m_UniformStorageBuffer.Size)
+				return false;
 
-			m_Material->GetShader()->SetUniformBufferData("Material", m_UniformStorageBuffer.Data, m_UniformStorageBuffer.Size);
+			for (size_t i = 0; i < m_Textures.size(); i++) {
+				if (m_Textures[i].Raw() != other.m_Textures[i].Raw())
+					return false;
+			}
+			return memcmp(m_UniformStorageBuffer.Data, other.m_UniformStorageBuffer.Data, m_UniformStorageBuffer.Size) == 0;
+		}
+
+		void MaterialInstance::Bind() {
+			uint32_t binding = m_Material->m_UniformBufferBinding;
+			if (m_UniformBuffer) {
+				if (m_Dirty)
+					m_UniformBuffer->SetData(m_UniformStorageBuffer.Data, m_UniformStorageBuffer.Size);
+				m_UniformBuffer->Bind(binding);
+			}
+			else
+				m_Material->GetShader()->SetUniformBufferData(binding, m_UniformStorageBuffer.Data, m_UniformStorageBuffer.Size);
+			m_Dirty = false;
 			m_Material->BindTextures();
 
 			for (size_t i = 0; i < m_Textures.size(); i++) {
@@ -6,12 +6,29 @@
 #include "Snow/Core/Ref.h"
 
 
+#include "Snow/Render/API/Buffer.h"
 #include "Snow/Render/API/Texture.h"
 
+#include <bitset>
 #include <unordered_set>
 
 namespace Snow {
 	namespace Render {
+		// A material property looked up by name once, setting it through the ID skips the string compares. IDs stay
+		// valid for every material and instance using the shader they were resolved with.
+		struct MaterialPropertyID {
+			static constexpr uint32_t Invalid = UINT32_MAX;
+
+			// Index into the Material uniform buffer's members, and where the value sits in it
+			uint32_t Uniform = Invalid;
+			uint32_t Offset = 0, Size = 0;
+			uint32_t Register = Invalid;
+
+			bool IsUniform() const { return Uniform != Invalid; }
+			bool IsTexture() const { return Register != Invalid; }
+			bool IsValid() const { return IsUniform() || IsTexture(); }
+		};
+
 		class Material : public RefCounted {
 			friend class MaterialInstance;
 		public:
@@ -19,14 +36,26 @@ namespace Snow {
 
 			void Bind();
 
+			// Instances keep track of overridden values in a bitset. Uniforms from the last bit on share it, so
+			// overriding one of those on an instance stops the material passing on any of them.
+			static constexpr uint32_t MaxUniforms = 64;
+
+			MaterialPropertyID GetPropertyID(const std::string& name) const;
+
 			template<typename T>
-			void Set(const std::string name, const T& value) {
-				auto u = FindUniformDecl(name);
-				auto& buffer = m_UniformStorageBuffer;
-				buffer.Write((byte*)&value, u->GetSize(), u->GetOffset());
+			void Set(MaterialPropertyID id, const T& value) {
+				if (!id.IsUniform())
+					return;
+
+				m_UniformStorageBuffer.Write((byte*)&value, std::min((uint32_t)sizeof(T), id.Size), id.Offset);
 
 				for (auto mi : m_MaterialInstances)
-					mi->OnMaterialValueUpdated(*u);
+					mi->OnMaterialValueUpdated(id);
+			}
+
+			template<typename T>
+			void Set(const std::string name, const T& value) {
+				Set(GetPropertyID(name), value);
 			}
 
 			void Set(const std::string& name, const Ref<API::Texture>& texture) {
@@ -56,6 +85,12 @@ namespace Snow {
 			}
 
 			Ref<Shader> GetShader() { return m_Shader; }
+			// Indexed by texture register, unset registers are null
+			const std::vector<Ref<API::Texture>>& GetTextures() const { return m_Textures; }
+
+			// Translucent materials are drawn after opaques, back to front
+			void SetTranslucent(bool translucent) { m_Translucent = translucent; }
+			bool IsTranslucent() const { return m_Translucent; }
 
 			static Ref<Material> Create(const Ref<Shader>& shader);
 		private:
@@ -70,7 +105,10 @@ namespace Snow {
 			std::unordered_set<MaterialInstance*> m_MaterialInstances;
 
 			Buffer m_UniformStorageBuffer;
+			uint32_t m_UniformBufferBinding = Shader::InvalidBinding;
 			std::vector<Ref<API::Texture>> m_Textures;
+
+			bool m_Translucent = false;
 		};
 
 		class MaterialInstance : public RefCounted {
@@ -79,30 +117,58 @@ namespace Snow {
 			MaterialInstance(const Ref<Material>& material, const std::string& name = "");
 			virtual ~MaterialInstance();
 
+			// Uploads the values to the GPU only if they changed since the last Bind. Leaves the shader to the caller,
+			// the same instance is drawn with PBR and PBRCompact.
 			void Bind();
 
 			template<typename T>
-			void Set(const std::string& name, const T& value) {
-				auto u = m_Material->FindUniformDecl(name);
-				if (!u)
+			void Set(MaterialPropertyID id, const T& value) {
+				if (!id.IsUniform())
 					return;
 
-				auto& buffer = m_UniformStorageBuffer;
-				buffer.Write((byte*)&value, u->GetSize(), u->GetOffset());
+				m_OverriddenValues.set(id.Uniform);
+
+				// Values set again to what they already are leave the instance clean
+				uint32_t size = std::min((uint32_t)sizeof(T), id.Size);
+				byte* target = m_UniformStorageBuffer.Data + id.Offset;
+				if (memcmp(target, &value, size) == 0)
+					return;
 
-				m_OverriddenValues.insert(name);
+				memcpy(target, &value, size);
+				m_Dirty = true;
+				m_ContentKeyDirty = true;
+			}
+
+			void Set(MaterialPropertyID id, const Ref<API::Texture>& texture) {
+				if (!id.IsTexture())
+					return;
+
+				if (m_Textures.size() <= id.Register)
+					m_Textures.resize((size_t)id.Register + 1);
+				m_Textures[id.Register] = texture;
+				m_ContentKeyDirty = true;
+			}
+
+			void Set(MaterialPropertyID id, const Ref<API::Texture2D>& texture) {
+				Set(id, (const Ref<API::Texture>&)texture);
+			}
+
+			void Set(MaterialPropertyID id, const Ref<API::TextureCube>& texture) {
+				Set(id, (const Ref<API::Texture>&)texture);
+			}
+
+			template<typename T>
+			void Set(const std::string& name, const T& value) {
+				Set(m_Material->GetPropertyID(name), value);
 			}
 
 			void Set(const std::string& name, const Ref<API::Texture>& texture) {
-				auto tex = m_Material->FindResourceDecl(name);
-				if (!tex) {
+				MaterialPropertyID id = m_Material->GetPropertyID(name);
+				if (!id.IsTexture()) {
 					SNOW_CORE_WARN("Could not find material property: {0}", name);
 					return;
 				}
-				uint32_t slot = tex->GetRegister();
-				if (m_Textures.size() <= slot)
-					m_Textures.resize((size_t)slot + 1);
-				m_Textures[slot] = texture;
+				Set(id, texture);
 			}
 
 			void Set(const std::string& name, const Ref<API::Texture2D>& texture) {
@@ -132,18 +198,33 @@ namespace Snow {
 			static Ref<MaterialInstance> Create(const Ref<Material>& material);
 
 			Ref<Material> GetMaterial() { return m_Material; }
+			// Indexed by texture register, registers left to the material are null
+			const std::vector<Ref<API::Texture>>& GetTextures() const { return m_Textures; }
+
+			// Hash of the material, values and textures the instance draws with. Separate instances with the same key
+			// most likely draw the same, DrawsLike tells for certain.
+			uint64_t GetContentKey();
+			// Same material, values and textures, so draws with either can share one instanced draw
+			bool DrawsLike(const MaterialInstance& other) const;
 
 		private:
 			void AllocateStorage();
-			void OnMaterialValueUpdated(const ShaderUniform& uniform);
+			void OnMaterialValueUpdated(MaterialPropertyID id);
 
 			Ref<Material> m_Material;
 			std::string m_Name;
 
 			Buffer m_UniformStorageBuffer;
+			// The instance's own copy of its values on the GPU, null where the render API has none
+			Ref<API::UniformBuffer> m_UniformBuffer;
+			bool m_Dirty = true;
 			std::vector<Ref<API::Texture>> m_Textures;
 
-			std::unordered_set<std::string> m_OverriddenValues;
+			uint64_t m_ContentKey = 0;
+			bool m_ContentKeyDirty = true;
+
+			// Indexed by MaterialPropertyID::Uniform, values the material no longer passes on to the instance
+			std::bitset<Material::MaxUniforms> m_OverriddenValues;
 		};
 	}
 }
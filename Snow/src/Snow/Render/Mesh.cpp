@@ -9,6 +9,15 @@
 #include <assimp/LogStream.hpp>
 
 #include "Snow/Render/Renderer.h"
+#include "Snow/Render/MeshOptimizer.h"
+#include "Snow/Render/MeshSimplifier.h"
+#include "Snow/Utils/MappedFile.h"
+
+#include <glm/gtc/packing.hpp>
+
+#include <cfloat>
+#include <cstddef>
+#include <filesystem>
 
 namespace Snow {
 	namespace Render {
@@ -25,37 +34,162 @@ namespace Snow {
 			}
 		};
 
-		Mesh::Mesh(const std::string& filePath) :
-			m_Path(filePath) {
-			CreateMesh();
+		// Any change to the import flags or to Vertex/Index must bump CookedMeshVersion so old caches are rebuilt
+		static constexpr uint32_t s_ImportFlags = aiProcess_CalcTangentSpace |
+			aiProcess_Triangulate |
+			aiProcess_JoinIdenticalVertices |
+			aiProcess_SortByPType;
+
+		static constexpr uint32_t CookedMeshMagic = 0x484d4e53; // "SNMH"
+		static constexpr uint32_t CookedMeshVersion = 4;
+
+		// Laid out so the submesh, vertex and index arrays that follow it stay 4 byte aligned
+		struct CookedMeshHeader {
+			uint32_t Magic;
+			uint32_t Version;
+			uint64_t SourceHash;
+			uint64_t SourceSize;
+			int64_t SourceWriteTime;
+			uint32_t ImportFlags;
+			uint32_t VertexSize;
+			uint32_t SubmeshCount;
+			uint32_t VertexCount;
+			uint32_t TriangleCount;
+			uint32_t LODCount; // Simplified levels, each a CookedMeshLOD after the index array followed by its own indices
+			glm::vec3 BoundsMin, BoundsMax;
+			glm::vec3 SphereCenter;
+			float SphereRadius;
+		};
+
+		struct CookedMeshLOD {
+			uint32_t TriangleCount;
+			float Error;
+		};
+
+		static std::string GetCookedPath(const std::string& filePath) {
+			std::filesystem::path path = filePath;
+			return (path.parent_path() / "cached" / (path.filename().string() + ".snowmesh")).string();
 		}
 
-		void Mesh::CreateMesh() {
-			Assimp::Importer importer;
+		Mesh::Mesh(const std::string& filePath, VertexFormat format, bool deferLoad) :
+			m_Path(filePath), m_VertexFormat(format) {
+			if (deferLoad)
+				return;
+
+			LoadData();
+			CreateResources();
+		}
 
-			uint32_t flags = aiProcess_CalcTangentSpace |
-							aiProcess_Triangulate |
-							aiProcess_JoinIdenticalVertices |
-							aiProcess_SortByPType;
-			const aiScene* scene = importer.ReadFile(m_Path, flags);
+		// Writes the source's new size and write time into a cooked mesh whose contents still match it
+		static void RestampCooked(const std::string& cookedPath, uint64_t sourceSize, int64_t sourceTime) {
+			std::fstream file(cookedPath, std::ios::binary | std::ios::in | std::ios::out);
+			if (!file)
+				return;
 
-			if (!scene || !scene->HasMeshes())
-				SNOW_CORE_ERROR("Scene must have meshes!");
+			file.seekp(offsetof(CookedMeshHeader, SourceSize));
+			file.write((const char*)&sourceSize, sizeof(uint64_t));
+			file.write((const char*)&sourceTime, sizeof(int64_t));
+		}
+
+		void Mesh::LoadData() {
+			std::string cookedPath = GetCookedPath(m_Path);
+
+			// Both stay 0 for a missing source
+			std::error_code error;
+			uint64_t sourceSize = 0;
+			int64_t sourceTime = 0;
+			auto writeTime = std::filesystem::last_write_time(m_Path, error);
+			if (!error) {
+				sourceSize = std::filesystem::file_size(m_Path, error);
+				sourceTime = error ? 0 : (int64_t)writeTime.time_since_epoch().count();
+			}
+
+			bool restamp = false;
+			if (LoadCooked(cookedPath, sourceSize, sourceTime, restamp)) {
+				if (restamp)
+					RestampCooked(cookedPath, sourceSize, sourceTime);
+				return;
+			}
+
+			if (Import()) {
+				MeshOptimizer::Optimize(m_VertexData, m_IndexData, m_Submeshes);
+				ComputeBounds();
+				GenerateLODs();
+				SaveCooked(cookedPath, sourceSize, sourceTime);
+			}
+		}
+
+		void Mesh::CreateResources() {
+			m_IBO = API::IndexBuffer::Create(m_IndexData.data(), m_IndexData.size() * sizeof(Index));
+			for (auto& lod : m_LODs)
+				lod.IBO = API::IndexBuffer::Create(lod.IndexData.data(), lod.IndexData.size() * sizeof(Index));
 			
+			PipelineSpecification pipelineSpec;
+			if (m_VertexFormat == VertexFormat::Compact) {
+				// The CPU keeps full vertices for bounds and processing, only the GPU copy is compressed
+				std::vector<CompactVertex> compactVertices = CompressVertices();
+				m_VBO = API::VertexBuffer::Create(compactVertices.data(), compactVertices.size() * sizeof(CompactVertex));
+
+				pipelineSpec.Layout = {
+					{ AttribType::UShort4, "a_Position", 0, true },
+					{ AttribType::Short2, "a_Normal", 0, true },
+					{ AttribType::Short2, "a_Tangent", 0, true },
+					{ AttribType::Half2, "a_TexCoord" }
+				};
+				pipelineSpec.Shader = Renderer::GetShaderLibrary()->Get("PBRCompact");
+			}
+			else {
+				m_VBO = API::VertexBuffer::Create(m_VertexData.data(), m_VertexData.size() * sizeof(Vertex));
+
+				pipelineSpec.Layout = {
+					{ AttribType::Float3, "a_Position" },
+					{ AttribType::Float3, "a_Normal" },
+					{ AttribType::Float3, "a_Tangent" },
+					{ AttribType::Float3, "a_Bitangent" },
+					{ AttribType::Float2, "a_TexCoord" }
+				};
+				pipelineSpec.Shader = Renderer::GetShaderLibrary()->Get("PBR");
+			}
+			pipelineSpec.Type = PrimitiveType::Triangle;
+			m_Pipeline = Pipeline::Create(pipelineSpec);
+			m_MaterialInstance = Ref<MaterialInstance>::Create(Ref<Material>::Create(pipelineSpec.Shader));
+			m_Loaded = true;
+		}
+
+		bool Mesh::Import() {
+			Assimp::Importer importer;
+			const aiScene* scene = importer.ReadFile(m_Path, s_ImportFlags);
+
+			if (!scene || !scene->HasMeshes()) {
+				SNOW_CORE_ERROR("Scene must have meshes!");
+				return false;
+			}
+
 			uint32_t vertexCount = 0;
-			uint32_t indexCount = 0;
+			uint32_t triangleCount = 0;
+			for (size_t m = 0; m < scene->mNumMeshes; m++) {
+				vertexCount += scene->mMeshes[m]->mNumVertices;
+				triangleCount += scene->mMeshes[m]->mNumFaces;
+			}
+
+			m_VertexData.reserve(vertexCount);
+			m_IndexData.reserve(triangleCount);
+			m_Submeshes.reserve(scene->mNumMeshes);
 
 			for (size_t m = 0; m < scene->mNumMeshes; m++) {
 				aiMesh* mesh = scene->mMeshes[m];
 
-				vertexCount += mesh->mNumVertices;
-				indexCount += mesh->mNumFaces * 3;
-
 				SNOW_CORE_ASSERT(mesh->HasPositions());
 				SNOW_CORE_ASSERT(mesh->HasNormals());
 
+				Submesh& submesh = m_Submeshes.emplace_back();
+				submesh.BaseVertex = (uint32_t)m_VertexData.size();
+				submesh.BaseIndex = (uint32_t)m_IndexData.size() * 3;
+				submesh.VertexCount = mesh->mNumVertices;
+				submesh.IndexCount = mesh->mNumFaces * 3;
+
 				for (size_t i = 0; i < mesh->mNumVertices; i++) {
-					Vertex vertex;
+					Vertex& vertex = m_VertexData.emplace_back();
 					vertex.Position = { mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z };
 					vertex.Normal = { mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z };
 
@@ -66,37 +200,245 @@ namespace Snow {
 
 					if (mesh->HasTextureCoords(0))
 						vertex.TexCoord = { mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y };
-
-					m_VertexData.push_back(vertex);
 				}
 
+				// Every submesh shares one vertex buffer, so its indices are rebased onto its first vertex
 				for (size_t i = 0; i < mesh->mNumFaces; i++) {
-					Index index;
-					index = { mesh->mFaces[i].mIndices[0], mesh->mFaces[i].mIndices[1], mesh->mFaces[i].mIndices[2] };
-					m_IndexData.push_back(index);
+					const uint32_t* indices = mesh->mFaces[i].mIndices;
+					m_IndexData.push_back({ submesh.BaseVertex + indices[0], submesh.BaseVertex + indices[1], submesh.BaseVertex + indices[2] });
 				}
 			}
 
+			return true;
+		}
 
-			m_VBO = API::VertexBuffer::Create(m_VertexData.data(), m_VertexData.size() * sizeof(Vertex));
+		static int16_t PackSnorm16(float value) {
+			return (int16_t)std::round(glm::clamp(value, -1.0f, 1.0f) * 32767.0f);
+		}
 
-			m_IBO = API::IndexBuffer::Create(m_IndexData.data(), m_IndexData.size() * sizeof(Index));
-			
-			PipelineSpecification pipelineSpec;
-			pipelineSpec.Layout = {
-				{ AttribType::Float3, "a_Position" },
-				{ AttribType::Float3, "a_Normal" },
-				{ AttribType::Float3, "a_Tangent" },
-				{ AttribType::Float3, "a_Bitangent" },
-				{ AttribType::Float2, "a_TexCoord" }
-			};
-			pipelineSpec.Shader = Renderer::GetShaderLibrary()->Get("PBR");
-			pipelineSpec.Type = PrimitiveType::Triangle;
-			Ref<Pipeline> pipeline = Pipeline::Create(pipelineSpec);
-			m_MaterialInstance = Ref<MaterialInstance>::Create(Ref<Material>::Create(pipeline));
+		// Octahedral mapping of a unit vector onto the [-1, 1] square
+		static glm::vec2 OctahedralEncode(const glm::vec3& v) {
+			float length = std::abs(v.x) + std::abs(v.y) + std::abs(v.z);
+			if (length == 0.0f)
+				return glm::vec2(0.0f);
 
-			
+			glm::vec3 n = v / length;
+			glm::vec2 p = glm::vec2(n.x, n.y);
+			if (n.z < 0.0f) {
+				glm::vec2 signs = glm::vec2(p.x >= 0.0f ? 1.0f : -1.0f, p.y >= 0.0f ? 1.0f : -1.0f);
+				p = (1.0f - glm::abs(glm::vec2(p.y, p.x))) * signs;
+			}
+			return p;
+		}
 
+		std::vector<CompactVertex> Mesh::CompressVertices() const {
+			glm::vec3 boundsMin = m_BoundingBox.MinBounds;
+			glm::vec3 extent = m_BoundingBox.MaxBounds - m_BoundingBox.MinBounds;
+			glm::vec3 inverseExtent = glm::vec3(
+				extent.x > 0.0f ? 1.0f / extent.x : 0.0f,
+				extent.y > 0.0f ? 1.0f / extent.y : 0.0f,
+				extent.z > 0.0f ? 1.0f / extent.z : 0.0f);
+
+			std::vector<CompactVertex> compactVertices(m_VertexData.size());
+			for (size_t i = 0; i < m_VertexData.size(); i++) {
+				const Vertex& vertex = m_VertexData[i];
+				CompactVertex& compact = compactVertices[i];
+
+				glm::vec3 position = glm::clamp((vertex.Position - boundsMin) * inverseExtent, 0.0f, 1.0f);
+				bool positiveBitangent = glm::dot(glm::cross(vertex.Normal, vertex.Tangent), vertex.Bitangent) >= 0.0f;
+				compact.Position[0] = (uint16_t)std::round(position.x * 65535.0f);
+				compact.Position[1] = (uint16_t)std::round(position.y * 65535.0f);
+				compact.Position[2] = (uint16_t)std::round(position.z * 65535.0f);
+				compact.Position[3] = positiveBitangent ? 65535 : 0;
+
+				glm::vec2 normal = OctahedralEncode(vertex.Normal);
+				compact.Normal[0] = PackSnorm16(normal.x);
+				compact.Normal[1] = PackSnorm16(normal.y);
+
+				glm::vec2 tangent = OctahedralEncode(vertex.Tangent);
+				compact.Tangent[0] = PackSnorm16(tangent.x);
+				compact.Tangent[1] = PackSnorm16(tangent.y);
+
+				compact.TexCoord[0] = glm::packHalf1x16(vertex.TexCoord.x);
+				compact.TexCoord[1] = glm::packHalf1x16(vertex.TexCoord.y);
+			}
+
+			return compactVertices;
+		}
+
+		void Mesh::ComputeBounds() {
+			if (m_VertexData.empty())
+				return;
+
+			m_BoundingBox = Core::AABB(m_VertexData[0].Position, m_VertexData[0].Position);
+			for (auto& vertex : m_VertexData)
+				m_BoundingBox.Expand(vertex.Position);
+
+			// Centered on the box, the radius only has to reach the furthest vertex rather than the box corners
+			glm::vec3 center = m_BoundingBox.GetCenter();
+			float radiusSquared = 0.0f;
+			for (auto& vertex : m_VertexData) {
+				glm::vec3 offset = vertex.Position - center;
+				radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+			}
+			m_BoundingSphere = Core::BoundingSphere(center, std::sqrt(radiusSquared));
+		}
+
+		void Mesh::GenerateLODs() {
+			m_LODs.clear();
+
+			// Every level is simplified from the full mesh, so its error is measured against the imported surface
+			std::vector<std::vector<uint32_t>> levels(MaxLODCount - 1);
+			std::vector<float> errors(MaxLODCount - 1, 0.0f);
+			std::vector<uint32_t> source, simplified;
+			const uint32_t* indexData = (const uint32_t*)m_IndexData.data();
+			for (auto& submesh : m_Submeshes) {
+				source.assign(indexData + submesh.BaseIndex, indexData + submesh.BaseIndex + submesh.IndexCount);
+				for (auto& index : source)
+					index -= submesh.BaseVertex;
+
+				for (uint32_t level = 0; level < levels.size(); level++) {
+					uint32_t targetIndexCount = (submesh.IndexCount >> (level + 1)) / 3 * 3;
+					float error = MeshSimplifier::Simplify(source.data(), (uint32_t)source.size(), m_VertexData.data() + submesh.BaseVertex, submesh.VertexCount,
+						targetIndexCount, FLT_MAX, simplified);
+					MeshOptimizer::OptimizeVertexCache(simplified.data(), (uint32_t)simplified.size(), submesh.VertexCount);
+
+					errors[level] = std::max(errors[level], error);
+					for (uint32_t index : simplified)
+						levels[level].push_back(index + submesh.BaseVertex);
+				}
+			}
+
+			// Stop at the first level that barely shrank, locked borders and seams can keep small meshes from simplifying
+			uint32_t previousTriangleCount = (uint32_t)m_IndexData.size();
+			float previousError = 0.0f;
+			for (uint32_t level = 0; level < levels.size(); level++) {
+				uint32_t triangleCount = (uint32_t)levels[level].size() / 3;
+				if (triangleCount == 0 || triangleCount > previousTriangleCount * 3 / 4)
+					break;
+
+				MeshLOD& lod = m_LODs.emplace_back();
+				lod.IndexData.resize(triangleCount);
+				memcpy(lod.IndexData.data(), levels[level].data(), levels[level].size() * sizeof(uint32_t));
+				lod.Error = std::max(errors[level], previousError);
+
+				previousTriangleCount = triangleCount;
+				previousError = lod.Error;
+			}
+
+			if (!m_LODs.empty())
+				SNOW_CORE_INFO("Generated {0} LODs for {1}, {2} -> {3} triangles", m_LODs.size(), m_Path, m_IndexData.size(), m_LODs.back().IndexData.size());
+		}
+
+		uint32_t Mesh::SelectLOD(float maxError) const {
+			uint32_t lod = 0;
+			while (lod < m_LODs.size() && m_LODs[lod].Error <= maxError)
+				lod++;
+			return lod;
+		}
+
+		bool Mesh::LoadCooked(const std::string& cookedPath, uint64_t sourceSize, int64_t sourceTime, bool& restamp) {
+			if (!std::filesystem::exists(cookedPath))
+				return false;
+
+			Utils::MappedFile file(cookedPath);
+			if (!file.IsValid() || file.GetSize() < sizeof(CookedMeshHeader))
+				return false;
+
+			const CookedMeshHeader& header = *(const CookedMeshHeader*)file.GetData();
+			if (header.Magic != CookedMeshMagic || header.Version != CookedMeshVersion || header.ImportFlags != s_ImportFlags || header.VertexSize != sizeof(Vertex))
+				return false;
+
+			// A missing source (shipped builds) trusts whatever was cooked. A touched source, say by a checkout, is
+			// hashed and only rebuilt if its contents changed.
+			if (sourceTime != 0 && (header.SourceSize != sourceSize || header.SourceWriteTime != sourceTime)) {
+				if (header.SourceHash != Utils::HashFile(m_Path))
+					return false;
+				restamp = true;
+			}
+
+			uint64_t expectedSize = sizeof(CookedMeshHeader) + (uint64_t)header.SubmeshCount * sizeof(Submesh)
+				+ (uint64_t)header.VertexCount * sizeof(Vertex) + (uint64_t)header.TriangleCount * sizeof(Index);
+			if (header.LODCount >= MaxLODCount || file.GetSize() < expectedSize) {
+				SNOW_CORE_WARN("Cooked mesh {0} is truncated and will be rebuilt", cookedPath);
+				return false;
+			}
+
+			const uint8_t* data = file.GetData() + sizeof(CookedMeshHeader);
+			const Submesh* submeshes = (const Submesh*)data;
+			data += header.SubmeshCount * sizeof(Submesh);
+			const Vertex* vertices = (const Vertex*)data;
+			data += header.VertexCount * sizeof(Vertex);
+			const Index* indices = (const Index*)data;
+			data += header.TriangleCount * sizeof(Index);
+
+			const uint8_t* end = file.GetData() + file.GetSize();
+			std::vector<MeshLOD> lods(header.LODCount);
+			for (auto& lod : lods) {
+				if ((uint64_t)(end - data) < sizeof(CookedMeshLOD)) {
+					SNOW_CORE_WARN("Cooked mesh {0} is truncated and will be rebuilt", cookedPath);
+					return false;
+				}
+				const CookedMeshLOD& lodHeader = *(const CookedMeshLOD*)data;
+				data += sizeof(CookedMeshLOD);
+
+				if ((uint64_t)(end - data) < (uint64_t)lodHeader.TriangleCount * sizeof(Index)) {
+					SNOW_CORE_WARN("Cooked mesh {0} is truncated and will be rebuilt", cookedPath);
+					return false;
+				}
+				const Index* lodIndices = (const Index*)data;
+				data += lodHeader.TriangleCount * sizeof(Index);
+
+				lod.IndexData.assign(lodIndices, lodIndices + lodHeader.TriangleCount);
+				lod.Error = lodHeader.Error;
+			}
+
+			m_Submeshes.assign(submeshes, submeshes + header.SubmeshCount);
+			m_VertexData.assign(vertices, vertices + header.VertexCount);
+			m_IndexData.assign(indices, indices + header.TriangleCount);
+			m_LODs = std::move(lods);
+
+			m_BoundingBox = Core::AABB(header.BoundsMin, header.BoundsMax);
+			m_BoundingSphere = Core::BoundingSphere(header.SphereCenter, header.SphereRadius);
+			return true;
+		}
+
+		void Mesh::SaveCooked(const std::string& cookedPath, uint64_t sourceSize, int64_t sourceTime) {
+			std::error_code error;
+			std::filesystem::create_directories(std::filesystem::path(cookedPath).parent_path(), error);
+
+			std::ofstream fout(cookedPath, std::ios::binary);
+			if (!fout) {
+				SNOW_CORE_WARN("Could not write cooked mesh {0}", cookedPath);
+				return;
+			}
+
+			CookedMeshHeader header;
+			header.Magic = CookedMeshMagic;
+			header.Version = CookedMeshVersion;
+			header.SourceHash = Utils::HashFile(m_Path);
+			header.SourceSize = sourceSize;
+			header.SourceWriteTime = sourceTime;
+			header.ImportFlags = s_ImportFlags;
+			header.VertexSize = sizeof(Vertex);
+			header.SubmeshCount = (uint32_t)m_Submeshes.size();
+			header.VertexCount = (uint32_t)m_VertexData.size();
+			header.TriangleCount = (uint32_t)m_IndexData.size();
+			header.LODCount = (uint32_t)m_LODs.size();
+			header.BoundsMin = m_BoundingBox.MinBounds;
+			header.BoundsMax = m_BoundingBox.MaxBounds;
+			header.SphereCenter = m_BoundingSphere.Center;
+			header.SphereRadius = m_BoundingSphere.Radius;
+
+			fout.write((const char*)&header, sizeof(CookedMeshHeader));
+			fout.write((const char*)m_Submeshes.data(), m_Submeshes.size() * sizeof(Submesh));
+			fout.write((const char*)m_VertexData.data(), m_VertexData.size() * sizeof(Vertex));
+			fout.write((const char*)m_IndexData.data(), m_IndexData.size() * sizeof(Index));
+			for (auto& lod : m_LODs) {
+				CookedMeshLOD lodHeader = { (uint32_t)lod.IndexData.size(), lod.Error };
+				fout.write((const char*)&lodHeader, sizeof(CookedMeshLOD));
+				fout.write((const char*)lod.IndexData.data(), lod.IndexData.size() * sizeof(Index));
+			}
 		}
 
 	}
@@ -5,9 +5,13 @@
 #include <string>
 
 #include "Snow/Render/Material.h"
+#include "Snow/Render/Pipeline.h"
 
 #include "Snow/Render/API/Buffer.h"
 
+#include "Snow/Math/AABB.h"
+#include "Snow/Math/BoundingSphere.h"
+
 #include <glm/glm.hpp>
 
 namespace Snow {
@@ -24,28 +28,94 @@ namespace Snow {
 			uint32_t V1, V2, V3;
 		};
 
+		enum class VertexFormat {
+			Full,		// Vertex as is, 56 bytes
+			Compact		// CompactVertex, 20 bytes, decoded by PBRCompact.vert.glsl
+		};
+
+		struct CompactVertex {
+			uint16_t Position[4];	// xyz as unorm16 inside the mesh bounds, w is the bitangent sign (0 negative, 65535 positive)
+			int16_t Normal[2];		// Octahedral snorm16
+			int16_t Tangent[2];		// Octahedral snorm16
+			uint16_t TexCoord[2];	// Half floats
+		};
+
+		// Range of the shared vertex and index buffers imported from one source mesh
+		struct Submesh {
+			uint32_t BaseVertex;
+			uint32_t BaseIndex;
+			uint32_t VertexCount;
+			uint32_t IndexCount;
+		};
+
+		// Simplified index list over the mesh's vertex buffer
+		struct MeshLOD {
+			std::vector<Index> IndexData;
+			float Error; // Distance in mesh units the simplified surface may stray from the imported one
+			Ref<API::IndexBuffer> IBO;
+		};
+
 		class Mesh : public RefCounted {
 		public:
-			Mesh(const std::string& filePath);
+			// A deferred mesh stays empty, and is skipped by the renderer, until AssetManager loads it in the background
+			Mesh(const std::string& filePath, VertexFormat format = VertexFormat::Full, bool deferLoad = false);
 
 			const std::string& GetPath() { return m_Path; }
+			bool IsLoaded() const { return m_Loaded; }
+			VertexFormat GetVertexFormat() const { return m_VertexFormat; }
 
 			Ref<MaterialInstance> GetMaterialInstance() const { return m_MaterialInstance; }
+			Ref<Pipeline> GetPipeline() const { return m_Pipeline; }
 
 			Ref<API::VertexBuffer> GetVertexBuffer() const { return m_VBO; }
-			Ref<API::IndexBuffer> GetIndexBuffer() const { return m_IBO; }
+			Ref<API::IndexBuffer> GetIndexBuffer(uint32_t lod = 0) const { return lod == 0 ? m_IBO : m_LODs[lod - 1].IBO; }
+
+			// LOD 0 is the imported mesh, every further level has about half the triangles of the one before it
+			uint32_t GetLODCount() const { return (uint32_t)m_LODs.size() + 1; }
+			// Coarsest LOD whose simplification error stays within maxError mesh units
+			uint32_t SelectLOD(float maxError) const;
+
+			static constexpr uint32_t MaxLODCount = 4;
+
+			const std::vector<Submesh>& GetSubmeshes() const { return m_Submeshes; }
+
+			// Local space bounds of every vertex in the mesh
+			const Core::AABB& GetBoundingBox() const { return m_BoundingBox; }
+			const Core::BoundingSphere& GetBoundingSphere() const { return m_BoundingSphere; }
 		private:
-			void CreateMesh();
+			// Reads, imports and cooks the mesh on the CPU, safe to run on a worker thread
+			void LoadData();
+			// Creates the render API objects, main thread only
+			void CreateResources();
+			bool Import();
+			std::vector<CompactVertex> CompressVertices() const;
+			void ComputeBounds();
+			void GenerateLODs();
+
+			// Cooked meshes live in a cached folder beside the source, keyed on its hash and the import flags. The
+			// source's size and write time are stored too, it is only hashed again once either of them changed.
+			bool LoadCooked(const std::string& cookedPath, uint64_t sourceSize, int64_t sourceTime, bool& restamp);
+			void SaveCooked(const std::string& cookedPath, uint64_t sourceSize, int64_t sourceTime);
 
 			std::string m_Path;
+			VertexFormat m_VertexFormat;
+			bool m_Loaded = false;
 
 			Ref<MaterialInstance> m_MaterialInstance;
+			Ref<Pipeline> m_Pipeline;
 
 			Ref<API::VertexBuffer> m_VBO;
 			Ref<API::IndexBuffer> m_IBO;
 
+			Core::AABB m_BoundingBox;
+			Core::BoundingSphere m_BoundingSphere;
+
 			std::vector<Vertex> m_VertexData;
 			std::vector<Index> m_IndexData;
+			std::vector<Submesh> m_Submeshes;
+			std::vector<MeshLOD> m_LODs;
+
+			friend class AssetManager;
 		};
 	}
 }
@@ -0,0 +1,255 @@
+#include <spch.h>
+#include "Snow/Render/MeshOptimizer.h"
+
+namespace Snow {
+	namespace Render {
+		void MeshOptimizer::Optimize(std::vector<Vertex>& vertices, std::vector<Index>& indices, const std::vector<Submesh>& submeshes) {
+			uint32_t* indexData = (uint32_t*)indices.data();
+
+			float acmrBefore = 0.0f, acmrAfter = 0.0f;
+			uint32_t triangleCount = 0;
+			std::vector<uint32_t> clusters;
+			for (auto& submesh : submeshes) {
+				if (submesh.IndexCount == 0)
+					continue;
+
+				uint32_t* submeshIndices = indexData + submesh.BaseIndex;
+				Vertex* submeshVertices = vertices.data() + submesh.BaseVertex;
+
+				// The passes work on indices relative to the submesh's first vertex
+				for (uint32_t i = 0; i < submesh.IndexCount; i++)
+					submeshIndices[i] -= submesh.BaseVertex;
+
+				uint32_t triangles = submesh.IndexCount / 3;
+				acmrBefore += ComputeACMR(submeshIndices, submesh.IndexCount, submesh.VertexCount) * triangles;
+
+				clusters.clear();
+				OptimizeVertexCache(submeshIndices, submesh.IndexCount, submesh.VertexCount, &clusters);
+				OptimizeOverdraw(submeshIndices, submesh.IndexCount, submeshVertices, submesh.VertexCount, clusters);
+				OptimizeVertexFetch(submeshVertices, submesh.VertexCount, submeshIndices, submesh.IndexCount);
+
+				acmrAfter += ComputeACMR(submeshIndices, submesh.IndexCount, submesh.VertexCount) * triangles;
+				triangleCount += triangles;
+
+				for (uint32_t i = 0; i < submesh.IndexCount; i++)
+					submeshIndices[i] += submesh.BaseVertex;
+			}
+
+			if (triangleCount > 0)
+				SNOW_CORE_INFO("Mesh optimized, {0} triangles, ACMR {1:.3f} -> {2:.3f}", triangleCount, acmrBefore / triangleCount, acmrAfter / triangleCount);
+		}
+
+		float MeshOptimizer::ComputeACMR(const uint32_t* indices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize) {
+			if (indexCount < 3)
+				return 0.0f;
+
+			// A vertex is in the FIFO while fewer than cacheSize misses happened since it was loaded
+			std::vector<uint32_t> loadedAt(vertexCount, 0);
+			uint32_t misses = 0;
+			for (uint32_t i = 0; i < indexCount; i++) {
+				uint32_t vertex = indices[i];
+				if (loadedAt[vertex] == 0 || misses - loadedAt[vertex] >= cacheSize) {
+					misses++;
+					loadedAt[vertex] = misses;
+				}
+			}
+
+			return (float)misses / (indexCount / 3);
+		}
+
+		void MeshOptimizer::OptimizeVertexCache(uint32_t* indices, uint32_t indexCount, uint32_t vertexCount, std::vector<uint32_t>* outClusters) {
+			uint32_t triangleCount = indexCount / 3;
+			if (triangleCount == 0)
+				return;
+
+			// Triangles adjacent to each vertex, packed per vertex
+			std::vector<uint32_t> liveCount(vertexCount, 0);
+			for (uint32_t i = 0; i < indexCount; i++)
+				liveCount[indices[i]]++;
+
+			std::vector<uint32_t> adjacencyOffset(vertexCount + 1, 0);
+			for (uint32_t v = 0; v < vertexCount; v++)
+				adjacencyOffset[v + 1] = adjacencyOffset[v] + liveCount[v];
+
+			std::vector<uint32_t> adjacency(indexCount);
+			std::vector<uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+			for (uint32_t i = 0; i < indexCount; i++)
+				adjacency[fill[indices[i]]++] = i / 3;
+
+			std::vector<uint32_t> cacheTime(vertexCount, 0);
+			std::vector<bool> emitted(triangleCount, false);
+			std::vector<uint32_t> deadEnds;
+			std::vector<uint32_t> candidates;
+			std::vector<uint32_t> output;
+			output.reserve(indexCount);
+
+			uint32_t time = CacheSize + 1;
+			uint32_t cursor = 0;
+
+			auto skipDeadEnd = [&]() -> int64_t {
+				while (!deadEnds.empty()) {
+					uint32_t vertex = deadEnds.back();
+					deadEnds.pop_back();
+					if (liveCount[vertex] > 0)
+						return vertex;
+				}
+				for (; cursor < vertexCount; cursor++) {
+					if (liveCount[cursor] > 0)
+						return cursor;
+				}
+				return -1;
+			};
+
+			int64_t fanning = skipDeadEnd();
+			if (outClusters)
+				outClusters->push_back(0);
+
+			while (fanning >= 0) {
+				candidates.clear();
+
+				for (uint32_t a = adjacencyOffset[fanning]; a < adjacencyOffset[fanning + 1]; a++) {
+					uint32_t triangle = adjacency[a];
+					if (emitted[triangle])
+						continue;
+
+					for (uint32_t c = 0; c < 3; c++) {
+						uint32_t vertex = indices[triangle * 3 + c];
+						output.push_back(vertex);
+						deadEnds.push_back(vertex);
+						candidates.push_back(vertex);
+						liveCount[vertex]--;
+
+						if (time - cacheTime[vertex] > CacheSize) {
+							cacheTime[vertex] = time;
+							time++;
+						}
+					}
+					emitted[triangle] = true;
+				}
+
+				// Prefer the candidate that will still be in the cache after its remaining triangles are emitted
+				int64_t next = -1;
+				int64_t bestPriority = -1;
+				for (uint32_t vertex : candidates) {
+					if (liveCount[vertex] == 0)
+						continue;
+
+					int64_t priority = 0;
+					if (time - cacheTime[vertex] + 2 * liveCount[vertex] <= CacheSize)
+						priority = time - cacheTime[vertex];
+
+					if (priority > bestPriority) {
+						bestPriority = priority;
+						next = vertex;
+					}
+				}
+
+				if (next == -1) {
+					next = skipDeadEnd();
+					if (next >= 0 && outClusters && output.size() / 3 < triangleCount)
+						outClusters->push_back((uint32_t)(output.size() / 3));
+				}
+
+				fanning = next;
+			}
+
+			memcpy(indices, output.data(), output.size() * sizeof(uint32_t));
+		}
+
+		void MeshOptimizer::OptimizeOverdraw(uint32_t* indices, uint32_t indexCount, const Vertex* vertices, uint32_t vertexCount, const std::vector<uint32_t>& clusters, float threshold) {
+			uint32_t triangleCount = indexCount / 3;
+			if (clusters.size() < 2)
+				return;
+
+			// Dead ends can split the mesh into tiny runs, merging them keeps most of the cache order intact
+			constexpr uint32_t MinClusterTriangles = 32;
+			std::vector<uint32_t> starts;
+			for (uint32_t start : clusters) {
+				if (starts.empty() || start - starts.back() >= MinClusterTriangles)
+					starts.push_back(start);
+			}
+			if (starts.size() < 2)
+				return;
+
+			glm::vec3 meshCenter(0.0f);
+			float meshArea = 0.0f;
+			struct Cluster {
+				uint32_t Start, Count;
+				float SortKey;
+			};
+			std::vector<Cluster> sorted(starts.size());
+			std::vector<glm::vec3> clusterCenters(starts.size());
+			std::vector<glm::vec3> clusterNormals(starts.size());
+
+			for (size_t c = 0; c < starts.size(); c++) {
+				uint32_t start = starts[c];
+				uint32_t end = c + 1 < starts.size() ? starts[c + 1] : triangleCount;
+
+				glm::vec3 center(0.0f), normal(0.0f);
+				float area = 0.0f;
+				for (uint32_t t = start; t < end; t++) {
+					const glm::vec3& p0 = vertices[indices[t * 3 + 0]].Position;
+					const glm::vec3& p1 = vertices[indices[t * 3 + 1]].Position;
+					const glm::vec3& p2 = vertices[indices[t * 3 + 2]].Position;
+
+					glm::vec3 cross = glm::cross(p1 - p0, p2 - p0);
+					float triangleArea = glm::length(cross);
+					center += (p0 + p1 + p2) * (triangleArea / 3.0f);
+					normal += cross;
+					area += triangleArea;
+				}
+
+				clusterCenters[c] = area > 0.0f ? center / area : vertices[indices[start * 3]].Position;
+				clusterNormals[c] = glm::length(normal) > 0.0f ? glm::normalize(normal) : glm::vec3(0.0f);
+				sorted[c] = { start, end - start, 0.0f };
+
+				meshCenter += center;
+				meshArea += area;
+			}
+			if (meshArea > 0.0f)
+				meshCenter /= meshArea;
+
+			// Clusters facing away from the center occlude the rest from most directions
+			for (size_t c = 0; c < sorted.size(); c++)
+				sorted[c].SortKey = glm::dot(clusterCenters[c] - meshCenter, clusterNormals[c]);
+
+			std::stable_sort(sorted.begin(), sorted.end(), [](const Cluster& a, const Cluster& b) {
+				return a.SortKey > b.SortKey;
+			});
+
+			std::vector<uint32_t> reordered;
+			reordered.reserve(indexCount);
+			for (auto& cluster : sorted)
+				reordered.insert(reordered.end(), indices + cluster.Start * 3, indices + (cluster.Start + cluster.Count) * 3);
+
+			float acmr = ComputeACMR(indices, indexCount, vertexCount);
+			float sortedAcmr = ComputeACMR(reordered.data(), indexCount, vertexCount);
+			if (sortedAcmr <= acmr * threshold)
+				memcpy(indices, reordered.data(), indexCount * sizeof(uint32_t));
+		}
+
+		void MeshOptimizer::OptimizeVertexFetch(Vertex* vertices, uint32_t vertexCount, uint32_t* indices, uint32_t indexCount) {
+			constexpr uint32_t Unused = 0xffffffff;
+			std::vector<uint32_t> remap(vertexCount, Unused);
+
+			uint32_t nextVertex = 0;
+			for (uint32_t i = 0; i < indexCount; i++) {
+				uint32_t& target = remap[indices[i]];
+				if (target == Unused)
+					target = nextVertex++;
+				indices[i] = target;
+			}
+
+			for (uint32_t v = 0; v < vertexCount; v++) {
+				if (remap[v] == Unused)
+					remap[v] = nextVertex++;
+			}
+
+			std::vector<Vertex> reordered(vertexCount);
+			for (uint32_t v = 0; v < vertexCount; v++)
+				reordered[remap[v]] = vertices[v];
+
+			memcpy(vertices, reordered.data(), vertexCount * sizeof(Vertex));
+		}
+	}
+}
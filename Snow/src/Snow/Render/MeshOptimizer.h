@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Snow/Render/Mesh.h"
+
+#include <vector>
+
+namespace Snow {
+	namespace Render {
+		// Reorders imported mesh data for the GPU. Indices are triangle lists relative to the vertex pointer passed in.
+		class MeshOptimizer {
+		public:
+			static constexpr uint32_t CacheSize = 16;
+
+			// Runs the cache, overdraw and fetch passes over every submesh and logs ACMR before and after
+			static void Optimize(std::vector<Vertex>& vertices, std::vector<Index>& indices, const std::vector<Submesh>& submeshes);
+
+			// Average cache miss ratio, the vertex shader invocations per triangle of a FIFO cache of cacheSize entries
+			static float ComputeACMR(const uint32_t* indices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize = CacheSize);
+
+			// Tipsify, Sander et al. 2007. outClusters receives the first triangle of every run that starts at a dead end
+			static void OptimizeVertexCache(uint32_t* indices, uint32_t indexCount, uint32_t vertexCount, std::vector<uint32_t>* outClusters = nullptr);
+
+			// Sorts the clusters so outward facing ones draw first, keeps the old order if ACMR degrades by more than threshold
+			static void OptimizeOverdraw(uint32_t* indices, uint32_t indexCount, const Vertex* vertices, uint32_t vertexCount, const std::vector<uint32_t>& clusters, float threshold = 1.05f);
+
+			// Renumbers vertices in the order they are first referenced, unreferenced vertices move to the end
+			static void OptimizeVertexFetch(Vertex* vertices, uint32_t vertexCount, uint32_t* indices, uint32_t indexCount);
+		};
+	}
+}
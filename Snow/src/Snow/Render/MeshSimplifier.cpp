@@ -0,0 +1,254 @@
+#include <spch.h>
+#include "Snow/Render/MeshSimplifier.h"
+
+#include <cfloat>
+#include <unordered_set>
+
+namespace Snow {
+	namespace Render {
+		// Symmetric 4x4 plane quadric, the sum of squared distances to a set of planes weighted by triangle area
+		struct Quadric {
+			float A00 = 0.0f, A11 = 0.0f, A22 = 0.0f;
+			float A01 = 0.0f, A02 = 0.0f, A12 = 0.0f;
+			float B0 = 0.0f, B1 = 0.0f, B2 = 0.0f;
+			float C = 0.0f;
+			float Weight = 0.0f;
+
+			void AddPlane(const glm::vec3& n, float d, float weight) {
+				A00 += weight * n.x * n.x;
+				A11 += weight * n.y * n.y;
+				A22 += weight * n.z * n.z;
+				A01 += weight * n.x * n.y;
+				A02 += weight * n.x * n.z;
+				A12 += weight * n.y * n.z;
+				B0 += weight * n.x * d;
+				B1 += weight * n.y * d;
+				B2 += weight * n.z * d;
+				C += weight * d * d;
+				Weight += weight;
+			}
+
+			void Add(const Quadric& other) {
+				A00 += other.A00; A11 += other.A11; A22 += other.A22;
+				A01 += other.A01; A02 += other.A02; A12 += other.A12;
+				B0 += other.B0; B1 += other.B1; B2 += other.B2;
+				C += other.C;
+				Weight += other.Weight;
+			}
+
+			// Mean squared distance from p to the planes
+			float Evaluate(const glm::vec3& p) const {
+				if (Weight <= 0.0f)
+					return 0.0f;
+
+				float r = A00 * p.x * p.x + A11 * p.y * p.y + A22 * p.z * p.z
+					+ 2.0f * (A01 * p.x * p.y + A02 * p.x * p.z + A12 * p.y * p.z)
+					+ 2.0f * (B0 * p.x + B1 * p.y + B2 * p.z) + C;
+				return std::abs(r) / Weight;
+			}
+		};
+
+		struct Collapse {
+			uint32_t From, To;
+			float Error;
+		};
+
+		// Vertices that share a position with another vertex (attribute seams) or lie on an open edge
+		static std::vector<bool> FindLockedVertices(const uint32_t* indices, uint32_t indexCount, const Vertex* vertices, uint32_t vertexCount) {
+			std::vector<bool> locked(vertexCount, false);
+
+			std::vector<uint32_t> order(vertexCount);
+			for (uint32_t v = 0; v < vertexCount; v++)
+				order[v] = v;
+			auto lessPosition = [&](uint32_t a, uint32_t b) {
+				const glm::vec3& pa = vertices[a].Position;
+				const glm::vec3& pb = vertices[b].Position;
+				if (pa.x != pb.x) return pa.x < pb.x;
+				if (pa.y != pb.y) return pa.y < pb.y;
+				return pa.z < pb.z;
+			};
+			std::sort(order.begin(), order.end(), lessPosition);
+			for (uint32_t i = 0; i + 1 < vertexCount; i++) {
+				if (!lessPosition(order[i], order[i + 1])) {
+					locked[order[i]] = true;
+					locked[order[i + 1]] = true;
+				}
+			}
+
+			// An edge is open when no triangle walks it in the opposite direction
+			std::unordered_set<uint64_t> edges;
+			edges.reserve(indexCount);
+			for (uint32_t i = 0; i < indexCount; i += 3) {
+				for (uint32_t e = 0; e < 3; e++)
+					edges.insert(((uint64_t)indices[i + e] << 32) | indices[i + (e + 1) % 3]);
+			}
+			for (uint32_t i = 0; i < indexCount; i += 3) {
+				for (uint32_t e = 0; e < 3; e++) {
+					uint32_t a = indices[i + e], b = indices[i + (e + 1) % 3];
+					if (edges.find(((uint64_t)b << 32) | a) == edges.end()) {
+						locked[a] = true;
+						locked[b] = true;
+					}
+				}
+			}
+
+			return locked;
+		}
+
+		float MeshSimplifier::Simplify(const uint32_t* indices, uint32_t indexCount, const Vertex* vertices, uint32_t vertexCount,
+			uint32_t targetIndexCount, float maxError, std::vector<uint32_t>& outIndices) {
+			outIndices.assign(indices, indices + indexCount);
+			if (indexCount <= targetIndexCount)
+				return 0.0f;
+
+			std::vector<bool> locked = FindLockedVertices(indices, indexCount, vertices, vertexCount);
+
+			std::vector<Quadric> quadrics(vertexCount);
+			for (uint32_t i = 0; i < indexCount; i += 3) {
+				const glm::vec3& p0 = vertices[indices[i + 0]].Position;
+				const glm::vec3& p1 = vertices[indices[i + 1]].Position;
+				const glm::vec3& p2 = vertices[indices[i + 2]].Position;
+
+				glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+				float area = glm::length(normal);
+				if (area == 0.0f)
+					continue;
+
+				normal = normal / area;
+				float d = -glm::dot(normal, p0);
+				for (uint32_t c = 0; c < 3; c++)
+					quadrics[indices[i + c]].AddPlane(normal, d, area);
+			}
+
+			float maxErrorSquared = maxError * maxError;
+			float resultError = 0.0f;
+
+			std::vector<uint32_t> adjacencyOffset(vertexCount + 1);
+			std::vector<uint32_t> adjacency;
+			std::vector<Collapse> collapses;
+			std::vector<uint32_t> remap(vertexCount);
+			std::vector<bool> touched(vertexCount);
+			bool widenPass = false;
+
+			// Each pass collapses a set of edges whose neighbourhoods do not overlap, so every check sees current topology
+			while (outIndices.size() > targetIndexCount) {
+				uint32_t currentIndexCount = (uint32_t)outIndices.size();
+
+				std::fill(adjacencyOffset.begin(), adjacencyOffset.end(), 0);
+				for (uint32_t i = 0; i < currentIndexCount; i++)
+					adjacencyOffset[outIndices[i] + 1]++;
+				for (uint32_t v = 0; v < vertexCount; v++)
+					adjacencyOffset[v + 1] += adjacencyOffset[v];
+
+				adjacency.resize(currentIndexCount);
+				std::vector<uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+				for (uint32_t i = 0; i < currentIndexCount; i++)
+					adjacency[fill[outIndices[i]]++] = i / 3;
+
+				collapses.clear();
+				for (uint32_t i = 0; i < currentIndexCount; i += 3) {
+					for (uint32_t e = 0; e < 3; e++) {
+						uint32_t a = outIndices[i + e], b = outIndices[i + (e + 1) % 3];
+						// Interior edges are walked once in each direction, open edges only join locked vertices
+						if (a > b)
+							continue;
+
+						Quadric combined = quadrics[a];
+						combined.Add(quadrics[b]);
+
+						Collapse collapse = { 0, 0, FLT_MAX };
+						if (!locked[a])
+							collapse = { a, b, combined.Evaluate(vertices[b].Position) };
+						if (!locked[b]) {
+							float error = combined.Evaluate(vertices[a].Position);
+							if (error < collapse.Error)
+								collapse = { b, a, error };
+						}
+						if (collapse.Error != FLT_MAX)
+							collapses.push_back(collapse);
+					}
+				}
+
+				if (collapses.empty())
+					break;
+
+				std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.Error < b.Error; });
+
+				for (uint32_t v = 0; v < vertexCount; v++)
+					remap[v] = v;
+				std::fill(touched.begin(), touched.end(), false);
+
+				// A collapse removes about two triangles, stop once the pass has removed enough to reach the target.
+				// Collapses well above the error of the goal wait for the next pass, where cheaper ones may have opened up.
+				uint32_t trianglesToRemove = (currentIndexCount - targetIndexCount) / 3;
+				uint32_t trianglesRemoved = 0;
+				size_t goal = std::min<size_t>(trianglesToRemove / 2, collapses.size() - 1);
+				float passErrorLimit = widenPass ? maxErrorSquared : std::min(collapses[goal].Error * 1.5f, maxErrorSquared);
+				for (auto& collapse : collapses) {
+					if (collapse.Error > passErrorLimit || trianglesRemoved >= trianglesToRemove)
+						break;
+
+					if (touched[collapse.From] || touched[collapse.To])
+						continue;
+
+					// Reject collapses that fold a triangle around the removed vertex by more than about 75 degrees
+					const glm::vec3& from = vertices[collapse.From].Position;
+					const glm::vec3& to = vertices[collapse.To].Position;
+					bool flips = false;
+					uint32_t shared = 0;
+					for (uint32_t a = adjacencyOffset[collapse.From]; a < adjacencyOffset[collapse.From + 1] && !flips; a++) {
+						const uint32_t* triangle = &outIndices[adjacency[a] * 3];
+						uint32_t corner = triangle[0] == collapse.From ? 0 : triangle[1] == collapse.From ? 1 : 2;
+						uint32_t x = triangle[(corner + 1) % 3], y = triangle[(corner + 2) % 3];
+						if (x == collapse.To || y == collapse.To) {
+							shared++;
+							continue;
+						}
+
+						const glm::vec3& px = vertices[x].Position;
+						const glm::vec3& py = vertices[y].Position;
+						glm::vec3 before = glm::cross(px - from, py - from);
+						glm::vec3 after = glm::cross(px - to, py - to);
+						flips = glm::dot(before, after) <= 0.25f * glm::length(before) * glm::length(after);
+					}
+					if (flips)
+						continue;
+
+					remap[collapse.From] = collapse.To;
+					quadrics[collapse.To].Add(quadrics[collapse.From]);
+					resultError = std::max(resultError, collapse.Error);
+					trianglesRemoved += shared;
+
+					touched[collapse.To] = true;
+					for (uint32_t a = adjacencyOffset[collapse.From]; a < adjacencyOffset[collapse.From + 1]; a++) {
+						const uint32_t* triangle = &outIndices[adjacency[a] * 3];
+						touched[triangle[0]] = touched[triangle[1]] = touched[triangle[2]] = true;
+					}
+				}
+
+				// Every collapse under the limit may have been rejected, try once more with the full error budget
+				if (trianglesRemoved == 0) {
+					if (widenPass || passErrorLimit >= maxErrorSquared)
+						break;
+					widenPass = true;
+					continue;
+				}
+				widenPass = false;
+
+				uint32_t writeIndex = 0;
+				for (uint32_t i = 0; i < currentIndexCount; i += 3) {
+					uint32_t a = remap[outIndices[i + 0]], b = remap[outIndices[i + 1]], c = remap[outIndices[i + 2]];
+					if (a == b || b == c || a == c)
+						continue;
+
+					outIndices[writeIndex++] = a;
+					outIndices[writeIndex++] = b;
+					outIndices[writeIndex++] = c;
+				}
+				outIndices.resize(writeIndex);
+			}
+
+			return std::sqrt(resultError);
+		}
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Snow/Render/Mesh.h"
+
+#include <vector>
+
+namespace Snow {
+	namespace Render {
+		// Quadric error metric simplification, Garland and Heckbert 1997. Edges collapse onto one of their existing
+		// vertices, so the result indexes the same vertex buffer. Border and attribute seam vertices never move.
+		class MeshSimplifier {
+		public:
+			// Collapses edges until at most targetIndexCount indices remain or the next collapse would exceed maxError.
+			// Returns the error of the result in mesh units, the largest quadric distance of any collapse it made.
+			static float Simplify(const uint32_t* indices, uint32_t indexCount, const Vertex* vertices, uint32_t vertexCount,
+				uint32_t targetIndexCount, float maxError, std::vector<uint32_t>& outIndices);
+		};
+	}
+}
@@ -2,6 +2,7 @@
 #include "Snow/Render/Pipeline.h"
 
 #include "Snow/Platform/OpenGL/OpenGLPipeline.h"
+#include "Snow/Platform/Null/NullPipeline.h"
 //#include "Snow/Platform/Vulkan/VulkanPipeline.h"
 
 #if defined(SNOW_PLATFORM_WINDOWS)
@@ -16,6 +17,7 @@ namespace Snow {
             switch(Renderer::GetRenderAPI()) {
             case RenderAPIType::None:   return nullptr;
             case RenderAPIType::OpenGL: return Ref<OpenGLPipeline>::Create(spec);
+            case RenderAPIType::Null:   return Ref<NullPipeline>::Create(spec);
             //case RenderAPIType::Vulkan: return Ref<VulkanPipeline>::Create(spec);
 #if defined(SNOW_PLATFORM_WINDOWS)
             //case RenderAPIType::DirectX:    return Ref<DirectX11Pipeline>::Create(spec);
@@ -18,6 +18,9 @@ namespace Snow {
             Float, Float2, Float3, Float4,
             Mat3x3, Mat4x4,
             Int, Int2, Int3, Int4, 
+            UInt,
+            // Compact vertex data, set Normalized on the element to read the shorts as [-1, 1] / [0, 1] floats
+            Half2, Short2, UShort4,
         };
 
         struct AttribElement {
@@ -46,6 +49,10 @@ namespace Snow {
                 case AttribType::Int2: return sizeof(int) * 2;
                 case AttribType::Int3: return sizeof(int) * 3;
                 case AttribType::Int4: return sizeof(int) * 4;
+                case AttribType::UInt: return sizeof(uint32_t);
+                case AttribType::Half2: return sizeof(uint16_t) * 2;
+                case AttribType::Short2: return sizeof(int16_t) * 2;
+                case AttribType::UShort4: return sizeof(uint16_t) * 4;
                 }
 
                 return 0;
@@ -63,6 +70,10 @@ namespace Snow {
 				case AttribType::Int2:    return 2;
 				case AttribType::Int3:    return 3;
 				case AttribType::Int4:    return 4;
+				case AttribType::UInt:    return 1;
+				case AttribType::Half2:   return 2;
+				case AttribType::Short2:  return 2;
+				case AttribType::UShort4: return 4;
 				}
                 return 0;
             }
@@ -108,12 +119,14 @@ namespace Snow {
             Ref<Shader> Shader;
             VertexBufferLayout Layout;
             PrimitiveType Type;
+            // When set, Layout is stepped once per instance rather than once per vertex
+            bool PerInstance = false;
             //Ref<RenderPass> BindedRenderPass;
         };
 
         class Pipeline : public RefCounted {
         public:
-            ~Pipeline() = default;
+            virtual ~Pipeline() = default;
 
             virtual void Bind() const = 0; 
 
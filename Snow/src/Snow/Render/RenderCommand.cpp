@@ -4,6 +4,7 @@
 #include "Snow/Render/Renderer.h"
 
 #include "Snow/Platform/OpenGL/OpenGLRenderCommand.h"
+#include "Snow/Platform/Null/NullRenderCommand.h"
 
 #include "Snow/Platform/DirectX11/DirectXRenderCommand.h"
 
@@ -16,7 +17,9 @@ namespace Snow {
             case RenderAPIType::None:   return nullptr;
             case RenderAPIType::OpenGL: return Core::CreateScope<OpenGLRenderCommand>();
             case RenderAPIType::DirectX:    return Core::CreateScope<DirectX11RenderCommand>();
+            case RenderAPIType::Null:   return Core::CreateScope<NullRenderCommand>();
             }
+            return nullptr;
         }
     }
 }
\ No newline at end of file
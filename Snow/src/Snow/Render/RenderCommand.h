@@ -9,6 +9,12 @@
 
 namespace Snow {
     namespace Render {
+        // State changes the renderer asked the backend for during a frame, and how many of them were already current
+        struct RenderStateStatistics {
+            uint32_t Calls = 0;
+            uint32_t Skipped = 0;
+        };
+
         class RenderAPI {
         public:
 
@@ -21,12 +27,16 @@ namespace Snow {
             virtual void SetDepthTesting(bool depthTest) = 0;
 
             virtual void DrawIndexed(uint32_t count, PrimitiveType type) = 0;
+            virtual void DrawIndexedInstanced(uint32_t count, uint32_t instanceCount, PrimitiveType type, uint32_t baseInstance) = 0;
 
             virtual void SwapBuffers() = 0;
 
             virtual void BeginCommandBuffer() = 0;
             virtual void EndCommandBuffer() = 0;
 
+            // Counts of the last frame, backends that do not filter redundant state changes report none
+            virtual RenderStateStatistics GetStateStatistics() const { return {}; }
+
             static Core::Scope<RenderAPI> Create();
 
         };
@@ -58,6 +68,10 @@ namespace Snow {
                 s_RenderAPI->DrawIndexed(count, type);
             }
 
+            static void DrawIndexedInstanced(uint32_t count, uint32_t instanceCount, PrimitiveType type, uint32_t baseInstance = 0) {
+                s_RenderAPI->DrawIndexedInstanced(count, instanceCount, type, baseInstance);
+            }
+
             static void SetViewport(int width, int height) {
                 s_RenderAPI->SetViewport(width, height);
             }
@@ -73,6 +87,10 @@ namespace Snow {
             static void SwapBuffers() {
                 s_RenderAPI->SwapBuffers();
             }
+
+            static RenderStateStatistics GetStateStatistics() {
+                return s_RenderAPI->GetStateStatistics();
+            }
         private:
             static Core::Scope<RenderAPI> s_RenderAPI;
         };
@@ -0,0 +1,77 @@
+#include <spch.h>
+#include "Snow/Render/RenderCommandQueue.h"
+
+namespace Snow {
+	namespace Render {
+		struct RenderCommandHeader {
+			// Null for data entries, which Execute skips
+			RenderCommandQueue::RenderCommandFn Fn;
+			uint32_t Size;
+		};
+
+		static constexpr uint32_t AlignSize(uint32_t size) {
+			return (size + RenderCommandQueue::Alignment - 1) / RenderCommandQueue::Alignment * RenderCommandQueue::Alignment;
+		}
+
+		static constexpr uint32_t HeaderSize = AlignSize(sizeof(RenderCommandHeader));
+
+		RenderCommandQueue::~RenderCommandQueue() {
+			for (Chunk& chunk : m_Chunks)
+				::operator delete[](chunk.Data, std::align_val_t(Alignment));
+		}
+
+		uint8_t* RenderCommandQueue::AllocateEntry(RenderCommandFn fn, uint32_t size) {
+			uint32_t entrySize = HeaderSize + AlignSize(size);
+
+			if (m_Chunks.empty() || m_Chunks[m_CurrentChunk].Used + entrySize > m_Chunks[m_CurrentChunk].Capacity) {
+				if (!m_Chunks.empty())
+					m_CurrentChunk++;
+
+				// Chunks after the current one are empty, one too small for the entry gets a larger one in front of it
+				if (m_CurrentChunk == m_Chunks.size() || m_Chunks[m_CurrentChunk].Capacity < entrySize) {
+					Chunk chunk;
+					chunk.Capacity = std::max(ChunkSize, entrySize);
+					chunk.Data = (uint8_t*)::operator new[](chunk.Capacity, std::align_val_t(Alignment));
+					m_Chunks.insert(m_Chunks.begin() + m_CurrentChunk, chunk);
+				}
+			}
+
+			Chunk& chunk = m_Chunks[m_CurrentChunk];
+			uint8_t* entry = chunk.Data + chunk.Used;
+			chunk.Used += entrySize;
+			m_Size += entrySize;
+
+			RenderCommandHeader* header = (RenderCommandHeader*)entry;
+			header->Fn = fn;
+			header->Size = entrySize - HeaderSize;
+			return entry + HeaderSize;
+		}
+
+		void* RenderCommandQueue::Allocate(RenderCommandFn fn, uint32_t size) {
+			m_CommandCount++;
+			return AllocateEntry(fn, size);
+		}
+
+		void* RenderCommandQueue::AllocateData(uint32_t size) {
+			return AllocateEntry(nullptr, size);
+		}
+
+		void RenderCommandQueue::Execute() {
+			for (uint32_t i = 0; i < m_Chunks.size() && i <= m_CurrentChunk; i++) {
+				Chunk& chunk = m_Chunks[i];
+				uint32_t offset = 0;
+				while (offset < chunk.Used) {
+					RenderCommandHeader* header = (RenderCommandHeader*)(chunk.Data + offset);
+					if (header->Fn)
+						header->Fn(chunk.Data + offset + HeaderSize);
+					offset += HeaderSize + header->Size;
+				}
+				chunk.Used = 0;
+			}
+
+			m_CurrentChunk = 0;
+			m_CommandCount = 0;
+			m_Size = 0;
+		}
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+namespace Snow {
+	namespace Render {
+		// Linear recording of render commands. Each command is a function pointer followed by its payload, written one
+		// after another into fixed size chunks so memory handed out stays in place while the queue grows. Execute runs
+		// the commands in the order they were written and resets the queue, the chunks are kept for the next recording.
+		class RenderCommandQueue {
+		public:
+			// Runs the command stored at the payload, and destroys the payload
+			typedef void(*RenderCommandFn)(void*);
+
+			RenderCommandQueue() = default;
+			RenderCommandQueue(const RenderCommandQueue&) = delete;
+			RenderCommandQueue& operator=(const RenderCommandQueue&) = delete;
+			~RenderCommandQueue();
+
+			// Storage for a payload of size bytes that fn is called with
+			void* Allocate(RenderCommandFn fn, uint32_t size);
+			// Storage for data commands read, it stays valid until Execute has run them
+			void* AllocateData(uint32_t size);
+
+			void Execute();
+
+			uint32_t GetCommandCount() const { return m_CommandCount; }
+			// Bytes recorded since the last Execute
+			uint64_t GetSize() const { return m_Size; }
+
+			static constexpr uint32_t ChunkSize = 1024 * 1024;
+			static constexpr uint32_t Alignment = 16;
+
+		private:
+			struct Chunk {
+				uint8_t* Data = nullptr;
+				uint32_t Capacity = 0;
+				uint32_t Used = 0;
+			};
+
+			uint8_t* AllocateEntry(RenderCommandFn fn, uint32_t size);
+
+			std::vector<Chunk> m_Chunks;
+			uint32_t m_CurrentChunk = 0;
+
+			uint32_t m_CommandCount = 0;
+			uint64_t m_Size = 0;
+		};
+	}
+}
@@ -4,6 +4,7 @@
 
 #include "Snow/Platform/OpenGL/OpenGLContext.h"
 #include "Snow/Platform/Vulkan/VulkanContext.h"
+#include "Snow/Platform/Null/NullContext.h"
 
 #if defined SNOW_PLATFORM_WINDOWS
     #include "Snow/Platform/DirectX11/DirectXContext.h"
@@ -23,6 +24,7 @@ namespace Snow {
             case RenderAPIType::None:   return nullptr;
             case RenderAPIType::OpenGL: return new OpenGLContext(spec);
             case RenderAPIType::Vulkan: return new VulkanContext(spec);
+            case RenderAPIType::Null:   return new NullContext(spec);
 #ifdef SNOW_PLATFORM_WINDOWS
             case RenderAPIType::DirectX:    return new DirectX11RenderContext(spec);
 #endif
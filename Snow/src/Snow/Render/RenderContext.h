@@ -5,7 +5,7 @@ namespace Snow {
 
         enum class RenderAPIType {
             None = 0,
-            OpenGL, DirectX, Vulkan
+            OpenGL, DirectX, Vulkan, Null
         };
 
         struct ContextSpecification {
@@ -20,6 +20,10 @@ namespace Snow {
 
             virtual const ContextSpecification& GetSpecification() const = 0;
 
+            // Moves the context between threads, for the render thread. A context is current on one thread at a time.
+            virtual void MakeCurrent() {}
+            virtual void ReleaseCurrent() {}
+
             static Context* Create(const ContextSpecification& spec);
         private:
             static bool s_Created;
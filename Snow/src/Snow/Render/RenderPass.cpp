@@ -5,6 +5,7 @@
 #include "Snow/Render/Renderer.h"
 
 #include "Snow/Platform/OpenGL/OpenGLRenderPass.h"
+#include "Snow/Platform/Null/NullRenderPass.h"
 
 #if defined SNOW_PLATFORM_WINDOWS
 #include "Snow/Platform/DirectX11/DirectXRenderPass.h"
@@ -16,6 +17,7 @@ namespace Snow {
 			switch (Renderer::GetRenderAPI()) {
 			case RenderAPIType::None:	return nullptr;
 			case RenderAPIType::OpenGL:	return Ref<OpenGLRenderPass>::Create(spec);
+			case RenderAPIType::Null:	return Ref<NullRenderPass>::Create(spec);
 
 #if defined SNOW_PLATFORM_WINDOWS
 			case RenderAPIType::DirectX:	return Ref<DirectX11RenderPass>::Create(spec);
@@ -0,0 +1,172 @@
+#include <spch.h>
+#include "Snow/Render/RenderThread.h"
+
+#include "Snow/Render/Renderer.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace Snow {
+	namespace Render {
+		struct RenderThreadData {
+			std::thread Thread;
+			std::thread::id ThreadID;
+			std::atomic<bool> Running{ false };
+
+			std::mutex Mutex;
+			std::condition_variable Condition;
+			bool Stopping = false;
+
+			// The main thread records into Queues[SubmitQueue], Executing is the one handed to the render thread and
+			// null while it is idle
+			RenderCommandQueue Queues[2];
+			uint32_t SubmitQueue = 0;
+			RenderCommandQueue* Executing = nullptr;
+			float ExecuteTime = 0.0f;
+
+			// Main thread only, flushes during a frame add to the frame's counts
+			RenderThread::Statistics FrameStats;
+			RenderThread::Statistics LastFrameStats;
+		};
+		static RenderThreadData s_Data;
+
+		static float GetMilliseconds(std::chrono::steady_clock::time_point start) {
+			return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		static void RenderLoop() {
+			Renderer::GetContext()->MakeCurrent();
+
+			while (true) {
+				RenderCommandQueue* queue;
+				{
+					std::unique_lock<std::mutex> lock(s_Data.Mutex);
+					s_Data.Condition.wait(lock, [] { return s_Data.Executing || s_Data.Stopping; });
+					if (!s_Data.Executing)
+						break;
+					queue = s_Data.Executing;
+				}
+
+				auto start = std::chrono::steady_clock::now();
+				queue->Execute();
+				float executeTime = GetMilliseconds(start);
+
+				{
+					std::lock_guard<std::mutex> lock(s_Data.Mutex);
+					s_Data.Executing = nullptr;
+					s_Data.ExecuteTime += executeTime;
+				}
+				s_Data.Condition.notify_all();
+			}
+
+			Renderer::GetContext()->ReleaseCurrent();
+		}
+
+		static void WaitUntilIdle(std::unique_lock<std::mutex>& lock) {
+			auto start = std::chrono::steady_clock::now();
+			s_Data.Condition.wait(lock, [] { return !s_Data.Executing; });
+			s_Data.FrameStats.WaitTime += GetMilliseconds(start);
+		}
+
+		// Hands the queue being recorded to the render thread once it is idle
+		static void Kick() {
+			std::unique_lock<std::mutex> lock(s_Data.Mutex);
+			WaitUntilIdle(lock);
+			s_Data.FrameStats.ExecuteTime += s_Data.ExecuteTime;
+			s_Data.ExecuteTime = 0.0f;
+
+			RenderCommandQueue& queue = s_Data.Queues[s_Data.SubmitQueue];
+			s_Data.FrameStats.Commands += queue.GetCommandCount();
+			s_Data.FrameStats.Bytes += queue.GetSize();
+
+			s_Data.Executing = &queue;
+			s_Data.SubmitQueue ^= 1;
+			lock.unlock();
+			s_Data.Condition.notify_all();
+		}
+
+		void RenderThread::Start() {
+			if (IsRunning())
+				return;
+
+			if (Renderer::GetRenderAPI() != RenderAPIType::OpenGL) {
+				SNOW_CORE_WARN("The render thread is only supported with OpenGL, rendering stays on the main thread");
+				return;
+			}
+
+			SNOW_CORE_INFO("Starting render thread");
+			Renderer::GetContext()->ReleaseCurrent();
+			s_Data.Stopping = false;
+			s_Data.Thread = std::thread(RenderLoop);
+			s_Data.ThreadID = s_Data.Thread.get_id();
+			s_Data.Running = true;
+		}
+
+		void RenderThread::Stop() {
+			if (!IsRunning())
+				return;
+
+			Flush();
+			{
+				std::lock_guard<std::mutex> lock(s_Data.Mutex);
+				s_Data.Stopping = true;
+			}
+			s_Data.Condition.notify_all();
+			s_Data.Thread.join();
+
+			s_Data.Running = false;
+			s_Data.ThreadID = {};
+			Renderer::GetContext()->MakeCurrent();
+			SNOW_CORE_INFO("Stopped render thread");
+		}
+
+		bool RenderThread::IsRunning() {
+			return s_Data.Running;
+		}
+
+		bool RenderThread::IsRenderThread() {
+			return IsRunning() && std::this_thread::get_id() == s_Data.ThreadID;
+		}
+
+		bool RenderThread::IsRecording() {
+			return IsRunning() && std::this_thread::get_id() != s_Data.ThreadID;
+		}
+
+		RenderCommandQueue& RenderThread::GetSubmitQueue() {
+			return s_Data.Queues[s_Data.SubmitQueue];
+		}
+
+		void RenderThread::SubmitFrame() {
+			if (!IsRecording())
+				return;
+
+			Kick();
+			s_Data.LastFrameStats = s_Data.FrameStats;
+			s_Data.FrameStats = {};
+		}
+
+		void RenderThread::WaitForFrame() {
+			if (!IsRecording())
+				return;
+
+			std::unique_lock<std::mutex> lock(s_Data.Mutex);
+			WaitUntilIdle(lock);
+		}
+
+		void RenderThread::Flush() {
+			if (!IsRecording())
+				return;
+
+			Kick();
+			std::unique_lock<std::mutex> lock(s_Data.Mutex);
+			WaitUntilIdle(lock);
+		}
+
+		RenderThread::Statistics RenderThread::GetStatistics() {
+			return s_Data.LastFrameStats;
+		}
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Snow/Render/RenderCommandQueue.h"
+
+namespace Snow {
+	namespace Render {
+		// Owns the render context while it runs and replays the commands the main thread records through
+		// Renderer::Submit, one frame behind: while it executes frame N the main thread records frame N + 1 into the
+		// other queue. Without it running, or on the render thread itself, commands run in place.
+		class RenderThread {
+		public:
+			// Hands the current context over to a new render thread, only backends recording every call through
+			// Renderer::Submit support it
+			static void Start();
+			// Runs what was recorded so far and gives the context back to the calling thread
+			static void Stop();
+
+			static bool IsRunning();
+			static bool IsRenderThread();
+			// Whether Renderer::Submit records instead of running the command in place
+			static bool IsRecording();
+
+			static RenderCommandQueue& GetSubmitQueue();
+
+			// Ends the frame being recorded: waits until the render thread is done with the previous frame and hands
+			// it this one
+			static void SubmitFrame();
+			// Returns once the render thread is done with the frame it was handed, the frame being recorded is kept
+			static void WaitForFrame();
+			// Returns once every command recorded so far has run, for results the main thread needs right away
+			static void Flush();
+
+			struct Statistics {
+				uint32_t Commands = 0;
+				uint64_t Bytes = 0;
+				// Milliseconds the main thread waited for the render thread, and the render thread spent executing
+				float WaitTime = 0.0f;
+				float ExecuteTime = 0.0f;
+			};
+			// Counts of the last frame handed to the render thread
+			static Statistics GetStatistics();
+		};
+	}
+}
@@ -67,14 +67,16 @@ namespace Snow {
             SNOW_CORE_INFO("Initializing Renderer");
             ContextSpecification contextSpec;
             contextSpec.s_RenderAPIType = GetRenderAPI();
-            contextSpec.WindowHandle = Core::Application::Get().GetWindow()->GetWindowHandle();
+            // The Null backend runs headless, so there may be no window to attach to
+            Ref<Core::Window> window = Core::Application::Get().GetWindow();
+            contextSpec.WindowHandle = window ? window->GetWindowHandle() : nullptr;
 
             
             s_Context = Context::Create(contextSpec);
 
             s_Data.m_ShaderLibrary = Ref<ShaderLibrary>::Create();
 
-            if (s_RenderAPI == RenderAPIType::OpenGL) {
+            if (s_RenderAPI == RenderAPIType::OpenGL || s_RenderAPI == RenderAPIType::Null) {
                 Renderer::GetShaderLibrary()->Load({
                     { ShaderType::Vertex, "assets/shaders/glsl/QuadBatchRender.vert.glsl" },
                     { ShaderType::Pixel, "assets/shaders/glsl/QuadBatchRender.frag.glsl" } });
@@ -90,6 +92,10 @@ namespace Snow {
                 Renderer::GetShaderLibrary()->Load({
                     { ShaderType::Vertex, "assets/shaders/glsl/PBR.vert.glsl" },
                     { ShaderType::Pixel, "assets/shaders/glsl/PBR.frag.glsl" } });
+
+                Renderer::GetShaderLibrary()->Load({
+                    { ShaderType::Vertex, "assets/shaders/glsl/PBRCompact.vert.glsl" },
+                    { ShaderType::Pixel, "assets/shaders/glsl/PBR.frag.glsl" } }, "PBRCompact");
             }
             else if (s_RenderAPI == RenderAPIType::DirectX) {
                 //Renderer::GetShaderLibrary()->Load(ShaderType::Vertex, "assets/shaders/hlsl/QuadBatchRenderVert.hlsl");
@@ -151,9 +157,6 @@ namespace Snow {
             s_Data.FullscreenQuadIndexBuffer->Bind();
 
             RenderCommand::DrawIndexed(6, s_Data.FullscreenQuadPipeline->GetSpecification().Type);
-
-            s_Data.FullscreenQuadIndexBuffer->Unbind();
-            s_Data.FullscreenQuadVertexBuffer->Unbind();
         }
         
     }
@@ -1,6 +1,7 @@
 #pragma once
 #include "Snow/Render/RenderContext.h"
 #include "Snow/Render/RenderCommand.h"
+#include "Snow/Render/RenderThread.h"
 #include "Snow/Render/Material.h"
 #include "Snow/Render/Pipeline.h"
 #include "Snow/Render/Shader/ShaderLibrary.h"
@@ -20,6 +21,37 @@ namespace Snow {
 
             static void SubmitFullscreenQuad(Ref<MaterialInstance> material);
 
+            // Records a command for the render thread, or runs it in place when there is none. Commands must only
+            // capture values, never the objects submitting them, as those may be gone by the time the command runs.
+            template<typename FuncT>
+            static void Submit(FuncT&& func) {
+                if (!RenderThread::IsRecording()) {
+                    func();
+                    return;
+                }
+
+                using Command = std::decay_t<FuncT>;
+                static_assert(alignof(Command) <= RenderCommandQueue::Alignment, "Render command is over-aligned");
+                auto execute = [](void* payload) {
+                    Command* command = (Command*)payload;
+                    (*command)();
+                    command->~Command();
+                };
+                void* storage = RenderThread::GetSubmitQueue().Allocate(execute, sizeof(Command));
+                new (storage) Command(std::forward<FuncT>(func));
+            }
+
+            // Data for a submitted command to read, copied into the queue so the caller may reuse its memory. Used in
+            // place when commands run straight away.
+            static const void* CopyCommandData(const void* data, uint32_t size) {
+                if (!data || !RenderThread::IsRecording())
+                    return data;
+
+                void* copy = RenderThread::GetSubmitQueue().AllocateData(size);
+                memcpy(copy, data, size);
+                return copy;
+            }
+
             //static void SwapBuffers();
 
             static void SetRenderAPI(RenderAPIType api) { s_RenderAPI = api; }
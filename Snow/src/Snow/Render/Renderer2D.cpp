@@ -4,17 +4,41 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <unordered_map>
 
 #include "Snow/Math/Mat4.h"
 
 namespace Snow {
     namespace Render {
 
-        struct QuadVertex {
-            glm::vec3 Position;
-            glm::vec2 TexCoord;
-            float TexID;
-            glm::vec4 Color;
+        // One record per quad, the corners are expanded in the vertex shader
+        struct QuadInstance {
+            glm::vec4 Transform[3]; // first three rows of the model matrix
+            glm::vec4 TexRect;      // uv min (xy), uv max (zw)
+            uint32_t Color;         // RGBA8
+            uint32_t TexIndex;
+        };
+
+        // Sprite textures are copied into one GL_TEXTURE_2D_ARRAY per power of two size class, so a
+        // batch never runs out of texture slots. TexIndex packs the class in the high and the layer in the low 16 bits
+        static const uint32_t NoTexture = SpriteRegion::NoPage;
+
+        struct TexturePage {
+            Ref<API::Texture2DArray> Layers;
+            uint32_t UsedLayers = 0;
+            std::vector<uint32_t> FreeLayers;
+            // Freed this frame, quads already batched may still sample them until the frame ends
+            std::vector<uint32_t> ReleasedLayers;
+        };
+
+        // Pages hold copies, so the source is only observed and can be freed once nothing else draws it
+        struct TextureLocation {
+            WeakRef<API::Texture2D> Texture;
+            uint32_t ImageVersion;
+            uint32_t Index;
+            glm::vec2 UVScale;
         };
 
         struct LineVertex {
@@ -23,34 +47,37 @@ namespace Snow {
         };
 
         struct Renderer2DStaticData {
-            static const uint32_t MaxTextureSlots = 32;
-
-            static const uint32_t MaxQuads = 2500;
-            static const uint32_t MaxQuadVertices = MaxQuads * 4;
-            static const uint32_t MaxQuadIndicies = MaxQuads * 6;
+            static const uint32_t MinPageSize = 16;
+            static const uint32_t PageClassCount = 9; // 16 to 4096 texels
+            // Pages start with and grow by as many layers as fit into this many bytes, at least one and at most
+            // MaxPageLayerStep, so a single large sprite does not allocate a stack of layers it never uses
+            static const uint32_t PageGrowthBytes = 16 * 1024 * 1024;
+            static const uint32_t MaxPageLayerStep = 64;
+
+            // Per-frame region size of the instance ring. It grows to fit reserved counts, doubles when an unreserved
+            // batch overflows it and is halved again once frames used at most a quarter of it for ShrinkAfterFrames
+            static const uint32_t InitialQuadInstances = 2500;
+            static const uint32_t ShrinkAfterFrames = 300;
 
             static const uint32_t MaxLines = 10000;
             static const uint32_t MaxLineVertices = MaxLines * 2;
             static const uint32_t MaxLineIndices = MaxLines * 6;
 
-            uint32_t QuadIndexCount = 0;
-            QuadVertex* QuadVertexData = nullptr;
-            QuadVertex* QuadVertexBase = nullptr;
+            QuadInstance* QuadInstanceBase = nullptr;
+            uint32_t QuadInstanceCount = 0;
+            uint32_t QuadInstanceCapacity = 0;
+            uint32_t FrameQuadInstances = 0;
+            uint32_t LowUsageFrames = 0;
 
             Ref<Pipeline> QuadPipeline;
             Ref<API::IndexBuffer> QuadIBO;
-            Ref<API::VertexBuffer> QuadVBO;
-
-            glm::vec4 QuadVertexPositions[4];
+            Ref<API::StreamingVertexBuffer> QuadInstanceBuffer;
 
             Ref<Shader> TextureShader;
-            Ref<API::Texture2D> WhiteTexture;
+            uint32_t CameraBinding;
 
-            std::vector<Ref<API::Texture2D>> TextureSlots;
-            uint32_t TextureSlotIndex = 1;
-
-
-            glm::vec2 TexCoords[4] = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f} };
+            TexturePage TexturePages[PageClassCount];
+            std::unordered_map<const API::Texture2D*, TextureLocation> TextureLocations;
 
 
             Ref<Pipeline> LinePipeline;
@@ -71,53 +98,28 @@ namespace Snow {
             {
                 PipelineSpecification pipelineSpec;
                 pipelineSpec.Layout = {
-                    { AttribType::Float3, "Position" },
-                    { AttribType::Float2, "TexCoord" },
-                    { AttribType::Float, "TexID" },
-                    { AttribType::Float4, "Color" },
+                    { AttribType::Float4, "TransformRow0" },
+                    { AttribType::Float4, "TransformRow1" },
+                    { AttribType::Float4, "TransformRow2" },
+                    { AttribType::Float4, "TexRect" },
+                    { AttribType::UInt, "Color" },
+                    { AttribType::UInt, "TexIndex" },
                 };
                 //pipelineSpec.Shader = { Renderer::GetShaderLibrary()->Get("QuadBatchRenderVert"), Renderer::GetShaderLibrary()->Get("QuadBatchRenderFrag") };
                 pipelineSpec.Type = PrimitiveType::Triangle;
+                pipelineSpec.PerInstance = true;
 
                 s_Data.QuadPipeline = Pipeline::Create(pipelineSpec);
 
-                s_Data.QuadVertexBase = new QuadVertex[s_Data.MaxQuadVertices];
-                s_Data.QuadVertexData = s_Data.QuadVertexBase;
-
-                s_Data.QuadVBO = API::VertexBuffer::Create(nullptr, sizeof(QuadVertex) * s_Data.MaxQuadVertices);
-
-                uint32_t* indicies = new uint32_t[s_Data.MaxQuadIndicies];
-                uint32_t offset = 0;
-                for (uint32_t i = 0; i < s_Data.MaxQuads; i++) {
-                    indicies[i * 6 + 0] = 0 + offset;
-                    indicies[i * 6 + 1] = 1 + offset;
-                    indicies[i * 6 + 2] = 2 + offset;
-                    indicies[i * 6 + 3] = 2 + offset;
-                    indicies[i * 6 + 4] = 3 + offset;
-                    indicies[i * 6 + 5] = 0 + offset;
+                s_Data.QuadInstanceBuffer = API::StreamingVertexBuffer::Create(sizeof(QuadInstance) * s_Data.InitialQuadInstances);
 
-                    offset += 4;
-                }
-
-                s_Data.QuadIBO = API::IndexBuffer::Create(indicies, sizeof(uint32_t) * s_Data.MaxQuadIndicies);
-                delete[] indicies;
-
-                s_Data.QuadVertexPositions[0] = { -0.5f, -0.5f, 0.0f, 1.0f };
-                s_Data.QuadVertexPositions[1] = { 0.5f, -0.5f, 0.0f, 1.0f };
-                s_Data.QuadVertexPositions[2] = { 0.5f,  0.5f, 0.0f, 1.0f };
-                s_Data.QuadVertexPositions[3] = { -0.5f,  0.5f, 0.0f, 1.0f };
+                // The corner is taken from the vertex index, so one quad worth of indices serves every instance
+                uint32_t indices[6] = { 0, 1, 2, 2, 3, 0 };
+                s_Data.QuadIBO = API::IndexBuffer::Create(indices, sizeof(uint32_t) * 6);
             }
 
-            s_Data.WhiteTexture = API::Texture2D::Create(API::TextureFormat::RGBA, 1, 1);
-            uint32_t whiteTextureData = 0xffffffff;
-            s_Data.WhiteTexture->Lock();
-            s_Data.WhiteTexture->SetData(&whiteTextureData, sizeof(uint32_t));
-            s_Data.WhiteTexture->Unlock();
-
             s_Data.TextureShader = Shader::Create({ {ShaderType::None, "assets/shaders/glsl/Texture2D.glsl"} });
-
-            s_Data.TextureSlots.resize(32);
-            s_Data.TextureSlots[0] = s_Data.WhiteTexture;
+            s_Data.CameraBinding = s_Data.TextureShader->GetUniformBufferBinding("Camera");
 
             // Line Pipeline
             {
@@ -149,7 +151,7 @@ namespace Snow {
             s_Data.TextureShader->Bind();
 
             glm::mat4 viewProjMatrix = camera.GetProjection() * viewMatrix;
-            s_Data.TextureShader->SetUniformBufferData("Camera", glm::value_ptr(viewProjMatrix), sizeof(glm::mat4));
+            s_Data.TextureShader->SetUniformBufferData(s_Data.CameraBinding, glm::value_ptr(viewProjMatrix), sizeof(glm::mat4));
 
             BeginBatch();
         }
@@ -158,45 +160,76 @@ namespace Snow {
             s_Data.TextureShader->Bind();
 
             glm::mat4 viewProjMatrix = editorCamera.GetViewProjectionMatrix();
-            s_Data.TextureShader->SetUniformBufferData("Camera", glm::value_ptr(viewProjMatrix), sizeof(glm::mat4));
+            s_Data.TextureShader->SetUniformBufferData(s_Data.CameraBinding, glm::value_ptr(viewProjMatrix), sizeof(glm::mat4));
 
             BeginBatch();
         }
 
+        void Renderer2D::NextFrame() {
+            auto& instanceBuffer = s_Data.QuadInstanceBuffer;
+            uint32_t frameSize = instanceBuffer->GetFrameSize();
+            uint32_t initialSize = sizeof(QuadInstance) * Renderer2DStaticData::InitialQuadInstances;
+            if (frameSize > initialSize && s_Data.FrameQuadInstances * sizeof(QuadInstance) * 4 <= frameSize)
+                s_Data.LowUsageFrames++;
+            else
+                s_Data.LowUsageFrames = 0;
+            s_Data.FrameQuadInstances = 0;
+
+            // A fresh ring starts on an unused region, so it replaces the frame advance
+            if (s_Data.LowUsageFrames >= Renderer2DStaticData::ShrinkAfterFrames) {
+                s_Data.LowUsageFrames = 0;
+                instanceBuffer->Resize(std::max(frameSize / 2, initialSize));
+            }
+            else
+                instanceBuffer->NextFrame();
+
+            for (auto it = s_Data.TextureLocations.begin(); it != s_Data.TextureLocations.end();) {
+                if (it->second.Texture.IsValid()) {
+                    ++it;
+                    continue;
+                }
+                FreePage(it->second.Index);
+                it = s_Data.TextureLocations.erase(it);
+            }
+
+            // No batch is open between frames, so layers freed during the last one can be handed out again
+            for (auto& page : s_Data.TexturePages) {
+                page.FreeLayers.insert(page.FreeLayers.end(), page.ReleasedLayers.begin(), page.ReleasedLayers.end());
+                page.ReleasedLayers.clear();
+            }
+        }
+
+        void Renderer2D::Reserve(uint32_t quadCount) {
+            uint32_t capacity = 0;
+            s_Data.QuadInstanceBuffer->Map(sizeof(QuadInstance), capacity);
+            if (capacity >= quadCount)
+                return;
+
+            // Earlier scenes of this frame already committed their instances, the new ring only has to hold these
+            uint32_t frameSize = s_Data.QuadInstanceBuffer->GetFrameSize();
+            do
+                frameSize *= 2;
+            while (frameSize < quadCount * sizeof(QuadInstance));
+            s_Data.QuadInstanceBuffer->Resize(frameSize);
+            s_Data.LowUsageFrames = 0;
+        }
+
         void Renderer2D::EndScene() {
             EndBatch();
             RenderCommand::SetBlending(false);
         }
 
         void Renderer2D::BeginBatch() {
-            s_Data.QuadVertexData = s_Data.QuadVertexBase;
-            s_Data.QuadIndexCount = 0;
+            MapQuadInstances();
 
             s_Data.LineVertexData = s_Data.LineVertexBase;
             s_Data.LineIndexCount = 0;
-
-            s_Data.TextureSlotIndex = 1;
         }
 
         void Renderer2D::EndBatch() {
-            ptrdiff_t size = (uint8_t*)s_Data.QuadVertexData - (uint8_t*)s_Data.QuadVertexBase;
-            if(size) {
-                s_Data.QuadVBO->SetData(s_Data.QuadVertexBase, size);
+            DrawQuadInstances();
 
-                s_Data.TextureShader->Bind();
-                for(uint32_t i=0; i< s_Data.TextureSlotIndex; i++)
-                    s_Data.TextureSlots[i]->Bind(i);
-                RenderCommand::SetDepthTesting(true);
-                s_Data.QuadPipeline->Bind();
-                s_Data.QuadVBO->Bind();
-                s_Data.QuadIBO->Bind();
-
-                
-                RenderCommand::DrawIndexed(s_Data.QuadIndexCount, s_Data.QuadPipeline->GetSpecification().Type);
-                RenderCommand::SetDepthTesting(false);
-            }
-
-            size = (uint8_t*)s_Data.LineVertexData - (uint8_t*)s_Data.LineVertexBase;
+            ptrdiff_t size = (uint8_t*)s_Data.LineVertexData - (uint8_t*)s_Data.LineVertexBase;
             if(size) {
                 s_Data.LineVBO->SetData(s_Data.LineVertexBase, size);
                 RenderCommand::SetDepthTesting(true);
@@ -207,10 +240,53 @@ namespace Snow {
             }
         }
 
-        void Renderer2D::NextBatch() {
-            EndBatch();
+        void Renderer2D::MapQuadInstances() {
+            s_Data.QuadInstanceBase = (QuadInstance*)s_Data.QuadInstanceBuffer->Map(sizeof(QuadInstance), s_Data.QuadInstanceCapacity);
+            s_Data.QuadInstanceCount = 0;
+        }
 
-            BeginBatch();
+        void Renderer2D::DrawQuadInstances() {
+            if (!s_Data.QuadInstanceCount)
+                return;
+
+            uint32_t baseInstance = s_Data.QuadInstanceBuffer->Commit(s_Data.QuadInstanceCount);
+            s_Data.FrameQuadInstances += s_Data.QuadInstanceCount;
+
+            s_Data.TextureShader->Bind();
+            for (uint32_t i = 0; i < Renderer2DStaticData::PageClassCount; i++) {
+                if (s_Data.TexturePages[i].Layers)
+                    s_Data.TexturePages[i].Layers->Bind(i);
+            }
+            RenderCommand::SetDepthTesting(true);
+            s_Data.QuadInstanceBuffer->Bind();
+            s_Data.QuadPipeline->Bind();
+            s_Data.QuadIBO->Bind();
+
+            RenderCommand::DrawIndexedInstanced(s_Data.QuadIBO->GetCount(), s_Data.QuadInstanceCount, s_Data.QuadPipeline->GetSpecification().Type, baseInstance);
+            RenderCommand::SetDepthTesting(false);
+
+            s_Data.QuadInstanceCount = 0;
+        }
+
+        void Renderer2D::SubmitQuad(const glm::mat4& transform, uint32_t textureIndex, const glm::vec4& texRect, const glm::vec4& color) {
+            if (s_Data.QuadInstanceCount == s_Data.QuadInstanceCapacity) {
+                // Texture pages stay bound, only the instance memory ran out. Growing here stalls on the render
+                // thread, which only callers that did not Reserve their count should run into.
+                DrawQuadInstances();
+                MapQuadInstances();
+                if (s_Data.QuadInstanceCapacity == 0) {
+                    s_Data.QuadInstanceBuffer->Resize(s_Data.QuadInstanceBuffer->GetFrameSize() * 2);
+                    MapQuadInstances();
+                }
+            }
+
+            QuadInstance& instance = s_Data.QuadInstanceBase[s_Data.QuadInstanceCount++];
+            instance.Transform[0] = { transform[0][0], transform[1][0], transform[2][0], transform[3][0] };
+            instance.Transform[1] = { transform[0][1], transform[1][1], transform[2][1], transform[3][1] };
+            instance.Transform[2] = { transform[0][2], transform[1][2], transform[2][2], transform[3][2] };
+            instance.TexRect = texRect;
+            instance.Color = glm::packUnorm4x8(color);
+            instance.TexIndex = textureIndex;
         }
 
         void Renderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color) {
@@ -236,56 +312,116 @@ namespace Snow {
         void Renderer2D::DrawQuad(const glm::mat4& transform, const glm::vec4& color) {
             if (color.a != 1.0f)
                 RenderCommand::SetBlending(true);
-            constexpr size_t quadVertexCount = 4;
-            const float textureIndex = 0.0f;
-            constexpr glm::vec2 textureCoords[] = { {0.0f, 0.0f}, {1.0f, 0.0f}, {0.0f, 1.0f}, {1.0f, 1.0f} };
-            const float tilingFactor = 1.0f;
-
-            if (s_Data.QuadIndexCount >= Renderer2DStaticData::MaxQuadIndicies)
-                NextBatch();
-
-            for (size_t i = 0; i < quadVertexCount; i++) {
-                s_Data.QuadVertexData->Position = transform * s_Data.QuadVertexPositions[i];
-                s_Data.QuadVertexData->TexCoord = textureCoords[i];
-                s_Data.QuadVertexData->TexID = textureIndex;
-                s_Data.QuadVertexData->Color = color;
-                s_Data.QuadVertexData++;
-            }
 
-            s_Data.QuadIndexCount += 6;
+            SubmitQuad(transform, NoTexture, { 0.0f, 0.0f, 1.0f, 1.0f }, color);
         }
 
         void Renderer2D::DrawQuad(const glm::mat4& transform, const Ref<API::Texture2D>& texture, const glm::vec4& tint) {
-            constexpr size_t quadVertexCount = 4;
-            constexpr glm::vec2 textureCoords[] = { {0.0f, 0.0f}, {1.0f, 0.0f}, {0.0f, 1.0f}, {1.0f, 1.0f} };
-            const float tilingFactor = 1.0f;
-
-            float textureIndex = 0.0f;
-            for (uint32_t i = 1; i < s_Data.TextureSlotIndex; i++) {
-                if (s_Data.TextureSlots[i].Raw() == texture.Raw()) {
-                    textureIndex = (float)i;
-                    break;
-                }
+            const TextureLocation* location = GetTextureLocation(texture);
+            if (!location) {
+                SubmitQuad(transform, NoTexture, { 0.0f, 0.0f, 1.0f, 1.0f }, tint);
+                return;
             }
 
-            if (textureIndex == 0.0f) {
-                if (s_Data.TextureSlotIndex >= Renderer2DStaticData::MaxTextureSlots)
-                    NextBatch();
+            SubmitQuad(transform, location->Index, { 0.0f, 0.0f, location->UVScale.x, location->UVScale.y }, tint);
+        }
+
+        void Renderer2D::DrawQuad(const glm::mat4& transform, const SpriteRegion& region, const glm::vec4& tint) {
+            SubmitQuad(transform, region.Page, region.IsPacked() ? region.UVRect : glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), tint);
+        }
 
-                textureIndex = (float)s_Data.TextureSlotIndex;
-                s_Data.TextureSlots[s_Data.TextureSlotIndex] = texture;
-                s_Data.TextureSlotIndex++;
+        // Smallest size class holding size texels, PageClassCount if none does
+        static uint32_t GetPageClass(uint32_t size) {
+            uint32_t pageClass = 0;
+            while (pageClass < Renderer2DStaticData::PageClassCount && (Renderer2DStaticData::MinPageSize << pageClass) < size)
+                pageClass++;
+            return pageClass;
+        }
+
+        static uint32_t GetPageLayerStep(uint32_t pageClass) {
+            uint64_t pageSize = Renderer2DStaticData::MinPageSize << pageClass;
+            uint64_t layerSize = pageSize * pageSize * API::Texture::GetBPP(API::TextureFormat::RGBA);
+            return (uint32_t)std::clamp<uint64_t>(Renderer2DStaticData::PageGrowthBytes / layerSize, 1, Renderer2DStaticData::MaxPageLayerStep);
+        }
+
+        uint32_t Renderer2D::AllocateLayer(uint32_t pageClass) {
+            uint32_t pageSize = Renderer2DStaticData::MinPageSize << pageClass;
+            TexturePage& page = s_Data.TexturePages[pageClass];
+            if (!page.Layers)
+                page.Layers = API::Texture2DArray::Create(API::TextureFormat::RGBA, pageSize, pageSize, GetPageLayerStep(pageClass));
+
+            uint32_t layer;
+            if (!page.FreeLayers.empty()) {
+                layer = page.FreeLayers.back();
+                page.FreeLayers.pop_back();
+            }
+            else {
+                if (page.UsedLayers == page.Layers->GetLayerCount())
+                    page.Layers->Resize(page.UsedLayers + GetPageLayerStep(pageClass));
+                layer = page.UsedLayers++;
+            }
+            return (pageClass << 16) | layer;
+        }
+
+        const TextureLocation* Renderer2D::GetTextureLocation(const Ref<API::Texture2D>& texture) {
+            auto it = s_Data.TextureLocations.find(texture.Raw());
+            if (it != s_Data.TextureLocations.end()) {
+                if (it->second.Texture.IsValid() && it->second.ImageVersion == texture->GetImageVersion())
+                    return &it->second;
+
+                // A texture created where a copied one was freed, or an image replaced since the copy, such as a
+                // placeholder that finished loading
+                FreePage(it->second.Index);
+                s_Data.TextureLocations.erase(it);
             }
 
-            for (size_t i = 0; i < quadVertexCount; i++) {
-                s_Data.QuadVertexData->Position = transform * s_Data.QuadVertexPositions[i];
-                s_Data.QuadVertexData->TexCoord = textureCoords[i];
-                s_Data.QuadVertexData->TexID = textureIndex;
-                s_Data.QuadVertexData->Color = tint;
-                s_Data.QuadVertexData++;
+            uint32_t pageClass = GetPageClass(std::max(texture->GetWidth(), texture->GetHeight()));
+            if (pageClass >= Renderer2DStaticData::PageClassCount) {
+                SNOW_CORE_ERROR("Texture {0} is too large to be drawn by Renderer2D", texture->GetPath());
+                return nullptr;
             }
 
-            s_Data.QuadIndexCount += 6;
+            // The texture sits in the corner of the layer, its edges fill the rest so nothing past them is sampled or
+            // filtered into the mips
+            uint32_t index = AllocateLayer(pageClass);
+            uint32_t pageSize = GetPageSize(index);
+            CopyToPage(index, texture, 0, 0, pageSize);
+
+            TextureLocation& location = s_Data.TextureLocations[texture.Raw()];
+            location.Texture = texture;
+            location.ImageVersion = texture->GetImageVersion();
+            location.Index = index;
+            location.UVScale = { (float)texture->GetWidth() / pageSize, (float)texture->GetHeight() / pageSize };
+            return &location;
+        }
+
+        uint32_t Renderer2D::AllocatePage(uint32_t size) {
+            uint32_t pageClass = GetPageClass(size);
+            if (pageClass >= Renderer2DStaticData::PageClassCount)
+                return SpriteRegion::NoPage;
+
+            return AllocateLayer(pageClass);
+        }
+
+        void Renderer2D::FreePage(uint32_t page) {
+            s_Data.TexturePages[page >> 16].ReleasedLayers.push_back(page & 0xffff);
+        }
+
+        uint32_t Renderer2D::GetPageSize(uint32_t page) {
+            return Renderer2DStaticData::MinPageSize << (page >> 16);
+        }
+
+        void Renderer2D::CopyToPage(uint32_t page, const Ref<API::Texture2D>& source, uint32_t x, uint32_t y, uint32_t extrude) {
+            s_Data.TexturePages[page >> 16].Layers->SetLayer(page & 0xffff, source, x, y, extrude);
+        }
+
+        void Renderer2D::ReleaseTexture(const Ref<API::Texture2D>& texture) {
+            auto it = s_Data.TextureLocations.find(texture.Raw());
+            if (it == s_Data.TextureLocations.end())
+                return;
+
+            FreePage(it->second.Index);
+            s_Data.TextureLocations.erase(it);
         }
 
 
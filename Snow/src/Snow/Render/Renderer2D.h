@@ -8,6 +8,7 @@
 #include "Snow/Render/EditorCamera.h"
 
 #include "Snow/Render/Pipeline.h"
+#include "Snow/Render/SpriteAtlas.h"
 
 
 #include <glm/glm.hpp>
@@ -15,6 +16,8 @@
 
 namespace Snow {
     namespace Render {
+        struct TextureLocation;
+
         class Renderer2D {
         public:
             static void Init();
@@ -24,6 +27,12 @@ namespace Snow {
             static void BeginScene(const Camera& camera, const glm::mat4& viewMatrix);
             static void EndScene();
 
+            // Moves the instance ring on to the next frame's region and reclaims the page layers of textures freed since.
+            // Every scene drawn in a frame shares one region, so this is called once per frame, at the frame boundary.
+            static void NextFrame();
+            // Makes room for quadCount more quads in this frame's region. Growing the ring waits for the render thread,
+            // so callers that know their count before recording do it once here, outside of BeginScene/EndScene.
+            static void Reserve(uint32_t quadCount);
 
             static void DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color);
             static void DrawQuad(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color);
@@ -32,15 +41,33 @@ namespace Snow {
 
             static void DrawQuad(const glm::mat4& transform, const glm::vec4& color);
             static void DrawQuad(const glm::mat4& transform, const Ref<API::Texture2D>& texture, const glm::vec4& tint = glm::vec4(1.0f));
+            static void DrawQuad(const glm::mat4& transform, const SpriteRegion& region, const glm::vec4& tint = glm::vec4(1.0f));
 
             static void DrawLine(const glm::vec2& startPosition, const glm::vec2& endPosition, const glm::vec4& color);
             static void DrawLine(const glm::vec3& startPosition, const glm::vec3& endPosition, const glm::vec4& color);
 
+            // Frees the texture page layer a texture was copied into, it is copied again on its next draw
+            static void ReleaseTexture(const Ref<API::Texture2D>& texture);
+
+            // Layers of the texture pages handed out whole, sprite atlases pack straight into them and draw their
+            // regions without another copy. Pages are at least size texels wide, SpriteRegion::NoPage if none is. Freed
+            // pages are handed out again from the next frame on.
+            static uint32_t AllocatePage(uint32_t size);
+            static void FreePage(uint32_t page);
+            static uint32_t GetPageSize(uint32_t page);
+            // Copies all of source into the page with its lower left corner at x, y, repeating its edges extrude texels out
+            static void CopyToPage(uint32_t page, const Ref<API::Texture2D>& source, uint32_t x, uint32_t y, uint32_t extrude = 0);
+
         private:
             static void BeginBatch();
             static void EndBatch();
 
-            static void NextBatch();
+            static void MapQuadInstances();
+            static void DrawQuadInstances();
+
+            static void SubmitQuad(const glm::mat4& transform, uint32_t textureIndex, const glm::vec4& texRect, const glm::vec4& color);
+            static const TextureLocation* GetTextureLocation(const Ref<API::Texture2D>& texture);
+            static uint32_t AllocateLayer(uint32_t pageClass);
         };
     }
 }
\ No newline at end of file
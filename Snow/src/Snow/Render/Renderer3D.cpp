@@ -8,24 +8,76 @@
 
 namespace Snow {
 	namespace Render {
+		struct Renderer3DData {
+			const Shader* BoundShader = nullptr;
+			const Mesh* BoundMesh = nullptr;
+			const API::IndexBuffer* BoundIndexBuffer = nullptr;
+			const MaterialInstance* BoundMaterialInstance = nullptr;
+			const Mesh* BoundQuantization = nullptr;
+
+			// Resolved whenever the bound shader changes
+			uint32_t ObjectTransformBinding = Shader::InvalidBinding;
+			uint32_t QuantizationBinding = Shader::InvalidBinding;
+		};
+		static Renderer3DData s_Data;
+
+		void Renderer3D::ResetBindings() {
+			s_Data = {};
+		}
+
 		void Renderer3D::DrawMesh(Ref<Render::Mesh> mesh, const glm::mat4& transform, Ref<MaterialInstance>& materialInstance) {
+			DrawMeshInstanced(mesh, &transform, 1, materialInstance);
+		}
+
+		void Renderer3D::DrawMeshInstanced(Ref<Render::Mesh> mesh, const glm::mat4* transforms, uint32_t count, Ref<MaterialInstance>& materialInstance, uint32_t lod) {
+			SNOW_CORE_ASSERT(count <= MaxInstancesPerDraw, "Too many instances for one draw");
+
 			Ref<MaterialInstance> matInstance = mesh->GetMaterialInstance();
 			Ref<Material> material = matInstance->GetMaterial();
-			
-			mesh->GetVertexBuffer()->Bind();
-			material->GetShader()->Bind();
+			Ref<Shader> shader = material->GetShader();
+
+			// Draws arrive sorted by shader, material and mesh, so only rebind what changed
+			if (s_Data.BoundMesh != mesh.Raw()) {
+				mesh->GetVertexBuffer()->Bind();
+				mesh->GetPipeline()->Bind();
+				s_Data.BoundMesh = mesh.Raw();
+				s_Data.BoundIndexBuffer = nullptr;
+			}
+
+			// Every LOD indexes the same vertex buffer, switching level only swaps the index buffer
+			Ref<API::IndexBuffer> indexBuffer = mesh->GetIndexBuffer(lod);
+			if (s_Data.BoundIndexBuffer != indexBuffer.Raw()) {
+				indexBuffer->Bind();
+				s_Data.BoundIndexBuffer = indexBuffer.Raw();
+			}
 
-			auto tf = transform;
+			// The only shader bind between ResetBindings and the end of the pass, material instances leave the shader
+			// to this so BoundShader stays true
+			if (s_Data.BoundShader != shader.Raw()) {
+				shader->Bind();
+				s_Data.BoundShader = shader.Raw();
+				s_Data.ObjectTransformBinding = shader->GetUniformBufferBinding("ObjectTransform");
+				s_Data.QuantizationBinding = shader->GetUniformBufferBinding("MeshQuantization");
+				s_Data.BoundMaterialInstance = nullptr;
+				s_Data.BoundQuantization = nullptr;
+			}
 
-			material->GetShader()->SetUniformBufferData("ObjectTransform", &tf, sizeof(glm::mat4));
+			// Compact positions are stored relative to the mesh bounds
+			if (mesh->GetVertexFormat() == VertexFormat::Compact && s_Data.BoundQuantization != mesh.Raw()) {
+				const Core::AABB& bounds = mesh->GetBoundingBox();
+				glm::vec4 quantization[2] = { glm::vec4(bounds.MinBounds, 0.0f), glm::vec4(bounds.MaxBounds - bounds.MinBounds, 0.0f) };
+				shader->SetUniformBufferData(s_Data.QuantizationBinding, quantization, sizeof(quantization));
+				s_Data.BoundQuantization = mesh.Raw();
+			}
 
-			if(materialInstance)
+			shader->SetUniformBufferData(s_Data.ObjectTransformBinding, (void*)transforms, count * sizeof(glm::mat4));
+
+			if (materialInstance && s_Data.BoundMaterialInstance != materialInstance.Raw()) {
 				materialInstance->Bind();
-			
-			mesh->GetIndexBuffer()->Bind();
-			RenderCommand::SetDepthTesting(true);
-			RenderCommand::DrawIndexed(mesh->GetIndexBuffer()->GetCount(), PrimitiveType::Triangle);
-			RenderCommand::SetDepthTesting(false);
+				s_Data.BoundMaterialInstance = materialInstance.Raw();
+			}
+
+			RenderCommand::DrawIndexedInstanced(indexBuffer->GetCount(), count, PrimitiveType::Triangle);
 		}
 	}
 }
\ No newline at end of file
@@ -9,7 +9,15 @@ namespace Snow {
 	namespace Render {
 		class Renderer3D {
 		public:
+			// Forgets the shader, mesh and material bound by the previous DrawMesh, call when other code may have changed them
+			static void ResetBindings();
+
 			static void DrawMesh(Ref<Mesh> mesh, const glm::mat4& transform, Ref<MaterialInstance>& materialInstance);
+			// Draws count copies of one LOD of the mesh in one call, count must not exceed MaxInstancesPerDraw
+			static void DrawMeshInstanced(Ref<Mesh> mesh, const glm::mat4* transforms, uint32_t count, Ref<MaterialInstance>& materialInstance, uint32_t lod = 0);
+
+			// Size of the ObjectTransform array in PBR.vert.glsl, 16KB is the smallest uniform block GL guarantees
+			static constexpr uint32_t MaxInstancesPerDraw = 256;
 		};
 	}
 }
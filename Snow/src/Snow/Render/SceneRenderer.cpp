@@ -4,11 +4,16 @@
 #include "Snow/Render/Renderer.h"
 #include "Snow/Render/Renderer2D.h"
 #include "Snow/Render/Renderer3D.h"
+#include "Snow/Render/TextureStreamer.h"
 
 #include "Snow/ImGui/ImGuiLayer.h"
 
+#include "Snow/Math/Frustum.h"
+
 #include <imgui.h>
 
+#include <unordered_map>
+
 namespace Snow {
 	namespace Render {
 		struct SceneRendererData {
@@ -31,20 +36,52 @@ namespace Snow {
 
 			struct DrawMeshCommand {
 				Ref<Mesh> Mesh;
-				Ref<MaterialInstance> MaterialInstance;
+				Ref<MaterialInstance> MaterialInstance; // The override, or the mesh's own when there is none
 				glm::mat4 Transform;
+				uint32_t LOD;
+				float ScreenSize = 0.0f; // Pixels the bounding sphere's diameter covers, set by SelectLODs
+				uint64_t MaterialKey = 0; // Content key of the material instance drawn with, set by SortDrawList
 			};
 
 			std::vector<DrawMeshCommand> MeshDrawList;
 
+			struct DrawKey {
+				uint64_t Key;
+				uint32_t Index;
+			};
+
+			std::vector<DrawKey> MeshDrawKeys;
+			std::vector<DrawKey> MeshDrawKeysScratch;
+
+			std::vector<glm::mat4> InstanceTransforms;
+
 			struct DrawQuadCommand {
 				glm::mat4 Transform;
 				glm::vec4 Color;
+				Ref<API::Texture2D> Texture; // Untextured when null and the region is not packed either
+				SpriteRegion Region;
 			};
 
 			std::vector<DrawQuadCommand> QuadDrawList;
 
+			// Bounding spheres of one draw list, laid out for Frustum::CullSpheres
+			struct CullingData {
+				std::vector<float> X, Y, Z, Radius;
+				std::vector<uint8_t> Visible;
+			} Culling;
+
+			// Draws of the last flushed frame left after culling, and the ones culled
+			struct DrawStatistics {
+				uint32_t Meshes = 0, Quads = 0, Culled = 0;
+			} DrawStats;
+
+			struct LODInfo {
+				float ErrorThreshold = 1.0f; // Pixels a LOD may deviate from the full mesh on screen
+				uint32_t Triangles = 0, FullDetailTriangles = 0;
+			} LODData;
+
 			Ref<Shader> CompositeShader;
+			uint32_t CameraBinding, EnvironmentBinding, CompositeBinding;
 
 			Ref<RenderPass> GeometryPass;
 			Ref<RenderPass> CompPass;
@@ -82,6 +119,9 @@ namespace Snow {
 			compPipelineSpec.Shader = Renderer::GetShaderLibrary()->Get("SceneComposite");
 			
 			s_Data.CompositeShader = Renderer::GetShaderLibrary()->Get("SceneComposite");
+			s_Data.CameraBinding = s_Data.CompositeShader->GetUniformBufferBinding("Camera");
+			s_Data.EnvironmentBinding = s_Data.CompositeShader->GetUniformBufferBinding("Environment");
+			s_Data.CompositeBinding = s_Data.CompositeShader->GetUniformBufferBinding("CompositeBuffer");
 
 
 		}
@@ -116,11 +156,229 @@ namespace Snow {
 		}
 
 		void SceneRenderer::SubmitMesh(Ref<Mesh> mesh, const glm::mat4& transform, const Ref<MaterialInstance> overrideMaterial) {
-			s_Data.MeshDrawList.push_back({ mesh, overrideMaterial, transform});
+			// Meshes still loading in the background have nothing to draw yet
+			if (!mesh->IsLoaded())
+				return;
+
+			// Sorted, grouped and bound with the same instance
+			s_Data.MeshDrawList.push_back({ mesh, overrideMaterial ? overrideMaterial : mesh->GetMaterialInstance(), transform, 0 });
 		}
 
 		void SceneRenderer::Submit2DQuad(const glm::mat4& transform, const glm::vec4& color) {
-			s_Data.QuadDrawList.push_back({ transform, color });
+			s_Data.QuadDrawList.push_back({ transform, color, nullptr, {} });
+		}
+
+		void SceneRenderer::Submit2DQuad(const glm::mat4& transform, const Ref<API::Texture2D>& texture, const glm::vec4& tint) {
+			s_Data.QuadDrawList.push_back({ transform, tint, texture, {} });
+		}
+
+		void SceneRenderer::Submit2DQuad(const glm::mat4& transform, const SpriteRegion& region, const glm::vec4& tint) {
+			s_Data.QuadDrawList.push_back({ transform, tint, nullptr, region });
+		}
+
+		// Drops the draws whose bounding sphere is outside the frustum, keeping the order of the rest. Returns how many
+		// were dropped.
+		template<typename T, typename GetSphere>
+		static uint32_t CullDrawList(std::vector<T>& drawList, const Core::Frustum& frustum, GetSphere getSphere) {
+			auto& culling = s_Data.Culling;
+			uint32_t count = (uint32_t)drawList.size();
+			culling.X.resize(count);
+			culling.Y.resize(count);
+			culling.Z.resize(count);
+			culling.Radius.resize(count);
+			culling.Visible.resize(count);
+			for (uint32_t i = 0; i < count; i++) {
+				Core::BoundingSphere sphere = getSphere(drawList[i]);
+				culling.X[i] = sphere.Center.x;
+				culling.Y[i] = sphere.Center.y;
+				culling.Z[i] = sphere.Center.z;
+				culling.Radius[i] = sphere.Radius;
+			}
+			frustum.CullSpheres(culling.X.data(), culling.Y.data(), culling.Z.data(), culling.Radius.data(), count, culling.Visible.data());
+
+			uint32_t visible = 0;
+			for (uint32_t i = 0; i < count; i++) {
+				if (!culling.Visible[i])
+					continue;
+				if (visible != i)
+					drawList[visible] = std::move(drawList[i]);
+				visible++;
+			}
+			drawList.resize(visible);
+			return count - visible;
+		}
+
+		// Every submitted draw is tested here, whether the scene found it through its spatial index or it was
+		// submitted directly
+		void SceneRenderer::CullDrawLists() {
+			auto& sceneCamera = s_Data.SceneData.Camera;
+			Core::Frustum frustum(sceneCamera.Camera.GetProjection() * sceneCamera.ViewMatrix);
+
+			uint32_t culled = CullDrawList(s_Data.MeshDrawList, frustum, [](const SceneRendererData::DrawMeshCommand& dc) {
+				return dc.Mesh->GetBoundingSphere().Transform(dc.Transform);
+			});
+			// Quads span -0.5 to 0.5 on their local x and y axes
+			culled += CullDrawList(s_Data.QuadDrawList, frustum, [](const SceneRendererData::DrawQuadCommand& dc) {
+				float radius = 0.5f * (glm::length(glm::vec3(dc.Transform[0])) + glm::length(glm::vec3(dc.Transform[1])));
+				return Core::BoundingSphere(glm::vec3(dc.Transform[3]), radius);
+			});
+			s_Data.DrawStats.Culled = culled;
+		}
+
+		// Pixels one world unit covers at distance 1, or at any distance for orthographic cameras
+		static float GetPixelsPerUnit(const glm::mat4& projection) {
+			float viewportHeight = (float)s_Data.GeometryPass->GetSpecification().TargetFramebuffer->GetSpecification().Height;
+			return 0.5f * viewportHeight * projection[1][1];
+		}
+
+		void SceneRenderer::SelectLODs() {
+			auto& sceneCamera = s_Data.SceneData.Camera;
+			const glm::mat4& projection = sceneCamera.Camera.GetProjection();
+			glm::vec3 cameraPosition = glm::inverse(sceneCamera.ViewMatrix)[3];
+			bool perspective = projection[3][3] == 0.0f;
+			float pixelsPerUnit = GetPixelsPerUnit(projection);
+
+			auto& lodData = s_Data.LODData;
+			lodData.Triangles = 0;
+			lodData.FullDetailTriangles = 0;
+			for (auto& dc : s_Data.MeshDrawList) {
+				const Core::BoundingSphere& localSphere = dc.Mesh->GetBoundingSphere();
+				Core::BoundingSphere sphere = localSphere.Transform(dc.Transform);
+
+				float distance = glm::length(sphere.Center - cameraPosition);
+				float scale = localSphere.Radius > 0.0f ? sphere.Radius / localSphere.Radius : 1.0f;
+				float projectedScale = pixelsPerUnit * scale;
+				if (perspective)
+					projectedScale /= std::max(distance, sphere.Radius);
+
+				// The coarsest level whose error, projected to the screen, stays under the threshold
+				dc.LOD = projectedScale > 0.0f ? dc.Mesh->SelectLOD(lodData.ErrorThreshold / projectedScale) : 0;
+				dc.ScreenSize = projectedScale * 2.0f * localSphere.Radius;
+
+				lodData.Triangles += dc.Mesh->GetIndexBuffer(dc.LOD)->GetCount() / 3;
+				lodData.FullDetailTriangles += dc.Mesh->GetIndexBuffer()->GetCount() / 3;
+			}
+		}
+
+		static void RequestTextures(const std::vector<Ref<API::Texture>>& textures, float screenSize) {
+			for (auto& texture : textures) {
+				if (texture)
+					TextureStreamer::Request(texture.Raw(), screenSize);
+			}
+		}
+
+		// Asks the streamer for the texture levels each visible draw samples. Textures are assumed to span the mesh or
+		// quad they are mapped onto. Atlas regions sample the copy packed into their page, not the streamed texture.
+		void SceneRenderer::RequestTextureMips() {
+			for (auto& dc : s_Data.MeshDrawList) {
+				RequestTextures(dc.MaterialInstance->GetTextures(), dc.ScreenSize);
+				RequestTextures(dc.MaterialInstance->GetMaterial()->GetTextures(), dc.ScreenSize);
+			}
+
+			auto& sceneCamera = s_Data.SceneData.Camera;
+			const glm::mat4& projection = sceneCamera.Camera.GetProjection();
+			glm::vec3 cameraPosition = glm::inverse(sceneCamera.ViewMatrix)[3];
+			bool perspective = projection[3][3] == 0.0f;
+			float pixelsPerUnit = GetPixelsPerUnit(projection);
+			for (auto& dc : s_Data.QuadDrawList) {
+				if (!dc.Texture)
+					continue;
+
+				float size = std::max(glm::length(glm::vec3(dc.Transform[0])), glm::length(glm::vec3(dc.Transform[1])));
+				float screenSize = pixelsPerUnit * size;
+				if (perspective)
+					screenSize /= std::max(glm::length(glm::vec3(dc.Transform[3]) - cameraPosition), size);
+				TextureStreamer::Request(dc.Texture.Raw(), screenSize);
+			}
+		}
+
+		// Opaque:      | pass:2 | 0 | shader:10 | material:12 | mesh:12 | depth:27 front to back |
+		// Translucent: | pass:2 | 1 | depth:27 back to front | shader:10 | material:12 | mesh:12 |
+		enum class DrawPass : uint64_t {
+			Geometry = 0
+		};
+
+		template<typename T>
+		static uint32_t GetSortID(std::unordered_map<T, uint32_t>& ids, T object) {
+			auto [it, inserted] = ids.try_emplace(object, (uint32_t)ids.size());
+			return it->second;
+		}
+
+		static uint64_t MakeDrawKey(DrawPass pass, bool translucent, uint32_t shaderID, uint32_t materialID, uint32_t meshID, float depth) {
+			// IDs past their fields share the last value instead of wrapping onto the first ones. Draws in that bucket
+			// sort less tightly, runs still compare the real mesh and material so they are never merged wrongly.
+			shaderID = std::min(shaderID, 0x3ffu);
+			materialID = std::min(materialID, 0xfffu);
+			meshID = std::min(meshID, 0xfffu);
+
+			uint32_t depthBits;
+			memcpy(&depthBits, &depth, sizeof(float));
+			// Distances are non-negative, so their bit patterns already sort like the floats
+			uint64_t depthKey = depthBits >> 5;
+			uint64_t stateKey = ((uint64_t)shaderID << 24) | ((uint64_t)materialID << 12) | meshID;
+
+			uint64_t key = (uint64_t)pass << 62;
+			if (!translucent)
+				return key | (stateKey << 27) | depthKey;
+
+			return key | (1ull << 61) | ((~depthKey & 0x7ffffff) << 34) | stateKey;
+		}
+
+		// LSD radix sort over 8 bit digits, digits every key shares are skipped
+		static void RadixSort(std::vector<SceneRendererData::DrawKey>& keys, std::vector<SceneRendererData::DrawKey>& scratch) {
+			scratch.resize(keys.size());
+			for (uint32_t shift = 0; shift < 64; shift += 8) {
+				uint32_t counts[256] = {};
+				for (auto& key : keys)
+					counts[(key.Key >> shift) & 0xff]++;
+
+				if (counts[(keys[0].Key >> shift) & 0xff] == keys.size())
+					continue;
+
+				uint32_t offset = 0;
+				for (uint32_t i = 0; i < 256; i++) {
+					uint32_t count = counts[i];
+					counts[i] = offset;
+					offset += count;
+				}
+
+				for (auto& key : keys)
+					scratch[counts[(key.Key >> shift) & 0xff]++] = key;
+				keys.swap(scratch);
+			}
+		}
+
+		void SceneRenderer::SortDrawList() {
+			auto& drawList = s_Data.MeshDrawList;
+			auto& keys = s_Data.MeshDrawKeys;
+			keys.clear();
+			if (drawList.empty())
+				return;
+
+			glm::vec3 cameraPosition = glm::inverse(s_Data.SceneData.Camera.ViewMatrix)[3];
+
+			std::unordered_map<const void*, uint32_t> shaderIDs, meshIDs;
+			// Materials are told apart by content, separate instances set up alike still end up in one run
+			std::unordered_map<uint64_t, uint32_t> materialIDs;
+			keys.reserve(drawList.size());
+			// Each LOD is keyed as its own mesh so instanced runs never mix levels
+			for (uint32_t i = 0; i < drawList.size(); i++) {
+				auto& dc = drawList[i];
+				Ref<Material> material = dc.MaterialInstance->GetMaterial();
+				dc.MaterialKey = dc.MaterialInstance->GetContentKey();
+
+				glm::vec3 offset = glm::vec3(dc.Transform[3]) - cameraPosition;
+				float depth = glm::dot(offset, offset);
+
+				// Keyed on the shader Renderer3D binds, the mesh's own, an override material only supplies values
+				uint64_t key = MakeDrawKey(DrawPass::Geometry, material->IsTranslucent(),
+					GetSortID<const void*>(shaderIDs, dc.Mesh->GetMaterialInstance()->GetMaterial()->GetShader().Raw()),
+					GetSortID(materialIDs, dc.MaterialKey),
+					GetSortID<const void*>(meshIDs, dc.Mesh->GetIndexBuffer(dc.LOD).Raw()), depth);
+				keys.push_back({ key, i });
+			}
+
+			RadixSort(keys, s_Data.MeshDrawKeysScratch);
 		}
 
 		void SceneRenderer::GeometryPass() {
@@ -139,25 +397,51 @@ namespace Snow {
 			EnvironmentUB enviroUB;
 			enviroUB.lights = s_Data.SceneData.ActiveLight;
 			enviroUB.u_CameraPosition = cameraPosition;
-			s_Data.CompositeShader->SetUniformBufferData("Environment", &enviroUB, sizeof(EnvironmentUB));
-
-			s_Data.CompositeShader->SetUniformBufferData("Camera", &viewProjection, sizeof(glm::mat4));
-
-			for (auto& dc : s_Data.MeshDrawList) {
-				Ref<MaterialInstance> mi = dc.Mesh->GetMaterialInstance();
-
-				
-
-				//pl->SetUniformBufferData(2, &s_Data.SceneData.ActiveLight, sizeof(Light));
-
-				Renderer3D::DrawMesh(dc.Mesh, dc.Transform, dc.MaterialInstance);
-
-				//pl->SetUniformBufferData(2, )
+			s_Data.CompositeShader->SetUniformBufferData(s_Data.EnvironmentBinding, &enviroUB, sizeof(EnvironmentUB));
+
+			s_Data.CompositeShader->SetUniformBufferData(s_Data.CameraBinding, &viewProjection, sizeof(glm::mat4));
+
+			CullDrawLists();
+			// Before any quad is recorded, so the instance ring never has to grow in the middle of the batch
+			Renderer2D::Reserve((uint32_t)s_Data.QuadDrawList.size());
+			SelectLODs();
+			RequestTextureMips();
+			SortDrawList();
+
+			Renderer3D::ResetBindings();
+			RenderCommand::SetDepthTesting(true);
+			// Keys group draws by shader, material content and mesh, so each run of identical draws becomes one instanced
+			// draw, bound with the first draw's material instance. Keys only hash the content, runs compare the real thing.
+			auto& keys = s_Data.MeshDrawKeys;
+			auto& transforms = s_Data.InstanceTransforms;
+			for (size_t first = 0; first < keys.size();) {
+				auto& dc = s_Data.MeshDrawList[keys[first].Index];
+
+				transforms.clear();
+				size_t last = first;
+				while (last < keys.size() && transforms.size() < Renderer3D::MaxInstancesPerDraw) {
+					auto& next = s_Data.MeshDrawList[keys[last].Index];
+					if (next.Mesh.Raw() != dc.Mesh.Raw() || next.LOD != dc.LOD || next.MaterialKey != dc.MaterialKey
+						|| !next.MaterialInstance->DrawsLike(*dc.MaterialInstance))
+						break;
+
+					transforms.push_back(next.Transform);
+					last++;
+				}
+
+				Renderer3D::DrawMeshInstanced(dc.Mesh, transforms.data(), (uint32_t)transforms.size(), dc.MaterialInstance, dc.LOD);
+				first = last;
 			}
+			RenderCommand::SetDepthTesting(false);
 
 			Render::Renderer2D::BeginScene(s_Data.SceneData.Camera.Camera, s_Data.SceneData.Camera.ViewMatrix);
 			for (auto& dc : s_Data.QuadDrawList) {
-				Renderer2D::DrawQuad(dc.Transform, dc.Color);
+				if (dc.Region.IsPacked())
+					Renderer2D::DrawQuad(dc.Transform, dc.Region, dc.Color);
+				else if (dc.Texture)
+					Renderer2D::DrawQuad(dc.Transform, dc.Texture, dc.Color);
+				else
+					Renderer2D::DrawQuad(dc.Transform, dc.Color);
 			}
 			Render::Renderer2D::EndScene();
 
@@ -171,7 +455,7 @@ namespace Snow {
 			s_Data.CompositeData.Samples = s_Data.GeometryPass->GetSpecification().TargetFramebuffer->GetSpecification().Samples;
 
 			s_Data.CompositeShader->Bind();
-			s_Data.CompositeShader->SetUniformBufferData("CompositeBuffer", &s_Data.CompositeData, sizeof(SceneRendererData::CompositeInfo));
+			s_Data.CompositeShader->SetUniformBufferData(s_Data.CompositeBinding, &s_Data.CompositeData, sizeof(SceneRendererData::CompositeInfo));
 			s_Data.GeometryPass->GetSpecification().TargetFramebuffer->BindTexture();
 			Renderer::SubmitFullscreenQuad(nullptr);
 
@@ -186,6 +470,28 @@ namespace Snow {
 			ImGui::Checkbox("Bloom Enable", &s_Data.CompositeData.Bloom);
 			if (s_Data.CompositeData.Bloom)
 				ImGui::DragFloat("Bloom Threshold", &s_Data.CompositeData.BloomThreshold, 0.01f, 0.0f, 1.0f);
+
+			auto& stats = s_Data.DrawStats;
+			ImGui::Text("Meshes: %u, Quads: %u, Culled: %u", stats.Meshes, stats.Quads, stats.Culled);
+
+			auto& lodData = s_Data.LODData;
+			ImGui::DragFloat("LOD Error (px)", &lodData.ErrorThreshold, 0.05f, 0.0f, 16.0f);
+			ImGui::Text("Triangles: %u (%u at full detail)", lodData.Triangles, lodData.FullDetailTriangles);
+
+			auto streaming = TextureStreamer::GetStatistics();
+			int budget = (int)(streaming.Budget >> 20);
+			if (ImGui::DragInt("Texture Budget (MB)", &budget, 4.0f, 16, 8192))
+				TextureStreamer::SetBudget((uint64_t)std::max(budget, 16) << 20);
+			ImGui::Text("Streamed Textures: %u, %.1f MB resident, %u loading", streaming.Textures, streaming.ResidentBytes / (1024.0f * 1024.0f), streaming.Loading);
+
+			RenderStateStatistics state = RenderCommand::GetStateStatistics();
+			ImGui::Text("State Changes: %u skipped of %u", state.Skipped, state.Calls);
+
+			if (RenderThread::IsRunning()) {
+				RenderThread::Statistics thread = RenderThread::GetStatistics();
+				ImGui::Text("Render Thread: %u commands, %.1f KB", thread.Commands, thread.Bytes / 1024.0f);
+				ImGui::Text("Render Thread: %.2f ms executing, %.2f ms waited on", thread.ExecuteTime, thread.WaitTime);
+			}
 			ImGui::End();
 		}
 
@@ -197,6 +503,9 @@ namespace Snow {
 			GeometryPass();
 			CompositePass();
 
+			s_Data.DrawStats.Meshes = (uint32_t)s_Data.MeshDrawList.size();
+			s_Data.DrawStats.Quads = (uint32_t)s_Data.QuadDrawList.size();
+
 			s_Data.QuadDrawList.clear();
 			s_Data.MeshDrawList.clear();
 			s_Data.SceneData = {};
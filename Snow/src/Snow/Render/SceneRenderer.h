@@ -3,6 +3,7 @@
 #include "Snow/Scene/Scene.h"
 
 #include "Snow/Render/Mesh.h"
+#include "Snow/Render/SpriteAtlas.h"
 
 #include "Snow/Scene/SceneCamera.h"
 
@@ -25,11 +26,17 @@ namespace Snow {
 
 			static void SubmitMesh(Ref<Mesh> mesh, const glm::mat4& transform = glm::mat4(1.0f), const Ref<MaterialInstance> overrideMaterial = nullptr);
 			static void Submit2DQuad(const glm::mat4& transform, const glm::vec4& color);
+			static void Submit2DQuad(const glm::mat4& transform, const Ref<API::Texture2D>& texture, const glm::vec4& tint = glm::vec4(1.0f));
+			static void Submit2DQuad(const glm::mat4& transform, const SpriteRegion& region, const glm::vec4& tint = glm::vec4(1.0f));
 
 			static void* GetFinalColorAttachment();
 			static void OnImGuiRender();
 		private:
 			static void FlushDrawList();
+			static void CullDrawLists();
+			static void SelectLODs();
+			static void RequestTextureMips();
+			static void SortDrawList();
 
 			static void GeometryPass();
 			static void CompositePass();
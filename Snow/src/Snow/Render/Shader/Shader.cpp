@@ -5,6 +5,7 @@
 
 #include "Snow/Platform/OpenGL/OpenGLShader.h"
 #include "Snow/Platform/Vulkan/VulkanShader.h"
+#include "Snow/Platform/Null/NullShader.h"
 
 #if defined(SNOW_PLATFORM_WINDOWS)
     #include "Snow/Platform/DirectX11/DirectXShader.h"
@@ -16,6 +17,7 @@ namespace Snow {
             switch(Renderer::GetRenderAPI()) {
             case RenderAPIType::None:   return nullptr;
             case RenderAPIType::OpenGL: return Ref<OpenGLShader>::Create(shaderModules);
+            case RenderAPIType::Null:   return Ref<NullShader>::Create(shaderModules);
             //case RenderAPIType::Vulkan: return Ref<VulkanShader>::Create(shaderModules);
 #if defined(SNOW_PLATFORM_WINDOWS)
             //case RenderAPIType::DirectX:    return Ref<DirectX11Shader>::Create(shaderModules);
@@ -25,17 +25,24 @@ namespace Snow {
 
             virtual void Bind() const = 0;
             virtual void Reload() = 0;
+            // Goes up with every reload, anything resolved from the shader's reflection is stale once it changes
+            uint32_t GetReloadCount() const { return m_ReloadCount; }
 
             virtual const ShaderUniformBuffer& GetUniformBuffer(const std::string& name) const = 0;
+            // Binding point of the named uniform buffer, InvalidBinding if there is none. Resolve it once and update the
+            // buffer through it, so per-draw updates skip the name lookup.
+            virtual uint32_t GetUniformBufferBinding(const std::string& name) const = 0;
             virtual const std::unordered_map<std::string, ShaderResource>& GetResources() const = 0;
 
             virtual void SetUniformBufferData(const std::string& uniformBufferName, void* data = nullptr, uint32_t size = 0) = 0;
             virtual void SetUniformBufferData(uint32_t bindingPoint, void* data = nullptr, uint32_t size = 0) = 0;
 
+            static constexpr uint32_t InvalidBinding = UINT32_MAX;
+
             static Ref<Shader> Create(const std::initializer_list<ShaderModule>& shaderModules);// ShaderType type, const std::string& path);
 
-            
-            
+        protected:
+            uint32_t m_ReloadCount = 0;
         };
         
     }
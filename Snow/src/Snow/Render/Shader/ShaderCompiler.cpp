@@ -0,0 +1,140 @@
+#include <spch.h>
+
+#include "Snow/Render/Shader/ShaderCompiler.h"
+
+#include <spirv_cross.hpp>
+
+namespace Snow {
+    namespace Render {
+        void ShaderCompiler::LoadSources(const std::vector<ShaderModule>& modules, std::vector<std::string>& outSources, std::vector<ShaderType>& outTypes) {
+            outSources.clear();
+            outTypes.clear();
+
+            if (modules.size() == 1) {
+                PreProcess(ReadFile(modules[0].second), outSources, outTypes);
+                return;
+            }
+
+            for (auto& [type, path] : modules) {
+                outSources.push_back(ReadFile(path));
+                outTypes.push_back(type);
+            }
+        }
+
+        std::string ShaderCompiler::ReadFile(const std::string& path) {
+            std::string result;
+            std::ifstream inFile(path, std::ios::in | std::ios::binary);
+            if (inFile.is_open()) {
+                inFile.seekg(0, std::ios::end);
+                result.resize(inFile.tellg());
+                inFile.seekg(0, std::ios::beg);
+                inFile.read(&result[0], result.size());
+            }
+            else {
+                SNOW_CORE_ERROR("Could not read file. (Path):{0}", path);
+            }
+            return result;
+        }
+
+        void ShaderCompiler::PreProcess(const std::string& source, std::vector<std::string>& outSources, std::vector<ShaderType>& outTypes) {
+            const char* typeToken = "#type";
+            size_t typeTokenLength = strlen(typeToken);
+            size_t pos = source.find(typeToken, 0);
+            while (pos != std::string::npos) {
+                size_t eol = source.find_first_of("\r\n", pos);
+                SNOW_CORE_ASSERT(eol != std::string::npos, "Syntax Error");
+                size_t begin = pos + typeTokenLength + 1;
+                std::string type = source.substr(begin, eol - begin);
+                SNOW_CORE_ASSERT(ShaderTypeFromString(type) != ShaderType::None, "Invalid shader type");
+
+                size_t nextLinePos = source.find_first_not_of("\r\n", eol);
+                pos = source.find(typeToken, nextLinePos);
+                outSources.push_back(source.substr(nextLinePos, pos - (nextLinePos == std::string::npos ? source.size() - 1 : nextLinePos)));
+                outTypes.push_back(ShaderTypeFromString(type));
+            }
+        }
+
+        ShaderType ShaderCompiler::ShaderTypeFromString(const std::string& type) {
+            if (type == "vertex")
+                return ShaderType::Vertex;
+            if (type == "fragment" || type == "pixel")
+                return ShaderType::Pixel;
+            if (type == "compute")
+                return ShaderType::Compute;
+            if (type == "geometry")
+                return ShaderType::Geometry;
+            return ShaderType::None;
+        }
+
+        const char* ShaderCompiler::ShaderTypeToString(ShaderType type) {
+            switch (type) {
+            case ShaderType::Vertex:    return "vertex";
+            case ShaderType::Pixel:     return "pixel";
+            case ShaderType::Compute:   return "compute";
+            case ShaderType::Geometry:  return "geometry";
+            }
+            return "";
+        }
+
+        shaderc_shader_kind ShaderCompiler::ShaderTypeToShaderC(ShaderType type) {
+            switch (type) {
+            case ShaderType::Vertex:    return shaderc_glsl_vertex_shader;
+            case ShaderType::Pixel:     return shaderc_glsl_fragment_shader;
+            case ShaderType::Compute:   return shaderc_glsl_compute_shader;
+            case ShaderType::Geometry:  return shaderc_glsl_geometry_shader;
+            }
+            return shaderc_glsl_infer_from_source;
+        }
+
+        UniformType ShaderCompiler::GetUniformType(const spirv_cross::SPIRType& type) {
+            switch (type.basetype) {
+            case spirv_cross::SPIRType::Boolean:    return UniformType::Bool;
+            case spirv_cross::SPIRType::Int: {
+                if (type.vecsize == 1)  return UniformType::Int;
+                if (type.vecsize == 2)  return UniformType::Int2;
+                if (type.vecsize == 3)  return UniformType::Int3;
+                if (type.vecsize == 4)  return UniformType::Int4;
+                break;
+            }
+            case spirv_cross::SPIRType::Float: {
+                if (type.vecsize == 1)  return UniformType::Float;
+                if (type.vecsize == 2)  return UniformType::Float2;
+                if (type.vecsize == 3)  return type.columns == 3 ? UniformType::Mat3x3 : UniformType::Float3;
+                if (type.vecsize == 4)  return type.columns == 4 ? UniformType::Mat4x4 : UniformType::Float4;
+                break;
+            }
+            case spirv_cross::SPIRType::Struct:     return UniformType::Struct;
+            }
+            return UniformType::None;
+        }
+
+        void ShaderCompiler::ReflectUniformBuffer(const spirv_cross::Compiler& compiler, const spirv_cross::Resource& resource, ShaderType stage, ShaderUniformBuffer& outBuffer) {
+            const auto& bufferType = compiler.get_type(resource.base_type_id);
+
+            outBuffer.Name = resource.name;
+            outBuffer.BindingPoint = compiler.get_decoration(resource.id, spv::DecorationBinding);
+            outBuffer.Stage = stage;
+            outBuffer.Size = (uint32_t)compiler.get_declared_struct_size(bufferType);
+            outBuffer.Uniforms.clear();
+
+            for (uint32_t i = 0; i < bufferType.member_types.size(); i++) {
+                const std::string& name = compiler.get_member_name(resource.base_type_id, i);
+                const auto& memberType = compiler.get_type(bufferType.member_types[i]);
+                uint32_t size = (uint32_t)compiler.get_declared_struct_member_size(bufferType, i);
+                uint32_t offset = compiler.type_struct_member_offset(bufferType, i);
+
+                // Structs are kept whole, materials only write them as a block at their offset
+                uint32_t count = memberType.array.size() == 1 ? memberType.array[0] : 1;
+                outBuffer.Uniforms.push_back(ShaderUniform(name, GetUniformType(memberType), size, offset, count));
+            }
+        }
+
+        ShaderResource ShaderCompiler::ReflectResource(const spirv_cross::Compiler& compiler, const spirv_cross::Resource& resource, ShaderType stage) {
+            const auto& resourceType = compiler.get_type(resource.type_id);
+            uint32_t binding = compiler.get_decoration(resource.id, spv::DecorationBinding);
+            uint32_t arrayCount = resourceType.array.size() == 1 ? resourceType.array[0] : 1;
+
+            return ShaderResource(resource.name, stage, ResourceType::Texture2D, binding, arrayCount);
+        }
+    }
+}
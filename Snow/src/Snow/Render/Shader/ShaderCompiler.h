@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Snow/Render/Shader/Shader.h"
+#include "Snow/Render/Shader/ShaderUniform.h"
+
+#include <shaderc/shaderc.hpp>
+
+#include <string>
+#include <vector>
+
+namespace spirv_cross {
+    class Compiler;
+    struct Resource;
+    struct SPIRType;
+}
+
+namespace Snow {
+    namespace Render {
+        // The steps from shader files to reflected SPIR-V that do not depend on the render API, shared so every backend
+        // splits stages and lays out uniform buffers the same way
+        class ShaderCompiler {
+        public:
+            // Reads every module into its own stage, a single module is split at its "#type" lines. The outputs are
+            // cleared first.
+            static void LoadSources(const std::vector<ShaderModule>& modules, std::vector<std::string>& outSources, std::vector<ShaderType>& outTypes);
+            static std::string ReadFile(const std::string& path);
+            static void PreProcess(const std::string& source, std::vector<std::string>& outSources, std::vector<ShaderType>& outTypes);
+
+            static ShaderType ShaderTypeFromString(const std::string& type);
+            static const char* ShaderTypeToString(ShaderType type);
+            static shaderc_shader_kind ShaderTypeToShaderC(ShaderType type);
+
+            static UniformType GetUniformType(const spirv_cross::SPIRType& type);
+            // Name, binding, size and members of a uniform buffer, the render API's buffer is left to the caller
+            static void ReflectUniformBuffer(const spirv_cross::Compiler& compiler, const spirv_cross::Resource& resource, ShaderType stage, ShaderUniformBuffer& outBuffer);
+            static ShaderResource ReflectResource(const spirv_cross::Compiler& compiler, const spirv_cross::Resource& resource, ShaderType stage);
+        };
+    }
+}
@@ -0,0 +1,189 @@
+#include <spch.h>
+#include "Snow/Render/SpriteAtlas.h"
+
+#include "Snow/Render/Renderer2D.h"
+
+namespace Snow {
+    namespace Render {
+        SpriteAtlas::SpriteAtlas(uint32_t pageSize, uint32_t padding) :
+            m_PageSize(pageSize), m_Padding(padding) {}
+
+        SpriteAtlas::~SpriteAtlas() {
+            for (uint32_t page : m_Pages)
+                Renderer2D::FreePage(page);
+        }
+
+        const SpriteRegion* SpriteAtlas::Find(const Ref<API::Texture2D>& texture) const {
+            auto it = m_Regions.find(texture.Raw());
+            if (it == m_Regions.end() || !it->second.Source.IsValid() || it->second.ImageVersion != texture->GetImageVersion())
+                return nullptr;
+
+            return &it->second.Region;
+        }
+
+        const SpriteRegion* SpriteAtlas::Pack(const Ref<API::Texture2D>& texture) {
+            auto it = m_Regions.find(texture.Raw());
+            bool known = it != m_Regions.end() && it->second.Source.IsValid();
+            if (known && it->second.ImageVersion == texture->GetImageVersion())
+                return &it->second.Region;
+
+            PackedTexture& entry = m_Regions[texture.Raw()];
+            uint32_t width = texture->GetWidth() + 2 * m_Padding;
+            uint32_t height = texture->GetHeight() + 2 * m_Padding;
+            bool reuse = known && entry.Region.IsPacked() && width <= entry.Width && height <= entry.Height;
+            if (!reuse && entry.Region.IsPacked()) {
+                m_UsedTexels -= (uint64_t)entry.Width * entry.Height;
+                m_WastedTexels += (uint64_t)entry.Width * entry.Height;
+            }
+
+            entry.Source = texture;
+            entry.ImageVersion = texture->GetImageVersion();
+            if (reuse) {
+                Place(entry, texture);
+                return &entry.Region;
+            }
+
+            entry.Region = {};
+            if (width > m_PageSize || height > m_PageSize) {
+                SNOW_CORE_WARN("Texture {0} is larger than an atlas page and is left unpacked", texture->GetPath());
+                return &entry.Region;
+            }
+
+            uint32_t x = 0, y = 0;
+            size_t page = 0;
+            while (page < m_Pages.size() && !Insert(m_Skylines[page], width, height, x, y))
+                page++;
+
+            if (page == m_Pages.size()) {
+                uint32_t index = Renderer2D::AllocatePage(m_PageSize);
+                if (index == SpriteRegion::NoPage) {
+                    SNOW_CORE_ERROR("Renderer2D has no texture pages of {0} texels for the atlas", m_PageSize);
+                    return &entry.Region;
+                }
+                m_Pages.push_back(index);
+                m_Skylines.push_back({ { 0, 0, m_PageSize } });
+                Insert(m_Skylines.back(), width, height, x, y);
+            }
+
+            entry.Region.Page = m_Pages[page];
+            entry.X = x;
+            entry.Y = y;
+            entry.Width = width;
+            entry.Height = height;
+            m_UsedTexels += (uint64_t)width * height;
+            Place(entry, texture);
+            return &entry.Region;
+        }
+
+        void SpriteAtlas::Place(PackedTexture& entry, const Ref<API::Texture2D>& texture) {
+            // The gutter around the texture repeats its edges, so filtering at its border never reads a neighbour
+            uint32_t x = entry.X + m_Padding;
+            uint32_t y = entry.Y + m_Padding;
+            Renderer2D::CopyToPage(entry.Region.Page, texture, x, y, m_Padding);
+
+            // The page may be larger than the atlas packs into
+            float pageSize = (float)Renderer2D::GetPageSize(entry.Region.Page);
+            entry.Region.UVRect = {
+                x / pageSize, y / pageSize,
+                (x + texture->GetWidth()) / pageSize, (y + texture->GetHeight()) / pageSize
+            };
+        }
+
+        bool SpriteAtlas::Insert(std::vector<SkylineNode>& skyline, uint32_t width, uint32_t height, uint32_t& outX, uint32_t& outY) {
+
+            // Bottom-left rule: lowest resulting top edge, narrowest node on ties
+            size_t bestIndex = skyline.size();
+            uint32_t bestTop = UINT32_MAX, bestWidth = UINT32_MAX, bestY = 0;
+            for (size_t i = 0; i < skyline.size(); i++) {
+                uint32_t x = skyline[i].X;
+                if (x + width > m_PageSize)
+                    break;
+
+                uint32_t y = 0;
+                uint32_t remaining = width;
+                for (size_t j = i; remaining > 0; j++) {
+                    y = std::max(y, skyline[j].Y);
+                    remaining -= std::min(remaining, skyline[j].Width);
+                }
+
+                if (y + height > m_PageSize)
+                    continue;
+
+                if (y + height < bestTop || (y + height == bestTop && skyline[i].Width < bestWidth)) {
+                    bestIndex = i;
+                    bestTop = y + height;
+                    bestWidth = skyline[i].Width;
+                    bestY = y;
+                }
+            }
+
+            if (bestIndex == skyline.size())
+                return false;
+
+            outX = skyline[bestIndex].X;
+            outY = bestY;
+
+            // Raise the skyline under the new rect and trim the nodes it now covers
+            SkylineNode node = { outX, bestY + height, width };
+            skyline.insert(skyline.begin() + bestIndex, node);
+            for (size_t i = bestIndex + 1; i < skyline.size();) {
+                uint32_t nodeEnd = node.X + node.Width;
+                if (skyline[i].X >= nodeEnd)
+                    break;
+
+                uint32_t shrink = nodeEnd - skyline[i].X;
+                if (skyline[i].Width <= shrink) {
+                    skyline.erase(skyline.begin() + i);
+                    continue;
+                }
+                skyline[i].X += shrink;
+                skyline[i].Width -= shrink;
+                break;
+            }
+
+            for (size_t i = 0; i + 1 < skyline.size();) {
+                if (skyline[i].Y == skyline[i + 1].Y) {
+                    skyline[i].Width += skyline[i + 1].Width;
+                    skyline.erase(skyline.begin() + i + 1);
+                }
+                else
+                    i++;
+            }
+
+            return true;
+        }
+
+        AtlasBuilder::AtlasBuilder(uint32_t pageSize, uint32_t padding) :
+            m_PageSize(pageSize), m_Padding(padding) {}
+
+        void AtlasBuilder::Add(const Ref<API::Texture2D>& texture) {
+            if (!texture)
+                return;
+
+            for (auto& added : m_Textures) {
+                if (added.Raw() == texture.Raw())
+                    return;
+            }
+            m_Textures.push_back(texture);
+        }
+
+        Ref<SpriteAtlas> AtlasBuilder::Build() {
+            Ref<SpriteAtlas> atlas = Ref<SpriteAtlas>::Create(m_PageSize, m_Padding);
+
+            // Tallest first keeps the skyline flat
+            std::vector<Ref<API::Texture2D>> textures = m_Textures;
+            std::sort(textures.begin(), textures.end(), [](const Ref<API::Texture2D>& a, const Ref<API::Texture2D>& b) {
+                return a->GetHeight() > b->GetHeight();
+            });
+
+            uint32_t packed = 0;
+            for (auto& texture : textures) {
+                if (atlas->Pack(texture)->IsPacked())
+                    packed++;
+            }
+
+            SNOW_CORE_INFO("Packed {0} textures into {1} atlas pages", packed, atlas->GetPages().size());
+            return atlas;
+        }
+    }
+}
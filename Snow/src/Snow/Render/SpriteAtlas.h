@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Snow/Core/Ref.h"
+#include "Snow/Render/API/Texture.h"
+
+#include <glm/glm.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+namespace Snow {
+    namespace Render {
+        struct SpriteRegion {
+            static constexpr uint32_t NoPage = UINT32_MAX;
+
+            // Renderer2D texture page the sprite was packed into, NoPage for textures left out of the atlas
+            uint32_t Page = NoPage;
+            glm::vec4 UVRect = { 0.0f, 0.0f, 1.0f, 1.0f }; // uv min (xy), uv max (zw) inside Page
+
+            bool IsPacked() const { return Page != NoPage; }
+        };
+
+        // Textures packed into square Renderer2D texture pages with a skyline bottom-left packer. Every texture is
+        // surrounded by a gutter of padding texels on each side, filled with its edge texels.
+        class SpriteAtlas : public RefCounted {
+        public:
+            SpriteAtlas(uint32_t pageSize, uint32_t padding);
+            virtual ~SpriteAtlas();
+
+            // Region the texture was packed into, nullptr if it was not added or its image changed since. Textures too
+            // large to pack have a region that is not packed, so they are not mistaken for new ones.
+            const SpriteRegion* Find(const Ref<API::Texture2D>& texture) const;
+
+            // Packs a texture added or changed since the atlas was built into the space left, without touching the
+            // rest. A changed image reuses its old rect when it still fits, otherwise that rect is wasted until the
+            // atlas is built again.
+            const SpriteRegion* Pack(const Ref<API::Texture2D>& texture);
+
+            // Texels lost to changed images, worth building the atlas again once it is more than what is in use
+            bool NeedsRebuild() const { return m_WastedTexels > m_UsedTexels; }
+
+            const std::vector<uint32_t>& GetPages() const { return m_Pages; }
+        private:
+            struct SkylineNode {
+                uint32_t X, Y, Width;
+            };
+
+            // The atlas keeps no reference to the textures it copied, the weak one tells a texture created where a
+            // packed one was freed apart from it
+            struct PackedTexture {
+                SpriteRegion Region;
+                WeakRef<API::Texture2D> Source;
+                uint32_t ImageVersion;
+                uint32_t X, Y, Width, Height; // Rect taken in the page, gutter included
+            };
+
+            bool Insert(std::vector<SkylineNode>& skyline, uint32_t width, uint32_t height, uint32_t& outX, uint32_t& outY);
+            void Place(PackedTexture& entry, const Ref<API::Texture2D>& texture);
+
+            uint32_t m_PageSize;
+            uint32_t m_Padding;
+
+            std::vector<uint32_t> m_Pages;
+            std::vector<std::vector<SkylineNode>> m_Skylines;
+            std::unordered_map<const API::Texture2D*, PackedTexture> m_Regions;
+            uint64_t m_UsedTexels = 0, m_WastedTexels = 0;
+        };
+
+        // Collects the textures of an atlas so they are packed together, tallest first
+        class AtlasBuilder {
+        public:
+            AtlasBuilder(uint32_t pageSize = 2048, uint32_t padding = 2);
+
+            void Add(const Ref<API::Texture2D>& texture);
+
+            Ref<SpriteAtlas> Build();
+        private:
+            uint32_t m_PageSize;
+            uint32_t m_Padding;
+
+            std::vector<Ref<API::Texture2D>> m_Textures;
+        };
+    }
+}
@@ -6,6 +6,7 @@
 #include "Snow/Render/Renderer.h"
 
 #include "Snow/Platform/OpenGL/OpenGLSwapChain.h"
+#include "Snow/Platform/Null/NullSwapChain.h"
 //#include "Snow/Platform/Vulkan/VulkanSwapChain.h"
 
 namespace Snow {
@@ -14,6 +15,7 @@ namespace Snow {
             switch(Renderer::GetRenderAPI()) {
             case RenderAPIType::None: return nullptr;
             case RenderAPIType::OpenGL: return new OpenGLSwapChain(spec);
+            case RenderAPIType::Null:   return new NullSwapChain(spec);
             }
 
             return nullptr;
@@ -0,0 +1,514 @@
+#include <spch.h>
+#include "Snow/Render/TextureCompressor.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+
+namespace Snow {
+	namespace Render {
+		using API::TextureFormat;
+
+		static float SRGBToLinear(float value) {
+			return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+		}
+
+		static float LinearToSRGB(float value) {
+			return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+		}
+
+		// Box filters an RGBA8 level to half size, odd edges repeat their last texel
+		static std::vector<uint8_t> Downsample(const std::vector<uint8_t>& pixels, uint32_t width, uint32_t height, bool srgb) {
+			static const std::array<float, 256> toLinear = [] {
+				std::array<float, 256> table;
+				for (uint32_t i = 0; i < 256; i++)
+					table[i] = SRGBToLinear(i / 255.0f);
+				return table;
+			}();
+
+			uint32_t newWidth = std::max(width / 2, 1u);
+			uint32_t newHeight = std::max(height / 2, 1u);
+			std::vector<uint8_t> result(newWidth * newHeight * 4);
+			for (uint32_t y = 0; y < newHeight; y++) {
+				for (uint32_t x = 0; x < newWidth; x++) {
+					float sum[4] = {};
+					for (uint32_t dy = 0; dy < 2; dy++) {
+						for (uint32_t dx = 0; dx < 2; dx++) {
+							uint32_t sx = std::min(x * 2 + dx, width - 1);
+							uint32_t sy = std::min(y * 2 + dy, height - 1);
+							const uint8_t* texel = &pixels[(sy * width + sx) * 4];
+							for (uint32_t c = 0; c < 4; c++)
+								sum[c] += srgb && c < 3 ? toLinear[texel[c]] : texel[c] / 255.0f;
+						}
+					}
+
+					uint8_t* texel = &result[(y * newWidth + x) * 4];
+					for (uint32_t c = 0; c < 4; c++) {
+						float value = sum[c] * 0.25f;
+						if (srgb && c < 3)
+							value = LinearToSRGB(value);
+						texel[c] = (uint8_t)std::round(std::clamp(value, 0.0f, 1.0f) * 255.0f);
+					}
+				}
+			}
+			return result;
+		}
+
+		// 4x4 texels in row order, blocks hanging over the edge repeat the last row and column
+		static void FetchBlock(const std::vector<uint8_t>& pixels, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, glm::vec4 block[16]) {
+			for (uint32_t y = 0; y < 4; y++) {
+				for (uint32_t x = 0; x < 4; x++) {
+					uint32_t px = std::min(blockX * 4 + x, width - 1);
+					uint32_t py = std::min(blockY * 4 + y, height - 1);
+					const uint8_t* texel = &pixels[(py * width + px) * 4];
+					block[y * 4 + x] = glm::vec4(texel[0], texel[1], texel[2], texel[3]);
+				}
+			}
+		}
+
+		// Direction of greatest variance through power iteration, zero for a flat block
+		static glm::vec4 PrincipalAxis(const glm::vec4 points[16], const glm::vec4& mean) {
+			glm::mat4 covariance(0.0f);
+			for (uint32_t i = 0; i < 16; i++)
+				covariance += glm::outerProduct(points[i] - mean, points[i] - mean);
+
+			uint32_t largest = 0;
+			for (uint32_t c = 1; c < 4; c++) {
+				if (covariance[c][c] > covariance[largest][largest])
+					largest = c;
+			}
+			if (covariance[largest][largest] < 1e-4f)
+				return glm::vec4(0.0f);
+
+			glm::vec4 axis = covariance[largest];
+			for (uint32_t i = 0; i < 8; i++) {
+				axis = covariance * axis;
+				float scale = std::max(std::max(std::abs(axis.x), std::abs(axis.y)), std::max(std::abs(axis.z), std::abs(axis.w)));
+				if (scale < 1e-8f)
+					return glm::vec4(0.0f);
+				axis /= scale;
+			}
+			return glm::normalize(axis);
+		}
+
+		// Endpoints at the extremes of the block projected onto its principal axis
+		static void FitEndpoints(const glm::vec4 block[16], glm::vec4& outStart, glm::vec4& outEnd) {
+			glm::vec4 mean(0.0f);
+			for (uint32_t i = 0; i < 16; i++)
+				mean += block[i];
+			mean /= 16.0f;
+
+			glm::vec4 axis = PrincipalAxis(block, mean);
+			float minT = 0.0f, maxT = 0.0f;
+			for (uint32_t i = 0; i < 16; i++) {
+				float t = glm::dot(block[i] - mean, axis);
+				minT = std::min(minT, t);
+				maxT = std::max(maxT, t);
+			}
+			outStart = glm::clamp(mean + axis * maxT, 0.0f, 255.0f);
+			outEnd = glm::clamp(mean + axis * minT, 0.0f, 255.0f);
+		}
+
+		// Least squares endpoints for fixed indices, weights[i] is how far texel i sits from start towards end
+		static bool RefineEndpoints(const glm::vec4 block[16], const float weights[16], glm::vec4& outStart, glm::vec4& outEnd) {
+			float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+			glm::vec4 ax(0.0f), bx(0.0f);
+			for (uint32_t i = 0; i < 16; i++) {
+				float b = weights[i];
+				float a = 1.0f - b;
+				aa += a * a;
+				ab += a * b;
+				bb += b * b;
+				ax += a * block[i];
+				bx += b * block[i];
+			}
+
+			float determinant = aa * bb - ab * ab;
+			if (std::abs(determinant) < 1e-6f)
+				return false;
+
+			outStart = glm::clamp((ax * bb - bx * ab) / determinant, 0.0f, 255.0f);
+			outEnd = glm::clamp((bx * aa - ax * ab) / determinant, 0.0f, 255.0f);
+			return true;
+		}
+
+		static float DistanceSquared(const glm::vec4& a, const glm::vec4& b) {
+			glm::vec4 d = a - b;
+			return glm::dot(d, d);
+		}
+
+		static uint16_t To565(const glm::vec4& color) {
+			uint32_t r = (uint32_t)std::round(color.r * 31.0f / 255.0f);
+			uint32_t g = (uint32_t)std::round(color.g * 63.0f / 255.0f);
+			uint32_t b = (uint32_t)std::round(color.b * 31.0f / 255.0f);
+			return (uint16_t)((r << 11) | (g << 5) | b);
+		}
+
+		static glm::vec4 From565(uint16_t color) {
+			uint32_t r = (color >> 11) & 31, g = (color >> 5) & 63, b = color & 31;
+			return glm::vec4((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 0.0f);
+		}
+
+		// Opaque four color BC1 block, 8 bytes. Also the color half of BC3.
+		static void EncodeColorBlock(const glm::vec4 source[16], uint8_t* out) {
+			glm::vec4 block[16];
+			for (uint32_t i = 0; i < 16; i++)
+				block[i] = glm::vec4(source[i].r, source[i].g, source[i].b, 0.0f);
+
+			glm::vec4 start, end;
+			FitEndpoints(block, start, end);
+
+			uint16_t color0 = 0, color1 = 0;
+			uint8_t indices[16] = {};
+			float bestError = FLT_MAX;
+			for (uint32_t pass = 0; pass < 2; pass++) {
+				uint16_t passColor0 = To565(start);
+				uint16_t passColor1 = To565(end);
+				if (passColor0 < passColor1)
+					std::swap(passColor0, passColor1);
+
+				glm::vec4 palette[4];
+				palette[0] = From565(passColor0);
+				palette[1] = From565(passColor1);
+				palette[2] = (palette[0] * 2.0f + palette[1]) / 3.0f;
+				palette[3] = (palette[0] + palette[1] * 2.0f) / 3.0f;
+				// Equal endpoints switch the block to three color mode, where only index 0 is safe to use
+				uint8_t paletteSize = passColor0 == passColor1 ? 1 : 4;
+
+				static constexpr float paletteWeights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+				uint8_t passIndices[16] = {};
+				float weights[16];
+				float error = 0.0f;
+				for (uint32_t i = 0; i < 16; i++) {
+					float bestDistance = FLT_MAX;
+					for (uint8_t p = 0; p < paletteSize; p++) {
+						float distance = DistanceSquared(block[i], palette[p]);
+						if (distance < bestDistance) {
+							bestDistance = distance;
+							passIndices[i] = p;
+						}
+					}
+					weights[i] = paletteWeights[passIndices[i]];
+					error += bestDistance;
+				}
+
+				if (error < bestError) {
+					bestError = error;
+					color0 = passColor0;
+					color1 = passColor1;
+					memcpy(indices, passIndices, sizeof(indices));
+				}
+
+				start = palette[0];
+				end = palette[1];
+				if (paletteSize == 1 || !RefineEndpoints(block, weights, start, end))
+					break;
+			}
+
+			out[0] = color0 & 0xff;
+			out[1] = color0 >> 8;
+			out[2] = color1 & 0xff;
+			out[3] = color1 >> 8;
+			for (uint32_t y = 0; y < 4; y++)
+				out[4 + y] = indices[y * 4] | (indices[y * 4 + 1] << 2) | (indices[y * 4 + 2] << 4) | (indices[y * 4 + 3] << 6);
+		}
+
+		// Eight value BC4 block, 8 bytes. The alpha half of BC3 and each channel of BC5.
+		static void EncodeChannelBlock(const glm::vec4 block[16], uint32_t channel, uint8_t* out) {
+			float low = 255.0f, high = 0.0f;
+			for (uint32_t i = 0; i < 16; i++) {
+				low = std::min(low, block[i][channel]);
+				high = std::max(high, block[i][channel]);
+			}
+
+			uint8_t value0 = (uint8_t)std::round(high);
+			uint8_t value1 = (uint8_t)std::round(low);
+			out[0] = value0;
+			out[1] = value1;
+			std::fill_n(out + 2, 6, 0);
+			if (value0 == value1)
+				return;
+
+			float palette[8] = { (float)value0, (float)value1 };
+			for (uint32_t i = 2; i < 8; i++)
+				palette[i] = ((8 - i) * value0 + (i - 1) * value1) / 7.0f;
+
+			uint64_t bits = 0;
+			for (uint32_t i = 0; i < 16; i++) {
+				uint64_t bestIndex = 0;
+				float bestDistance = FLT_MAX;
+				for (uint32_t p = 0; p < 8; p++) {
+					float distance = std::abs(block[i][channel] - palette[p]);
+					if (distance < bestDistance) {
+						bestDistance = distance;
+						bestIndex = p;
+					}
+				}
+				bits |= bestIndex << (3 * i);
+			}
+			for (uint32_t i = 0; i < 6; i++)
+				out[2 + i] = (uint8_t)(bits >> (8 * i));
+		}
+
+		// BC7 mode 6, one RGBA subset with 7 bit endpoints, a p bit each and 4 bit indices. 16 bytes.
+		static void EncodeBC7Block(const glm::vec4 block[16], uint8_t* out) {
+			static constexpr uint32_t indexWeights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+			glm::vec4 start, end;
+			FitEndpoints(block, start, end);
+
+			uint32_t bestEndpoints[2][4] = {};
+			uint32_t bestP[2] = {};
+			uint8_t bestIndices[16] = {};
+			float bestError = FLT_MAX;
+			for (uint32_t pass = 0; pass < 2; pass++) {
+				uint8_t passIndices[16] = {};
+				float passError = FLT_MAX;
+				// The p bit is the shared low bit of all four channels, try each pair
+				for (uint32_t p0 = 0; p0 < 2; p0++) {
+					for (uint32_t p1 = 0; p1 < 2; p1++) {
+						uint32_t endpoints[2][4];
+						glm::vec4 expanded[2];
+						for (uint32_t c = 0; c < 4; c++) {
+							endpoints[0][c] = (uint32_t)std::clamp(std::round((start[c] - p0) / 2.0f), 0.0f, 127.0f);
+							endpoints[1][c] = (uint32_t)std::clamp(std::round((end[c] - p1) / 2.0f), 0.0f, 127.0f);
+							expanded[0][c] = (float)(endpoints[0][c] << 1 | p0);
+							expanded[1][c] = (float)(endpoints[1][c] << 1 | p1);
+						}
+
+						glm::vec4 palette[16];
+						for (uint32_t i = 0; i < 16; i++) {
+							for (uint32_t c = 0; c < 4; c++)
+								palette[i][c] = (float)(((64 - indexWeights[i]) * (uint32_t)expanded[0][c] + indexWeights[i] * (uint32_t)expanded[1][c] + 32) >> 6);
+						}
+
+						uint8_t indices[16];
+						float error = 0.0f;
+						for (uint32_t i = 0; i < 16; i++) {
+							float bestDistance = FLT_MAX;
+							for (uint8_t p = 0; p < 16; p++) {
+								float distance = DistanceSquared(block[i], palette[p]);
+								if (distance < bestDistance) {
+									bestDistance = distance;
+									indices[i] = p;
+								}
+							}
+							error += bestDistance;
+						}
+
+						if (error < passError) {
+							passError = error;
+							memcpy(passIndices, indices, sizeof(indices));
+						}
+						if (error < bestError) {
+							bestError = error;
+							memcpy(bestEndpoints, endpoints, sizeof(endpoints));
+							bestP[0] = p0;
+							bestP[1] = p1;
+							memcpy(bestIndices, indices, sizeof(indices));
+						}
+					}
+				}
+
+				if (pass == 0) {
+					float weights[16];
+					for (uint32_t i = 0; i < 16; i++)
+						weights[i] = indexWeights[passIndices[i]] / 64.0f;
+					if (!RefineEndpoints(block, weights, start, end))
+						break;
+				}
+			}
+
+			// The first index drops its top bit, so it has to point into the start half of the palette
+			if (bestIndices[0] >= 8) {
+				std::swap(bestEndpoints[0], bestEndpoints[1]);
+				std::swap(bestP[0], bestP[1]);
+				for (uint32_t i = 0; i < 16; i++)
+					bestIndices[i] = 15 - bestIndices[i];
+			}
+
+			std::fill_n(out, 16, 0);
+			uint32_t position = 0;
+			auto write = [out, &position](uint32_t value, uint32_t bits) {
+				for (uint32_t b = 0; b < bits; b++, position++) {
+					if ((value >> b) & 1)
+						out[position >> 3] |= 1 << (position & 7);
+				}
+			};
+
+			write(1 << 6, 7);
+			for (uint32_t c = 0; c < 4; c++) {
+				write(bestEndpoints[0][c], 7);
+				write(bestEndpoints[1][c], 7);
+			}
+			write(bestP[0], 1);
+			write(bestP[1], 1);
+			write(bestIndices[0], 3);
+			for (uint32_t i = 1; i < 16; i++)
+				write(bestIndices[i], 4);
+		}
+
+		static void EncodeLevel(const std::vector<uint8_t>& pixels, uint32_t width, uint32_t height, TextureFormat format, uint8_t* out) {
+			uint32_t blockSize = API::Texture::GetBlockSize(format);
+			uint32_t blocksX = (width + 3) / 4;
+			uint32_t blocksY = (height + 3) / 4;
+
+			glm::vec4 block[16];
+			for (uint32_t by = 0; by < blocksY; by++) {
+				for (uint32_t bx = 0; bx < blocksX; bx++) {
+					FetchBlock(pixels, width, height, bx, by, block);
+					uint8_t* blockData = out + (by * blocksX + bx) * blockSize;
+					switch (format) {
+					case TextureFormat::BC1:
+						EncodeColorBlock(block, blockData);
+						break;
+					case TextureFormat::BC3:
+						EncodeChannelBlock(block, 3, blockData);
+						EncodeColorBlock(block, blockData + 8);
+						break;
+					case TextureFormat::BC5:
+						EncodeChannelBlock(block, 0, blockData);
+						EncodeChannelBlock(block, 1, blockData + 8);
+						break;
+					case TextureFormat::BC7:
+						EncodeBC7Block(block, blockData);
+						break;
+					}
+				}
+			}
+		}
+
+		TextureFormat TextureCompressor::ChooseFormat(const API::Image& image, bool srgb) {
+			if (srgb)
+				return TextureFormat::BC7;
+
+			uint32_t channels = API::Texture::GetBPP(image.Format);
+			uint32_t texelCount = image.Width * image.Height;
+			bool alpha = false, grayscale = true;
+			uint32_t unitVectors = 0;
+			for (uint32_t i = 0; i < texelCount; i++) {
+				const uint8_t* texel = &image.Pixels[i * channels];
+				if (channels == 4 && texel[3] < 255)
+					alpha = true;
+				if (std::abs(texel[0] - texel[1]) > 2 || std::abs(texel[1] - texel[2]) > 2)
+					grayscale = false;
+
+				glm::vec3 normal = glm::vec3(texel[0], texel[1], texel[2]) / 127.5f - 1.0f;
+				if (normal.z > 0.0f && std::abs(glm::length(normal) - 1.0f) < 0.2f)
+					unitVectors++;
+			}
+
+			if (alpha)
+				return TextureFormat::BC3;
+			// Tangent space normals are unit length and face out of the surface, BC5 keeps x and y and the shader rebuilds z
+			if (!grayscale && unitVectors >= texelCount * 0.98f)
+				return TextureFormat::BC5;
+			return TextureFormat::BC1;
+		}
+
+		API::Image TextureCompressor::Compress(const API::Image& image, TextureFormat format, bool srgb) {
+			uint32_t channels = API::Texture::GetBPP(image.Format);
+			if (channels == 0 || image.MipCount != 1 || API::Texture::GetBlockSize(format) == 0) {
+				SNOW_CORE_ERROR("Only single level RGB and RGBA images can be block compressed");
+				return image;
+			}
+
+			uint32_t width = image.Width;
+			uint32_t height = image.Height;
+			std::vector<uint8_t> level(width * height * 4, 0xff);
+			for (uint32_t i = 0; i < width * height; i++)
+				memcpy(&level[i * 4], &image.Pixels[i * channels], channels);
+
+			API::Image result;
+			result.Width = width;
+			result.Height = height;
+			result.Format = format;
+			result.MipCount = 0;
+			while (true) {
+				size_t offset = result.Pixels.size();
+				result.Pixels.resize(offset + API::Texture::GetImageSize(format, width, height));
+				EncodeLevel(level, width, height, format, result.Pixels.data() + offset);
+				result.MipCount++;
+
+				if (width == 1 && height == 1)
+					break;
+				level = Downsample(level, width, height, srgb);
+				width = std::max(width / 2, 1u);
+				height = std::max(height / 2, 1u);
+			}
+			return result;
+		}
+
+		// Reverses the first rows rows of 2 bit indices in a BC1 color block
+		static void FlipColorBlock(uint8_t* block, uint32_t rows) {
+			std::reverse(block + 4, block + 4 + rows);
+		}
+
+		// Reverses the first rows rows of 3 bit indices in a BC4 block, each row is 12 bits
+		static void FlipChannelBlock(uint8_t* block, uint32_t rows) {
+			uint64_t bits = 0;
+			for (uint32_t i = 0; i < 6; i++)
+				bits |= (uint64_t)block[2 + i] << (8 * i);
+
+			uint64_t flipped = bits;
+			for (uint32_t r = 0; r < rows; r++) {
+				uint64_t row = (bits >> (12 * r)) & 0xfff;
+				flipped &= ~(0xfffull << (12 * (rows - 1 - r)));
+				flipped |= row << (12 * (rows - 1 - r));
+			}
+
+			for (uint32_t i = 0; i < 6; i++)
+				block[2 + i] = (uint8_t)(flipped >> (8 * i));
+		}
+
+		bool TextureCompressor::FlipVertically(API::Image& image) {
+			TextureFormat format = image.Format;
+			if (format != TextureFormat::BC1 && format != TextureFormat::BC3 && format != TextureFormat::BC5)
+				return false;
+
+			// Rows only stay inside their block when the height is a whole number of blocks or fits in one. The whole chain is
+			// checked so a texture flips the same way whichever of its levels were loaded.
+			for (uint32_t level = 0, height = image.Height; level < image.MipCount; level++, height = std::max(height / 2, 1u)) {
+				if (height > 4 && height % 4 != 0)
+					return false;
+			}
+
+			uint32_t blockSize = API::Texture::GetBlockSize(format);
+			uint32_t width = std::max(image.Width >> image.FirstMip, 1u), height = std::max(image.Height >> image.FirstMip, 1u);
+			uint8_t* data = image.Pixels.data();
+			for (uint32_t level = image.FirstMip; level < image.MipCount; level++) {
+				uint32_t blocksX = (width + 3) / 4;
+				uint32_t blocksY = (height + 3) / 4;
+				uint32_t rowSize = blocksX * blockSize;
+				for (uint32_t by = 0; by < blocksY / 2; by++)
+					std::swap_ranges(data + by * rowSize, data + (by + 1) * rowSize, data + (blocksY - 1 - by) * rowSize);
+
+				uint32_t rows = std::min(height, 4u);
+				for (uint32_t i = 0; i < blocksX * blocksY; i++) {
+					uint8_t* block = data + i * blockSize;
+					switch (format) {
+					case TextureFormat::BC1:
+						FlipColorBlock(block, rows);
+						break;
+					case TextureFormat::BC3:
+						FlipChannelBlock(block, rows);
+						FlipColorBlock(block + 8, rows);
+						break;
+					case TextureFormat::BC5:
+						FlipChannelBlock(block, rows);
+						FlipChannelBlock(block + 8, rows);
+						break;
+					}
+				}
+
+				data += API::Texture::GetImageSize(format, width, height);
+				width = std::max(width / 2, 1u);
+				height = std::max(height / 2, 1u);
+			}
+			return true;
+		}
+	}
+}
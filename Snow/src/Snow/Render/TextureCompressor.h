@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Snow/Render/API/Texture.h"
+
+namespace Snow {
+	namespace Render {
+		// Encodes decoded images into block compressed mip chains for the texture cook
+		class TextureCompressor {
+		public:
+			// BC7 for color, BC5 for tangent space normal maps, BC3 for other data with alpha and BC1 for the rest
+			static API::TextureFormat ChooseFormat(const API::Image& image, bool srgb);
+
+			// Builds the full mip chain of an uncompressed RGB or RGBA image and encodes every level to format.
+			// srgb images are filtered in linear space.
+			static API::Image Compress(const API::Image& image, API::TextureFormat format, bool srgb);
+
+			// Mirrors every level of a block compressed image top to bottom by reordering its blocks and index rows.
+			// Only BC1, BC3 and BC5 store their rows separately, other formats return false and are left as they are.
+			static bool FlipVertically(API::Image& image);
+		};
+	}
+}
@@ -0,0 +1,428 @@
+#include <spch.h>
+#include "Snow/Render/TextureFile.h"
+
+#include "Snow/Render/TextureCompressor.h"
+#include "Snow/Utils/MappedFile.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+namespace Snow {
+	namespace Render {
+		using API::TextureFormat;
+
+		static constexpr uint8_t KTX2Identifier[12] = { 0xab, 'K', 'T', 'X', ' ', '2', '0', 0xbb, '\r', '\n', 0x1a, '\n' };
+
+		// Bump when the compressor output changes so old cooks are rebuilt
+		static constexpr uint32_t CookedTextureVersion = 1;
+
+		struct KTX2Header {
+			uint8_t Identifier[12];
+			uint32_t VkFormat;
+			uint32_t TypeSize;
+			uint32_t PixelWidth, PixelHeight, PixelDepth;
+			uint32_t LayerCount, FaceCount, LevelCount;
+			uint32_t SupercompressionScheme;
+			uint32_t DFDByteOffset, DFDByteLength;
+			uint32_t KVDByteOffset, KVDByteLength;
+			uint64_t SGDByteOffset, SGDByteLength;
+		};
+
+		struct KTX2Level {
+			uint64_t ByteOffset;
+			uint64_t ByteLength;
+			uint64_t UncompressedByteLength;
+		};
+
+		// Value of the SnowCook key written next to the standard keys
+		struct KTX2CookInfo {
+			uint32_t Version;
+			uint32_t Reserved;
+			uint64_t SourceHash;
+		};
+
+		struct VkFormatMapping {
+			uint32_t Unorm, SRGB;
+			TextureFormat Format;
+		};
+
+		// VkFormat values of the block formats we can upload, 0 where there is no sRGB variant
+		static constexpr VkFormatMapping s_VkFormats[] = {
+			{ 131, 132, TextureFormat::BC1 },       // VK_FORMAT_BC1_RGB_UNORM_BLOCK, _SRGB_BLOCK
+			{ 137, 138, TextureFormat::BC3 },       // VK_FORMAT_BC3_UNORM_BLOCK, _SRGB_BLOCK
+			{ 141, 0, TextureFormat::BC5 },         // VK_FORMAT_BC5_UNORM_BLOCK
+			{ 145, 146, TextureFormat::BC7 },       // VK_FORMAT_BC7_UNORM_BLOCK, _SRGB_BLOCK
+			{ 147, 148, TextureFormat::ETC2 },      // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, _SRGB_BLOCK
+			{ 151, 152, TextureFormat::ETC2Alpha }  // VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK, _SRGB_BLOCK
+		};
+
+		static TextureFormat FromVkFormat(uint32_t vkFormat) {
+			for (auto& mapping : s_VkFormats) {
+				if (mapping.Unorm == vkFormat || (mapping.SRGB != 0 && mapping.SRGB == vkFormat))
+					return mapping.Format;
+			}
+			return TextureFormat::None;
+		}
+
+		static uint32_t ToVkFormat(TextureFormat format, bool srgb) {
+			for (auto& mapping : s_VkFormats) {
+				if (mapping.Format == format)
+					return srgb && mapping.SRGB != 0 ? mapping.SRGB : mapping.Unorm;
+			}
+			return 0;
+		}
+
+		// Copies the levels from outImage.FirstMip on into outImage
+		static bool ReadLevels(const std::string& path, const uint8_t* data, uint64_t size, const KTX2Level* levels, API::Image& outImage) {
+			uint32_t width = std::max(outImage.Width >> outImage.FirstMip, 1u), height = std::max(outImage.Height >> outImage.FirstMip, 1u);
+			for (uint32_t level = outImage.FirstMip; level < outImage.MipCount; level++) {
+				uint64_t levelSize = API::Texture::GetImageSize(outImage.Format, width, height);
+				if (levels[level].ByteLength != levelSize || levels[level].ByteOffset + levelSize > size) {
+					SNOW_CORE_ERROR("Texture {0} has a truncated or malformed mip level {1}", path, level);
+					return false;
+				}
+
+				const uint8_t* levelData = data + levels[level].ByteOffset;
+				outImage.Pixels.insert(outImage.Pixels.end(), levelData, levelData + levelSize);
+				width = std::max(width / 2, 1u);
+				height = std::max(height / 2, 1u);
+			}
+			return true;
+		}
+
+		static void FlipStoredImage(const std::string& path, API::Image& image) {
+			if (!TextureCompressor::FlipVertically(image))
+				SNOW_CORE_WARN("Texture {0} is stored top down in a format that cannot be flipped, it will sample upside down", path);
+		}
+
+		std::string TextureFile::GetCookedPath(const std::string& path, bool srgb) {
+			std::filesystem::path source = path;
+			std::string extension = source.extension().string();
+			std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+			if (extension == ".ktx2")
+				return path;
+			if (extension == ".dds")
+				return std::string();
+
+			// srgb changes both the decoded channels and the chosen format, so each variant gets its own cook
+			return (source.parent_path() / "cached" / (source.filename().string() + (srgb ? ".srgb.ktx2" : ".ktx2"))).string();
+		}
+
+		bool TextureFile::ReadKTX2(const std::string& path, API::Image& outImage, uint64_t* outSourceHash, uint32_t maxSize) {
+			if (outSourceHash)
+				*outSourceHash = 0;
+
+			Utils::MappedFile file(path);
+			if (!file.IsValid() || file.GetSize() < sizeof(KTX2Header))
+				return false;
+
+			const uint8_t* data = file.GetData();
+			const KTX2Header& header = *(const KTX2Header*)data;
+			if (memcmp(header.Identifier, KTX2Identifier, sizeof(KTX2Identifier)) != 0) {
+				SNOW_CORE_ERROR("{0} is not a KTX2 file", path);
+				return false;
+			}
+
+			TextureFormat format = FromVkFormat(header.VkFormat);
+			if (format == TextureFormat::None || header.SupercompressionScheme != 0) {
+				SNOW_CORE_ERROR("KTX2 file {0} uses an unsupported format or supercompression", path);
+				return false;
+			}
+			if (header.PixelWidth == 0 || header.PixelDepth > 1 || header.LayerCount > 1 || header.FaceCount != 1) {
+				SNOW_CORE_ERROR("KTX2 file {0} is not a single 2D texture", path);
+				return false;
+			}
+
+			// A level count of 0 asks the loader to generate mips, which block formats cannot do
+			uint32_t levelCount = std::max(header.LevelCount, 1u);
+			if (sizeof(KTX2Header) + levelCount * sizeof(KTX2Level) > file.GetSize()) {
+				SNOW_CORE_ERROR("KTX2 file {0} is truncated", path);
+				return false;
+			}
+
+			// Key/value pairs are a 4 byte length, a null terminated key, the value and padding to 4 bytes
+			bool bottomUp = false;
+			uint64_t sourceHash = 0;
+			if ((uint64_t)header.KVDByteOffset + header.KVDByteLength <= file.GetSize()) {
+				const uint8_t* kvd = data + header.KVDByteOffset;
+				const uint8_t* kvdEnd = kvd + header.KVDByteLength;
+				while (kvd + sizeof(uint32_t) <= kvdEnd) {
+					uint32_t length = *(const uint32_t*)kvd;
+					const char* key = (const char*)(kvd + sizeof(uint32_t));
+					if (kvd + sizeof(uint32_t) + length > kvdEnd)
+						break;
+
+					size_t keyLength = strnlen(key, length);
+					if (keyLength == length)
+						break;
+
+					std::string_view keyName(key, keyLength);
+					const uint8_t* value = (const uint8_t*)key + keyLength + 1;
+					size_t valueLength = length - keyLength - 1;
+					if (keyName == "KTXorientation" && valueLength >= 2)
+						bottomUp = value[1] == 'u';
+					else if (keyName == "SnowCook" && valueLength == sizeof(KTX2CookInfo)) {
+						// Values are only 4 byte aligned
+						KTX2CookInfo info;
+						memcpy(&info, value, sizeof(KTX2CookInfo));
+						if (info.Version == CookedTextureVersion)
+							sourceHash = info.SourceHash;
+					}
+
+					kvd += sizeof(uint32_t) + ((length + 3) & ~3u);
+				}
+			}
+
+			API::Image image;
+			image.Width = header.PixelWidth;
+			image.Height = std::max(header.PixelHeight, 1u);
+			image.Format = format;
+			image.MipCount = levelCount;
+			image.FirstMip = image.GetMipForSize(maxSize);
+			const KTX2Level* levels = (const KTX2Level*)(data + sizeof(KTX2Header));
+			if (!ReadLevels(path, data, file.GetSize(), levels, image))
+				return false;
+
+			if (!bottomUp)
+				FlipStoredImage(path, image);
+
+			outImage = std::move(image);
+			if (outSourceHash)
+				*outSourceHash = sourceHash;
+			return true;
+		}
+
+		static constexpr uint32_t FourCC(char a, char b, char c, char d) {
+			return (uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24);
+		}
+
+		struct DDSPixelFormat {
+			uint32_t Size, Flags, FourCC, RGBBitCount;
+			uint32_t RBitMask, GBitMask, BBitMask, ABitMask;
+		};
+
+		struct DDSHeader {
+			uint32_t Size, Flags, Height, Width, PitchOrLinearSize, Depth, MipMapCount;
+			uint32_t Reserved1[11];
+			DDSPixelFormat PixelFormat;
+			uint32_t Caps, Caps2, Caps3, Caps4, Reserved2;
+		};
+
+		struct DDSHeaderDXT10 {
+			uint32_t DXGIFormat, ResourceDimension, MiscFlag, ArraySize, MiscFlags2;
+		};
+
+		static constexpr uint32_t DDSPixelFormatFourCC = 0x4;
+		static constexpr uint32_t DDSCaps2Cubemap = 0x200;
+		static constexpr uint32_t DDSResourceMiscTextureCube = 0x4;
+
+		static TextureFormat FromDXGIFormat(uint32_t dxgiFormat) {
+			switch (dxgiFormat) {
+			case 71: case 72:   return TextureFormat::BC1; // DXGI_FORMAT_BC1_UNORM, _SRGB
+			case 77: case 78:   return TextureFormat::BC3; // DXGI_FORMAT_BC3_UNORM, _SRGB
+			case 83:            return TextureFormat::BC5; // DXGI_FORMAT_BC5_UNORM
+			case 98: case 99:   return TextureFormat::BC7; // DXGI_FORMAT_BC7_UNORM, _SRGB
+			}
+			return TextureFormat::None;
+		}
+
+		bool TextureFile::ReadDDS(const std::string& path, API::Image& outImage) {
+			Utils::MappedFile file(path);
+			if (!file.IsValid() || file.GetSize() < sizeof(uint32_t) + sizeof(DDSHeader))
+				return false;
+
+			const uint8_t* data = file.GetData();
+			if (*(const uint32_t*)data != FourCC('D', 'D', 'S', ' ')) {
+				SNOW_CORE_ERROR("{0} is not a DDS file", path);
+				return false;
+			}
+
+			const DDSHeader& header = *(const DDSHeader*)(data + sizeof(uint32_t));
+			uint64_t dataOffset = sizeof(uint32_t) + sizeof(DDSHeader);
+			bool cube = (header.Caps2 & DDSCaps2Cubemap) != 0;
+
+			TextureFormat format = TextureFormat::None;
+			if (header.PixelFormat.Flags & DDSPixelFormatFourCC) {
+				switch (header.PixelFormat.FourCC) {
+				case FourCC('D', 'X', 'T', '1'):    format = TextureFormat::BC1; break;
+				case FourCC('D', 'X', 'T', '5'):    format = TextureFormat::BC3; break;
+				case FourCC('A', 'T', 'I', '2'):
+				case FourCC('B', 'C', '5', 'U'):    format = TextureFormat::BC5; break;
+				case FourCC('D', 'X', '1', '0'): {
+					if (file.GetSize() < dataOffset + sizeof(DDSHeaderDXT10))
+						return false;
+					const DDSHeaderDXT10& extension = *(const DDSHeaderDXT10*)(data + dataOffset);
+					dataOffset += sizeof(DDSHeaderDXT10);
+					format = FromDXGIFormat(extension.DXGIFormat);
+					cube |= (extension.MiscFlag & DDSResourceMiscTextureCube) != 0 || extension.ArraySize > 1;
+					break;
+				}
+				}
+			}
+
+			if (format == TextureFormat::None) {
+				SNOW_CORE_ERROR("DDS file {0} is not BC1, BC3, BC5 or BC7 compressed", path);
+				return false;
+			}
+			if (cube) {
+				SNOW_CORE_ERROR("DDS file {0} is a cube map or array, only single 2D textures are supported", path);
+				return false;
+			}
+
+			// DDS stores the levels back to back, largest first
+			API::Image image;
+			image.Width = header.Width;
+			image.Height = header.Height;
+			image.Format = format;
+			image.MipCount = std::max(header.MipMapCount, 1u);
+
+			std::vector<KTX2Level> levels(image.MipCount);
+			uint64_t offset = dataOffset;
+			for (uint32_t level = 0, width = image.Width, height = image.Height; level < image.MipCount; level++) {
+				levels[level].ByteOffset = offset;
+				levels[level].ByteLength = API::Texture::GetImageSize(format, width, height);
+				offset += levels[level].ByteLength;
+				width = std::max(width / 2, 1u);
+				height = std::max(height / 2, 1u);
+			}
+			if (!ReadLevels(path, data, file.GetSize(), levels.data(), image))
+				return false;
+
+			FlipStoredImage(path, image);
+			outImage = std::move(image);
+			return true;
+		}
+
+		// Khronos data format descriptor of one block format, required by KTX2 even though our loader ignores it
+		static std::vector<uint8_t> BuildDataFormatDescriptor(TextureFormat format, bool srgb) {
+			struct Sample {
+				uint8_t Channel;
+				uint16_t BitOffset;
+			};
+
+			static constexpr uint8_t ChannelColor = 0, ChannelGreen = 1, ChannelAlpha = 15;
+			static constexpr uint8_t SampleLinear = 1 << 4;
+
+			uint8_t colorModel = 0;
+			std::vector<Sample> samples;
+			switch (format) {
+			case TextureFormat::BC1:    colorModel = 128; samples = { { ChannelColor, 0 } }; break;
+			case TextureFormat::BC3:    colorModel = 130; samples = { { (uint8_t)(ChannelAlpha | (srgb ? SampleLinear : 0)), 0 }, { ChannelColor, 64 } }; break;
+			case TextureFormat::BC5:    colorModel = 132; samples = { { ChannelColor, 0 }, { ChannelGreen, 64 } }; break;
+			case TextureFormat::BC7:    colorModel = 134; samples = { { ChannelColor, 0 } }; break;
+			}
+
+			uint32_t blockSize = API::Texture::GetBlockSize(format);
+			uint16_t descriptorSize = (uint16_t)(24 + 16 * samples.size());
+			std::vector<uint8_t> dfd(sizeof(uint32_t) + descriptorSize, 0);
+			uint8_t* out = dfd.data();
+			*(uint32_t*)out = (uint32_t)dfd.size();
+			out += sizeof(uint32_t);
+
+			// Vendor and descriptor type are both 0 for the basic Khronos descriptor
+			*(uint16_t*)(out + 4) = 2;
+			*(uint16_t*)(out + 6) = descriptorSize;
+			out[8] = colorModel;
+			out[9] = 1;             // BT.709 primaries
+			out[10] = srgb ? 2 : 1; // sRGB or linear transfer
+			out[11] = 0;            // straight alpha
+			out[12] = 3;            // 4x4 texel blocks, stored as size - 1
+			out[13] = 3;
+			out[16] = (uint8_t)blockSize;
+
+			uint8_t* sample = out + 24;
+			for (auto& s : samples) {
+				uint16_t bitLength = (uint16_t)(blockSize * 8 / samples.size());
+				*(uint16_t*)sample = s.BitOffset;
+				sample[2] = (uint8_t)(bitLength - 1);
+				sample[3] = s.Channel;
+				*(uint32_t*)(sample + 12) = UINT32_MAX;
+				sample += 16;
+			}
+			return dfd;
+		}
+
+		static void AppendKeyValue(std::vector<uint8_t>& kvd, const char* key, const void* value, uint32_t valueSize) {
+			uint32_t length = (uint32_t)strlen(key) + 1 + valueSize;
+			size_t offset = kvd.size();
+			kvd.resize(offset + sizeof(uint32_t) + ((length + 3) & ~3u), 0);
+			memcpy(&kvd[offset], &length, sizeof(uint32_t));
+			memcpy(&kvd[offset + sizeof(uint32_t)], key, strlen(key) + 1);
+			memcpy(&kvd[offset + sizeof(uint32_t) + strlen(key) + 1], value, valueSize);
+		}
+
+		bool TextureFile::WriteKTX2(const std::string& path, const API::Image& image, bool srgb, uint64_t sourceHash) {
+			uint32_t blockSize = API::Texture::GetBlockSize(image.Format);
+			uint32_t vkFormat = ToVkFormat(image.Format, srgb);
+			if (blockSize == 0 || vkFormat == 0) {
+				SNOW_CORE_ERROR("Only BCn textures can be written to {0}", path);
+				return false;
+			}
+			if (image.FirstMip != 0) {
+				SNOW_CORE_ERROR("Only complete mip chains can be written to {0}", path);
+				return false;
+			}
+
+			std::vector<uint8_t> dfd = BuildDataFormatDescriptor(image.Format, srgb);
+
+			// Keys are sorted by name
+			std::vector<uint8_t> kvd;
+			AppendKeyValue(kvd, "KTXorientation", "ru", 3);
+			AppendKeyValue(kvd, "KTXwriter", "Snow", 5);
+			KTX2CookInfo cookInfo = { CookedTextureVersion, 0, sourceHash };
+			AppendKeyValue(kvd, "SnowCook", &cookInfo, sizeof(KTX2CookInfo));
+
+			KTX2Header header = {};
+			memcpy(header.Identifier, KTX2Identifier, sizeof(KTX2Identifier));
+			header.VkFormat = vkFormat;
+			header.TypeSize = 1;
+			header.PixelWidth = image.Width;
+			header.PixelHeight = image.Height;
+			header.FaceCount = 1;
+			header.LevelCount = image.MipCount;
+			header.DFDByteOffset = (uint32_t)(sizeof(KTX2Header) + image.MipCount * sizeof(KTX2Level));
+			header.DFDByteLength = (uint32_t)dfd.size();
+			header.KVDByteOffset = header.DFDByteOffset + header.DFDByteLength;
+			header.KVDByteLength = (uint32_t)kvd.size();
+
+			// Levels are stored smallest first, each aligned to its block size
+			std::vector<KTX2Level> levels(image.MipCount);
+			std::vector<uint64_t> sourceOffsets(image.MipCount);
+			for (uint32_t level = 0, width = image.Width, height = image.Height, offset = 0; level < image.MipCount; level++) {
+				sourceOffsets[level] = offset;
+				levels[level].ByteLength = levels[level].UncompressedByteLength = API::Texture::GetImageSize(image.Format, width, height);
+				offset += (uint32_t)levels[level].ByteLength;
+				width = std::max(width / 2, 1u);
+				height = std::max(height / 2, 1u);
+			}
+
+			uint64_t fileSize = header.KVDByteOffset + header.KVDByteLength;
+			for (uint32_t level = image.MipCount; level-- > 0;) {
+				fileSize = (fileSize + blockSize - 1) / blockSize * blockSize;
+				levels[level].ByteOffset = fileSize;
+				fileSize += levels[level].ByteLength;
+			}
+
+			std::vector<uint8_t> file(fileSize, 0);
+			memcpy(file.data(), &header, sizeof(KTX2Header));
+			memcpy(file.data() + sizeof(KTX2Header), levels.data(), levels.size() * sizeof(KTX2Level));
+			memcpy(file.data() + header.DFDByteOffset, dfd.data(), dfd.size());
+			memcpy(file.data() + header.KVDByteOffset, kvd.data(), kvd.size());
+			for (uint32_t level = 0; level < image.MipCount; level++)
+				memcpy(file.data() + levels[level].ByteOffset, image.Pixels.data() + sourceOffsets[level], levels[level].ByteLength);
+
+			std::error_code error;
+			std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+
+			std::ofstream fout(path, std::ios::binary);
+			if (!fout) {
+				SNOW_CORE_WARN("Could not write cooked texture {0}", path);
+				return false;
+			}
+			fout.write((const char*)file.data(), file.size());
+			return true;
+		}
+	}
+}
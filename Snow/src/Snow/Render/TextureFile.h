@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Snow/Render/API/Texture.h"
+
+#include <string>
+
+namespace Snow {
+	namespace Render {
+		// Reads and writes precomputed mip chains in KTX2 and DDS containers. Images always come back with their rows
+		// bottom to top like decoded images, files stored top down are flipped where the block format allows it.
+		class TextureFile {
+		public:
+			// outSourceHash receives the hash of the file a cooked texture was built from, 0 for files from other tools
+			// or from an older cook. Levels wider or taller than maxSize are skipped unless it is 0.
+			static bool ReadKTX2(const std::string& path, API::Image& outImage, uint64_t* outSourceHash = nullptr, uint32_t maxSize = 0);
+			static bool ReadDDS(const std::string& path, API::Image& outImage);
+
+			// The KTX2 file holding the mip chain Image::LoadCooked reads for path: path itself for KTX2 files, the cook
+			// of decoded formats and nothing for DDS files, which are always loaded whole
+			static std::string GetCookedPath(const std::string& path, bool srgb);
+
+			// Writes a block compressed image as a cooked KTX2 file
+			static bool WriteKTX2(const std::string& path, const API::Image& image, bool srgb, uint64_t sourceHash);
+		};
+	}
+}
@@ -0,0 +1,231 @@
+#include <spch.h>
+#include "Snow/Render/TextureStreamer.h"
+
+#include "Snow/Render/AssetManager.h"
+#include "Snow/Render/Renderer2D.h"
+#include "Snow/Render/TextureFile.h"
+
+#include <cmath>
+#include <unordered_map>
+
+namespace Snow {
+	namespace Render {
+		static constexpr uint32_t NoRequest = UINT32_MAX;
+
+		struct StreamedTexture {
+			WeakRef<API::Texture2D> Texture;
+			std::string Path;
+			API::TextureFormat Format = API::TextureFormat::None;
+			uint32_t Width = 0, Height = 0;
+			uint32_t MipCount = 0;
+
+			// The levels loaded with the texture, they are never freed
+			uint32_t FloorMip = 0;
+			uint32_t ResidentMip = 0;
+			// Finest level requested since the last Update, and the finest the texture should currently hold
+			uint32_t RequestedMip = NoRequest;
+			uint32_t WantedMip = 0;
+			uint64_t LastUsedFrame = 0;
+
+			bool Loading = false;
+			uint64_t LoadingBytes = 0;
+		};
+
+		struct TextureStreamerData {
+			std::unordered_map<const API::Texture*, StreamedTexture> Textures;
+			uint64_t Budget = 512ull * 1024 * 1024;
+			uint64_t ResidentBytes = 0;
+			uint32_t Loading = 0;
+			uint64_t Frame = 0;
+		};
+		static TextureStreamerData s_Data;
+
+		// Bytes of the levels from firstMip to the end of the chain
+		static uint64_t GetChainSize(const StreamedTexture& entry, uint32_t firstMip) {
+			uint64_t size = 0;
+			for (uint32_t level = firstMip; level < entry.MipCount; level++)
+				size += API::Texture::GetImageSize(entry.Format, std::max(entry.Width >> level, 1u), std::max(entry.Height >> level, 1u));
+			return size;
+		}
+
+		void TextureStreamer::Shutdown() {
+			s_Data.Textures.clear();
+			s_Data.ResidentBytes = 0;
+			s_Data.Loading = 0;
+		}
+
+		void TextureStreamer::Register(const Ref<API::Texture2D>& texture, const std::string& path, uint32_t width, uint32_t height) {
+			StreamedTexture entry;
+			entry.Texture = texture;
+			entry.Path = path;
+			entry.Format = texture->GetFormat();
+			entry.Width = width;
+			entry.Height = height;
+			entry.MipCount = texture->GetMipCount();
+			entry.FloorMip = entry.ResidentMip = entry.WantedMip = texture->GetResidentMip();
+			entry.LastUsedFrame = s_Data.Frame;
+
+			auto it = s_Data.Textures.find(texture.Raw());
+			if (it != s_Data.Textures.end())
+				s_Data.ResidentBytes -= GetChainSize(it->second, it->second.ResidentMip);
+			s_Data.ResidentBytes += GetChainSize(entry, entry.ResidentMip);
+			s_Data.Textures[texture.Raw()] = std::move(entry);
+		}
+
+		void TextureStreamer::Request(const API::Texture* texture, float screenSize) {
+			auto it = s_Data.Textures.find(texture);
+			if (it == s_Data.Textures.end())
+				return;
+
+			StreamedTexture& entry = it->second;
+			float size = (float)std::max(entry.Width, entry.Height);
+			uint32_t mip = screenSize >= size ? 0 : (uint32_t)std::log2(size / std::max(screenSize, 1.0f));
+			entry.RequestedMip = std::min({ entry.RequestedMip, mip, entry.FloorMip });
+		}
+
+		// Frees the levels textures hold beyond what they want, least recently drawn first, until bytes are freed
+		static void Trim(uint64_t bytes) {
+			std::vector<StreamedTexture*> unused;
+			for (auto& [key, entry] : s_Data.Textures) {
+				if (!entry.Loading && entry.ResidentMip < entry.WantedMip)
+					unused.push_back(&entry);
+			}
+			std::sort(unused.begin(), unused.end(), [](const StreamedTexture* a, const StreamedTexture* b) {
+				return a->LastUsedFrame < b->LastUsedFrame;
+			});
+
+			uint64_t freed = 0;
+			for (StreamedTexture* entry : unused) {
+				if (freed >= bytes)
+					break;
+
+				Ref<API::Texture2D> texture = entry->Texture.Lock();
+				if (!texture)
+					continue;
+
+				freed += GetChainSize(*entry, entry->ResidentMip) - GetChainSize(*entry, entry->WantedMip);
+				texture->EvictMips(entry->WantedMip);
+				Renderer2D::ReleaseTexture(texture);
+				entry->ResidentMip = entry->WantedMip;
+			}
+			s_Data.ResidentBytes -= freed;
+		}
+
+		static void FinishLoad(const API::Texture* key, Ref<API::Texture2D>& texture, const API::Image& image) {
+			s_Data.Loading--;
+			auto it = s_Data.Textures.find(key);
+			if (it == s_Data.Textures.end())
+				return;
+
+			StreamedTexture& entry = it->second;
+			entry.Loading = false;
+
+			// A file that failed to read or was cooked again since registration stops the texture from streaming
+			bool matches = image.Width == entry.Width && image.Height == entry.Height && image.Format == entry.Format && image.MipCount == entry.MipCount;
+			if (!matches || image.FirstMip >= entry.ResidentMip) {
+				SNOW_CORE_WARN("Could not stream {0}, the texture keeps the levels it has", entry.Path);
+				s_Data.ResidentBytes -= GetChainSize(entry, entry.ResidentMip);
+				s_Data.Textures.erase(it);
+				return;
+			}
+
+			// The whole chain from the new level on is uploaded again, the coarse levels it repeats are small
+			s_Data.ResidentBytes += GetChainSize(entry, image.FirstMip) - GetChainSize(entry, entry.ResidentMip);
+			texture->SetImage(image);
+			Renderer2D::ReleaseTexture(texture);
+			entry.ResidentMip = image.FirstMip;
+		}
+
+		// Returns the bytes the load adds once it is uploaded
+		static uint64_t StartLoad(StreamedTexture& entry, uint32_t mip) {
+			Ref<API::Texture2D> texture = entry.Texture.Lock();
+			uint64_t loadingBytes = GetChainSize(entry, mip) - GetChainSize(entry, entry.ResidentMip);
+			entry.Loading = true;
+			entry.LoadingBytes = loadingBytes;
+			s_Data.Loading++;
+
+			const API::Texture* key = texture.Raw();
+			uint32_t maxSize = std::max(std::max(entry.Width, entry.Height) >> mip, 1u);
+			auto image = std::make_shared<API::Image>();
+			AssetManager::Submit(
+				[image, path = entry.Path, maxSize]() {
+					TextureFile::ReadKTX2(path, *image, nullptr, maxSize);
+				},
+				[image, texture, key]() mutable {
+					FinishLoad(key, texture, *image);
+				});
+			return loadingBytes;
+		}
+
+		void TextureStreamer::Update() {
+			s_Data.Frame++;
+
+			uint64_t loadingBytes = 0;
+			std::vector<StreamedTexture*> wanting;
+			for (auto it = s_Data.Textures.begin(); it != s_Data.Textures.end();) {
+				StreamedTexture& entry = it->second;
+				if (!entry.Texture.IsValid()) {
+					s_Data.ResidentBytes -= GetChainSize(entry, entry.ResidentMip);
+					it = s_Data.Textures.erase(it);
+					continue;
+				}
+
+				if (entry.RequestedMip != NoRequest) {
+					entry.WantedMip = entry.RequestedMip;
+					entry.LastUsedFrame = s_Data.Frame;
+				}
+				else if (s_Data.Frame - entry.LastUsedFrame > LingerFrames)
+					entry.WantedMip = entry.FloorMip;
+				entry.RequestedMip = NoRequest;
+
+				if (entry.Loading)
+					loadingBytes += entry.LoadingBytes;
+				else if (entry.WantedMip < entry.ResidentMip)
+					wanting.push_back(&entry);
+				++it;
+			}
+
+			// A lowered budget frees what is no longer drawn straight away
+			if (s_Data.ResidentBytes + loadingBytes > s_Data.Budget)
+				Trim(s_Data.ResidentBytes + loadingBytes - s_Data.Budget);
+
+			// Textures missing the most detail go first, ties go to the most recently drawn
+			std::sort(wanting.begin(), wanting.end(), [](const StreamedTexture* a, const StreamedTexture* b) {
+				uint32_t missingA = a->ResidentMip - a->WantedMip, missingB = b->ResidentMip - b->WantedMip;
+				if (missingA != missingB)
+					return missingA > missingB;
+				return a->LastUsedFrame > b->LastUsedFrame;
+			});
+
+			for (StreamedTexture* entry : wanting) {
+				if (s_Data.Loading >= MaxLoadsInFlight)
+					break;
+
+				uint64_t resident = GetChainSize(*entry, entry->ResidentMip);
+				uint64_t needed = GetChainSize(*entry, entry->WantedMip) - resident;
+				if (s_Data.ResidentBytes + loadingBytes + needed > s_Data.Budget)
+					Trim(s_Data.ResidentBytes + loadingBytes + needed - s_Data.Budget);
+
+				// Settle for the finest level that still fits
+				uint32_t mip = entry->WantedMip;
+				while (mip < entry->ResidentMip && s_Data.ResidentBytes + loadingBytes + GetChainSize(*entry, mip) - resident > s_Data.Budget)
+					mip++;
+				if (mip < entry->ResidentMip)
+					loadingBytes += StartLoad(*entry, mip);
+			}
+		}
+
+		void TextureStreamer::SetBudget(uint64_t bytes) {
+			s_Data.Budget = bytes;
+		}
+
+		TextureStreamer::Statistics TextureStreamer::GetStatistics() {
+			Statistics stats;
+			stats.Textures = (uint32_t)s_Data.Textures.size();
+			stats.Loading = s_Data.Loading;
+			stats.ResidentBytes = s_Data.ResidentBytes;
+			stats.Budget = s_Data.Budget;
+			return stats;
+		}
+	}
+}
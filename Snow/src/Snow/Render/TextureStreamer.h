@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Snow/Core/Ref.h"
+
+#include "Snow/Render/API/Texture.h"
+
+#include <string>
+
+namespace Snow {
+	namespace Render {
+		// Keeps only the mip levels textures are drawn at in VRAM. Streamed textures load with their levels up to
+		// MinResidentSize, the renderer requests finer ones from the size textures cover on screen and Update streams
+		// them in through the AssetManager. Once the budget is reached, levels of the textures drawn least recently are
+		// freed first.
+		class TextureStreamer {
+		public:
+			static void Shutdown();
+
+			// path is the KTX2 file holding the texture's complete mip chain, width and height the size of its level 0
+			static void Register(const Ref<API::Texture2D>& texture, const std::string& path, uint32_t width, uint32_t height);
+
+			// Asks for the level giving about one texel per pixel while the texture covers screenSize pixels. Textures
+			// that are not streamed are ignored.
+			static void Request(const API::Texture* texture, float screenSize);
+
+			// Once per frame: starts loading the levels requested since the last update and frees unused ones
+			static void Update();
+
+			static void SetBudget(uint64_t bytes);
+
+			struct Statistics {
+				uint32_t Textures = 0;
+				uint32_t Loading = 0;
+				uint64_t ResidentBytes = 0;
+				uint64_t Budget = 0;
+			};
+			static Statistics GetStatistics();
+
+			static constexpr uint32_t MinResidentSize = 128;
+			static constexpr uint32_t MaxLoadsInFlight = 4;
+			// Frames a texture keeps the levels it last asked for after it stops being drawn
+			static constexpr uint32_t LingerFrames = 120;
+		};
+	}
+}
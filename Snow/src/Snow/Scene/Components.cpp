@@ -3,6 +3,7 @@
 #include "Snow/Scene/Components.h"
 
 #include "Snow/Script/ScriptEngine.h"
+#include "Snow/Render/AssetManager.h"
 
 namespace YAML {
     template<>
@@ -132,14 +133,38 @@ namespace Snow {
         out << YAML::BeginMap;
 
         out << YAML::Key << "Color" << YAML::Value << Color;
+        if (Texture && !Texture->GetPath().empty())
+            out << YAML::Key << "Texture" << YAML::Value << Texture->GetPath();
 
-        out << YAML::EndMap; // TransformComponent
+        out << YAML::EndMap; // SpriteRendererComponent
     }
 
     bool SpriteRendererComponent::Deserialize(YAML::Node node, SpriteRendererComponent& outSRC) {
         auto src = node["SpriteRendererComponent"];
         if (src) {
             outSRC.Color = src["Color"].as<glm::vec4>();
+            if (src["Texture"])
+                outSRC.Texture = Render::AssetManager::LoadTexture2D(src["Texture"].as<std::string>());
+            return true;
+        }
+        return false;
+    }
+
+    void MeshComponent::Serialize(YAML::Emitter& out) {
+        out << YAML::Key << "MeshComponent";
+        out << YAML::BeginMap;
+
+        out << YAML::Key << "Mesh" << YAML::Value << Mesh->GetPath();
+        out << YAML::Key << "Compact" << YAML::Value << (Mesh->GetVertexFormat() == Render::VertexFormat::Compact);
+
+        out << YAML::EndMap; // MeshComponent
+    }
+
+    bool MeshComponent::Deserialize(YAML::Node node, MeshComponent& outMC) {
+        auto mc = node["MeshComponent"];
+        if (mc && mc["Mesh"]) {
+            bool compact = mc["Compact"] && mc["Compact"].as<bool>();
+            outMC.Mesh = Render::AssetManager::LoadMesh(mc["Mesh"].as<std::string>(), compact ? Render::VertexFormat::Compact : Render::VertexFormat::Full);
             return true;
         }
         return false;
@@ -11,6 +11,7 @@
 #include "Snow/Render/API/Texture.h"
 
 #include "Snow/Render/Mesh.h"
+#include "Snow/Render/AssetManager.h"
 
 #include "Snow/Math/Mat4.h"
 #include "Snow/Physics/2D/RigidBody2D.h"
@@ -153,6 +154,9 @@ namespace Snow {
         };
         Roughness RoughnessInput;
 
+        // Must be set whenever an input above is edited, the scene copies them into the material instance only then
+        bool Dirty = true;
+
         BRDFMaterialComponent() = default;
         BRDFMaterialComponent(const BRDFMaterialComponent& other) = default;
         BRDFMaterialComponent(const Ref<Render::MaterialInstance>& materialInstance) :
@@ -163,9 +167,12 @@ namespace Snow {
         Ref<Render::Mesh> Mesh;
 
         MeshComponent() = default;
-        MeshComponent(const std::string& filePath) {
-            Mesh = Ref<Render::Mesh>::Create(filePath);
+        MeshComponent(const std::string& filePath, Render::VertexFormat format = Render::VertexFormat::Full) {
+            Mesh = Render::AssetManager::LoadMesh(filePath, format);
         }
+
+        void Serialize(YAML::Emitter& out);
+        static bool Deserialize(YAML::Node node, MeshComponent& outMC);
     };
 
     struct ScriptComponent {
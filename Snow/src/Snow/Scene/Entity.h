@@ -32,6 +32,12 @@ namespace Snow {
             return m_Scene->m_Registry.has<T>(m_EntityHandle);
         }
 
+        // Tells the scene a component was edited in place through the reference GetComponent returned
+        template<typename T>
+        void MarkChanged() {
+            m_Scene->m_Registry.patch<T>(m_EntityHandle);
+        }
+
         template<typename T>
         void RemoveComponent() {
             m_Scene->m_Registry.remove<T>(m_EntityHandle);
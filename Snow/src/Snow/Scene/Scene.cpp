@@ -1,6 +1,8 @@
 #include <spch.h>
 #include "Snow/Scene/Scene.h"
 
+#include "Snow/Core/JobSystem.h"
+
 #include "Snow/Render/Renderer2D.h"
 #include "Snow/Render/Renderer3D.h"
 
@@ -24,6 +26,55 @@ namespace Snow {
         UUID SceneID;
     };
 
+    // Where an entity sits in the spatial index, and the transform and bounds it was last inserted with
+    struct SpatialProxyComponent {
+        int32_t Proxy;
+        glm::mat4 Transform;
+        Core::AABB LocalBounds;
+        Core::AABB Bounds;
+    };
+
+    // The PBR shader's material properties, resolved once per shader and again after it reloads
+    struct BRDFMaterialProperties {
+        // Weak so a shader freed and another created at the same address is not taken for the same one
+        WeakRef<Render::Shader> Shader;
+        uint32_t ShaderReloadCount = 0;
+
+        Render::MaterialPropertyID AlbedoColor, Metalness, Roughness, RadiancePrefilter;
+        Render::MaterialPropertyID AlbedoTexToggle, NormalTexToggle, MetalnessTexToggle, RoughnessTexToggle;
+        Render::MaterialPropertyID AlbedoTexture, NormalTexture, MetalnessTexture, RoughnessTexture;
+        Render::MaterialPropertyID EnvRadianceTexture, EnvIrradianceTexture, BRDFLUTTexture;
+    };
+    static std::unordered_map<const Render::Shader*, BRDFMaterialProperties> s_BRDFProperties;
+
+    static const BRDFMaterialProperties& GetBRDFProperties(Render::MaterialInstance& instance) {
+        Ref<Render::Material> material = instance.GetMaterial();
+        Ref<Render::Shader> shader = material->GetShader();
+
+        BRDFMaterialProperties& properties = s_BRDFProperties[shader.Raw()];
+        if (properties.Shader.IsValid() && properties.ShaderReloadCount == shader->GetReloadCount())
+            return properties;
+
+        properties.Shader = shader;
+        properties.ShaderReloadCount = shader->GetReloadCount();
+        properties.AlbedoColor = material->GetPropertyID("AlbedoColor");
+        properties.Metalness = material->GetPropertyID("Metalness");
+        properties.Roughness = material->GetPropertyID("Roughness");
+        properties.RadiancePrefilter = material->GetPropertyID("RadiancePrefilter");
+        properties.AlbedoTexToggle = material->GetPropertyID("AlbedoTexToggle");
+        properties.NormalTexToggle = material->GetPropertyID("NormalTexToggle");
+        properties.MetalnessTexToggle = material->GetPropertyID("MetalnessTexToggle");
+        properties.RoughnessTexToggle = material->GetPropertyID("RoughnessTexToggle");
+        properties.AlbedoTexture = material->GetPropertyID("u_AlbedoTexture");
+        properties.NormalTexture = material->GetPropertyID("u_NormalTexture");
+        properties.MetalnessTexture = material->GetPropertyID("u_MetalnessTexture");
+        properties.RoughnessTexture = material->GetPropertyID("u_RoughnessTexture");
+        properties.EnvRadianceTexture = material->GetPropertyID("u_EnvRadianceTexture");
+        properties.EnvIrradianceTexture = material->GetPropertyID("u_EnvIrradianceTexture");
+        properties.BRDFLUTTexture = material->GetPropertyID("u_BRDFLUTTexture");
+        return properties;
+    }
+
     static void OnScriptComponentConstruct(entt::registry& registry, entt::entity entity) {
         auto sceneView = registry.view<SceneComponent>();
         UUID sceneID = registry.get<SceneComponent>(sceneView.front()).SceneID;
@@ -45,11 +96,23 @@ namespace Snow {
         Script::ScriptEngine::OnScriptComponentDestroyed(sceneID, entityID);
     }
 
+    // Adding, editing or removing T moves or resizes the entity's bounds in the spatial index
+    template<typename T>
+    void Scene::TrackSpatialChanges() {
+        m_Registry.on_construct<T>().template connect<&Scene::OnSpatialChange>(*this);
+        m_Registry.on_update<T>().template connect<&Scene::OnSpatialChange>(*this);
+        m_Registry.on_destroy<T>().template connect<&Scene::OnSpatialChange>(*this);
+    }
+
     Scene::Scene(const std::string& name) :
         m_Name(name) {
 
         m_Registry.on_construct<ScriptComponent>().connect<&OnScriptComponentConstruct>();
         m_Registry.on_destroy<ScriptComponent>().connect<&OnScriptComponentDestroy>();
+        m_Registry.on_destroy<SpatialProxyComponent>().connect<&Scene::OnSpatialProxyDestroy>(*this);
+        TrackSpatialChanges<TransformComponent>();
+        TrackSpatialChanges<MeshComponent>();
+        TrackSpatialChanges<SpriteRendererComponent>();
 
         m_SceneEntity = m_Registry.create();
         m_Registry.emplace<SceneComponent>(m_SceneEntity, m_SceneID);
@@ -61,12 +124,16 @@ namespace Snow {
         s_ActiveScenes[m_SceneID] = this;
 
 
-        m_EnvMap = Render::API::TextureCube::Create("assets/textures/SunnyTextureCube.png");
-        m_BRDFLUT = Render::API::Texture2D::Create("assets/textures/BRDFLUT.png");
+        m_EnvMap = Render::AssetManager::LoadTextureCube("assets/textures/SunnyTextureCube.png");
+        m_BRDFLUT = Render::AssetManager::LoadTexture2D("assets/textures/BRDFLUT.png");
     }
 
     Scene::~Scene() {
         m_Registry.on_destroy<ScriptComponent>().disconnect();
+        m_Registry.on_destroy<SpatialProxyComponent>().disconnect(*this);
+        m_Registry.on_destroy<TransformComponent>().disconnect(*this);
+        m_Registry.on_destroy<MeshComponent>().disconnect(*this);
+        m_Registry.on_destroy<SpriteRendererComponent>().disconnect(*this);
 
         m_Registry.clear();
         s_ActiveScenes.erase(m_SceneID);
@@ -150,147 +217,149 @@ namespace Snow {
         m_PhysicsWorld->Step(ts, 6, 2);
         {
 
+            // Every body only writes its own transform, so the write back is split across the job system. Sleeping
+            // bodies have not moved since they were last written, and neither have bodies whose transform comes out the same.
             auto view = m_Registry.view<RigidBody2DComponent>();
-            for (auto entity : view) {
-                Entity e = { entity, this };
-                auto& transform = e.GetTransform();
-                auto rigidBody2D = e.GetComponent<RigidBody2DComponent>();
-
-                auto& position = rigidBody2D.RigidBody->GetPosition();
-                glm::vec3 translation, rotation, scale;
-                Math::DecomposeTransform(transform, translation, rotation, scale);
+            std::vector<entt::entity> bodies(view.begin(), view.end());
+            std::vector<uint8_t> moved(bodies.size(), 0);
+            Core::JobSystem::ParallelFor((uint32_t)bodies.size(), 64, [&](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; i++) {
+                    auto& rigidBody2D = m_Registry.get<RigidBody2DComponent>(bodies[i]);
+                    if (!rigidBody2D.RigidBody->IsAwake())
+                        continue;
+
+                    auto& transform = m_Registry.get<TransformComponent>(bodies[i]).Transform;
+                    auto& position = rigidBody2D.RigidBody->GetPosition();
+                    glm::vec3 translation, rotation, scale;
+                    Math::DecomposeTransform(transform, translation, rotation, scale);
+
+                    glm::mat4 bodyTransform = glm::translate(glm::mat4(1.0f), { position.x, position.y, transform[3].z }) *
+                        glm::toMat4(glm::quat({ rotation.x, rotation.y, rigidBody2D.RigidBody->GetAngle() })) *
+                        glm::scale(glm::mat4(1.0f), scale);
+                    if (bodyTransform == transform)
+                        continue;
+
+                    transform = bodyTransform;
+                    moved[i] = 1;
+                }
+            });
 
-                transform = glm::translate(glm::mat4(1.0f), { position.x, position.y, transform[3].z }) *
-                    glm::toMat4(glm::quat({ rotation.x, rotation.y, rigidBody2D.RigidBody->GetAngle() })) *
-                    glm::scale(glm::mat4(1.0f), scale);
+            // The change signals are not thread safe, so the moved bodies are only reported once the jobs are done
+            for (size_t i = 0; i < bodies.size(); i++) {
+                if (moved[i])
+                    m_Registry.patch<TransformComponent>(bodies[i]);
             }
         }
     }
 
-    void Scene::OnRenderRuntime(Timestep ts) {
-        Entity cameraEntity = GetMainCamera();
-        SNOW_CORE_ASSERT(cameraEntity.m_Scene);
-        if (!cameraEntity || !cameraEntity.m_Scene)
-            return;
+    // Copies the component's inputs into its material instance, which keeps them until they are edited again
+    static void SyncBRDFMaterial(BRDFMaterialComponent& material, const Ref<Render::API::TextureCube>& envMap, const Ref<Render::API::Texture2D>& brdfLUT) {
+        auto& matInstance = material.MaterialInstance;
+        const BRDFMaterialProperties& properties = GetBRDFProperties(*matInstance);
+        matInstance->Set(properties.AlbedoColor, material.AlbedoInput.AlbedoColor);
+        matInstance->Set(properties.Metalness, material.MetalnessInput.Value);
+        matInstance->Set(properties.Roughness, material.RoughnessInput.Value);
 
-        SNOW_CORE_ASSERT(cameraEntity.HasComponent<TransformComponent>() && cameraEntity.HasComponent<CameraComponent>(), "Scene does not contain any cameras!");
+        matInstance->Set(properties.RadiancePrefilter, 0.0f);
 
-        glm::mat4 cameraViewMatrix = glm::inverse(cameraEntity.GetComponent<TransformComponent>().GetTransform());
-
-        SceneCamera& camera = cameraEntity.GetComponent<CameraComponent>().Camera;
-        camera.SetViewportSize(m_ViewportWidth, m_ViewportHeight);
+        matInstance->Set(properties.AlbedoTexToggle, material.AlbedoInput.UseTexture ? 1.0f : 0.0f);
+        if (material.AlbedoInput.UseTexture)
+            matInstance->Set(properties.AlbedoTexture, material.AlbedoInput.AlbedoTexture);
 
-        Render::SceneRenderer::BeginScene(this, { camera, cameraViewMatrix });
-        {
-            auto group = m_Registry.view<TransformComponent, MeshComponent, BRDFMaterialComponent>();
-            for (auto entity : group) {
-                auto [transform, mesh, material] = group.get<TransformComponent, MeshComponent, BRDFMaterialComponent>(entity);
+        matInstance->Set(properties.NormalTexToggle, material.NormalInput.UseTexture ? 1.0f : 0.0f);
+        if (material.NormalInput.UseTexture)
+            matInstance->Set(properties.NormalTexture, material.NormalInput.NormalTexture);
 
-                if (mesh.Mesh.Raw() != nullptr) {
-                    //auto material = group.get<BRDFMaterialComponent>(entity);
+        matInstance->Set(properties.MetalnessTexToggle, material.MetalnessInput.UseTexture ? 1.0f : 0.0f);
+        if (material.MetalnessInput.UseTexture)
+            matInstance->Set(properties.MetalnessTexture, material.MetalnessInput.MetalnessTexture);
 
-                    if (material.MaterialInstance) {
-                        auto& matInstance = material.MaterialInstance;
-                        matInstance->Set("AlbedoColor", material.AlbedoInput.AlbedoColor);
-                        matInstance->Set("Metalness", material.MetalnessInput.Value);
-                        matInstance->Set("Roughness", material.RoughnessInput.Value);
+        matInstance->Set(properties.RoughnessTexToggle, material.RoughnessInput.UseTexture ? 1.0f : 0.0f);
+        if (material.RoughnessInput.UseTexture)
+            matInstance->Set(properties.RoughnessTexture, material.RoughnessInput.RoughnessTexture);
 
-                        matInstance->Set("RadiancePrefilter", 0.0f);
+        matInstance->Set(properties.EnvRadianceTexture, envMap);
+        matInstance->Set(properties.EnvIrradianceTexture, envMap);
+        matInstance->Set(properties.BRDFLUTTexture, brdfLUT);
 
-                        matInstance->Set("AlbedoTexToggle", material.AlbedoInput.UseTexture ? 1.0f : 0.0f);
-                        if (material.AlbedoInput.UseTexture)
-                            matInstance->Set("u_AlbedoTexture", material.AlbedoInput.AlbedoTexture);
-
-                        matInstance->Set("NormalTexToggle", material.NormalInput.UseTexture ? 1.0f : 0.0f);
-                        if (material.NormalInput.UseTexture)
-                            matInstance->Set("u_NormalTexture", material.NormalInput.NormalTexture);
+        material.Dirty = false;
+    }
 
-                        matInstance->Set("MetalnessTexToggle", material.MetalnessInput.UseTexture ? 1.0f : 0.0f);
-                        if (material.MetalnessInput.UseTexture)
-                            matInstance->Set("u_MetalnessTexture", material.MetalnessInput.MetalnessTexture);
+    void Scene::SubmitVisibleMeshes() {
+        auto group = m_Registry.view<TransformComponent, MeshComponent, BRDFMaterialComponent>();
+        for (auto entity : m_VisibleEntities) {
+            if (!group.contains(entity))
+                continue;
 
-                        matInstance->Set("RoughnessTexToggle", material.RoughnessInput.UseTexture ? 1.0f : 0.0f);
-                        if (material.RoughnessInput.UseTexture)
-                            matInstance->Set("u_MetalnessTexture", material.RoughnessInput.RoughnessTexture);
+            auto [transform, mesh, material] = group.get<TransformComponent, MeshComponent, BRDFMaterialComponent>(entity);
+            if (mesh.Mesh.Raw() == nullptr)
+                continue;
 
-                        matInstance->Set("u_EnvRadianceTexture", m_EnvMap);
-                    }
+            if (material.MaterialInstance && material.Dirty)
+                SyncBRDFMaterial(material, m_EnvMap, m_BRDFLUT);
 
-                    Render::SceneRenderer::SubmitMesh(mesh.Mesh, transform.GetTransform(), material.MaterialInstance);
-                }
-            }
-        }
-        {
-            auto group = m_Registry.view<TransformComponent, SpriteRendererComponent>();
-            for (auto entity : group) {
-                auto [transform, sprite] = group.get<TransformComponent, SpriteRendererComponent>(entity);
-
-                if (!sprite.Texture)
-                    Render::SceneRenderer::Submit2DQuad(transform.GetTransform(), sprite.Color);
-                else
-                    Render::Renderer2D::DrawQuad(transform.GetTransform(), sprite.Texture, sprite.Color);
-            }
+            Render::SceneRenderer::SubmitMesh(mesh.Mesh, transform.GetTransform(), material.MaterialInstance);
         }
-        Render::SceneRenderer::EndScene();
-          
-        
     }
 
-    void Scene::OnRenderEditor(Timestep ts, Render::EditorCamera& editorCamera) {
-        Render::SceneRenderer::BeginScene(this, editorCamera);
-        {
-            auto group = m_Registry.view<TransformComponent, MeshComponent, BRDFMaterialComponent>();
-            for (auto entity : group) {
-                auto [transform, mesh, material] = group.get<TransformComponent, MeshComponent, BRDFMaterialComponent>(entity);
+    void Scene::SubmitVisibleSprites() {
+        // Repacking moves every sprite, it waits until the scene is not playing
+        if (!m_SpriteAtlas || (!m_IsPlaying && m_SpriteAtlas->NeedsRebuild()))
+            BuildSpriteAtlas();
 
-                if (mesh.Mesh.Raw() != nullptr) {
-                    //auto material = group.get<BRDFMaterialComponent>(entity);
+        auto group = m_Registry.view<TransformComponent, SpriteRendererComponent>();
+        for (auto entity : m_VisibleEntities) {
+            if (!group.contains(entity))
+                continue;
 
-                    if (material.MaterialInstance) {
-                        auto& matInstance = material.MaterialInstance;
-                        matInstance->Set("AlbedoColor", material.AlbedoInput.AlbedoColor);
-                        matInstance->Set("Metalness", material.MetalnessInput.Value);
-                        matInstance->Set("Roughness", material.RoughnessInput.Value);
+            auto [transform, sprite] = group.get<TransformComponent, SpriteRendererComponent>(entity);
+            if (!sprite.Texture) {
+                Render::SceneRenderer::Submit2DQuad(transform.GetTransform(), sprite.Color);
+                continue;
+            }
 
-                        matInstance->Set("RadiancePrefilter", 0.0f);
+            // Sprites new to the atlas, or whose image changed such as a placeholder that finished loading, are
+            // packed into the space left without touching the rest
+            const Render::SpriteRegion* region = m_SpriteAtlas->Find(sprite.Texture);
+            if (!region)
+                region = m_SpriteAtlas->Pack(sprite.Texture);
 
-                        matInstance->Set("AlbedoTexToggle", material.AlbedoInput.UseTexture ? 1.0f : 0.0f);
-                        if (material.AlbedoInput.UseTexture)
-                            matInstance->Set("u_AlbedoTexture", material.AlbedoInput.AlbedoTexture);
+            if (region->IsPacked())
+                Render::SceneRenderer::Submit2DQuad(transform.GetTransform(), *region, sprite.Color);
+            else
+                Render::SceneRenderer::Submit2DQuad(transform.GetTransform(), sprite.Texture, sprite.Color);
+        }
+    }
 
-                        matInstance->Set("NormalTexToggle", material.NormalInput.UseTexture ? 1.0f : 0.0f);
-                        if (material.NormalInput.UseTexture)
-                            matInstance->Set("u_NormalTexture", material.NormalInput.NormalTexture);
+    void Scene::OnRenderRuntime(Timestep ts) {
+        Entity cameraEntity = GetMainCamera();
+        SNOW_CORE_ASSERT(cameraEntity.m_Scene);
+        if (!cameraEntity || !cameraEntity.m_Scene)
+            return;
 
-                        matInstance->Set("MetalnessTexToggle", material.MetalnessInput.UseTexture ? 1.0f : 0.0f);
-                        if (material.MetalnessInput.UseTexture)
-                            matInstance->Set("u_MetalnessTexture", material.MetalnessInput.MetalnessTexture);
+        SNOW_CORE_ASSERT(cameraEntity.HasComponent<TransformComponent>() && cameraEntity.HasComponent<CameraComponent>(), "Scene does not contain any cameras!");
 
-                        matInstance->Set("RoughnessTexToggle", material.RoughnessInput.UseTexture ? 1.0f : 0.0f);
-                        if (material.RoughnessInput.UseTexture)
-                            matInstance->Set("u_MetalnessTexture", material.RoughnessInput.RoughnessTexture);
+        glm::mat4 cameraViewMatrix = glm::inverse(cameraEntity.GetComponent<TransformComponent>().GetTransform());
 
-                        matInstance->Set("u_EnvRadianceTexture", m_EnvMap);
-                        matInstance->Set("u_EnvIrradianceTexture", m_EnvMap);
-                        matInstance->Set("u_BRDFLUTTexture", m_BRDFLUT);
-                    }
+        SceneCamera& camera = cameraEntity.GetComponent<CameraComponent>().Camera;
+        camera.SetViewportSize(m_ViewportWidth, m_ViewportHeight);
 
-                    Render::SceneRenderer::SubmitMesh(mesh.Mesh, transform.GetTransform(), material.MaterialInstance);
-                }
-            }
-        }
+        CollectVisibleEntities(camera.GetProjection() * cameraViewMatrix);
+
+        Render::SceneRenderer::BeginScene(this, { camera, cameraViewMatrix });
+        SubmitVisibleMeshes();
+        SubmitVisibleSprites();
+        Render::SceneRenderer::EndScene();
+          
         
-        auto group = m_Registry.group<TransformComponent>(entt::get<SpriteRendererComponent>);
-        for (auto entity : group) {
-            auto [transform, sprite] = group.get<TransformComponent, SpriteRendererComponent>(entity);
+    }
 
-            if (!sprite.Texture)
-                Render::SceneRenderer::Submit2DQuad(transform.GetTransform(), sprite.Color);
-            else
-                Render::Renderer2D::DrawQuad(transform.GetTransform(), sprite.Texture, sprite.Color);
-        }
+    void Scene::OnRenderEditor(Timestep ts, Render::EditorCamera& editorCamera) {
+        CollectVisibleEntities(editorCamera.GetViewProjectionMatrix());
 
-        
+        Render::SceneRenderer::BeginScene(this, editorCamera);
+        SubmitVisibleMeshes();
+        SubmitVisibleSprites();
 
         Render::SceneRenderer::EndScene();
         
@@ -322,6 +391,146 @@ namespace Snow {
         }
     }
 
+    void Scene::BuildSpriteAtlas() {
+        Render::AtlasBuilder builder;
+        auto view = m_Registry.view<SpriteRendererComponent>();
+        for (auto entity : view)
+            builder.Add(view.get<SpriteRendererComponent>(entity).Texture);
+
+        m_SpriteAtlas = builder.Build();
+    }
+
+    static Core::AABB GetLocalBounds(entt::registry& registry, entt::entity entity, bool& outLoading) {
+        auto* mesh = registry.try_get<MeshComponent>(entity);
+        // Meshes still loading in the background have no bounds yet, the proxy is refreshed once they arrive
+        outLoading = mesh && mesh->Mesh && !mesh->Mesh->IsLoaded();
+        if (mesh && mesh->Mesh && mesh->Mesh->IsLoaded())
+            return mesh->Mesh->GetBoundingBox();
+
+        // Sprites are unit quads, anything else is indexed as a point at its origin
+        if (registry.has<SpriteRendererComponent>(entity))
+            return Core::AABB({ -0.5f, -0.5f, 0.0f }, { 0.5f, 0.5f, 0.0f });
+
+        return Core::AABB();
+    }
+
+    void Scene::UpdateSpatialIndex() {
+        m_SpatialChanges.insert(m_SpatialChanges.end(), m_SpatialPending.begin(), m_SpatialPending.end());
+        m_SpatialPending.clear();
+        if (m_SpatialChanges.empty())
+            return;
+
+        std::sort(m_SpatialChanges.begin(), m_SpatialChanges.end());
+        m_SpatialChanges.erase(std::unique(m_SpatialChanges.begin(), m_SpatialChanges.end()), m_SpatialChanges.end());
+
+        struct ProxyUpdate {
+            entt::entity Entity;
+            bool Changed;
+            bool Loading;
+            Core::AABB LocalBounds;
+            Core::AABB Bounds;
+        };
+
+        std::vector<ProxyUpdate> updates;
+        updates.reserve(m_SpatialChanges.size());
+        for (auto entity : m_SpatialChanges) {
+            // Destroyed entities took their proxy with them
+            if (!m_Registry.valid(entity))
+                continue;
+
+            if (!m_Registry.has<TransformComponent>(entity)) {
+                if (m_Registry.has<SpatialProxyComponent>(entity))
+                    m_Registry.remove<SpatialProxyComponent>(entity);
+                continue;
+            }
+
+            updates.push_back({ entity, false, false });
+        }
+        m_SpatialChanges.clear();
+
+        // Bounds are worked out on the job system, the tree and registry are only changed afterwards on this thread
+        auto view = m_Registry.view<TransformComponent>();
+        Core::JobSystem::ParallelFor((uint32_t)updates.size(), 256, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                ProxyUpdate& update = updates[i];
+                const glm::mat4& transform = view.get<TransformComponent>(update.Entity).Transform;
+                update.LocalBounds = GetLocalBounds(m_Registry, update.Entity, update.Loading);
+
+                auto* proxy = m_Registry.try_get<SpatialProxyComponent>(update.Entity);
+                update.Changed = !proxy || proxy->Transform != transform || proxy->LocalBounds.MinBounds != update.LocalBounds.MinBounds || proxy->LocalBounds.MaxBounds != update.LocalBounds.MaxBounds;
+                if (update.Changed)
+                    update.Bounds = update.LocalBounds.Transform(transform);
+            }
+        });
+
+        for (const ProxyUpdate& update : updates) {
+            if (update.Loading)
+                m_SpatialPending.push_back(update.Entity);
+
+            if (!update.Changed)
+                continue;
+
+            const glm::mat4& transform = view.get<TransformComponent>(update.Entity).Transform;
+            auto* proxy = m_Registry.try_get<SpatialProxyComponent>(update.Entity);
+            if (!proxy) {
+                int32_t id = m_SpatialIndex.CreateProxy(update.Bounds, (uint64_t)update.Entity);
+                m_Registry.emplace<SpatialProxyComponent>(update.Entity, id, transform, update.LocalBounds, update.Bounds);
+                continue;
+            }
+
+            m_SpatialIndex.MoveProxy(proxy->Proxy, update.Bounds);
+            proxy->Transform = transform;
+            proxy->LocalBounds = update.LocalBounds;
+            proxy->Bounds = update.Bounds;
+        }
+    }
+
+    void Scene::OnSpatialProxyDestroy(entt::registry& registry, entt::entity entity) {
+        m_SpatialIndex.DestroyProxy(registry.get<SpatialProxyComponent>(entity).Proxy);
+    }
+
+    void Scene::OnSpatialChange(entt::registry& registry, entt::entity entity) {
+        m_SpatialChanges.push_back(entity);
+    }
+
+    Entity Scene::RayCast(const Core::Ray& ray, float maxDistance, float* outDistance) {
+        UpdateSpatialIndex();
+
+        entt::entity closest = entt::null;
+        float closestDistance = maxDistance;
+
+        // The tree only knows the fattened boxes, so hits are confirmed against the entity's own bounds
+        m_SpatialIndex.RayCast(ray, maxDistance, [&](uint64_t userData, float) {
+            entt::entity entity = (entt::entity)userData;
+            float distance;
+            if (ray.Intersects(m_Registry.get<SpatialProxyComponent>(entity).Bounds, distance) && distance <= closestDistance) {
+                closest = entity;
+                closestDistance = distance;
+            }
+            return true;
+        });
+
+        if (closest == entt::null)
+            return Entity{};
+
+        if (outDistance)
+            *outDistance = closestDistance;
+        return Entity(closest, this);
+    }
+
+    void Scene::CollectVisibleEntities(const glm::mat4& viewProjection) {
+        UpdateSpatialIndex();
+
+        // The tree only knows the fattened boxes, its hits are candidates. SceneRenderer culls every submitted draw
+        // against its own bounds, so they are not tested again here.
+        Core::Frustum frustum(viewProjection);
+        m_VisibleEntities.clear();
+        m_SpatialIndex.Query(frustum, [&](uint64_t userData) {
+            m_VisibleEntities.push_back((entt::entity)userData);
+            return true;
+        });
+    }
+
     Entity Scene::FindEntityByTag(const std::string& tag) {
         auto view = m_Registry.view<TagComponent>();
         for (auto entity : view) {
@@ -353,6 +562,8 @@ namespace Snow {
         CopyComponent<NativeScriptComponent>(scene->m_Registry, m_Registry, enttMap);
         CopyComponent<RigidBody2DComponent>(scene->m_Registry, m_Registry, enttMap);
 
+        scene->m_SpriteAtlas = m_SpriteAtlas;
+
         const auto& entityInstanceMap = Script::ScriptEngine::GetEntityInstanceMap();
         if (entityInstanceMap.find(scene->GetUUID()) != entityInstanceMap.end())
             Script::ScriptEngine::CopyEntityScriptData(scene->GetUUID(), m_SceneID);
@@ -3,12 +3,17 @@
 #include "Snow/Core/Ref.h"
 #include "Snow/Render/EditorCamera.h"
 #include "Snow/Render/API/Texture.h"
+#include "Snow/Render/SpriteAtlas.h"
+
+#include "Snow/Math/DynamicAABBTree.h"
 
 #include "Snow/Core/Timestep.h"
 #include "Snow/Core/UUID.h"
 
 #include <entt.hpp>
 
+#include <cfloat>
+
 #include <glm/glm.hpp>
 
 #include <box2d/b2_world.h>
@@ -50,7 +55,17 @@ namespace Snow {
 
         void OnViewportResize(uint32_t width, uint32_t height);
 
+        // Packs every sprite texture in the scene into shared atlas pages. Sprites drawing a texture the atlas has not
+        // seen, or whose image changed since, have it rebuilt on the next frame.
+        void BuildSpriteAtlas();
+
         Entity FindEntityByTag(const std::string& tag);
+
+        // Refreshes the proxies of the entities whose transform, mesh or sprite was added, changed or removed since
+        // the last update. Components edited in place are only seen once Entity::MarkChanged is called for them.
+        void UpdateSpatialIndex();
+        // Closest entity whose bounds the ray hits, an empty Entity if there is none
+        Entity RayCast(const Core::Ray& ray, float maxDistance = FLT_MAX, float* outDistance = nullptr);
         void CopyScene(Ref<Scene> scene);
 
         Light& GetLight() { return m_Light; }
@@ -65,6 +80,16 @@ namespace Snow {
         UUID GetUUID() const { return m_SceneID; }
         static Ref<Scene> GetScene(UUID uuid);
     private:
+        void CollectVisibleEntities(const glm::mat4& viewProjection);
+        // Submits the meshes among the visible entities, syncing the materials edited since they were last drawn
+        void SubmitVisibleMeshes();
+        // Submits the sprites among the visible entities, from the atlas where they were packed into it
+        void SubmitVisibleSprites();
+        void OnSpatialProxyDestroy(entt::registry& registry, entt::entity entity);
+        void OnSpatialChange(entt::registry& registry, entt::entity entity);
+        template<typename T>
+        void TrackSpatialChanges();
+
         UUID m_SceneID;
         entt::entity m_SceneEntity;
         entt::registry m_Registry;
@@ -78,7 +103,15 @@ namespace Snow {
         Ref<Render::API::TextureCube> m_EnvMap;
         Ref<Render::API::Texture2D> m_BRDFLUT;
 
-        bool m_IsPlaying;
+        Ref<Render::SpriteAtlas> m_SpriteAtlas;
+
+        Core::DynamicAABBTree m_SpatialIndex;
+        std::vector<entt::entity> m_SpatialChanges;
+        // Entities whose mesh is still loading, looked at again every update until its bounds are known
+        std::vector<entt::entity> m_SpatialPending;
+        std::vector<entt::entity> m_VisibleEntities;
+
+        bool m_IsPlaying = false;
 
         std::string m_Name;
 
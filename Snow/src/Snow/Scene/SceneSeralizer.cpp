@@ -4,7 +4,9 @@
 #include "Snow/Scene/Entity.h"
 #include "Snow/Scene/Components.h"
 
-
+#include "Snow/Script/ScriptEngine.h"
+#include "Snow/Render/AssetManager.h"
+#include "Snow/Utils/MappedFile.h"
 
 #include <yaml-cpp/yaml.h>
 
@@ -31,6 +33,12 @@ namespace Snow {
 			src.Serialize(out);
 		}
 
+		if (entity.HasComponent<MeshComponent>()) {
+			auto& mc = entity.GetComponent<MeshComponent>();
+			if (mc.Mesh)
+				mc.Serialize(out);
+		}
+
 		if (entity.HasComponent<RigidBody2DComponent>()) {
 			auto& src = entity.GetComponent<RigidBody2DComponent>();
 			src.Serialize(out);
@@ -64,8 +72,242 @@ namespace Snow {
 		fout << out.c_str();
 	}
 
+	// Binary scenes are a header followed by chunks, one per component type, each holding a packed array of records.
+	// Records refer to entities by their index in the Entities chunk and to strings by a range in the Strings chunk.
+	// Chunks of unknown type or newer version are skipped, so the format can grow without breaking old loaders.
+	namespace BinaryScene {
+		constexpr uint32_t MakeFourCC(char a, char b, char c, char d) {
+			return (uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24);
+		}
+
+		constexpr uint32_t Magic = MakeFourCC('S', 'N', 'O', 'W');
+		constexpr uint32_t Version = 1;
+		constexpr uint32_t ChunkAlignment = 8;
+
+		enum ChunkType : uint32_t {
+			Entities = MakeFourCC('E', 'N', 'T', 'S'),
+			Strings = MakeFourCC('S', 'T', 'R', 'S'),
+			Tags = MakeFourCC('T', 'A', 'G', 'S'),
+			Transforms = MakeFourCC('X', 'F', 'R', 'M'),
+			Sprites = MakeFourCC('S', 'P', 'R', 'T'),
+			SpriteTextures = MakeFourCC('S', 'P', 'T', 'X'),
+			RigidBodies2D = MakeFourCC('R', 'B', '2', 'D'),
+			Scripts = MakeFourCC('S', 'C', 'R', 'P'),
+			ScriptFields = MakeFourCC('S', 'F', 'L', 'D'),
+			Meshes = MakeFourCC('M', 'E', 'S', 'H')
+		};
+
+		struct FileHeader {
+			uint32_t Magic;
+			uint32_t Version;
+			uint64_t SceneID;
+			uint32_t EntityCount;
+			uint32_t ChunkCount;
+		};
+
+		struct ChunkHeader {
+			uint32_t Type;
+			uint32_t Version;
+			uint32_t Count;
+			uint32_t Size; // Payload bytes, the next chunk starts at the following ChunkAlignment boundary
+		};
+
+		struct StringRef {
+			uint32_t Offset, Length;
+		};
+
+		struct TagRecord {
+			uint32_t Entity;
+			StringRef Tag;
+		};
+
+		struct TransformRecord {
+			uint32_t Entity;
+			glm::vec3 Translation, Rotation, Scale;
+		};
+
+		struct SpriteRecord {
+			uint32_t Entity;
+			glm::vec4 Color;
+		};
+
+		// Kept out of SpriteRecord so scenes saved before sprites had textures still load
+		struct SpriteTextureRecord {
+			uint32_t Entity;
+			StringRef Path;
+		};
+
+		struct MeshRecord {
+			uint32_t Entity;
+			StringRef Path;
+			uint32_t Format; // Render::VertexFormat
+		};
+
+		struct RigidBody2DRecord {
+			uint32_t Entity;
+			uint32_t Type;
+			glm::vec2 Position;
+			float Rotation;
+			glm::vec2 Size;
+			float Density;
+			float Friction;
+		};
+
+		struct ScriptRecord {
+			uint32_t Entity;
+			StringRef ModuleName;
+			uint32_t FirstField, FieldCount;
+		};
+
+		struct ScriptFieldRecord {
+			StringRef Name;
+			uint32_t Type;
+			uint8_t Data[16];
+		};
+
+		static_assert(sizeof(FileHeader) == 24 && sizeof(ChunkHeader) == 16, "Binary scene headers must stay packed");
+		static_assert(sizeof(TransformRecord) == 40 && sizeof(SpriteRecord) == 20 && sizeof(RigidBody2DRecord) == 36, "Binary scene records must stay packed");
+
+		class Writer {
+		public:
+			StringRef AddString(const std::string& string) {
+				StringRef ref = { (uint32_t)m_Strings.size(), (uint32_t)string.size() };
+				m_Strings.insert(m_Strings.end(), string.begin(), string.end());
+				return ref;
+			}
+
+			template<typename T>
+			void WriteChunk(ChunkType type, const std::vector<T>& records) {
+				WriteChunk(type, records.data(), (uint32_t)records.size(), (uint32_t)(records.size() * sizeof(T)));
+			}
+
+			void WriteChunk(ChunkType type, const void* data, uint32_t count, uint32_t size) {
+				ChunkHeader header = { type, Version, count, size };
+				Append(&header, sizeof(ChunkHeader));
+				Append(data, size);
+				m_Data.resize((m_Data.size() + ChunkAlignment - 1) & ~(size_t)(ChunkAlignment - 1), 0);
+				m_ChunkCount++;
+			}
+
+			void WriteStrings() {
+				WriteChunk(Strings, m_Strings.data(), (uint32_t)m_Strings.size(), (uint32_t)m_Strings.size());
+			}
+
+			bool Save(const std::string& filepath, uint64_t sceneID, uint32_t entityCount) {
+				FileHeader header = { Magic, Version, sceneID, entityCount, m_ChunkCount };
+
+				std::ofstream fout(filepath, std::ios::binary);
+				if (!fout)
+					return false;
+
+				fout.write((const char*)&header, sizeof(FileHeader));
+				fout.write((const char*)m_Data.data(), m_Data.size());
+				return true;
+			}
+		private:
+			void Append(const void* data, size_t size) {
+				const uint8_t* bytes = (const uint8_t*)data;
+				m_Data.insert(m_Data.end(), bytes, bytes + size);
+			}
+
+			std::vector<uint8_t> m_Data;
+			std::vector<char> m_Strings;
+			uint32_t m_ChunkCount = 0;
+		};
+
+		// Points straight into the mapped file, nothing is copied until the components are created
+		template<typename T>
+		struct ChunkView {
+			const T* Records = nullptr;
+			uint32_t Count = 0;
+		};
+	}
+
 	void SceneSerializer::SerializeBinary(const std::string& filepath) {
+		using namespace BinaryScene;
+
+		std::vector<Entity> entities;
+		m_Scene->m_Registry.each([&](auto entityID) {
+			Entity entity = { entityID, m_Scene.Raw() };
+			if (!entity || !entity.HasComponent<IDComponent>())
+				return;
+
+			entities.push_back(entity);
+		});
+
+		Writer writer;
+		std::vector<uint64_t> ids;
+		std::vector<TagRecord> tags;
+		std::vector<TransformRecord> transforms;
+		std::vector<SpriteRecord> sprites;
+		std::vector<SpriteTextureRecord> spriteTextures;
+		std::vector<MeshRecord> meshes;
+		std::vector<RigidBody2DRecord> rigidBodies;
+		std::vector<ScriptRecord> scripts;
+		std::vector<ScriptFieldRecord> scriptFields;
+
+		ids.reserve(entities.size());
+		for (uint32_t i = 0; i < entities.size(); i++) {
+			Entity entity = entities[i];
+			ids.push_back(entity.GetUUID());
+
+			if (entity.HasComponent<TagComponent>())
+				tags.push_back({ i, writer.AddString(entity.GetComponent<TagComponent>().Tag) });
+
+			if (entity.HasComponent<TransformComponent>()) {
+				auto& tc = entity.GetComponent<TransformComponent>();
+				transforms.push_back({ i, tc.Translation, tc.Rotation, tc.Scale });
+			}
+
+			if (entity.HasComponent<SpriteRendererComponent>()) {
+				auto& src = entity.GetComponent<SpriteRendererComponent>();
+				sprites.push_back({ i, src.Color });
+				if (src.Texture && !src.Texture->GetPath().empty())
+					spriteTextures.push_back({ i, writer.AddString(src.Texture->GetPath()) });
+			}
+
+			if (entity.HasComponent<MeshComponent>()) {
+				auto& mesh = entity.GetComponent<MeshComponent>().Mesh;
+				if (mesh)
+					meshes.push_back({ i, writer.AddString(mesh->GetPath()), (uint32_t)mesh->GetVertexFormat() });
+			}
+
+			if (entity.HasComponent<RigidBody2DComponent>()) {
+				auto& rb = entity.GetComponent<RigidBody2DComponent>().RigidBody;
+				rigidBodies.push_back({ i, rb.GetType(), rb.GetPosition(), rb.GetRotation(), rb.GetSize(), rb.GetDensity(), rb.GetFriction() });
+			}
+
+			if (entity.HasComponent<ScriptComponent>()) {
+				auto& sc = entity.GetComponent<ScriptComponent>();
+				ScriptRecord record = { i, writer.AddString(sc.ModuleName), (uint32_t)scriptFields.size(), 0 };
+
+				Script::EntityInstanceData& data = Script::ScriptEngine::GetEntityInstanceData(entity.GetSceneUUID(), entity.GetUUID());
+				auto fieldsIt = data.ModuleFieldMap.find(sc.ModuleName);
+				if (fieldsIt != data.ModuleFieldMap.end()) {
+					for (const auto& [name, field] : fieldsIt->second) {
+						ScriptFieldRecord fieldRecord = { writer.AddString(name), (uint32_t)field.Type, {} };
+						field.GetStoredValueRaw(fieldRecord.Data);
+						scriptFields.push_back(fieldRecord);
+						record.FieldCount++;
+					}
+				}
+				scripts.push_back(record);
+			}
+		}
 
+		writer.WriteChunk(Entities, ids);
+		writer.WriteChunk(Tags, tags);
+		writer.WriteChunk(Transforms, transforms);
+		writer.WriteChunk(Sprites, sprites);
+		writer.WriteChunk(SpriteTextures, spriteTextures);
+		writer.WriteChunk(Meshes, meshes);
+		writer.WriteChunk(RigidBodies2D, rigidBodies);
+		writer.WriteChunk(Scripts, scripts);
+		writer.WriteChunk(ScriptFields, scriptFields);
+		writer.WriteStrings();
+
+		if (!writer.Save(filepath, m_Scene->m_SceneID, (uint32_t)entities.size()))
+			SNOW_CORE_ERROR("Could not write binary scene {0}", filepath);
 	}
 
 	bool SceneSerializer::DeserializeText(const std::string& filepath) {
@@ -96,6 +338,7 @@ namespace Snow {
 					tc.Translation = transformComp.Translation;
 					tc.Rotation = transformComp.Rotation;
 					tc.Scale = transformComp.Scale;
+					tc.UpdateTransform();
 				}
 				
 				SpriteRendererComponent spriteRendererComp;
@@ -103,6 +346,11 @@ namespace Snow {
 					deserializedEntity.AddComponent<SpriteRendererComponent>(spriteRendererComp);
 				}
 
+				MeshComponent meshComp;
+				if (MeshComponent::Deserialize(entity, meshComp)) {
+					deserializedEntity.AddComponent<MeshComponent>(meshComp);
+				}
+
 				RigidBody2DComponent rb2dComp;
 				rb2dComp = RigidBody2DComponent(RigidBody2D(m_Scene->GetPhysicsWorld(), transformComp.GetTransform()));
 				if (RigidBody2DComponent::Deserialize(entity, rb2dComp)) {
@@ -117,10 +365,189 @@ namespace Snow {
 			}
 		}
 
+		m_Scene->BuildSpriteAtlas();
 		return true;
 	}
 
 	bool SceneSerializer::DeserializeBinary(const std::string& filepath) {
-		return false;
+		using namespace BinaryScene;
+
+		Utils::MappedFile file(filepath);
+		if (!file.IsValid() || file.GetSize() < sizeof(FileHeader))
+			return false;
+
+		const uint8_t* data = file.GetData();
+		const FileHeader& header = *(const FileHeader*)data;
+		if (header.Magic != Magic) {
+			SNOW_CORE_ERROR("{0} is not a binary scene", filepath);
+			return false;
+		}
+		if (header.Version > Version) {
+			SNOW_CORE_ERROR("Binary scene {0} has version {1}, newest supported is {2}", filepath, header.Version, Version);
+			return false;
+		}
+
+		ChunkView<uint64_t> ids;
+		ChunkView<char> strings;
+		ChunkView<TagRecord> tags;
+		ChunkView<TransformRecord> transforms;
+		ChunkView<SpriteRecord> sprites;
+		ChunkView<SpriteTextureRecord> spriteTextures;
+		ChunkView<MeshRecord> meshes;
+		ChunkView<RigidBody2DRecord> rigidBodies;
+		ChunkView<ScriptRecord> scripts;
+		ChunkView<ScriptFieldRecord> scriptFields;
+
+		auto bind = [](auto& view, const ChunkHeader& chunk, const uint8_t* payload) {
+			using Record = std::remove_const_t<std::remove_pointer_t<decltype(view.Records)>>;
+			if ((uint64_t)chunk.Count * sizeof(Record) > chunk.Size)
+				return false;
+
+			view.Records = (const Record*)payload;
+			view.Count = chunk.Count;
+			return true;
+		};
+
+		uint64_t offset = sizeof(FileHeader);
+		for (uint32_t i = 0; i < header.ChunkCount; i++) {
+			if (offset + sizeof(ChunkHeader) > file.GetSize())
+				return false;
+
+			const ChunkHeader& chunk = *(const ChunkHeader*)(data + offset);
+			const uint8_t* payload = data + offset + sizeof(ChunkHeader);
+			offset += sizeof(ChunkHeader) + chunk.Size;
+			if (offset > file.GetSize()) {
+				SNOW_CORE_ERROR("Binary scene {0} has a truncated chunk", filepath);
+				return false;
+			}
+			offset = (offset + ChunkAlignment - 1) & ~(uint64_t)(ChunkAlignment - 1);
+
+			if (chunk.Version > Version) {
+				SNOW_CORE_WARN("Skipping chunk {0:x} with unsupported version {1}", chunk.Type, chunk.Version);
+				continue;
+			}
+
+			bool valid = true;
+			switch (chunk.Type) {
+			case Entities:		valid = bind(ids, chunk, payload); break;
+			case Strings:		valid = bind(strings, chunk, payload); break;
+			case Tags:			valid = bind(tags, chunk, payload); break;
+			case Transforms:	valid = bind(transforms, chunk, payload); break;
+			case Sprites:		valid = bind(sprites, chunk, payload); break;
+			case SpriteTextures:	valid = bind(spriteTextures, chunk, payload); break;
+			case Meshes:		valid = bind(meshes, chunk, payload); break;
+			case RigidBodies2D:	valid = bind(rigidBodies, chunk, payload); break;
+			case Scripts:		valid = bind(scripts, chunk, payload); break;
+			case ScriptFields:	valid = bind(scriptFields, chunk, payload); break;
+			}
+
+			if (!valid) {
+				SNOW_CORE_ERROR("Binary scene {0} has a chunk too small for its records", filepath);
+				return false;
+			}
+		}
+
+		if (ids.Count != header.EntityCount) {
+			SNOW_CORE_ERROR("Binary scene {0} is missing entities", filepath);
+			return false;
+		}
+
+		auto getString = [&](const StringRef& ref) {
+			if ((uint64_t)ref.Offset + ref.Length > strings.Count)
+				return std::string();
+			return std::string(strings.Records + ref.Offset, ref.Length);
+		};
+
+		SNOW_CORE_TRACE("Deserializing Scene with id = {0}", header.SceneID);
+		m_Scene->m_SceneID = header.SceneID;
+
+		std::vector<Entity> entities;
+		entities.reserve(ids.Count);
+		for (uint32_t i = 0; i < ids.Count; i++)
+			entities.push_back(m_Scene->CreateEntityWithID(ids.Records[i]));
+
+		for (uint32_t i = 0; i < tags.Count; i++) {
+			auto& record = tags.Records[i];
+			if (record.Entity < entities.size())
+				entities[record.Entity].GetComponent<TagComponent>().Tag = getString(record.Tag);
+		}
+
+		for (uint32_t i = 0; i < transforms.Count; i++) {
+			auto& record = transforms.Records[i];
+			if (record.Entity >= entities.size())
+				continue;
+
+			auto& tc = entities[record.Entity].GetComponent<TransformComponent>();
+			tc.Translation = record.Translation;
+			tc.Rotation = record.Rotation;
+			tc.Scale = record.Scale;
+			tc.UpdateTransform();
+		}
+
+		for (uint32_t i = 0; i < sprites.Count; i++) {
+			auto& record = sprites.Records[i];
+			if (record.Entity < entities.size())
+				entities[record.Entity].AddComponent<SpriteRendererComponent>(record.Color);
+		}
+
+		for (uint32_t i = 0; i < spriteTextures.Count; i++) {
+			auto& record = spriteTextures.Records[i];
+			if (record.Entity < entities.size() && entities[record.Entity].HasComponent<SpriteRendererComponent>())
+				entities[record.Entity].GetComponent<SpriteRendererComponent>().Texture = Render::AssetManager::LoadTexture2D(getString(record.Path));
+		}
+
+		for (uint32_t i = 0; i < meshes.Count; i++) {
+			auto& record = meshes.Records[i];
+			if (record.Entity < entities.size())
+				entities[record.Entity].AddComponent<MeshComponent>(getString(record.Path), record.Format == (uint32_t)Render::VertexFormat::Compact ? Render::VertexFormat::Compact : Render::VertexFormat::Full);
+		}
+
+		for (uint32_t i = 0; i < rigidBodies.Count; i++) {
+			auto& record = rigidBodies.Records[i];
+			if (record.Entity >= entities.size())
+				continue;
+
+			Entity entity = entities[record.Entity];
+			RigidBody2DComponent rb2dComp = RigidBody2DComponent(RigidBody2D(m_Scene->GetPhysicsWorld(), entity.GetComponent<TransformComponent>().GetTransform()));
+
+			glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(record.Position, 0.0f))
+				* glm::rotate(glm::mat4(1.0f), record.Rotation, { 0, 0, 1 })
+				* glm::scale(glm::mat4(1.0f), glm::vec3(record.Size, 1.0f));
+
+			rb2dComp.RigidBody.SetType((RigidBodyType)record.Type);
+			rb2dComp.RigidBody.SetTransform(transform);
+			rb2dComp.RigidBody.SetDensity(record.Density);
+			rb2dComp.RigidBody.SetFriction(record.Friction);
+			entity.AddComponent<RigidBody2DComponent>(rb2dComp);
+		}
+
+		for (uint32_t i = 0; i < scripts.Count; i++) {
+			auto& record = scripts.Records[i];
+			if (record.Entity >= entities.size())
+				continue;
+
+			Entity entity = entities[record.Entity];
+			std::string moduleName = getString(record.ModuleName);
+
+			// Stored fields have to exist before the component is added, adding it instantiates the script
+			if (Script::ScriptEngine::ModuleExists(moduleName) && (uint64_t)record.FirstField + record.FieldCount <= scriptFields.Count) {
+				Script::EntityInstanceData& instanceData = Script::ScriptEngine::GetEntityInstanceData(entity.GetSceneUUID(), entity.GetUUID());
+				auto& publicFields = instanceData.ModuleFieldMap[moduleName];
+				for (uint32_t f = 0; f < record.FieldCount; f++) {
+					auto& fieldRecord = scriptFields.Records[record.FirstField + f];
+					std::string name = getString(fieldRecord.Name);
+					if (publicFields.find(name) == publicFields.end()) {
+						Script::PublicField field = { name, (Script::FieldType)fieldRecord.Type };
+						publicFields.emplace(name, std::move(field));
+					}
+					publicFields.at(name).SetStoredValueRaw((void*)fieldRecord.Data);
+				}
+			}
+
+			entity.AddComponent<ScriptComponent>(moduleName);
+		}
+
+		m_Scene->BuildSpriteAtlas();
+		return true;
 	}
 }
\ No newline at end of file
@@ -101,6 +101,7 @@ namespace Snow {
 			}
 
 			void SetStoredValueRaw(void* src);
+			void GetStoredValueRaw(void* dst) const { GetStoredValue_Internal(dst); }
 		private:
 			EntityInstance* m_EntityInstance;
 			MonoClassField* m_MonoClassField;
@@ -43,6 +43,7 @@ namespace Snow {
 			Entity entity = entityMap.at(entityID);
 			auto& transformComp = entity.GetComponent<TransformComponent>();
 			transformComp.SetTransform(*inTransform);
+			entity.MarkChanged<TransformComponent>();
 		}
 
 		void Snow_Entity_CreateComponent(uint64_t entityID, void* type) {
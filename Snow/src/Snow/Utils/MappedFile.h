@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+
+namespace Snow {
+	namespace Utils {
+		// Read only view of a whole file mapped into memory, unmapped on destruction. A missing file is not logged,
+		// IsValid tells callers to fall back.
+		class MappedFile {
+		public:
+			MappedFile(const std::string& filepath);
+			~MappedFile();
+
+			MappedFile(const MappedFile&) = delete;
+			MappedFile& operator=(const MappedFile&) = delete;
+
+			bool IsValid() const { return m_Data != nullptr; }
+
+			const uint8_t* GetData() const { return m_Data; }
+			uint64_t GetSize() const { return m_Size; }
+		private:
+			const uint8_t* m_Data = nullptr;
+			uint64_t m_Size = 0;
+
+			void* m_FileHandle = nullptr;
+			void* m_MappingHandle = nullptr;
+		};
+
+		// FNV-1a of a file's contents, 0 if it cannot be read. Cooked assets store it to notice edited sources.
+		inline uint64_t HashFile(const std::string& filepath) {
+			MappedFile file(filepath);
+			if (!file.IsValid())
+				return 0;
+
+			uint64_t hash = 14695981039346656037ull;
+			const uint8_t* data = file.GetData();
+			for (uint64_t i = 0; i < file.GetSize(); i++) {
+				hash ^= data[i];
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+	}
+}